@@ -3,7 +3,10 @@
  ** Interface to loadable lexers.
  ** Maintains a list of lexer library paths and CreateLexer functions.
  ** If list changes then load all the lexer libraries and find the functions.
- ** When asked to create a lexer, call each function until one succeeds.
+ ** When asked to create a lexer, call the function of the library listing that name or,
+ ** for unlisted names, call each function until one succeeds.
+ ** Plugin directories hold a library for each lexer which is only loaded when that lexer
+ ** is first made.
  **/
 // Copyright 2019 by Neil Hodgson <neilh@scintilla.org>
 // The License.txt file describes the conditions under which this software may be distributed.
@@ -14,6 +17,9 @@
 #include <string_view>
 #include <vector>
 #include <set>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
 
 #if !defined(_WIN32)
 #include <dlfcn.h>
@@ -81,9 +87,28 @@ struct LexLibrary {
 };
 std::vector<LexLibrary> libraries;
 
+// The library that creates each lexer name, found when loading so MakeLexer need not try each library
+struct LexerCreator {
+	Lexilla::CreateLexerFn fnCL;
+	std::string name;	// Without namespace
+};
+std::map<std::string, LexerCreator, std::less<>> creators;
+
 std::vector<std::string> lexers;
 std::vector<std::string> libraryProperties;
 
+// Directories with a plugin library for each lexer and the names already looked for in them
+std::vector<std::string> pluginDirectories;
+std::set<std::string, std::less<>> pluginsTried;
+
+// Library properties are also set on plugins loaded after they were set
+std::map<std::string, std::string> propertiesSet;
+
+// MakeLexer may load a plugin so all state in this file is guarded against calls from multiple threads.
+// Functions that only read the state share the lock. Lexers are created after releasing it so threads
+// making lexers do not wait for each other: libraries are never unloaded so their functions stay valid.
+std::shared_mutex accessMutex;
+
 Function FindSymbol(Module m, const char *symbol) noexcept {
 #if defined(_WIN32)
 	return ::GetProcAddress(m, symbol);
@@ -109,25 +134,167 @@ constexpr bool HasPrefix(std::string_view s, std::string_view prefix) noexcept {
 	return (s.size() >= prefix.size()) && (prefix == s.substr(0, prefix.size()));
 }
 
+bool EndsWithSeparator(std::string_view path) noexcept {
+	return !path.empty() && (path.back() == '/' || path.back() == '\\');
+}
+
+// Load one library and add its lexers to lexers and plainNames.
+bool LoadLibraryPath(const std::string &path, std::vector<LexerCreator> &plainNames) {
+#if defined(_WIN32)
+	// Convert from UTF-8 to wide characters
+	std::wstring wsPath = WideStringFromUTF8(path);
+	Module lexillaDL = ::LoadLibraryW(wsPath.c_str());
+#else
+	Module lexillaDL = dlopen(path.c_str(), RTLD_LAZY);
+#endif
+	if (!lexillaDL) {
+		return false;
+	}
+	Lexilla::GetLexerCountFn fnLexerCount = FunctionPointer<Lexilla::GetLexerCountFn>(
+		FindSymbol(lexillaDL, LEXILLA_GETLEXERCOUNT));
+	Lexilla::GetLexerNameFn fnLexerName = FunctionPointer<Lexilla::GetLexerNameFn>(
+		FindSymbol(lexillaDL, LEXILLA_GETLEXERNAME));
+	const size_t firstLexer = lexers.size();
+	if (fnLexerCount && fnLexerName) {
+		const int nLexers = fnLexerCount();
+		for (int i = 0; i < nLexers; i++) {
+			constexpr size_t lengthName = 200;
+			char name[lengthName]{};
+			fnLexerName(i, name, sizeof(name));
+			lexers.emplace_back(name);
+		}
+	}
+	Lexilla::CreateLexerFn fnCL = FunctionPointer<Lexilla::CreateLexerFn>(
+		FindSymbol(lexillaDL, LEXILLA_CREATELEXER));
+	Lexilla::LexerNameFromIDFn fnLNFI = FunctionPointer<Lexilla::LexerNameFromIDFn>(
+		FindSymbol(lexillaDL, LEXILLA_LEXERNAMEFROMID));
+	Lexilla::GetLibraryPropertyNamesFn fnGLPN = FunctionPointer<Lexilla::GetLibraryPropertyNamesFn>(
+		FindSymbol(lexillaDL, LEXILLA_GETLIBRARYPROPERTYNAMES));
+	Lexilla::SetLibraryPropertyFn fnSLP = FunctionPointer<Lexilla::SetLibraryPropertyFn>(
+		FindSymbol(lexillaDL, LEXILLA_SETLIBRARYPROPERTY));
+	Lexilla::GetNameSpaceFn fnGNS = FunctionPointer<Lexilla::GetNameSpaceFn>(
+		FindSymbol(lexillaDL, LEXILLA_GETNAMESPACE));
+	std::string nameSpace;
+	if (fnGNS) {
+		nameSpace = fnGNS();
+		nameSpace += LEXILLA_NAMESPACE_SEPARATOR;
+	}
+	if (fnCL) {
+		for (size_t i = firstLexer; i < lexers.size(); i++) {
+			if (!nameSpace.empty()) {
+				creators.emplace(nameSpace + lexers[i], LexerCreator{fnCL, lexers[i]});
+			}
+			plainNames.push_back(LexerCreator{fnCL, lexers[i]});
+		}
+	}
+	LexLibrary lexLib {
+		fnCL,
+		fnLNFI,
+		fnGLPN,
+		fnSLP,
+		nameSpace
+	};
+	libraries.push_back(lexLib);
+	return true;
+}
+
+void AddPlainNames(const std::vector<LexerCreator> &plainNames) {
+	for (const LexerCreator &creator : plainNames) {
+		// Does not replace namespaced names or names from earlier libraries
+		creators.emplace(creator.name, creator);
+	}
+}
+
+void FindLibraryProperties() {
+	std::set<std::string> nameSet;
+	for (const LexLibrary &lexLib : libraries) {
+		if (lexLib.fnGLPN) {
+			const char *cpNames = lexLib.fnGLPN();
+			if (cpNames) {
+				std::string_view names = cpNames;
+				while (!names.empty()) {
+					const size_t separator = names.find_first_of('\n');
+					std::string name(names.substr(0, separator));
+					nameSet.insert(name);
+					if (separator == std::string::npos) {
+						names.remove_prefix(names.size());
+					} else {
+						names.remove_prefix(separator + 1);
+					}
+				}
+			}
+		}
+	}
+	// Properties of a statically linked Lexilla are not listed.
+	libraryProperties = std::vector<std::string>(nameSet.begin(), nameSet.end());
+}
+
+// Plugin files are named for their lexer with characters other than letters, digits, and '_'
+// changed to '_' so they are safe in file names. This matches PluginStem in LexillaGen.py.
+std::string PluginPath(const std::string &directory, std::string_view languageName) {
+	std::string path = directory;
+	path += LEXILLA_LIB;
+	path += "-";
+	for (const char ch : languageName) {
+		const bool safe = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') ||
+			(ch >= '0' && ch <= '9') || (ch == '_');
+		path += safe ? ch : '_';
+	}
+	path += LEXILLA_EXTENSION;
+	return path;
+}
+
+// Load the plugin for languageName from the first plugin directory that has it.
+// Each name is only looked for once so missing plugins do not slow each MakeLexer.
+bool LoadPlugin(std::string_view languageName) {
+	if (pluginDirectories.empty() || (pluginsTried.find(languageName) != pluginsTried.end())) {
+		return false;
+	}
+	pluginsTried.emplace(languageName);
+	for (const std::string &directory : pluginDirectories) {
+		std::vector<LexerCreator> plainNames;
+		if (LoadLibraryPath(PluginPath(directory, languageName), plainNames)) {
+			AddPlainNames(plainNames);
+			const LexLibrary &plugin = libraries.back();
+			if (plugin.fnSLP) {
+				for (const auto &[key, value] : propertiesSet) {
+					plugin.fnSLP(key.c_str(), value.c_str());
+				}
+			}
+			FindLibraryProperties();
+			return true;
+		}
+	}
+	return false;
+}
+
 }
 
 void Lexilla::SetDefault(CreateLexerFn pCreate) noexcept {
+	std::unique_lock<std::shared_mutex> guard(accessMutex);
 	pCreateLexerDefault = pCreate;
 }
 
 void Lexilla::SetDefaultDirectory(std::string_view directory) {
+	std::unique_lock<std::shared_mutex> guard(accessMutex);
 	directoryLoadDefault = directory;
 }
 
 bool Lexilla::Load(std::string_view sharedLibraryPaths) {
+	std::unique_lock<std::shared_mutex> guard(accessMutex);
 	if (sharedLibraryPaths == lastLoaded) {
-		return !libraries.empty();
+		return !libraries.empty() || !pluginDirectories.empty();
 	}
 
 	std::string_view paths = sharedLibraryPaths;
 	lexers.clear();
 
 	libraries.clear();
+	creators.clear();
+	pluginDirectories.clear();
+	pluginsTried.clear();
+	// Names without namespace are added after all libraries are loaded as namespaced names take precedence
+	std::vector<LexerCreator> plainNames;
 	while (!paths.empty()) {
 		const size_t separator = paths.find_first_of(';');
 		std::string path(paths.substr(0, separator));
@@ -136,6 +303,11 @@ bool Lexilla::Load(std::string_view sharedLibraryPaths) {
 		} else {
 			paths.remove_prefix(separator + 1);
 		}
+		if (EndsWithSeparator(path)) {
+			// Plugins are loaded when their lexer is first made
+			pluginDirectories.push_back(path);
+			continue;
+		}
 		if (path == ".") {
 			if (directoryLoadDefault.empty()) {
 				path = "";
@@ -149,83 +321,52 @@ bool Lexilla::Load(std::string_view sharedLibraryPaths) {
 			// No '.' in name so add extension
 			path.append(LEXILLA_EXTENSION);
 		}
-#if defined(_WIN32)
-		// Convert from UTF-8 to wide characters
-		std::wstring wsPath = WideStringFromUTF8(path);
-		Module lexillaDL = ::LoadLibraryW(wsPath.c_str());
-#else
-		Module lexillaDL = dlopen(path.c_str(), RTLD_LAZY);
-#endif
-		if (lexillaDL) {
-			GetLexerCountFn fnLexerCount = FunctionPointer<GetLexerCountFn>(
-				FindSymbol(lexillaDL, LEXILLA_GETLEXERCOUNT));
-			GetLexerNameFn fnLexerName = FunctionPointer<GetLexerNameFn>(
-				FindSymbol(lexillaDL, LEXILLA_GETLEXERNAME));
-			if (fnLexerCount && fnLexerName) {
-				const int nLexers = fnLexerCount();
-				for (int i = 0; i < nLexers; i++) {
-					constexpr size_t lengthName = 200;
-					char name[lengthName]{};
-					fnLexerName(i, name, sizeof(name));
-					lexers.emplace_back(name);
-				}
-			}
-			CreateLexerFn fnCL = FunctionPointer<CreateLexerFn>(
-				FindSymbol(lexillaDL, LEXILLA_CREATELEXER));
-			LexerNameFromIDFn fnLNFI = FunctionPointer<LexerNameFromIDFn>(
-				FindSymbol(lexillaDL, LEXILLA_LEXERNAMEFROMID));
-			GetLibraryPropertyNamesFn fnGLPN = FunctionPointer<GetLibraryPropertyNamesFn>(
-				FindSymbol(lexillaDL, LEXILLA_GETLIBRARYPROPERTYNAMES));
-			SetLibraryPropertyFn fnSLP = FunctionPointer<SetLibraryPropertyFn>(
-				FindSymbol(lexillaDL, LEXILLA_SETLIBRARYPROPERTY));
-			GetNameSpaceFn fnGNS = FunctionPointer<GetNameSpaceFn>(
-				FindSymbol(lexillaDL, LEXILLA_GETNAMESPACE));
-			std::string nameSpace;
-			if (fnGNS) {
-				nameSpace = fnGNS();
-				nameSpace += LEXILLA_NAMESPACE_SEPARATOR;
-			}
-			LexLibrary lexLib {
-				fnCL,
-				fnLNFI,
-				fnGLPN,
-				fnSLP,
-				nameSpace
-			};
-			libraries.push_back(lexLib);
-		}
+		LoadLibraryPath(path, plainNames);
 	}
+	AddPlainNames(plainNames);
 	lastLoaded = sharedLibraryPaths;
 
-	std::set<std::string> nameSet;
-	for (const LexLibrary &lexLib : libraries) {
-		if (lexLib.fnGLPN) {
-			const char *cpNames = lexLib.fnGLPN();
-			if (cpNames) {
-				std::string_view names = cpNames;
-				while (!names.empty()) {
-					const size_t separator = names.find_first_of('\n');
-					std::string name(names.substr(0, separator));
-					nameSet.insert(name);
-					if (separator == std::string::npos) {
-						names.remove_prefix(names.size());
-					} else {
-						names.remove_prefix(separator + 1);
-					}
-				}
-			}
-		}
-	}
-	// Standard Lexilla does not have any properties so can't be added to set.
-	libraryProperties = std::vector<std::string>(nameSet.begin(), nameSet.end());
+	FindLibraryProperties();
 
-	return !libraries.empty();
+	return !libraries.empty() || !pluginDirectories.empty();
 }
 
 Scintilla::ILexer5 *Lexilla::MakeLexer(std::string_view languageName) {
+	LexerCreator creator {};
+	{
+		std::shared_lock<std::shared_mutex> guard(accessMutex);
+		auto itCreator = creators.find(languageName);
+		if (itCreator != creators.end()) {
+			creator = itCreator->second;
+		}
+	}
+	if (!creator.fnCL) {
+		// Only loading a plugin needs exclusive access. LoadPlugin looks for each name once.
+		std::unique_lock<std::shared_mutex> guard(accessMutex);
+		if (LoadPlugin(languageName)) {
+			auto itCreator = creators.find(languageName);
+			if (itCreator != creators.end()) {
+				creator = itCreator->second;
+			}
+		}
+	}
+	if (creator.fnCL) {
+		Scintilla::ILexer5 *pLexer = creator.fnCL(creator.name.c_str());
+		if (pLexer) {
+			return pLexer;
+		}
+	}
+	// Libraries may create lexers with names they do not list
+	std::vector<LexLibrary> librariesCreating;
+	CreateLexerFn pCreateDefault = nullptr;
+	{
+		std::shared_lock<std::shared_mutex> guard(accessMutex);
+		librariesCreating = libraries;
+		pCreateDefault = pCreateLexerDefault;
+	}
 	std::string sLanguageName(languageName);	// Ensure NUL-termination
 	// First, try to match namespace then name suffix
-	for (const LexLibrary &lexLib : libraries) {
+	for (const LexLibrary &lexLib : librariesCreating) {
 		if (lexLib.fnCL && !lexLib.nameSpace.empty()) {
 			if (HasPrefix(languageName, lexLib.nameSpace)) {
 				Scintilla::ILexer5 *pLexer = lexLib.fnCL(sLanguageName.substr(lexLib.nameSpace.size()).c_str());
@@ -236,7 +377,7 @@ Scintilla::ILexer5 *Lexilla::MakeLexer(std::string_view languageName) {
 		}
 	}
 	// If no match with namespace, try to just match name
-	for (const LexLibrary &lexLib : libraries) {
+	for (const LexLibrary &lexLib : librariesCreating) {
 		if (lexLib.fnCL) {
 			Scintilla::ILexer5 *pLexer = lexLib.fnCL(sLanguageName.c_str());
 			if (pLexer) {
@@ -244,8 +385,8 @@ Scintilla::ILexer5 *Lexilla::MakeLexer(std::string_view languageName) {
 			}
 		}
 	}
-	if (pCreateLexerDefault) {
-		return pCreateLexerDefault(sLanguageName.c_str());
+	if (pCreateDefault) {
+		return pCreateDefault(sLanguageName.c_str());
 	}
 #if defined(LEXILLA_STATIC)
 	Scintilla::ILexer5 *pLexer = CreateLexer(sLanguageName.c_str());
@@ -257,10 +398,12 @@ Scintilla::ILexer5 *Lexilla::MakeLexer(std::string_view languageName) {
 }
 
 std::vector<std::string> Lexilla::Lexers() {
+	std::shared_lock<std::shared_mutex> guard(accessMutex);
 	return lexers;
 }
 
 std::string Lexilla::NameFromID(int identifier) {
+	std::shared_lock<std::shared_mutex> guard(accessMutex);
 	for (const LexLibrary &lexLib : libraries) {
 		if (lexLib.fnLNFI) {
 			const char *name = lexLib.fnLNFI(identifier);
@@ -273,14 +416,19 @@ std::string Lexilla::NameFromID(int identifier) {
 }
 
 std::vector<std::string> Lexilla::LibraryProperties() {
+	std::shared_lock<std::shared_mutex> guard(accessMutex);
 	return libraryProperties;
 }
 
 void Lexilla::SetProperty(const char *key, const char *value) {
+	std::unique_lock<std::shared_mutex> guard(accessMutex);
+	propertiesSet[key] = value;
 	for (const LexLibrary &lexLib : libraries) {
 		if (lexLib.fnSLP) {
 			lexLib.fnSLP(key, value);
 		}
 	}
-	// Standard Lexilla does not have any properties so don't set.
+#if defined(LEXILLA_STATIC)
+	SetLibraryProperty(key, value);
+#endif
 }
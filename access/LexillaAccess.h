@@ -20,7 +20,12 @@ void SetDefault(CreateLexerFn pCreate) noexcept;
 
 // sharedLibraryPaths is a ';' separated list of shared libraries to load.
 // On Win32 it is treated as UTF-8 and on Unix it is passed to dlopen directly.
-// Return true if any shared libraries are loaded.
+// Entries ending with a path separator are plugin directories. The plugin for a lexer is named
+// LEXILLA_LIB "-" name LEXILLA_EXTENSION and is loaded when MakeLexer is first called for that
+// name. Its lexers are not in Lexers until then.
+// Return true if any shared libraries are loaded or there are plugin directories.
+// These functions may be called from multiple threads as they share a lock.
+// MakeLexer only holds it to find the creator and load a plugin, not while creating the lexer.
 bool Load(std::string_view sharedLibraryPaths);
 
 Scintilla::ILexer5 *MakeLexer(std::string_view languageName);
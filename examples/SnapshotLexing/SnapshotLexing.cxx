@@ -0,0 +1,202 @@
+// Lexilla lexer library use example
+/** @file SnapshotLexing.cxx
+ ** Lex a snapshot of a document on another thread while the document is edited.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+/* Build and run
+
+    Linux or macOS after building Lexilla in ../../src
+make
+./SnapshotLexing
+./SnapshotLexing ../../bin/liblexilla.so 2000000
+
+The document is a C++ file repeated to the requested size, default 2 MB.
+A snapshot is taken then lexed and folded on a worker thread while the main thread
+edits the document. The result is rebased over the edits, applied, and the rest of the
+document lexed. The final styles, line states, and fold levels are checked against lexing
+the edited document from scratch and the times of each step shown.
+
+The document is the TestDocument from ../../test which stands in for an editor's document.
+*/
+
+#include <cstdlib>
+#include <cstdio>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <utility>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "ILexer.h"
+
+#include "Lexilla.h"
+#include "LexillaExtensions.h"
+#include "LexillaAccess.h"
+
+#include "SnapshotDocument.h"
+#include "TestDocument.h"
+
+using namespace Lexilla;
+
+namespace {
+
+constexpr std::string_view sample =
+	"// A sample of C++ that is repeated to make a large document\n"
+	"#include <string>\n"
+	"\n"
+	"#if defined(FEATURE)\n"
+	"/* Block comment\n"
+	"   over lines */\n"
+	"namespace sample {\n"
+	"\n"
+	"int Count(const std::string &s, char ch) {\n"
+	"\tint count = 0;\n"
+	"\tfor (const char c : s) {\n"
+	"\t\tif (c == ch) {\n"
+	"\t\t\tcount++; // Found\n"
+	"\t\t}\n"
+	"\t}\n"
+	"\treturn count + R\"(raw\n"
+	"string)\"[0] + 'x' + 0x1F;\n"
+	"}\n"
+	"\n"
+	"}\n"
+	"#else\n"
+	"const char *message = \"feature not enabled\";\n"
+	"#endif\n";
+
+constexpr std::string_view edit = "/* Comment opened by an edit\n";
+
+class Timer {
+	std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+public:
+	// Milliseconds since construction
+	[[nodiscard]] double Duration() const noexcept {
+		const auto now = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<double, std::milli>(now - startTime).count();
+	}
+};
+
+void LexAndFold(Scintilla::ILexer5 *plex, Scintilla::IDocument *pdoc, Sci_Position start) {
+	const Sci_Position length = pdoc->Length() - start;
+	const int initStyle = (start > 0) ? pdoc->StyleAt(start - 1) : 0;
+	plex->Lex(start, length, initStyle, pdoc);
+	plex->Fold(start, length, initStyle, pdoc);
+}
+
+// Return the first line that differs in styles, line state, or fold level or -1 when the same.
+Sci_Position FirstDifference(const TestDocument &a, const TestDocument &b) {
+	if (a.Length() != b.Length()) {
+		return 0;
+	}
+	for (Sci_Position line = 0; line <= a.MaxLine(); line++) {
+		if ((a.GetLineState(line) != b.GetLineState(line)) || (a.GetLevel(line) != b.GetLevel(line))) {
+			return line;
+		}
+		for (Sci_Position position = a.LineStart(line); position < a.LineStart(line + 1); position++) {
+			if (a.StyleAt(position) != b.StyleAt(position)) {
+				return line;
+			}
+		}
+	}
+	return -1;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+	const char *libraryPath = (argc > 1) ? argv[1] : "../../bin/liblexilla.so";
+	const size_t sizeWanted = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 2000000;
+	if (!Load(libraryPath)) {
+		std::printf("Could not load %s\n", libraryPath);
+		return 1;
+	}
+
+	std::string text;
+	while (text.length() < sizeWanted) {
+		text.append(sample);
+	}
+
+	TestDocument doc;
+	doc.Set(text);
+	Scintilla::ILexer5 *plex = MakeLexer("cpp");
+	if (!plex) {
+		std::printf("No cpp lexer in %s\n", libraryPath);
+		return 1;
+	}
+	plex->PropertySet("fold", "1");
+
+	// Main thread: take the snapshot
+	const Timer timerSnapshot;
+	SnapshotDocument snapshot(&doc);
+	const double durationSnapshot = timerSnapshot.Duration();
+
+	// Worker thread: lex and fold the snapshot
+	double durationWorker = 0.0;
+	std::thread worker([&]() {
+		const Timer timerWorker;
+		LexAndFold(plex, &snapshot, 0);
+		durationWorker = timerWorker.Duration();
+	});
+
+	// Main thread: edit the document while the worker lexes, remembering the lowest position edited
+	const Timer timerEdits;
+	Sci_Position positionEdited = doc.Length();
+	for (const Sci_Position position : { doc.Length() * 3 / 4, doc.Length() / 2 }) {
+		const Sci_Position lineStart = doc.LineStart(doc.LineFromPosition(position));
+		doc.InsertText(lineStart, edit);
+		positionEdited = std::min(positionEdited, lineStart);
+	}
+	const double durationEdits = timerEdits.Duration();
+
+	worker.join();
+
+	// Main thread: keep the results before the edits and apply them then lex the remainder
+	const Timer timerApply;
+	LexResult result = snapshot.Result();
+	result.Rebase(&doc, positionEdited);
+	result.Apply(&doc);
+	const double durationApply = timerApply.Duration();
+
+	const Timer timerRemainder;
+	const Sci_Position endStyled = result.EndStyled();
+	LexAndFold(plex, &doc, endStyled);
+	const double durationRemainder = timerRemainder.Duration();
+
+	// Check against lexing the edited document from scratch on the main thread
+	std::string textEdited(doc.Length(), '\0');
+	doc.GetCharRange(textEdited.data(), 0, doc.Length());
+	TestDocument docCheck;
+	docCheck.Set(textEdited);
+	Scintilla::ILexer5 *plexCheck = MakeLexer("cpp");
+	plexCheck->PropertySet("fold", "1");
+	const Timer timerFull;
+	LexAndFold(plexCheck, &docCheck, 0);
+	const double durationFull = timerFull.Duration();
+
+	const Sci_Position lineDifferent = FirstDifference(doc, docCheck);
+
+	std::printf("Document %zu bytes, %zu lines\n", static_cast<size_t>(doc.Length()), static_cast<size_t>(doc.MaxLine()));
+	std::printf("Snapshot taken on main thread %8.3f ms\n", durationSnapshot);
+	std::printf("Lex and fold snapshot on worker %8.3f ms\n", durationWorker);
+	std::printf("Edits on main thread during lex %8.3f ms\n", durationEdits);
+	std::printf("Rebase and apply on main thread %8.3f ms, %zu bytes kept of %zu\n", durationApply,
+		static_cast<size_t>(endStyled), static_cast<size_t>(snapshot.Length()));
+	std::printf("Lex remainder on main thread %8.3f ms\n", durationRemainder);
+	std::printf("Lex whole document on main thread %8.3f ms\n", durationFull);
+
+	plex->Release();
+	plexCheck->Release();
+
+	if (lineDifferent >= 0) {
+		std::printf("Result differs from full lex at line %zu\n", static_cast<size_t>(lineDifferent));
+		return 1;
+	}
+	std::printf("Result matches full lex\n");
+	return 0;
+}
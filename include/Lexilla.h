@@ -62,6 +62,7 @@ DEPRECATE_DEFINITION typedef const char *(LEXILLA_CALL *LexerNameFromIDFn)(int i
 typedef const char *(LEXILLA_CALL *GetLibraryPropertyNamesFn)(void);
 typedef void(LEXILLA_CALL *SetLibraryPropertyFn)(const char *key, const char *value);
 typedef const char *(LEXILLA_CALL *GetNameSpaceFn)(void);
+typedef const char *(LEXILLA_CALL *GetLexerStatisticsFn)(void);
 
 #if defined(__cplusplus)
 }
@@ -77,6 +78,7 @@ typedef const char *(LEXILLA_CALL *GetNameSpaceFn)(void);
 #define LEXILLA_GETLIBRARYPROPERTYNAMES "GetLibraryPropertyNames"
 #define LEXILLA_SETLIBRARYPROPERTY "SetLibraryProperty"
 #define LEXILLA_GETNAMESPACE "GetNameSpace"
+#define LEXILLA_GETLEXERSTATISTICS "GetLexerStatistics"
 
 // Static linking prototypes
 
@@ -92,6 +94,7 @@ DEPRECATE_DEFINITION const char *LEXILLA_CALL LexerNameFromID(int identifier);
 const char * LEXILLA_CALL GetLibraryPropertyNames(void);
 void LEXILLA_CALL SetLibraryProperty(const char *key, const char *value);
 const char *LEXILLA_CALL GetNameSpace(void);
+const char *LEXILLA_CALL GetLexerStatistics(void);
 
 #if defined(__cplusplus)
 }
@@ -0,0 +1,132 @@
+// Lexilla lexer library
+/** @file LexillaExtensions.h
+ ** Optional lexer features accessed through ILexer5::PrivateCall and optional document features.
+ ** Lexers return nullptr from PrivateCall for operations they do not implement.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef LEXILLAEXTENSIONS_H
+#define LEXILLAEXTENSIONS_H
+
+// Must have already included ILexer.h to have Scintilla::IDocument defined.
+
+namespace Lexilla {
+
+// Operation codes for ILexer5::PrivateCall.
+// Values are large to avoid collisions with codes used by individual lexers.
+constexpr int privateCallLexConverging = 0x4C580001;
+constexpr int privateCallFoldDuringLex = 0x4C580002;
+constexpr int privateCallMemoryUse = 0x4C580003;
+constexpr int privateCallLexBudgeted = 0x4C580004;
+constexpr int privateCallLineStyleCache = 0x4C580005;
+
+// Arguments for privateCallLexConverging, called after a change in place of ILexer5::Lex.
+// The document must have been lexed past the change before the change was made.
+// The lexer styles from startPos like Lex but may stop after a line following the change
+// where its state matches the state stored by the previous lex as the styles after that
+// line are still valid. When fold is set, the lexer also folds each range as it lexes it
+// and only stops where the fold levels match too, so the application does not call Fold.
+// Without fold, the lexer still stops only where the fold levels match when it folds during lex
+// but otherwise fold levels after the range lexed may be stale.
+// PrivateCall returns the arguments pointer when performed.
+struct LexConvergingArguments {
+	// As for ILexer5::Lex
+	Sci_PositionU startPos = 0;
+	Sci_Position lengthDoc = 0;
+	int initStyle = 0;
+	Scintilla::IDocument *pAccess = nullptr;
+	// End of the text changed since the previous lex
+	Sci_Position changedEnd = 0;
+	// Number of lines added by the change, negative when lines were removed
+	Sci_Position linesInserted = 0;
+	// Whether the application folds
+	bool fold = false;
+	// Set by the lexer: the line after which its state converged or -1 when it did not
+	Sci_Position lineConverged = -1;
+	// Set by the lexer: the end of the range actually lexed
+	Sci_Position endLexed = 0;
+};
+
+// Arguments for privateCallLexBudgeted, called in place of ILexer5::Lex to bound the time
+// taken by lexing. The lexer styles from startPos like Lex but stops at the first line start
+// after either budget is spent and sets endLexed so the application can continue from there
+// later with the style before endLexed as initStyle. At least one line is always lexed and a
+// line is never split so a very long line may exceed the budget.
+// PrivateCall returns the arguments pointer when performed.
+struct LexBudgetArguments {
+	// As for ILexer5::Lex
+	Sci_PositionU startPos = 0;
+	Sci_Position lengthDoc = 0;
+	int initStyle = 0;
+	Scintilla::IDocument *pAccess = nullptr;
+	// Budgets, 0 for no limit
+	Sci_Position maxBytes = 0;
+	int maxMilliseconds = 0;
+	// Set by the lexer: the end of the range actually lexed
+	Sci_Position endLexed = 0;
+};
+
+// Documents that can copy a range of styles in one call derive from IDocumentStyles and
+// add the dvStyleRange flag to the value returned from IDocument::Version.
+// Lexers then read styles through a cached window instead of calling StyleAt for each byte.
+constexpr int dvStyleRange = 0x10000;
+
+class IDocumentStyles : public Scintilla::IDocument {
+public:
+	// Copy the styles of [position, position + lengthRetrieve) into buffer.
+	virtual void SCI_METHOD GetStyleRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const = 0;
+};
+
+// Documents that record how lexers read them derive from IDocumentFills and add the dvFills
+// flag to the value returned from IDocument::Version. Lexers buffer text so the range passed
+// to GetCharRange often starts well before the position actually needed or covers the whole
+// document so lexers report the position needed before each buffer fill.
+constexpr int dvFills = 0x20000;
+
+class IDocumentFills : public Scintilla::IDocument {
+public:
+	// Called before the GetCharRange that fills a buffer around position.
+	virtual void SCI_METHOD Filling(Sci_Position position) = 0;
+};
+
+// privateCallFoldDuringLex takes a pointer to an int which turns the mode on when non-zero.
+// In this mode Lex also sets fold levels so the Fold call that follows for the same range
+// returns without reading the styles back. Only turn on when the application folds.
+// Experimental: it reads less of the document but has not been measured to be faster.
+// PrivateCall returns the pointer when the lexer supports the mode.
+
+// privateCallMemoryUse takes a pointer to a LexerMemoryUse which the lexer fills with an
+// estimate of the memory retained by the instance. total includes the instance itself and
+// items break down the heap memory held by the larger structures that grow with the document.
+// PrivateCall returns the pointer when the lexer supports the report.
+struct LexerMemoryUse {
+	struct Item {
+		const char *name;
+		size_t bytes;
+	};
+	static constexpr int maxItems = 16;
+	size_t total = 0;
+	int items = 0;
+	Item item[maxItems] {};
+	void Add(const char *name, size_t bytes) noexcept {
+		if (items < maxItems) {
+			item[items++] = { name, bytes };
+		}
+		total += bytes;
+	}
+};
+
+// privateCallLineStyleCache takes a pointer to a LineStyleCacheUse which the lexer fills with
+// the activity of the cache it uses to replay the styles of repeated lines when the library
+// property lexilla.line.cache is on. Counts are totals since the lexer was created.
+// PrivateCall returns the pointer when the lexer has a line style cache.
+struct LineStyleCacheUse {
+	size_t lookups = 0;
+	size_t hits = 0;
+	size_t entries = 0;
+	size_t bytes = 0;
+};
+
+}
+
+#endif
@@ -33,8 +33,8 @@ static void ColouriseAsyDoc(Sci_PositionU startPos, Sci_Position length, int ini
 	WordList &keywords = *keywordlists[0];
 	WordList &keywords2 = *keywordlists[1];
 
-	CharacterSet setWordStart(CharacterSet::setAlpha, "_", 0x80, true);
-	CharacterSet setWord(CharacterSet::setAlphaNum, "._", 0x80, true);
+	static constexpr CharacterSet setWordStart(CharacterSet::setAlpha, "_", 0x80, true);
+	static constexpr CharacterSet setWord(CharacterSet::setAlphaNum, "._", 0x80, true);
 
 	int visibleChars = 0;
 
@@ -32,6 +32,7 @@
 #include "LexerModule.h"
 #include "OptionSet.h"
 #include "SubStyles.h"
+#include "Convergence.h"
 #include "DefaultLexer.h"
 
 using namespace Scintilla;
@@ -471,6 +472,14 @@ const LexicalClass lexicalClasses[] = {
 	13, "SCE_SH_HERE_Q", "here-doc literal string", "Heredoc quoted string",
 };
 
+// Lex backtracks to the start of a command so can only stop after a line that starts a command.
+class ConvergenceBash : public Convergence {
+public:
+	bool ConvergedAfter(IDocument *pAccess, Sci_Position line, Sci_Position) override {
+		return pAccess->GetLineState(line) == static_cast<int>(CmdState::Start);
+	}
+};
+
 }
 
 class LexerBash final : public DefaultLexer {
@@ -484,6 +493,7 @@ class LexerBash final : public DefaultLexer {
 	CharacterSet setParamStart;
 	enum { ssIdentifier, ssScalar };
 	SubStyles subStyles{styleSubable};
+	ConvergenceBash convergence;
 public:
 	LexerBash() :
 		DefaultLexer("bash", SCLEX_BASH, lexicalClasses, std::size(lexicalClasses)),
@@ -493,6 +503,7 @@ public:
 		bashStruct_in.Set("for case select");
 		testOperator.Set("eq ge gt le lt ne ef nt ot");
 		SetOptionSet(&osBash);
+		SetConvergence(&convergence);
 	}
 	void SCI_METHOD Release() override {
 		delete this;
@@ -572,17 +583,20 @@ Sci_Position SCI_METHOD LexerBash::WordListSet(int n, const char *wl) {
 }
 
 void SCI_METHOD LexerBash::Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) {
-	const CharacterSet setWordStart(CharacterSet::setAlpha, "_");
+	static constexpr CharacterSet setWordStart(CharacterSet::setAlpha, "_");
 	// note that [+-] are often parts of identifiers in shell scripts
-	const CharacterSet setWord(CharacterSet::setAlphaNum, "._+-");
-	CharacterSet setMetaCharacter(CharacterSet::setNone, "|&;()<> \t\r\n");
-	setMetaCharacter.Add(0);
-	const CharacterSet setBashOperator(CharacterSet::setNone, "^&%()-+=|{}[]:;>,*/<?!.~@");
-	const CharacterSet setSingleCharOp(CharacterSet::setNone, "rwxoRWXOezsfdlpSbctugkTBMACahGLNn");
-	const CharacterSet setParam(CharacterSet::setAlphaNum, "_");
-	const CharacterSet setHereDoc(CharacterSet::setAlpha, "_\\-+!%*,./:?@[]^`{}~");
-	const CharacterSet setHereDoc2(CharacterSet::setAlphaNum, "_-+!%*,./:=?@[]^`{}~");
-	const CharacterSet setLeftShift(CharacterSet::setDigits, "$");
+	static constexpr CharacterSet setWord(CharacterSet::setAlphaNum, "._+-");
+	static constexpr CharacterSet setMetaCharacter = [] {
+		CharacterSet setMeta(CharacterSet::setNone, "|&;()<> \t\r\n");
+		setMeta.Add(0);
+		return setMeta;
+	}();
+	static constexpr CharacterSet setBashOperator(CharacterSet::setNone, "^&%()-+=|{}[]:;>,*/<?!.~@");
+	static constexpr CharacterSet setSingleCharOp(CharacterSet::setNone, "rwxoRWXOezsfdlpSbctugkTBMACahGLNn");
+	static constexpr CharacterSet setParam(CharacterSet::setAlphaNum, "_");
+	static constexpr CharacterSet setHereDoc(CharacterSet::setAlpha, "_\\-+!%*,./:?@[]^`{}~");
+	static constexpr CharacterSet setHereDoc2(CharacterSet::setAlphaNum, "_-+!%*,./:=?@[]^`{}~");
+	static constexpr CharacterSet setLeftShift(CharacterSet::setDigits, "$");
 
 	class HereDocCls {	// Class to manage HERE document elements
 	public:
@@ -194,11 +194,8 @@ void ColouriseCOBOLDoc(Sci_PositionU startPos, Sci_Position length, int initStyl
                 ColourTo(styler, i, state);
                 state = SCE_COBOL_DEFAULT;
             }
-            styler.SetLineState(currentLine, nContainment);
-            currentLine++;
+            // Line state is set after a word ending the line has been classified
             bSetNewLine = true;
-            if (nContainment & NOT_HEADER)
-                nContainment &= ~(NOT_HEADER | IN_DECLARATIVES | IN_SECTION);
         }
 
         if (styler.IsLeadByte(ch)) {
@@ -310,6 +307,10 @@ void ColouriseCOBOLDoc(Sci_PositionU startPos, Sci_Position length, int initStyl
         bNewLine = bSetNewLine;
         if (bNewLine)
             {
+            styler.SetLineState(currentLine, nContainment);
+            currentLine++;
+            if (nContainment & NOT_HEADER)
+                nContainment &= ~(NOT_HEADER | IN_DECLARATIVES | IN_SECTION);
             bAarea = false;
             }
     }
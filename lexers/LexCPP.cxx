@@ -15,6 +15,7 @@
 #include <string_view>
 #include <vector>
 #include <map>
+#include <optional>
 #include <algorithm>
 #include <iterator>
 #include <functional>
@@ -22,6 +23,7 @@
 #include "ILexer.h"
 #include "Scintilla.h"
 #include "SciLexer.h"
+#include "LexillaExtensions.h"
 
 #include "StringCopy.h"
 #include "WordList.h"
@@ -32,7 +34,10 @@
 #include "LexerModule.h"
 #include "OptionSet.h"
 #include "SparseState.h"
+#include "MemoryUse.h"
 #include "SubStyles.h"
+#include "Convergence.h"
+#include "DefaultLexer.h"
 
 using namespace Scintilla;
 using namespace Lexilla;
@@ -166,9 +171,24 @@ void highlightTaskMarker(StyleContext &sc, LexAccessor &styler,
 	}
 }
 
-const CharacterSet setHexDigits(CharacterSet::setDigits, "ABCDEFabcdef");
-const CharacterSet setOctDigits("01234567");
-const CharacterSet setNoneNumeric;
+constexpr CharacterSet setHexDigits(CharacterSet::setDigits, "ABCDEFabcdef");
+constexpr CharacterSet setOctDigits("01234567");
+constexpr CharacterSet setNoneNumeric;
+
+// Sets that do not depend on options are built at compile time instead of in each Lex call
+constexpr CharacterSet setOKBeforeRE("([{=,:;!%^&*|?~+-> ");
+constexpr CharacterSet setCouldBePostOp("+-");
+constexpr CharacterSet setDoxygen(CharacterSet::setAlpha, "$@\\&<>#{}[]");
+constexpr CharacterSet setInvalidRawFirst(" )\\\t\v\f\n");
+
+// Characters that may have an effect in comments and strings, other characters are skipped
+// in bulk by ForwardUntilAny. Backslash may continue a line in any state. Strings stop at
+// spaces so the last character skipped is not a space and updates chPrevNonWhite.
+constexpr CharacterSet setStopComment("*\\");
+constexpr CharacterSet setStopCommentDoc("*\\@</");
+constexpr CharacterSet setStopCommentLine("\\");
+constexpr CharacterSet setStopCommentLineDoc("\\@</");
+constexpr CharacterSet setStopString("\"\\ \t\v\f");
 
 class EscapeSequence {
 	const CharacterSet *escapeSetValid = nullptr;
@@ -245,8 +265,16 @@ struct PPDefinition {
 	PPDefinition(Sci_Position line_, std::string_view key_, std::string_view value_, bool isUndef_, std::string_view arguments_) :
 		line(line_), key(key_), value(value_), isUndef(isUndef_), arguments(arguments_) {
 	}
+	// Same effect on the symbol table even if on a different line
+	[[nodiscard]] bool SameDefinition(const PPDefinition &other) const noexcept {
+		return (key == other.key) && (value == other.value) && (isUndef == other.isUndef) && (arguments == other.arguments);
+	}
 };
 
+size_t HeapBytes(const PPDefinition &definition) noexcept {
+	return Lexilla::HeapBytes(definition.key) + Lexilla::HeapBytes(definition.value) + Lexilla::HeapBytes(definition.arguments);
+}
+
 constexpr int inactiveFlag = 0x40;
 
 class LinePPState {
@@ -271,6 +299,9 @@ class LinePPState {
 	}
 public:
 	LinePPState() noexcept = default;
+	[[nodiscard]] bool operator==(const LinePPState &other) const noexcept {
+		return (state == other.state) && (ifTaken == other.ifTaken) && (level == other.level);
+	}
 	[[nodiscard]] bool ValidLevel() const noexcept {
 		return level >= 0 && level < maximumNestingLevel;
 	}
@@ -328,6 +359,16 @@ public:
 		vlls.resize(line+1);
 		vlls[line] = lls;
 	}
+	// Replace the states after line with those from saved that were lineDelta lines earlier.
+	void RestoreAfter(Sci_Position line, const PPStates &saved, Sci_Position lineDelta) {
+		vlls.resize(line+1);
+		for (Sci_Position lineSaved = line + 1 - lineDelta; lineSaved < static_cast<Sci_Position>(saved.vlls.size()); lineSaved++) {
+			vlls.push_back(saved.ForLine(lineSaved));
+		}
+	}
+	[[nodiscard]] size_t HeapBytes() const noexcept {
+		return Lexilla::HeapBytes(vlls);
+	}
 };
 
 enum class BackQuotedString : int {
@@ -342,6 +383,23 @@ struct InterpolatingState {
 	int braceCount;
 };
 
+using InterpolatingMap = std::map<Sci_Position, std::vector<InterpolatingState>>;
+
+// Are the interpolating states at the end of lineA in a and lineB in b the same?
+bool SameInterpolatingStates(const InterpolatingMap &a, Sci_Position lineA, const InterpolatingMap &b, Sci_Position lineB) {
+	const InterpolatingMap::const_iterator itA = a.find(lineA);
+	const InterpolatingMap::const_iterator itB = b.find(lineB);
+	const bool emptyA = (itA == a.end()) || itA->second.empty();
+	const bool emptyB = (itB == b.end()) || itB->second.empty();
+	if (emptyA || emptyB) {
+		return emptyA == emptyB;
+	}
+	return std::equal(itA->second.begin(), itA->second.end(), itB->second.begin(), itB->second.end(),
+		[](const InterpolatingState &x, const InterpolatingState &y) noexcept {
+			return (x.state == y.state) && (x.braceCount == y.braceCount);
+		});
+}
+
 struct Definition {
 	std::string_view name;
 	std::string_view value;
@@ -421,6 +479,18 @@ struct OptionsCPP {
 	bool foldAtElse = false;
 };
 
+// Characters that may start an identifier with the dollar and hash options
+CharacterSet WordStartSet(const OptionsCPP &options) {
+	CharacterSet setWordStart(CharacterSet::setAlpha, "_", true);
+	if (options.identifiersAllowDollars) {
+		setWordStart.Add('$');
+	}
+	if (options.identifiersAllowHashes) {
+		setWordStart.Add('#');
+	}
+	return setWordStart;
+}
+
 const char *const cppWordLists[] = {
             "Primary keywords and identifiers",
             "Secondary keywords and identifiers",
@@ -550,7 +620,7 @@ constexpr int sizeLexicalClasses = static_cast<int>(std::size(lexicalClasses));
 
 }
 
-class LexerCPP : public ILexer5 {
+class LexerCPP : public DefaultLexer, public Convergence {
 	bool caseSensitive;
 	CharacterSet setWord;
 	CharacterSet setNegationOp;
@@ -562,6 +632,12 @@ class LexerCPP : public ILexer5 {
 	PPStates vlls;
 	std::vector<PPDefinition> ppDefineHistory;
 	std::map<Sci_Position, std::vector<InterpolatingState>> interpolatingAtEol;
+	// State before privateCallLexConverging so it can be compared and restored
+	Sci_Position lineSaved = 0;
+	PPStates vllsSaved;
+	std::vector<PPDefinition> ppDefineHistorySaved;
+	InterpolatingMap interpolatingSaved;
+	SparseState<std::string> rawStringTerminatorsSaved;
 	WordList keywords;
 	WordList keywords2;
 	WordList keywords3;
@@ -594,13 +670,20 @@ class LexerCPP : public ILexer5 {
 	std::string returnBuffer;
 public:
 	explicit LexerCPP(bool caseSensitive_) :
+		DefaultLexer(caseSensitive_ ? "cpp" : "cppnocase", caseSensitive_ ? SCLEX_CPP : SCLEX_CPPNOCASE,
+			lexicalClasses, std::size(lexicalClasses)),
 		caseSensitive(caseSensitive_),
 		setWord(CharacterSet::setAlphaNum, "._", true),
 		setNegationOp("!"),
 		setAddOp("+-"),
 		setMultOp("*/%"),
 		setRelOp("=!<>"),
-		setLogicalOp("|&") {
+		setLogicalOp("|&"),
+		// Default options allow dollars but not hashes
+		setWordStart(CharacterSet::setAlpha, "_$", true) {
+		SetConvergence(this);
+		SetCanFoldDuringLex();
+		SetCanLexBudgeted();
 	}
 	// Deleted so LexerCPP objects can not be copied.
 	LexerCPP(const LexerCPP &) = delete;
@@ -631,9 +714,12 @@ public:
 	void SCI_METHOD Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) override;
 	void SCI_METHOD Fold(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) override;
 
-	void *SCI_METHOD PrivateCall(int, void *) noexcept override {
-		return nullptr;
-	}
+	bool ReportMemory(LexerMemoryUse &use) const override;
+
+	// Convergence
+	void SaveLexerState(Sci_Position line) override;
+	bool ConvergedAfter(IDocument *pAccess, Sci_Position line, Sci_Position lineDelta) override;
+	void RestoreLexerState(Sci_Position line, Sci_Position lineDelta) override;
 
 	int SCI_METHOD LineEndTypesSupported() noexcept override {
 		return SC_LINE_END_TYPE_UNICODE;
@@ -723,12 +809,6 @@ public:
 	}
 
 	// ILexer5 methods
-	const char *SCI_METHOD GetName() override {
-		return caseSensitive ? "cpp" : "cppnocase";
-	}
-	int SCI_METHOD  GetIdentifier() override {
-		return caseSensitive ? SCLEX_CPP : SCLEX_CPPNOCASE;
-	}
 	const char *SCI_METHOD PropertyGet(const char *key) override;
 
 	static ILexer5 *LexerFactoryCPP() {
@@ -756,6 +836,7 @@ Sci_Position SCI_METHOD LexerCPP::PropertySet(const char *key, const char *val)
 			if (options.identifiersAllowHashes) {
 				setWord.Add('#');
 			}
+			setWordStart = WordStartSet(options);
 		}
 		return 0;
 	}
@@ -807,26 +888,155 @@ Sci_Position SCI_METHOD LexerCPP::WordListSet(int n, const char *wl) {
 	return firstModification;
 }
 
-void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) {
-	LexAccessor styler(pAccess);
+bool LexerCPP::ReportMemory(LexerMemoryUse &use) const {
+	use.total = sizeof(*this);
+	use.Add("vlls", vlls.HeapBytes());
+	use.Add("ppDefineHistory", HeapBytes(ppDefineHistory));
+	use.Add("interpolatingAtEol", HeapBytes(interpolatingAtEol));
+	use.Add("rawStringTerminators", HeapBytes(rawStringTerminators));
+	size_t bytesDefinitions = preprocessorDefinitionsStart.size() * (mapNodeOverhead + sizeof(SymbolTable::value_type));
+	for (const auto &[name, symbol] : preprocessorDefinitionsStart) {
+		bytesDefinitions += HeapBytes(name) + HeapBytes(symbol.value) + HeapBytes(symbol.arguments);
+	}
+	use.Add("preprocessorDefinitionsStart", bytesDefinitions);
+	use.Add("saved", vllsSaved.HeapBytes() + HeapBytes(ppDefineHistorySaved) +
+		HeapBytes(interpolatingSaved) + HeapBytes(rawStringTerminatorsSaved));
+	return true;
+}
 
-	const StyleContext::Transform transform = caseSensitive ?
-		StyleContext::Transform::none : StyleContext::Transform::lower;
+void LexerCPP::SaveLexerState(Sci_Position line) {
+	lineSaved = line;
+	vllsSaved = vlls;
+	ppDefineHistorySaved.clear();
+	std::copy_if(ppDefineHistory.begin(), ppDefineHistory.end(), std::back_inserter(ppDefineHistorySaved),
+		[line](const PPDefinition &p) noexcept { return p.line >= line; });
+	interpolatingSaved.clear();
+	interpolatingSaved.insert(interpolatingAtEol.lower_bound(line), interpolatingAtEol.end());
+	rawStringTerminatorsSaved = rawStringTerminators;
+}
 
-	const CharacterSet setOKBeforeRE("([{=,:;!%^&*|?~+-> ");
-	const CharacterSet setCouldBePostOp("+-");
+bool LexerCPP::ConvergedAfter(IDocument *, Sci_Position line, Sci_Position lineDelta) {
+	const Sci_Position lineBefore = line - lineDelta;
+	if (!(vlls.ForLine(line + 1) == vllsSaved.ForLine(lineBefore + 1)) ||
+		(rawStringTerminators.ValueAt(line) != rawStringTerminatorsSaved.ValueAt(lineBefore)) ||
+		!SameInterpolatingStates(interpolatingAtEol, line, interpolatingSaved, lineBefore)) {
+		return false;
+	}
+	// Definitions since lexing started must have the same effect
+	std::vector<const PPDefinition *> definitions;
+	for (const PPDefinition &ppDef : ppDefineHistory) {
+		if ((ppDef.line >= lineSaved) && (ppDef.line <= line)) {
+			definitions.push_back(&ppDef);
+		}
+	}
+	std::vector<const PPDefinition *> definitionsBefore;
+	for (const PPDefinition &ppDef : ppDefineHistorySaved) {
+		if (ppDef.line <= lineBefore) {
+			definitionsBefore.push_back(&ppDef);
+		}
+	}
+	return std::equal(definitions.begin(), definitions.end(), definitionsBefore.begin(), definitionsBefore.end(),
+		[](const PPDefinition *a, const PPDefinition *b) noexcept {
+			return a->SameDefinition(*b);
+		});
+}
 
-	const CharacterSet setDoxygen(CharacterSet::setAlpha, "$@\\&<>#{}[]");
+void LexerCPP::RestoreLexerState(Sci_Position line, Sci_Position lineDelta) {
+	const Sci_Position lineBefore = line - lineDelta;
+	vlls.RestoreAfter(line, vllsSaved, lineDelta);
+	ppDefineHistory.erase(std::find_if(ppDefineHistory.begin(), ppDefineHistory.end(),
+		[line](const PPDefinition &p) noexcept { return p.line > line; }), ppDefineHistory.end());
+	for (const PPDefinition &ppDef : ppDefineHistorySaved) {
+		if (ppDef.line > lineBefore) {
+			ppDefineHistory.push_back(ppDef);
+			ppDefineHistory.back().line += lineDelta;
+		}
+	}
+	interpolatingAtEol.erase(interpolatingAtEol.upper_bound(line), interpolatingAtEol.end());
+	for (InterpolatingMap::const_iterator it = interpolatingSaved.upper_bound(lineBefore); it != interpolatingSaved.end(); ++it) {
+		interpolatingAtEol.emplace(it->first + lineDelta, it->second);
+	}
+	rawStringTerminators.Splice(rawStringTerminatorsSaved, line, lineDelta);
+	vllsSaved = PPStates();
+	ppDefineHistorySaved.clear();
+	interpolatingSaved.clear();
+}
 
-	setWordStart = CharacterSet(CharacterSet::setAlpha, "_", true);
+// Store both the current line's fold level and the next lines in the
+// level store to make it easy to pick up with each increment
+// and to make it possible to fiddle the current level for "} else {".
+// Sets fold levels from the styles of each character in turn. Used by Fold and also by Lex in
+// FoldDuringLex mode where the styles are received as they are set.
+// The style of the following character is needed so each character is folded when the next
+// character's style is known.
+class FolderCPP : public StyleListener {
+	LexAccessor &styler;
+	const OptionsCPP &options;
+	const Sci_PositionU endPos;
+	const bool userDefinedFoldMarkers;
+	int visibleChars = 0;
+	bool inLineComment = false;
+	Sci_Position lineCurrent;
+	int levelCurrent = SC_FOLDLEVELBASE;
+	Sci_PositionU lineStartNext;
+	int levelMinCurrent = SC_FOLDLEVELBASE;
+	int levelNext = SC_FOLDLEVELBASE;
+	int stylePrev;
+	Sci_Position positionWaiting = -1;
+	int styleWaiting = 0;
+
+	void Fold(Sci_PositionU i, int style, int styleNext);
+public:
+	FolderCPP(LexAccessor &styler_, const OptionsCPP &options_, Sci_PositionU startPos, Sci_Position length, int initStyle) :
+		styler(styler_),
+		options(options_),
+		endPos(startPos + length),
+		userDefinedFoldMarkers(!options.foldExplicitStart.empty() && !options.foldExplicitEnd.empty()),
+		lineCurrent(styler.GetLine(startPos)),
+		lineStartNext(styler.LineStart(lineCurrent + 1)),
+		stylePrev(LexerCPP::MaskActive(initStyle)) {
+		if (lineCurrent > 0)
+			levelCurrent = FoldLevelStart(styler.LevelAt(lineCurrent-1));
+		levelMinCurrent = levelCurrent;
+		levelNext = levelCurrent;
+	}
+	void Character(Sci_PositionU position, int style) {
+		if (positionWaiting >= 0) {
+			Fold(positionWaiting, styleWaiting, LexerCPP::MaskActive(style));
+		}
+		positionWaiting = position;
+		styleWaiting = LexerCPP::MaskActive(style);
+	}
+	void Styled(Sci_PositionU start, Sci_PositionU end, int style) override {
+		for (Sci_PositionU position = start; position < end; position++) {
+			Character(position, style);
+		}
+	}
+	void Complete() {
+		if (positionWaiting >= 0) {
+			// The style after the range is read from the document as it was not set by this Lex
+			Fold(positionWaiting, styleWaiting, LexerCPP::MaskActive(styler.StyleIndexAt(endPos)));
+			positionWaiting = -1;
+		}
+	}
+};
 
-	const CharacterSet setInvalidRawFirst(" )\\\t\v\f\n");
+void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) {
+	LexAccessor styler(pAccess);
 
-	if (options.identifiersAllowDollars) {
-		setWordStart.Add('$');
+	ForgetFolded();
+	std::optional<FolderCPP> folder;
+	if (options.fold && FoldDuringLex()) {
+		folder.emplace(styler, options, startPos, length, initStyle);
+		styler.SetStyleListener(&*folder);
 	}
-	if (options.identifiersAllowHashes) {
-		setWordStart.Add('#');
+
+	const StyleContext::Transform transform = caseSensitive ?
+		StyleContext::Transform::none : StyleContext::Transform::lower;
+
+	if (styler.ReferencePath()) {
+		// Rebuilt from the options as on each call before PropertySet kept it current
+		setWordStart = WordStartSet(options);
 	}
 
 	int chPrevNonWhite = ' ';
@@ -861,8 +1071,10 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 		// Set continuationLine if last character of previous line is '\'
 		if (lineCurrent > 0) {
 			const Sci_Position endLinePrevious = styler.LineEnd(lineCurrent - 1);
-			if (endLinePrevious > 0) {
-				continuationLine = styler.SafeGetCharAt(endLinePrevious-1) == '\\';
+			if ((endLinePrevious > 0) && (styler.SafeGetCharAt(endLinePrevious-1) == '\\')) {
+				// In DBCS the '\' may be the trail byte of a character
+				continuationLine = (styler.Encoding() != EncodingType::dbcs) ||
+					(styler.MultiByteAccess()->GetRelativePosition(endLinePrevious, -1) == endLinePrevious - 1);
 			}
 		}
 	}
@@ -906,8 +1118,6 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 	std::string rawStringTerminator = rawStringTerminators.ValueAt(lineCurrent-1);
 	SparseState<std::string> rawSTNew(lineCurrent);
 
-	std::string currentText;
-
 	int activitySet = preproc.ActiveState();
 
 	const WordClassifier &classifierIdentifiers = subStyles.Classifier(SCE_C_IDENTIFIER);
@@ -1001,7 +1211,7 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 				break;
 			case SCE_C_IDENTIFIER:
 				if (sc.atLineStart || sc.atLineEnd || !setWord.Contains(sc.ch) || (sc.ch == '.')) {
-					sc.GetCurrentString(currentText, transform);
+					const std::string_view currentText = sc.GetCurrentView(transform);
 					if (keywords.InList(currentText)) {
 						lastWordWasUUID = currentText == "uuid";
 						sc.ChangeState(SCE_C_WORD|activitySet);
@@ -1086,6 +1296,9 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 				} else {
 					styleBeforeTaskMarker = SCE_C_COMMENT;
 					highlightTaskMarker(sc, styler, activitySet, markerList, caseSensitive);
+					if (!markerList.Length()) {
+						sc.ForwardUntilAny(setStopComment);
+					}
 				}
 				break;
 			case SCE_C_COMMENTDOC:
@@ -1102,6 +1315,8 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 							|| (sc.ch == '/' && sc.chPrev == '<')) { // XML comment style
 					styleBeforeDCKeyword = SCE_C_COMMENTDOC;
 					sc.ForwardSetState(SCE_C_COMMENTDOCKEYWORD | activitySet);
+				} else {
+					sc.ForwardUntilAny(setStopCommentDoc);
 				}
 				break;
 			case SCE_C_COMMENTLINE:
@@ -1110,6 +1325,9 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 				} else {
 					styleBeforeTaskMarker = SCE_C_COMMENTLINE;
 					highlightTaskMarker(sc, styler, activitySet, markerList, caseSensitive);
+					if (!markerList.Length()) {
+						sc.ForwardUntilAny(setStopCommentLine);
+					}
 				}
 				break;
 			case SCE_C_COMMENTLINEDOC:
@@ -1125,6 +1343,8 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 							|| (sc.ch == '/' && sc.chPrev == '<')) { // XML comment style
 					styleBeforeDCKeyword = SCE_C_COMMENTLINEDOC;
 					sc.ForwardSetState(SCE_C_COMMENTDOCKEYWORD | activitySet);
+				} else {
+					sc.ForwardUntilAny(setStopCommentLineDoc);
 				}
 				break;
 			case SCE_C_COMMENTDOCKEYWORD:
@@ -1140,9 +1360,9 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 					if (!(IsASpace(sc.ch) || (sc.ch == 0))) {
 						sc.ChangeState(SCE_C_COMMENTDOCKEYWORDERROR|activitySet);
 					} else {
-						sc.GetCurrentString(currentText, transform);
+						const std::string_view currentText = sc.GetCurrentView(transform);
 						assert(!currentText.empty());
-						const std::string currentSuffix = currentText.substr(1);
+						const std::string_view currentSuffix = currentText.substr(1);
 						if (!keywords3.InList(currentSuffix) && !keywords3.InList(currentText)) {
 							const int subStyleCDKW = classifierDocKeyWords.ValueFor(currentSuffix);
 							if (subStyleCDKW >= 0) {
@@ -1155,7 +1375,7 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 					sc.SetState(styleBeforeDCKeyword|activitySet);
 					seenDocKeyBrace = false;
 				} else if (sc.ch == '>') {
-					sc.GetCurrentString(currentText, transform);
+					const std::string_view currentText = sc.GetCurrentView(transform);
 					if (!keywords3.InList(currentText)) {
 						const int subStyleCDKW = classifierDocKeyWords.ValueFor(currentText.substr(1));
 						if (subStyleCDKW >= 0) {
@@ -1188,6 +1408,8 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 					} else {
 						sc.ForwardSetState(SCE_C_DEFAULT|activitySet);
 					}
+				} else {
+					sc.ForwardUntilAny(setStopString);
 				}
 				break;
 			case SCE_C_ESCAPESEQUENCE:
@@ -1509,134 +1731,128 @@ void SCI_METHOD LexerCPP::Lex(Sci_PositionU startPos, Sci_Position length, int i
 	if (definitionsChanged || rawStringsChanged)
 		styler.ChangeLexerState(startPos, startPos + length);
 	sc.Complete();
-}
 
-// Store both the current line's fold level and the next lines in the
-// level store to make it easy to pick up with each increment
-// and to make it possible to fiddle the current level for "} else {".
-
-void SCI_METHOD LexerCPP::Fold(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) {
-
-	if (!options.fold)
-		return;
-
-	LexAccessor styler(pAccess);
+	if (folder) {
+		folder->Complete();
+		FoldedDuringLex(startPos, length, pAccess);
+	}
+}
 
-	const Sci_PositionU endPos = startPos + length;
-	int visibleChars = 0;
-	bool inLineComment = false;
-	Sci_Position lineCurrent = styler.GetLine(startPos);
-	int levelCurrent = SC_FOLDLEVELBASE;
-	if (lineCurrent > 0)
-		levelCurrent = FoldLevelStart(styler.LevelAt(lineCurrent-1));
-	Sci_PositionU lineStartNext = styler.LineStart(lineCurrent+1);
-	int levelMinCurrent = levelCurrent;
-	int levelNext = levelCurrent;
-	char chNext = styler[startPos];
-	int styleNext = MaskActive(styler.StyleAt(startPos));
-	int style = MaskActive(initStyle);
-	const bool userDefinedFoldMarkers = !options.foldExplicitStart.empty() && !options.foldExplicitEnd.empty();
-	for (Sci_PositionU i = startPos; i < endPos; i++) {
-		const char ch = chNext;
-		chNext = styler.SafeGetCharAt(i + 1);
-		const int stylePrev = style;
-		style = styleNext;
-		styleNext = MaskActive(styler.StyleAt(i + 1));
-		const bool atEOL = i == (lineStartNext-1);
-		if ((style == SCE_C_COMMENTLINE) || (style == SCE_C_COMMENTLINEDOC))
-			inLineComment = true;
-		if (options.foldComment && options.foldCommentMultiline && IsStreamCommentStyle(style) && !inLineComment) {
-			if (!IsStreamCommentStyle(stylePrev)) {
+void FolderCPP::Fold(Sci_PositionU i, int style, int styleNext) {
+	const char ch = styler.SafeGetCharAt(i);
+	const char chNext = styler.SafeGetCharAt(i + 1);
+	const bool atEOL = i == (lineStartNext-1);
+	if ((style == SCE_C_COMMENTLINE) || (style == SCE_C_COMMENTLINEDOC))
+		inLineComment = true;
+	if (options.foldComment && options.foldCommentMultiline && IsStreamCommentStyle(style) && !inLineComment) {
+		if (!IsStreamCommentStyle(stylePrev)) {
+			levelNext++;
+		} else if (!IsStreamCommentStyle(styleNext) && !atEOL) {
+			// Comments don't end at end of line and the next character may be unstyled.
+			levelNext--;
+		}
+	}
+	if (options.foldComment && options.foldCommentExplicit && ((style == SCE_C_COMMENTLINE) || options.foldExplicitAnywhere)) {
+		if (userDefinedFoldMarkers) {
+			if (styler.Match(i, std::string_view(options.foldExplicitStart))) {
 				levelNext++;
-			} else if (!IsStreamCommentStyle(styleNext) && !atEOL) {
-				// Comments don't end at end of line and the next character may be unstyled.
+			} else if (styler.Match(i, std::string_view(options.foldExplicitEnd))) {
 				levelNext--;
 			}
-		}
-		if (options.foldComment && options.foldCommentExplicit && ((style == SCE_C_COMMENTLINE) || options.foldExplicitAnywhere)) {
-			if (userDefinedFoldMarkers) {
-				if (styler.Match(i, std::string_view(options.foldExplicitStart))) {
+		} else {
+			if ((ch == '/') && (chNext == '/')) {
+				const char chNext2 = styler.SafeGetCharAt(i + 2);
+				if (chNext2 == '{') {
 					levelNext++;
-				} else if (styler.Match(i, std::string_view(options.foldExplicitEnd))) {
+				} else if (chNext2 == '}') {
 					levelNext--;
 				}
-			} else {
-				if ((ch == '/') && (chNext == '/')) {
-					const char chNext2 = styler.SafeGetCharAt(i + 2);
-					if (chNext2 == '{') {
+			}
+		}
+	}
+	if (options.foldPreprocessor && (style == SCE_C_PREPROCESSOR)) {
+		if (ch == '#') {
+			Sci_PositionU j = i + 1;
+			while ((j < endPos) && IsASpaceOrTab(styler.SafeGetCharAt(j))) {
+				j++;
+			}
+			if (styler.Match(j, "region") || styler.Match(j, "if")) {
+				levelNext++;
+			} else if (styler.Match(j, "end")) {
+				levelNext--;
+			} else if (styler.Match(j, "pragma")) {
+				constexpr size_t lenPragma = 6;
+				j += lenPragma;
+				if (IsASpaceOrTab(styler.SafeGetCharAt(j))) {
+					while ((j < endPos) && IsASpaceOrTab(styler.SafeGetCharAt(j))) {
+						j++;
+					}
+					if (styler.Match(j, "region")) {
 						levelNext++;
-					} else if (chNext2 == '}') {
+					} else if (styler.Match(j, "endregion")) {
 						levelNext--;
 					}
 				}
 			}
-		}
-		if (options.foldPreprocessor && (style == SCE_C_PREPROCESSOR)) {
-			if (ch == '#') {
-				Sci_PositionU j = i + 1;
-				while ((j < endPos) && IsASpaceOrTab(styler.SafeGetCharAt(j))) {
-					j++;
-				}
-				if (styler.Match(j, "region") || styler.Match(j, "if")) {
-					levelNext++;
-				} else if (styler.Match(j, "end")) {
-					levelNext--;
-				} else if (styler.Match(j, "pragma")) {
-					constexpr size_t lenPragma = 6;
-					j += lenPragma;
-					if (IsASpaceOrTab(styler.SafeGetCharAt(j))) {
-						while ((j < endPos) && IsASpaceOrTab(styler.SafeGetCharAt(j))) {
-							j++;
-						}
-						if (styler.Match(j, "region")) {
-							levelNext++;
-						} else if (styler.Match(j, "endregion")) {
-							levelNext--;
-						}
-					}
-				}
 
-				if (options.foldPreprocessorAtElse && (styler.Match(j, "else") || styler.Match(j, "elif"))) {
-					levelMinCurrent--;
-				}
+			if (options.foldPreprocessorAtElse && (styler.Match(j, "else") || styler.Match(j, "elif"))) {
+				levelMinCurrent--;
 			}
 		}
-		if (options.foldSyntaxBased && (style == SCE_C_OPERATOR)) {
-			if (ch == '{' || ch == '[' || ch == '(') {
-				// Measure the minimum before a '{' to allow
-				// folding on "} else {"
-				if (options.foldAtElse && levelMinCurrent > levelNext) {
-					levelMinCurrent = levelNext;
-				}
-				levelNext++;
-			} else if (ch == '}' || ch == ']' || ch == ')') {
-				levelNext--;
+	}
+	if (options.foldSyntaxBased && (style == SCE_C_OPERATOR)) {
+		if (ch == '{' || ch == '[' || ch == '(') {
+			// Measure the minimum before a '{' to allow
+			// folding on "} else {"
+			if (options.foldAtElse && levelMinCurrent > levelNext) {
+				levelMinCurrent = levelNext;
 			}
+			levelNext++;
+		} else if (ch == '}' || ch == ']' || ch == ')') {
+			levelNext--;
 		}
-		if (!IsASpace(ch))
-			visibleChars++;
-		if (atEOL || (i == endPos-1)) {
-			int levelUse = levelCurrent;
-			if ((options.foldSyntaxBased && options.foldAtElse) ||
-				(options.foldPreprocessor && options.foldPreprocessorAtElse)
-			) {
-				levelUse = levelMinCurrent;
-			}
-			const int lev = FoldLevelForCurrentNext(levelUse, levelNext) |
-				FoldLevelFlags(levelUse, levelNext, visibleChars == 0 && options.foldCompact);
-			styler.SetLevelIfDifferent(lineCurrent, lev);
-			lineCurrent++;
-			lineStartNext = styler.LineStart(lineCurrent+1);
-			levelCurrent = levelNext;
-			levelMinCurrent = levelCurrent;
-			if (atEOL && (i == static_cast<Sci_PositionU>(styler.Length()-1))) {
-				// There is an empty line at end of file so give it same level and empty
-				styler.SetLevel(lineCurrent, FoldLevelForCurrent(levelCurrent) | SC_FOLDLEVELWHITEFLAG);
-			}
-			visibleChars = 0;
-			inLineComment = false;
+	}
+	if (!IsASpace(ch))
+		visibleChars++;
+	if (atEOL || (i == endPos-1)) {
+		int levelUse = levelCurrent;
+		if ((options.foldSyntaxBased && options.foldAtElse) ||
+			(options.foldPreprocessor && options.foldPreprocessorAtElse)
+		) {
+			levelUse = levelMinCurrent;
 		}
+		const int lev = FoldLevelForCurrentNext(levelUse, levelNext) |
+			FoldLevelFlags(levelUse, levelNext, visibleChars == 0 && options.foldCompact);
+		styler.SetLevelIfDifferent(lineCurrent, lev);
+		lineCurrent++;
+		lineStartNext = styler.LineStart(lineCurrent+1);
+		levelCurrent = levelNext;
+		levelMinCurrent = levelCurrent;
+		if (atEOL && (i == static_cast<Sci_PositionU>(styler.Length()-1))) {
+			// There is an empty line at end of file so give it same level and empty
+			styler.SetLevel(lineCurrent, FoldLevelForCurrent(levelCurrent) | SC_FOLDLEVELWHITEFLAG);
+		}
+		visibleChars = 0;
+		inLineComment = false;
+	}
+	stylePrev = style;
+}
+
+void SCI_METHOD LexerCPP::Fold(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) {
+
+	if (!options.fold)
+		return;
+
+	if (AlreadyFolded(startPos, length, pAccess))
+		return;
+
+	LexAccessor styler(pAccess);
+	FolderCPP folder(styler, options, startPos, length, initStyle);
+	const Sci_PositionU endPos = startPos + length;
+	for (Sci_PositionU i = startPos; i < endPos; i++) {
+		folder.Character(i, styler.StyleIndexAt(i));
 	}
+	folder.Complete();
 }
 
 void LexerCPP::EvaluateTokens(Tokens &tokens, const SymbolTable &preprocessorDefinitions) {
@@ -28,6 +28,7 @@
 #include "Scintilla.h"
 #include "SciLexer.h"
 
+#include "PropSetSimple.h"
 #include "WordList.h"
 #include "LexAccessor.h"
 #include "Accessor.h"
@@ -39,6 +40,12 @@ using namespace Lexilla;
 
 namespace {
 
+const PropertyKey propCssScssLanguage("lexer.css.scss.language");
+const PropertyKey propCssLessLanguage("lexer.css.less.language");
+const PropertyKey propCssHssLanguage("lexer.css.hss.language");
+const PropertyKey propFoldComment("fold.comment");
+const PropertyKey propFoldCompact("fold.compact");
+
 inline bool IsAWordChar(const unsigned int ch) {
 	/* FIXME:
 	 * The CSS spec allows "ISO 10646 characters U+00A1 and higher" to be treated as word chars.
@@ -60,20 +67,38 @@ inline bool IsCssOperator(const int ch) {
 	return false;
 }
 
-// look behind (from start of document to our start position) to determine current nesting level
-inline int NestingLevelLookBehind(Sci_PositionU startPos, Accessor &styler) {
-	int ch;
-	int nestingLevel = 0;
-
-	for (Sci_PositionU i = 0; i < startPos; i++) {
-		ch = styler.SafeGetCharAt(i);
+int BraceBalance(Sci_PositionU startPos, Sci_PositionU endPos, Accessor &styler) {
+	int balance = 0;
+	for (Sci_PositionU i = startPos; i < endPos; i++) {
+		const char ch = styler[i];
 		if (ch == '{')
-			nestingLevel++;
+			balance++;
 		else if (ch == '}')
-			nestingLevel--;
+			balance--;
 	}
+	return balance;
+}
 
-	return nestingLevel;
+// look behind to determine current nesting level: the count of braces from the start of the
+// document to the end of each line lexed is kept as its line state so only the start of the
+// current line is counted
+inline int NestingLevelLookBehind(Sci_PositionU startPos, Accessor &styler) {
+	const Sci_Position line = styler.GetLine(startPos);
+	const int nestingLevel = (line > 0) ? styler.GetLineState(line - 1) : 0;
+	return nestingLevel + BraceBalance(styler.LineStart(line), startPos, styler);
+}
+
+// store the count of braces at the end of each line completed in [startPos, endPos)
+void StoreNestingLevels(Sci_PositionU startPos, Sci_PositionU endPos, int nestingLevel, Accessor &styler) {
+	Sci_Position line = styler.GetLine(startPos);
+	Sci_PositionU lineEnd = styler.LineStart(line + 1);
+	while (lineEnd <= endPos && startPos < endPos) {
+		nestingLevel += BraceBalance(startPos, lineEnd, styler);
+		styler.SetLineState(line, nestingLevel);
+		startPos = lineEnd;
+		line++;
+		lineEnd = styler.LineStart(line + 1);
+	}
 }
 
 void ColouriseCssDoc(Sci_PositionU startPos, Sci_Position length, int initStyle, WordList *keywordlists[], Accessor &styler) {
@@ -99,15 +124,15 @@ void ColouriseCssDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
 
 	// property lexer.css.scss.language
 	//	Set to 1 for Sassy CSS (.scss)
-	bool isScssDocument = styler.GetPropertyInt("lexer.css.scss.language") != 0;
+	bool isScssDocument = styler.GetPropertyInt(propCssScssLanguage) != 0;
 
 	// property lexer.css.less.language
 	// Set to 1 for Less CSS (.less)
-	bool isLessDocument = styler.GetPropertyInt("lexer.css.less.language") != 0;
+	bool isLessDocument = styler.GetPropertyInt(propCssLessLanguage) != 0;
 
 	// property lexer.css.hss.language
 	// Set to 1 for HSS (.hss)
-	bool isHssDocument = styler.GetPropertyInt("lexer.css.hss.language") != 0;
+	bool isHssDocument = styler.GetPropertyInt(propCssHssLanguage) != 0;
 
 	// SCSS/LESS/HSS have the concept of variable
 	bool hasVariables = isScssDocument || isLessDocument || isHssDocument;
@@ -127,6 +152,7 @@ void ColouriseCssDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
 		hasNesting = true;
 		nestingLevel = NestingLevelLookBehind(startPos, styler);
 	}
+	const int nestingLevelStart = nestingLevel;
 
 	// "the loop"
 	for (; sc.More(); sc.Forward()) {
@@ -504,11 +530,15 @@ void ColouriseCssDoc(Sci_PositionU startPos, Sci_Position length, int initStyle,
 	}
 
 	sc.Complete();
+
+	if (hasNesting) {
+		StoreNestingLevels(startPos, startPos + length, nestingLevelStart, styler);
+	}
 }
 
 void FoldCSSDoc(Sci_PositionU startPos, Sci_Position length, int, WordList *[], Accessor &styler) {
-	bool foldComment = styler.GetPropertyInt("fold.comment") != 0;
-	bool foldCompact = styler.GetPropertyInt("fold.compact", 1) != 0;
+	bool foldComment = styler.GetPropertyInt(propFoldComment) != 0;
+	bool foldCompact = styler.GetPropertyInt(propFoldCompact, 1) != 0;
 	Sci_PositionU endPos = startPos + length;
 	int visibleChars = 0;
 	Sci_Position lineCurrent = styler.GetLine(startPos);
@@ -197,9 +197,9 @@ void SCI_METHOD LexerDMIS::Lex(Sci_PositionU startPos, Sci_Position lengthDoc, i
 
 	LexAccessor styler(pAccess);
 	StyleContext scCTX(startPos, lengthDoc, initStyle, styler);
-	CharacterSet setDMISNumber(CharacterSet::setDigits, ".-+eE");
-	CharacterSet setDMISWordStart(CharacterSet::setAlpha, "-234", 0x80, true);
-	CharacterSet setDMISWord(CharacterSet::setAlpha);
+	static constexpr CharacterSet setDMISNumber(CharacterSet::setDigits, ".-+eE");
+	static constexpr CharacterSet setDMISWordStart(CharacterSet::setAlpha, "-234", 0x80, true);
+	static constexpr CharacterSet setDMISWord(CharacterSet::setAlpha);
 
 
 	bool isIFLine = false;
@@ -305,7 +305,7 @@ void SCI_METHOD LexerDMIS::Fold(Sci_PositionU startPos, Sci_Position lengthDoc,
 	int levelCurrent = levelPrev;
 	int strPos = 0;
 	bool foldWordPossible = false;
-	CharacterSet setDMISFoldWord(CharacterSet::setAlpha);
+	static constexpr CharacterSet setDMISFoldWord(CharacterSet::setAlpha);
 	char *tmpStr;
 
 
@@ -61,6 +61,7 @@ The list of keywords that can be used in dataflex.properties file (up to DataFle
 #include "Scintilla.h"
 #include "SciLexer.h"
 
+#include "PropSetSimple.h"
 #include "WordList.h"
 #include "LexAccessor.h"
 #include "Accessor.h"
@@ -70,6 +71,11 @@ The list of keywords that can be used in dataflex.properties file (up to DataFle
 
 using namespace Lexilla;
 
+static const PropertyKey propFoldDataflexCompilerList("fold.dataflex.compilerlist");
+static const PropertyKey propFoldComment("fold.comment");
+static const PropertyKey propFoldPreprocessor("fold.preprocessor");
+static const PropertyKey propFoldCompact("fold.compact");
+
 
 static void GetRangeLowered(Sci_PositionU start,
 		Sci_PositionU end,
@@ -85,7 +91,7 @@ static void GetRangeLowered(Sci_PositionU start,
 }
 
 static void GetForwardRangeLowered(Sci_PositionU start,
-		CharacterSet &charSet,
+		const CharacterSet &charSet,
 		Accessor &styler,
 		char *s,
 		Sci_PositionU len) {
@@ -194,11 +200,11 @@ static void ColouriseDataFlexDoc(Sci_PositionU startPos, Sci_Position length, in
 		Accessor &styler) {
 //	bool bSmartHighlighting = styler.GetPropertyInt("lexer.dataflex.smart.highlighting", 1) != 0;
 
-			CharacterSet setWordStart(CharacterSet::setAlpha, "_$#@", 0x80, true);
-			CharacterSet setWord(CharacterSet::setAlphaNum, "_$#@", 0x80, true);
-	CharacterSet setNumber(CharacterSet::setDigits, ".-+eE");
-	CharacterSet setHexNumber(CharacterSet::setDigits, "abcdefABCDEF");
-	CharacterSet setOperator(CharacterSet::setNone, "*+-/<=>^");
+			static constexpr CharacterSet setWordStart(CharacterSet::setAlpha, "_$#@", 0x80, true);
+			static constexpr CharacterSet setWord(CharacterSet::setAlphaNum, "_$#@", 0x80, true);
+	static constexpr CharacterSet setNumber(CharacterSet::setDigits, ".-+eE");
+	static constexpr CharacterSet setHexNumber(CharacterSet::setDigits, "abcdefABCDEF");
+	static constexpr CharacterSet setOperator(CharacterSet::setNone, "*+-/<=>^");
 
 	Sci_Position curLine = styler.GetLine(startPos);
 	int curLineState = curLine > 0 ? styler.GetLineState(curLine - 1) : 0;
@@ -379,7 +385,7 @@ static void SetFoldInPreprocessorLevelFlag(int &lineFoldStateCurrent, unsigned i
 
 static int ClassifyDataFlexPreprocessorFoldPoint(int &levelCurrent, int &lineFoldStateCurrent,
 		Sci_PositionU startPos, Accessor &styler) {
-	CharacterSet setWord(CharacterSet::setAlpha);
+	static constexpr CharacterSet setWord(CharacterSet::setAlpha);
 
 	char s[100];	// Size of the longest possible keyword + one additional character + null
 	GetForwardRangeLowered(startPos, setWord, styler, s, sizeof(s));
@@ -420,7 +426,7 @@ static void ClassifyDataFlexWordFoldPoint(int &levelCurrent, int &lineFoldStateC
 
 	// property fold.dataflex.compilerlist
 	//	Set to 1 for enabling the code folding feature in *.prn files
-	bool foldPRN = styler.GetPropertyInt("fold.dataflex.compilerlist",0) != 0;
+	bool foldPRN = styler.GetPropertyInt(propFoldDataflexCompilerList,0) != 0;
 
 	GetRangeLowered(lastStart, currentPos, styler, s, sizeof(s));
 
@@ -499,9 +505,9 @@ static void ClassifyDataFlexMetaDataFoldPoint(int &levelCurrent,
 
 static void FoldDataFlexDoc(Sci_PositionU startPos, Sci_Position length, int initStyle, WordList *keywordlists[],
 		Accessor &styler) {
-	bool foldComment = styler.GetPropertyInt("fold.comment") != 0;
-	bool foldPreprocessor = styler.GetPropertyInt("fold.preprocessor") != 0;
-	bool foldCompact = styler.GetPropertyInt("fold.compact", 1) != 0;
+	bool foldComment = styler.GetPropertyInt(propFoldComment) != 0;
+	bool foldPreprocessor = styler.GetPropertyInt(propFoldPreprocessor) != 0;
+	bool foldCompact = styler.GetPropertyInt(propFoldCompact, 1) != 0;
 	Sci_PositionU endPos = startPos + length;
 	int visibleChars = 0;
 	Sci_Position lineCurrent = styler.GetLine(startPos);
@@ -514,7 +520,7 @@ static void FoldDataFlexDoc(Sci_PositionU startPos, Sci_Position length, int ini
 	int iWordSize;
 
 	Sci_Position lastStart = 0;
-	CharacterSet setWord(CharacterSet::setAlphaNum, "_$#@", 0x80, true);
+	static constexpr CharacterSet setWord(CharacterSet::setAlphaNum, "_$#@", 0x80, true);
 
 	for (Sci_PositionU i = startPos; i < endPos; i++) {
 		char ch = chNext;
@@ -76,11 +76,11 @@ static void ColouriseEclDoc(Sci_PositionU startPos, Sci_Position length, int ini
 
 	bool stylingWithinPreprocessor = false;
 
-	CharacterSet setOKBeforeRE(CharacterSet::setNone, "(=,");
-	CharacterSet setDoxygen(CharacterSet::setLower, "$@\\&<>#{}[]");
-	CharacterSet setWordStart(CharacterSet::setAlpha, "_", 0x80, true);
-	CharacterSet setWord(CharacterSet::setAlphaNum, "._", 0x80, true);
-	CharacterSet setQualified(CharacterSet::setNone, "uUxX");
+	static constexpr CharacterSet setOKBeforeRE(CharacterSet::setNone, "(=,");
+	static constexpr CharacterSet setDoxygen(CharacterSet::setLower, "$@\\&<>#{}[]");
+	static constexpr CharacterSet setWordStart(CharacterSet::setAlpha, "_", 0x80, true);
+	static constexpr CharacterSet setWord(CharacterSet::setAlphaNum, "._", 0x80, true);
+	static constexpr CharacterSet setQualified(CharacterSet::setNone, "uUxX");
 
 	int chPrevNonWhite = ' ';
 	int visibleChars = 0;
@@ -13,12 +13,14 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
 #include <map>
 #include <initializer_list>
 
 #include "ILexer.h"
 #include "Scintilla.h"
 #include "SciLexer.h"
+#include "LexillaExtensions.h"
 
 #include "InList.h"
 #include "WordList.h"
@@ -28,6 +30,7 @@
 #include "CharacterSet.h"
 #include "LexerModule.h"
 #include "OptionSet.h"
+#include "LineStyleCache.h"
 #include "DefaultLexer.h"
 
 using namespace Scintilla;
@@ -123,9 +126,11 @@ const LexicalClass lexicalClasses[] = {
 class LexerErrorList : public DefaultLexer {
 	OptionsErrorList options;
 	OptionSetErrorList osErrorList;
+	LineStyleCache lineStyleCache;
 public:
 	LexerErrorList() :
 		DefaultLexer("errorlist", SCLEX_ERRORLIST, lexicalClasses, std::size(lexicalClasses)) {
+		SetLineStyleCache(&lineStyleCache);
 	}
 
 	const char *SCI_METHOD PropertyNames() override {
@@ -154,6 +159,7 @@ public:
 
 Sci_Position SCI_METHOD LexerErrorList::PropertySet(const char *key, const char *val) {
 	if (osErrorList.PropertySet(&options, key, val)) {
+		lineStyleCache.Clear();
 		return 0;
 	}
 	return -1;
@@ -548,6 +554,7 @@ void ColouriseErrorListLine(
 
 void LexerErrorList::Lex(Sci_PositionU startPos, Sci_Position length, int /* initStyle */, IDocument *pAccess) {
 	Accessor styler(pAccess, nullptr);
+	LineStyleCache *cache = ActiveLineStyleCache();
 	std::string lineBuffer;
 	styler.StartAt(startPos);
 	styler.StartSegment(startPos);
@@ -556,7 +563,10 @@ void LexerErrorList::Lex(Sci_PositionU startPos, Sci_Position length, int /* ini
 		lineBuffer.push_back(styler[i]);
 		if (AtEOL(styler, i)) {
 			// End of line met, colourise it
-			ColouriseErrorListLine(lineBuffer, i, styler, options.valueSeparate, options.escapeSequences);
+			StyleLine(cache, styler, i + 1 - lineBuffer.length(), i, lineBuffer, 0, [&]() {
+				ColouriseErrorListLine(lineBuffer, i, styler, options.valueSeparate, options.escapeSequences);
+				return 0;
+			});
 			lineBuffer.clear();
 		}
 	}
@@ -407,6 +407,9 @@ void ColouriseEscSeqLine(const std::string &lineBuffer,
 		}
 
 		styler.ColourTo(endPos, portionStyle);
+	} else {
+		// Lines without sequences are styled too so no styles remain from earlier text
+		styler.ColourTo(endPos, style);
 	}
 }
 
@@ -31,6 +31,7 @@
 #include "LexerModule.h"
 #include "OptionSet.h"
 #include "SubStyles.h"
+#include "Convergence.h"
 #include "DefaultLexer.h"
 
 using namespace Scintilla;
@@ -1056,6 +1057,16 @@ const char * const tagsThatDoNotFold[] = {
 	"wbr"
 };
 
+// Lex backtracks from inside tags and PHP strings so can not stop after a line ending in one.
+class ConvergenceHTML : public Convergence {
+public:
+	bool ConvergedAfter(IDocument *pAccess, Sci_Position line, Sci_Position) override {
+		const Sci_Position lineEnd = pAccess->LineStart(line + 1) - 1;
+		const int style = static_cast<unsigned char>(pAccess->StyleAt(lineEnd));
+		return !StyleNeedsBacktrack(stateForPrintState(style));
+	}
+};
+
 }
 
 class LexerHTML : public DefaultLexer {
@@ -1071,6 +1082,7 @@ class LexerHTML : public DefaultLexer {
 	OptionSetHTML osHTML;
 	std::set<std::string> nonFoldingTags;
 	SubStyles subStyles{styleSubable,SubStylesHTML,SubStylesAvailable,0};
+	ConvergenceHTML convergence;
 public:
 	explicit LexerHTML(bool isXml_, bool isPHPScript_) :
 		DefaultLexer(
@@ -1082,6 +1094,8 @@ public:
 		isPHPScript(isPHPScript_),
 		osHTML(isPHPScript_),
 		nonFoldingTags(std::begin(tagsThatDoNotFold), std::end(tagsThatDoNotFold)) {
+		SetConvergence(&convergence);
+		SetCanLexBudgeted();
 	}
 	~LexerHTML() override {
 	}
@@ -1263,9 +1277,14 @@ void SCI_METHOD LexerHTML::Lex(Sci_PositionU startPos, Sci_Position length, int
 	script_type clientScript = static_cast<script_type>((lineState >> 8) & 0x0F); // 4 bits of script name
 	int beforePreProc = (lineState >> 12) & 0xFF; // 8 bits of state
 	bool isLanguageType = (lineState >> 20) & 1; // type or language attribute for script tag
-	int sgmlBlockLevel = (lineState >> 21);
+	const bool inSGMLBlock = (lineState >> 21) & 1; // SGML states inside a [ ] block
+	int sgmlBlockLevel = (lineState >> 22);
 
 	script_type scriptLanguage = ScriptOfState(state);
+	// Strings and errors directly inside a [ ] block share styles with declarations
+	if (inSGMLBlock && scriptLanguage == eScriptSGML) {
+		scriptLanguage = eScriptSGMLblock;
+	}
 	// If eNonHtmlScript coincides with SCE_H_COMMENT, assume eScriptComment
 	if (inScriptType == eNonHtmlScript && state == SCE_H_COMMENT) {
 		scriptLanguage = eScriptComment;
@@ -1284,13 +1303,13 @@ void SCI_METHOD LexerHTML::Lex(Sci_PositionU startPos, Sci_Position length, int
 	const bool isMako = options.isMako;
 	const bool isDjango = options.isDjango;
 	const bool allowASP = (isXml ? options.allowASPinXML : options.allowASPinHTML) && !isMako && !isDjango;
-	const CharacterSet setHTMLWord(CharacterSet::setAlphaNum, ".-_:!#", true);
-	const CharacterSet setTagContinue(CharacterSet::setAlphaNum, ".-_:!#[", true);
-	const CharacterSet setAttributeContinue(CharacterSet::setAlphaNum, ".-_:!#/", true);
+	static constexpr CharacterSet setHTMLWord(CharacterSet::setAlphaNum, ".-_:!#", true);
+	static constexpr CharacterSet setTagContinue(CharacterSet::setAlphaNum, ".-_:!#[", true);
+	static constexpr CharacterSet setAttributeContinue(CharacterSet::setAlphaNum, ".-_:!#/", true);
 	// TODO: also handle + and - (except if they're part of ++ or --) and return keywords
-	const CharacterSet setOKBeforeJSRE(CharacterSet::setNone, "([{=,:;!%^&*|?~> ");
+	static constexpr CharacterSet setOKBeforeJSRE(CharacterSet::setNone, "([{=,:;!%^&*|?~> ");
 	// Only allow [A-Za-z0-9.#-_:] in entities
-	const CharacterSet setEntity(CharacterSet::setAlphaNum, ".#-_:");
+	static constexpr CharacterSet setEntity(CharacterSet::setAlphaNum, ".#-_:");
 
 	int levelPrev = styler.LevelAt(lineCurrent) & SC_FOLDLEVELNUMBERMASK;
 	int levelCurrent = levelPrev;
@@ -1310,7 +1329,8 @@ void SCI_METHOD LexerHTML::Lex(Sci_PositionU startPos, Sci_Position length, int
 				// includes SCE_HJ_COMMENT & SCE_HJ_COMMENTLINE
 				break;
 		}
-		if (style == SCE_HJ_SYMBOLS) {
+		if (style > SCE_HJ_COMMENTDOC && style <= SCE_HJ_TEMPLATELITERAL) {
+			// Words, numbers and strings also decide whether '/' divides or starts a regex
 			chPrevNonWhite = SafeGetUnsignedCharAt(styler, back);
 		}
 	}
@@ -1417,15 +1437,24 @@ void SCI_METHOD LexerHTML::Lex(Sci_PositionU startPos, Sci_Position length, int
 				visibleChars = 0;
 				levelPrev = levelCurrent;
 			}
+			// A Mako '%' line is ended by this line end after the state is recorded so record
+			// the state that follows it as lexing may restart on the next line
+			script_mode inScriptTypeNext = inScriptType;
+			if (isMako && (makoBlockType == "%") && (scriptLanguage != eScriptNone) &&
+				((inScriptType == eNonHtmlPreProc) || (inScriptType == eNonHtmlScriptPreProc)) &&
+				(makoComment || stateAllowsTermination(state))) {
+				inScriptTypeNext = (inScriptType == eNonHtmlScriptPreProc) ? eNonHtmlScript : eHtml;
+			}
 			styler.SetLineState(lineCurrent,
-			                    ((inScriptType & 0x03) << 0) |
+			                    ((inScriptTypeNext & 0x03) << 0) |
 			                    ((tagOpened ? 1 : 0) << 2) |
 			                    ((tagClosing ? 1 : 0) << 3) |
 			                    ((aspScript & 0x0F) << 4) |
 			                    ((clientScript & 0x0F) << 8) |
 			                    ((beforePreProc & 0xFF) << 12) |
 			                    ((isLanguageType ? 1 : 0) << 20) |
-			                    (sgmlBlockLevel << 21));
+			                    (((scriptLanguage == eScriptSGMLblock) && (ScriptOfState(state) == eScriptSGML) ? 1 : 0) << 21) |
+			                    (sgmlBlockLevel << 22));
 			lineCurrent++;
 			lineStartVisibleChars = 0;
 		}
@@ -17,6 +17,7 @@
 
 #include <string>
 #include <string_view>
+#include <optional>
 #include <vector>
 #include <map>
 #include <functional>
@@ -30,6 +31,7 @@
 #include "CharacterSet.h"
 #include "LexerModule.h"
 #include "OptionSet.h"
+#include "Convergence.h"
 #include "DefaultLexer.h"
 
 using namespace Scintilla;
@@ -43,6 +45,12 @@ const char *const JSONWordListDesc[] = {
 	nullptr
 };
 
+// Characters that may have an effect in comments and strings, other characters are skipped
+// in bulk by ForwardUntilAny. Strings stop at the first letter of each URI scheme matched.
+// Block comments skip to their end with ForwardUntilMatch.
+constexpr CharacterSet setStopLineComment;
+constexpr CharacterSet setStopString("\"\\@fghms");
+
 /**
  * Used to detect compact IRI/URLs in JSON-LD without first looking ahead for the
  * colon separating the prefix and suffix
@@ -143,6 +151,7 @@ class LexerJSON : public DefaultLexer {
 	CharacterSet setURL;
 	CharacterSet setKeywordJSONLD;
 	CharacterSet setKeywordJSON;
+	Convergence convergence;
 	CompactIRI compactIRI;
 
 	static bool IsNextNonWhitespace(LexAccessor &styler, Sci_Position start, char ch) {
@@ -190,7 +199,6 @@ class LexerJSON : public DefaultLexer {
 
 	static bool IsNextWordInList(const WordList &keywordList, const CharacterSet &wordSet,
 								 const StyleContext &context, LexAccessor &styler) {
-		char word[51];
 		const Sci_Position currPos = static_cast<Sci_Position>(context.currentPos);
 		int i = 0;
 		while (i < 50) {
@@ -198,11 +206,13 @@ class LexerJSON : public DefaultLexer {
 			if (!wordSet.Contains(ch)) {
 				break;
 			}
-			word[i] = ch;
 			i++;
 		}
-		word[i] = '\0';
-		return keywordList.InList(word);
+		// The word was just read so is normally still in the styler's buffer
+		if (const char *text = styler.BufferPointer(currPos, currPos + i)) {
+			return keywordList.InList(std::string_view(text, i));
+		}
+		return keywordList.InList(styler.GetRange(currPos, currPos + i));
 	}
 
 	public:
@@ -212,6 +222,9 @@ class LexerJSON : public DefaultLexer {
 		setURL(CharacterSet::setAlphaNum, "-._~:/?#[]@!$&'()*+,),="),
 		setKeywordJSONLD(CharacterSet::setAlpha, ":@"),
 		setKeywordJSON(CharacterSet::setAlpha, "$_") {
+		SetConvergence(&convergence);
+		SetCanFoldDuringLex();
+		SetCanLexBudgeted();
 	}
 	virtual ~LexerJSON() = default;
 	int SCI_METHOD Version() const override {
@@ -256,9 +269,6 @@ class LexerJSON : public DefaultLexer {
 		}
 		return firstModification;
 	}
-	void *SCI_METHOD PrivateCall(int, void *) override {
-		return nullptr;
-	}
 	static ILexer5 *LexerFactoryJSON() {
 		return new LexerJSON;
 	}
@@ -275,11 +285,73 @@ class LexerJSON : public DefaultLexer {
 								 IDocument *pAccess) override;
 };
 
+// Sets fold levels from the styles of each character in turn. Used by Fold and also by Lex in
+// FoldDuringLex mode where the styles are received as they are set.
+class FolderJSON : public StyleListener {
+	LexAccessor &styler;
+	const bool foldCompact;
+	const Sci_PositionU endPos;
+	Sci_PositionU currLine;
+	int currLevel = SC_FOLDLEVELBASE;
+	int nextLevel;
+	int visibleChars = 0;
+public:
+	FolderJSON(LexAccessor &styler_, Sci_PositionU startPos, Sci_Position length, bool foldCompact_) :
+		styler(styler_),
+		foldCompact(foldCompact_),
+		endPos(startPos + length),
+		currLine(styler.GetLine(startPos)) {
+		if (currLine > 0)
+			currLevel = styler.LevelAt(currLine - 1) >> 16;
+		nextLevel = currLevel;
+	}
+	void Character(Sci_PositionU i, int style) {
+		const char curr = styler.SafeGetCharAt(i);
+		const char next = styler.SafeGetCharAt(i+1);
+		const bool atEOL = (curr == '\r' && next != '\n') || (curr == '\n');
+		if (style == SCE_JSON_OPERATOR) {
+			if (curr == '{' || curr == '[') {
+				nextLevel++;
+			} else if (curr == '}' || curr == ']') {
+				nextLevel--;
+			}
+		}
+		if (atEOL || i == (endPos-1)) {
+			int level = currLevel | nextLevel << 16;
+			if (!visibleChars && foldCompact) {
+				level |= SC_FOLDLEVELWHITEFLAG;
+			} else if (nextLevel > currLevel) {
+				level |= SC_FOLDLEVELHEADERFLAG;
+			}
+			if (level != styler.LevelAt(currLine)) {
+				styler.SetLevel(currLine, level);
+			}
+			currLine++;
+			currLevel = nextLevel;
+			visibleChars = 0;
+		}
+		if (!isspacechar(curr)) {
+			visibleChars++;
+		}
+	}
+	void Styled(Sci_PositionU start, Sci_PositionU end, int style) override {
+		for (Sci_PositionU i = start; i < end; i++) {
+			Character(i, style);
+		}
+	}
+};
+
 void SCI_METHOD LexerJSON::Lex(Sci_PositionU startPos,
 							   Sci_Position length,
 							   int initStyle,
 							   IDocument *pAccess) {
 	LexAccessor styler(pAccess);
+	ForgetFolded();
+	std::optional<FolderJSON> folder;
+	if (options.fold && FoldDuringLex()) {
+		folder.emplace(styler, startPos, length, options.foldCompact);
+		styler.SetStyleListener(&*folder);
+	}
 	StyleContext context(startPos, length, initStyle, styler);
 	int stringStyleBefore = SCE_JSON_STRING;
 	while (context.More()) {
@@ -288,11 +360,15 @@ void SCI_METHOD LexerJSON::Lex(Sci_PositionU startPos,
 				if (context.Match("*/")) {
 					context.Forward();
 					context.ForwardSetState(SCE_JSON_DEFAULT);
+				} else {
+					context.ForwardUntilMatch("*/");
 				}
 				break;
 			case SCE_JSON_LINECOMMENT:
 				if (context.MatchLineEnd()) {
 					context.SetState(SCE_JSON_DEFAULT);
+				} else {
+					context.ForwardUntilAny(setStopLineComment);
 				}
 				break;
 			case SCE_JSON_STRINGEOL:
@@ -362,6 +438,10 @@ void SCI_METHOD LexerJSON::Lex(Sci_PositionU startPos,
 					}
 				} else {
 					compactIRI.checkChar(context.ch);
+					if (compactIRI.foundInvalidChar) {
+						// Skipped characters can no longer make the string a compact IRI
+						context.ForwardUntilAny(setStopString);
+					}
 				}
 				break;
 			case SCE_JSON_LDKEYWORD:
@@ -459,6 +539,9 @@ void SCI_METHOD LexerJSON::Lex(Sci_PositionU startPos,
 		context.Forward();
 	}
 	context.Complete();
+	if (folder) {
+		FoldedDuringLex(startPos, length, pAccess);
+	}
 }
 
 void SCI_METHOD LexerJSON::Fold(Sci_PositionU startPos,
@@ -468,42 +551,14 @@ void SCI_METHOD LexerJSON::Fold(Sci_PositionU startPos,
 	if (!options.fold) {
 		return;
 	}
+	if (AlreadyFolded(startPos, length, pAccess)) {
+		return;
+	}
 	LexAccessor styler(pAccess);
-	Sci_PositionU currLine = styler.GetLine(startPos);
+	FolderJSON folder(styler, startPos, length, options.foldCompact);
 	const Sci_PositionU endPos = startPos + length;
-	int currLevel = SC_FOLDLEVELBASE;
-	if (currLine > 0)
-		currLevel = styler.LevelAt(currLine - 1) >> 16;
-	int nextLevel = currLevel;
-	int visibleChars = 0;
 	for (Sci_PositionU i = startPos; i < endPos; i++) {
-		const char curr = styler.SafeGetCharAt(i);
-		const char next = styler.SafeGetCharAt(i+1);
-		const bool atEOL = (curr == '\r' && next != '\n') || (curr == '\n');
-		if (styler.StyleAt(i) == SCE_JSON_OPERATOR) {
-			if (curr == '{' || curr == '[') {
-				nextLevel++;
-			} else if (curr == '}' || curr == ']') {
-				nextLevel--;
-			}
-		}
-		if (atEOL || i == (endPos-1)) {
-			int level = currLevel | nextLevel << 16;
-			if (!visibleChars && options.foldCompact) {
-				level |= SC_FOLDLEVELWHITEFLAG;
-			} else if (nextLevel > currLevel) {
-				level |= SC_FOLDLEVELHEADERFLAG;
-			}
-			if (level != styler.LevelAt(currLine)) {
-				styler.SetLevel(currLine, level);
-			}
-			currLine++;
-			currLevel = nextLevel;
-			visibleChars = 0;
-		}
-		if (!isspacechar(curr)) {
-			visibleChars++;
-		}
+		folder.Character(i, styler.StyleIndexAt(i));
 	}
 }
 
@@ -13,6 +13,7 @@
 
 #include <string>
 #include <string_view>
+#include <optional>
 #include <vector>
 #include <map>
 
@@ -28,6 +29,7 @@
 #include "LexerModule.h"
 #include "OptionSet.h"
 #include "SubStyles.h"
+#include "Convergence.h"
 #include "DefaultLexer.h"
 
 using namespace Scintilla;
@@ -112,9 +114,12 @@ class LexerLua : public DefaultLexer {
 	OptionsLua options;
 	OptionSetLua osLua;
 	SubStyles subStyles{styleSubable};
+	Convergence convergence;
 public:
 	explicit LexerLua() :
 		DefaultLexer("lua", SCLEX_LUA, lexicalClasses, std::size(lexicalClasses)) {
+		SetConvergence(&convergence);
+		SetCanFoldDuringLex();
 	}
 	LexerLua(const LexerLua &) = delete;
 	LexerLua(LexerLua &&) = delete;
@@ -231,18 +236,125 @@ constexpr int maskSeparator = 0xFF;
 constexpr int maskStringWs = 0x100;
 constexpr int maskDocComment = 0x200;
 
+// Sets fold levels from the styles of each character in turn. Used by Fold and also by Lex in
+// FoldDuringLex mode where the styles are received as they are set.
+// The style of the following character is needed so each character is folded when the next
+// character's style is known.
+class FolderLua : public StyleListener {
+	LexAccessor &styler;
+	const bool foldCompact;
+	Sci_Position lineCurrent;
+	int levelPrev;
+	int levelCurrent;
+	int visibleChars = 0;
+	int stylePrev;
+	Sci_Position positionWaiting = -1;
+	int styleWaiting = 0;
+
+	void Fold(Sci_Position i, int style, int styleNext) {
+		const char ch = styler[i];
+		const char chNext = styler.SafeGetCharAt(i + 1);
+		const bool atEOL = (ch == '\r' && chNext != '\n') || (ch == '\n');
+		if (style == SCE_LUA_WORD) {
+			// Fixed list of folding words: if, do, function, repeat, end, until
+			// Must fix up next line with initial characters if any new words added.
+			if ((style != stylePrev) && AnyOf(ch, 'i', 'd', 'f', 'e', 'r', 'u')) {
+				constexpr Sci_Position maxFoldWord = 9; // "function"sv.length() + 1
+				std::string s;
+				for (Sci_Position j = 0; j < maxFoldWord; j++) {
+					if (!iswordchar(styler[i + j])) {
+						break;
+					}
+					s.push_back(styler[i + j]);
+				}
+
+				if (s == "if" || s == "do" || s == "function" || s == "repeat") {
+					levelCurrent++;
+				}
+				if (s == "end" || s == "until") {
+					levelCurrent--;
+				}
+			}
+		} else if (style == SCE_LUA_OPERATOR) {
+			if (ch == '{' || ch == '(') {
+				levelCurrent++;
+			} else if (ch == '}' || ch == ')') {
+				levelCurrent--;
+			}
+		} else if (style == SCE_LUA_LITERALSTRING || style == SCE_LUA_COMMENT) {
+			if (stylePrev != style) {
+				levelCurrent++;
+			} else if (styleNext != style) {
+				levelCurrent--;
+			}
+		}
+
+		if (atEOL) {
+			const int lev = levelPrev |
+				FoldLevelFlags(levelPrev, levelCurrent, visibleChars == 0 && foldCompact, visibleChars > 0);
+			styler.SetLevelIfDifferent(lineCurrent, lev);
+			lineCurrent++;
+			levelPrev = levelCurrent;
+			visibleChars = 0;
+		}
+		if (!isspacechar(ch)) {
+			visibleChars++;
+		}
+		stylePrev = style;
+	}
+
+public:
+	FolderLua(LexAccessor &styler_, Sci_Position startPos, int initStyle, bool foldCompact_) :
+		styler(styler_),
+		foldCompact(foldCompact_),
+		lineCurrent(styler.GetLine(startPos)),
+		levelPrev(styler.LevelAt(lineCurrent) & SC_FOLDLEVELNUMBERMASK),
+		levelCurrent(levelPrev),
+		stylePrev(initStyle) {
+	}
+	void Character(Sci_Position position, int style) {
+		if (positionWaiting >= 0) {
+			Fold(positionWaiting, styleWaiting, style);
+		}
+		positionWaiting = position;
+		styleWaiting = style;
+	}
+	void Styled(Sci_PositionU start, Sci_PositionU end, int style) override {
+		for (Sci_PositionU position = start; position < end; position++) {
+			Character(position, style);
+		}
+	}
+	void Complete() {
+		if (positionWaiting >= 0) {
+			// Style treated as continuing after the range
+			Fold(positionWaiting, styleWaiting, styleWaiting);
+			positionWaiting = -1;
+		}
+		// Fill in the real level of the next line, keeping the current flags as they will be filled in later
+		const int flagsNext = styler.LevelAt(lineCurrent) & ~SC_FOLDLEVELNUMBERMASK;
+		styler.SetLevel(lineCurrent, levelPrev | flagsNext);
+	}
+};
+
 void LexerLua::Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) {
 	LexAccessor styler(pAccess);
 
+	ForgetFolded();
+	std::optional<FolderLua> folder;
+	if (FoldDuringLex()) {
+		folder.emplace(styler, startPos, initStyle, options.foldCompact);
+		styler.SetStyleListener(&*folder);
+	}
+
 	// Accepts accented characters
-	const CharacterSet setWordStart(CharacterSet::setAlpha, "_", true);
-	const CharacterSet setWord(CharacterSet::setAlphaNum, "_", true);
+	static constexpr CharacterSet setWordStart(CharacterSet::setAlpha, "_", true);
+	static constexpr CharacterSet setWord(CharacterSet::setAlphaNum, "_", true);
 	// Not exactly following number definition (several dots are seen as OK, etc.)
 	// but probably enough in most cases. [pP] is for hex floats.
-	const CharacterSet setNumber(CharacterSet::setDigits, ".-+abcdefpABCDEFP");
-	const CharacterSet setExponent("eEpP");
-	const CharacterSet setLuaOperator("*/-+()={}~[];<>,.^%:#&|");
-	const CharacterSet setEscapeSkip("\"'\\");
+	static constexpr CharacterSet setNumber(CharacterSet::setDigits, ".-+abcdefpABCDEFP");
+	static constexpr CharacterSet setExponent("eEpP");
+	static constexpr CharacterSet setLuaOperator("*/-+()={}~[];<>,.^%:#&|");
+	static constexpr CharacterSet setEscapeSkip("\"'\\");
 
 	const WordClassifier &classifierIdentifiers = subStyles.Classifier(SCE_LUA_IDENTIFIER);
 
@@ -279,25 +391,32 @@ void LexerLua::Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, I
 		// shbang line: "#!" is a comment only if located at the start of the script
 		sc.SetState(SCE_LUA_COMMENTLINE);
 	}
+	// Update the line state, so it can be seen by next line. Handlers may move onto
+	// a line end with ForwardSetState, so lines not recorded at the top of the loop
+	// are recorded at its bottom.
+	Sci_Position lineStateSet = -1;
+	auto setLineState = [&]() {
+		currentLine = styler.GetLine(sc.currentPos);
+		lineStateSet = currentLine;
+		switch (sc.state) {
+		case SCE_LUA_DEFAULT:
+		case SCE_LUA_LITERALSTRING:
+		case SCE_LUA_COMMENT:
+		case SCE_LUA_COMMENTDOC:
+		case SCE_LUA_STRING:
+		case SCE_LUA_CHARACTER:
+			// Inside a literal string, block comment or string, we set the line state
+			styler.SetLineState(currentLine, lastLineDocComment | stringWs | sepCount);
+			break;
+		default:
+			// Reset the line state
+			styler.SetLineState(currentLine, 0);
+			break;
+		}
+	};
 	for (; sc.More(); sc.Forward()) {
 		if (sc.atLineEnd) {
-			// Update the line state, so it can be seen by next line
-			currentLine = styler.GetLine(sc.currentPos);
-			switch (sc.state) {
-			case SCE_LUA_DEFAULT:
-			case SCE_LUA_LITERALSTRING:
-			case SCE_LUA_COMMENT:
-			case SCE_LUA_COMMENTDOC:
-			case SCE_LUA_STRING:
-			case SCE_LUA_CHARACTER:
-				// Inside a literal string, block comment or string, we set the line state
-				styler.SetLineState(currentLine, lastLineDocComment | stringWs | sepCount);
-				break;
-			default:
-				// Reset the line state
-				styler.SetLineState(currentLine, 0);
-				break;
-			}
+			setLineState();
 		}
 		if (sc.atLineStart && (sc.state == SCE_LUA_STRING)) {
 			// Prevent SCE_LUA_STRINGEOL from leaking back to previous line
@@ -312,6 +431,7 @@ void LexerLua::Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, I
 				if (sc.ch == '\r' && sc.chNext == '\n') {
 					sc.Forward();
 				}
+				setLineState();
 				continue;
 			}
 		}
@@ -387,9 +507,7 @@ void LexerLua::Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, I
 					sc.Forward();
 					while (setWord.Contains(sc.ch))
 						sc.Forward();
-					std::string s;
-					sc.GetCurrentString(s, StyleContext::Transform::none);
-					if (keywords.InList(s))		// labels cannot be keywords
+					if (keywords.InList(sc.GetCurrentView()))		// labels cannot be keywords
 						sc.ChangeState(SCE_LUA_WORD);
 				}
 				sc.SetState(SCE_LUA_DEFAULT);
@@ -439,6 +557,8 @@ void LexerLua::Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, I
 			if (sep == sepCount) {   // ]=]-style delim
 				sc.Forward(sep);
 				sc.ForwardSetState(SCE_LUA_DEFAULT);
+				// Not stored in later line states so lexing restarted at any line matches
+				sepCount = 0;
 			}
 		}
 
@@ -554,84 +674,31 @@ void LexerLua::Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, I
 				lastLineDocComment = 0;
 			}
 		}
+		if (sc.More() && sc.atLineEnd && styler.GetLine(sc.currentPos) != lineStateSet) {
+			setLineState();
+		}
 	}
 
 	sc.Complete();
+
+	if (folder) {
+		folder->Complete();
+		FoldedDuringLex(startPos, length, pAccess);
+	}
 }
 
 void LexerLua::Fold(Sci_PositionU startPos_, Sci_Position length, int initStyle, IDocument *pAccess) {
+	if (AlreadyFolded(startPos_, length, pAccess)) {
+		return;
+	}
 	LexAccessor styler(pAccess);
 	const Sci_Position startPos = startPos_;
 	const Sci_Position lengthDoc = startPos + length;
-	int visibleChars = 0;
-	Sci_Position lineCurrent = styler.GetLine(startPos);
-	int levelPrev = styler.LevelAt(lineCurrent) & SC_FOLDLEVELNUMBERMASK;
-	int levelCurrent = levelPrev;
-	char chNext = styler[startPos];
-	const bool foldCompact = options.foldCompact;
-	int style = initStyle;
-	int styleNext = styler.StyleIndexAt(startPos);
-
+	FolderLua folder(styler, startPos, initStyle, options.foldCompact);
 	for (Sci_Position i = startPos; i < lengthDoc; i++) {
-		const char ch = chNext;
-		chNext = styler.SafeGetCharAt(i + 1);
-		const int stylePrev = style;
-		style = styleNext;
-		if ((i + 1) < lengthDoc) {
-			// Only read styles that have been set, otherwise treat style as continuing
-			styleNext = styler.StyleIndexAt(i + 1);
-		}
-		const bool atEOL = (ch == '\r' && chNext != '\n') || (ch == '\n');
-		if (style == SCE_LUA_WORD) {
-			// Fixed list of folding words: if, do, function, repeat, end, until
-			// Must fix up next line with initial characters if any new words added.
-			if ((style != stylePrev) && AnyOf(ch, 'i', 'd', 'f', 'e', 'r', 'u')) {
-				constexpr Sci_Position maxFoldWord = 9; // "function"sv.length() + 1
-				std::string s;
-				for (Sci_Position j = 0; j < maxFoldWord; j++) {
-					if (!iswordchar(styler[i + j])) {
-						break;
-					}
-					s.push_back(styler[i + j]);
-				}
-
-				if (s == "if" || s == "do" || s == "function" || s == "repeat") {
-					levelCurrent++;
-				}
-				if (s == "end" || s == "until") {
-					levelCurrent--;
-				}
-			}
-		} else if (style == SCE_LUA_OPERATOR) {
-			if (ch == '{' || ch == '(') {
-				levelCurrent++;
-			} else if (ch == '}' || ch == ')') {
-				levelCurrent--;
-			}
-		} else if (style == SCE_LUA_LITERALSTRING || style == SCE_LUA_COMMENT) {
-			if (stylePrev != style) {
-				levelCurrent++;
-			} else if (styleNext != style) {
-				levelCurrent--;
-			}
-		}
-
-		if (atEOL) {
-			const int lev = levelPrev |
-				FoldLevelFlags(levelPrev, levelCurrent, visibleChars == 0 && foldCompact, visibleChars > 0);
-			styler.SetLevelIfDifferent(lineCurrent, lev);
-			lineCurrent++;
-			levelPrev = levelCurrent;
-			visibleChars = 0;
-		}
-		if (!isspacechar(ch)) {
-			visibleChars++;
-		}
+		folder.Character(i, styler.StyleIndexAt(i));
 	}
-	// Fill in the real level of the next line, keeping the current flags as they will be filled in later
-
-	const int flagsNext = styler.LevelAt(lineCurrent) & ~SC_FOLDLEVELNUMBERMASK;
-	styler.SetLevel(lineCurrent, levelPrev | flagsNext);
+	folder.Complete();
 }
 
 }
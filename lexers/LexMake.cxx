@@ -14,11 +14,13 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
 #include <map>
 
 #include "ILexer.h"
 #include "Scintilla.h"
 #include "SciLexer.h"
+#include "LexillaExtensions.h"
 
 #include "WordList.h"
 #include "LexAccessor.h"
@@ -27,6 +29,7 @@
 #include "CharacterSet.h"
 #include "LexerModule.h"
 #include "OptionSet.h"
+#include "LineStyleCache.h"
 #include "DefaultLexer.h"
 
 using namespace Scintilla;
@@ -72,9 +75,11 @@ class LexerMakeFile : public DefaultLexer {
 	WordList directives;
 	OptionsMake options;
 	OptionSetMake osMake;
+	LineStyleCache lineStyleCache;
 public:
 	LexerMakeFile() :
 		DefaultLexer("makefile", SCLEX_MAKEFILE, lexicalClasses, std::size(lexicalClasses)) {
+		SetLineStyleCache(&lineStyleCache);
 	}
 
 	const char *SCI_METHOD PropertyNames() override {
@@ -107,6 +112,7 @@ public:
 
 Sci_Position SCI_METHOD LexerMakeFile::PropertySet(const char *key, const char *val) {
 	if (osMake.PropertySet(&options, key, val)) {
+		lineStyleCache.Clear();
 		return 0;
 	}
 	return -1;
@@ -123,6 +129,7 @@ Sci_Position SCI_METHOD LexerMakeFile::WordListSet(int n, const char *wl) {
 	}
 	Sci_Position firstModification = -1;
 	if (wordListN && wordListN->Set(wl)) {
+		lineStyleCache.Clear();
 		firstModification = 0;
 	}
 	return firstModification;
@@ -220,6 +227,7 @@ void LexerMakeFile::ColouriseMakeLine(
 
 void LexerMakeFile::Lex(Sci_PositionU startPos, Sci_Position length, int /* initStyle */, IDocument *pAccess) {
 	Accessor styler(pAccess, nullptr);
+	LineStyleCache *cache = ActiveLineStyleCache();
 	std::string lineBuffer;
 	styler.StartAt(startPos);
 	styler.StartSegment(startPos);
@@ -228,7 +236,10 @@ void LexerMakeFile::Lex(Sci_PositionU startPos, Sci_Position length, int /* init
 		lineBuffer.push_back(styler[i]);
 		if (AtEOL(styler, i)) {
 			// End of line (or of line buffer) met, colourise it
-			ColouriseMakeLine(lineBuffer, startLine, i, styler);
+			StyleLine(cache, styler, startLine, i, lineBuffer, 0, [&]() {
+				ColouriseMakeLine(lineBuffer, startLine, i, styler);
+				return 0;
+			});
 			lineBuffer.clear();
 			startLine = i + 1;
 		}
@@ -20,6 +20,7 @@
 #include "Scintilla.h"
 #include "SciLexer.h"
 
+#include "PropSetSimple.h"
 #include "WordList.h"
 #include "LexAccessor.h"
 #include "Accessor.h"
@@ -29,6 +30,12 @@
 
 using namespace Lexilla;
 
+static const PropertyKey propNsisIgnoreCase("nsis.ignorecase");
+static const PropertyKey propNsisUserVars("nsis.uservars");
+static const PropertyKey propFold("fold");
+static const PropertyKey propFoldAtElse("fold.at.else");
+static const PropertyKey propNsisFoldUtilCmd("nsis.foldutilcmd");
+
 /*
 // located in SciLexer.h
 #define SCLEX_NSIS 43
@@ -141,7 +148,7 @@ static int calculateFoldNsis(Sci_PositionU start, Sci_PositionU end, int foldlev
   bool bIgnoreCase = false;
   // property nsis.ignorecase
   // Set to 1 to ignore case for NSIS.
-  if( styler.GetPropertyInt("nsis.ignorecase") == 1 )
+  if( styler.GetPropertyInt(propNsisIgnoreCase) == 1 )
     bIgnoreCase = true;
 
   char s[20]; // The key word we are looking for has atmost 13 characters
@@ -175,13 +182,13 @@ static int calculateFoldNsis(Sci_PositionU start, Sci_PositionU end, int foldlev
 static int classifyWordNsis(Sci_PositionU start, Sci_PositionU end, WordList *keywordLists[], Accessor &styler )
 {
   bool bIgnoreCase = false;
-  if( styler.GetPropertyInt("nsis.ignorecase") == 1 )
+  if( styler.GetPropertyInt(propNsisIgnoreCase) == 1 )
     bIgnoreCase = true;
 
   bool bUserVars = false;
   // property nsis.uservars
   // Set to 1 to recognise user defined variables in NSIS.
-  if( styler.GetPropertyInt("nsis.uservars") == 1 )
+  if( styler.GetPropertyInt(propNsisUserVars) == 1 )
     bUserVars = true;
 
 	char s[100];
@@ -505,7 +512,7 @@ static void ColouriseNsisDoc(Sci_PositionU startPos, Sci_Position length, int, W
 		{
       bool bIngoreNextDollarSign = false;
       bool bUserVars = false;
-      if( styler.GetPropertyInt("nsis.uservars") == 1 )
+      if( styler.GetPropertyInt(propNsisUserVars) == 1 )
         bUserVars = true;
 
       if( bVarInString && cCurrChar == '$' )
@@ -560,11 +567,11 @@ static void ColouriseNsisDoc(Sci_PositionU startPos, Sci_Position length, int, W
 static void FoldNsisDoc(Sci_PositionU startPos, Sci_Position length, int, WordList *[], Accessor &styler)
 {
 	// No folding enabled, no reason to continue...
-	if( styler.GetPropertyInt("fold") == 0 )
+	if( styler.GetPropertyInt(propFold) == 0 )
 		return;
 
-  bool foldAtElse = styler.GetPropertyInt("fold.at.else", 0) == 1;
-  bool foldUtilityCmd = styler.GetPropertyInt("nsis.foldutilcmd", 1) == 1;
+  bool foldAtElse = styler.GetPropertyInt(propFoldAtElse, 0) == 1;
+  bool foldUtilityCmd = styler.GetPropertyInt(propNsisFoldUtilCmd, 1) == 1;
   bool blockComment = false;
 
   Sci_Position lineCurrent = styler.GetLine(startPos);
@@ -320,11 +320,11 @@ void ClassifyPascalWord(const WordList &keywords, StyleContext &sc, int &curLine
 void LexerPascal::Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, Scintilla::IDocument *pAccess) {
 	LexAccessor styler(pAccess);
 
-	const CharacterSet setWordStart(CharacterSet::setAlpha, "_", 0x80, true);
-	const CharacterSet setWord(CharacterSet::setAlphaNum, "_", 0x80, true);
-	const CharacterSet setNumber(CharacterSet::setDigits, ".-+eE");
-	const CharacterSet setHexNumber(CharacterSet::setDigits, "abcdefABCDEF");
-	const CharacterSet setOperator(CharacterSet::setNone, "#$&'()*+,-./:;<=>@[]^{}");
+	static constexpr CharacterSet setWordStart(CharacterSet::setAlpha, "_", 0x80, true);
+	static constexpr CharacterSet setWord(CharacterSet::setAlphaNum, "_", 0x80, true);
+	static constexpr CharacterSet setNumber(CharacterSet::setDigits, ".-+eE");
+	static constexpr CharacterSet setHexNumber(CharacterSet::setDigits, "abcdefABCDEF");
+	static constexpr CharacterSet setOperator(CharacterSet::setNone, "#$&'()*+,-./:;<=>@[]^{}");
 
 	// To terminate SCE_PAS_MULTILINESTRING, need to know number of quotes at start so retreat to starting line. 
 	if ((initStyle == SCE_PAS_MULTILINESTRING) && (startPos > 0)) {
@@ -527,7 +527,7 @@ void SetFoldInPreprocessorLevelFlag(int &lineFoldStateCurrent, unsigned int nest
 
 void ClassifyPascalPreprocessorFoldPoint(int &levelCurrent, int &lineFoldStateCurrent,
 		Sci_Position startPos, LexAccessor &styler) {
-	const CharacterSet setWord(CharacterSet::setAlpha);
+	static constexpr CharacterSet setWord(CharacterSet::setAlpha);
 
 	char s[11];	// Size of the longest possible keyword + one additional character + null
 	GetForwardRangeLowered(startPos, setWord, styler, s, sizeof(s));
@@ -560,7 +560,7 @@ void ClassifyPascalPreprocessorFoldPoint(int &levelCurrent, int &lineFoldStateCu
 
 Sci_Position SkipWhiteSpace(Sci_Position currentPos, Sci_Position endPos,
 		LexAccessor &styler, bool includeChars = false) {
-	const CharacterSet setWord(CharacterSet::setAlphaNum, "_");
+	static constexpr CharacterSet setWord(CharacterSet::setAlphaNum, "_");
 	Sci_Position j = currentPos + 1;
 	char ch = styler.SafeGetCharAt(j);
 	while ((j < endPos) && (IsASpaceOrTab(ch) || ch == '\r' || ch == '\n' ||
@@ -590,8 +590,8 @@ void ClassifyPascalWordFoldPoint(int &levelCurrent, int &lineFoldStateCurrent,
 		bool ignoreKeyword = false;
 		Sci_Position j = SkipWhiteSpace(currentPos, endPos, styler);
 		if (j < endPos) {
-			const CharacterSet setWordStart(CharacterSet::setAlpha, "_");
-			const CharacterSet setWord(CharacterSet::setAlphaNum, "_");
+			static constexpr CharacterSet setWordStart(CharacterSet::setAlpha, "_");
+			static constexpr CharacterSet setWord(CharacterSet::setAlphaNum, "_");
 
 			if (styler.SafeGetCharAt(j) == ';') {
 				// Handle forward class declarations ("type TMyClass = class;")
@@ -696,7 +696,7 @@ void LexerPascal::Fold(Sci_PositionU startPos_, Sci_Position length, int initSty
 	int visibleChars = 0;
 
 	Sci_Position lastStart = 0;
-	const CharacterSet setWord(CharacterSet::setAlphaNum, "_", 0x80, true);
+	static constexpr CharacterSet setWord(CharacterSet::setAlphaNum, "_", 0x80, true);
 
 	for (Sci_Position i = startPos; i < endPos; i++) {
 		const char ch = chNext;
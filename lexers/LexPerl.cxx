@@ -680,25 +680,25 @@ void SCI_METHOD LexerPerl::Lex(Sci_PositionU startPos, Sci_Position length, int
 	reWords.Set("elsif if split while");
 
 	// charset classes
-	CharacterSet setSingleCharOp(CharacterSet::setNone, "rwxoRWXOezsfdlpSbctugkTBMAC");
+	static constexpr CharacterSet setSingleCharOp(CharacterSet::setNone, "rwxoRWXOezsfdlpSbctugkTBMAC");
 	// lexing of "%*</" operators is non-trivial; these are missing in the set below
-	CharacterSet setPerlOperator(CharacterSet::setNone, "^&\\()-+=|{}[]:;>,?!.~");
-	CharacterSet setQDelim(CharacterSet::setNone, "qrwx");
-	CharacterSet setModifiers(CharacterSet::setAlpha);
-	CharacterSet setPreferRE(CharacterSet::setNone, "*/<%");
+	static constexpr CharacterSet setPerlOperator(CharacterSet::setNone, "^&\\()-+=|{}[]:;>,?!.~");
+	static constexpr CharacterSet setQDelim(CharacterSet::setNone, "qrwx");
+	static constexpr CharacterSet setModifiers(CharacterSet::setAlpha);
+	static constexpr CharacterSet setPreferRE(CharacterSet::setNone, "*/<%");
 	// setArray and setHash also accepts chars for special vars like $_,
 	// which are then truncated when the next char does not match setVar
-	CharacterSet setVar(CharacterSet::setAlphaNum, "#$_'", 0x80, true);
-	CharacterSet setArray(CharacterSet::setAlpha, "#$_+-", 0x80, true);
-	CharacterSet setHash(CharacterSet::setAlpha, "#$_!^+-", 0x80, true);
-	CharacterSet &setPOD = setModifiers;
-	CharacterSet setNonHereDoc(CharacterSet::setDigits, "=$@");
-	CharacterSet setHereDocDelim(CharacterSet::setAlphaNum, "_");
-	CharacterSet setSubPrototype(CharacterSet::setNone, "\\[$@%&*+];_ \t");
-	CharacterSet setRepetition(CharacterSet::setDigits, ")\"'");
+	static constexpr CharacterSet setVar(CharacterSet::setAlphaNum, "#$_'", 0x80, true);
+	static constexpr CharacterSet setArray(CharacterSet::setAlpha, "#$_+-", 0x80, true);
+	static constexpr CharacterSet setHash(CharacterSet::setAlpha, "#$_!^+-", 0x80, true);
+	const CharacterSet &setPOD = setModifiers;
+	static constexpr CharacterSet setNonHereDoc(CharacterSet::setDigits, "=$@");
+	static constexpr CharacterSet setHereDocDelim(CharacterSet::setAlphaNum, "_");
+	static constexpr CharacterSet setSubPrototype(CharacterSet::setNone, "\\[$@%&*+];_ \t");
+	static constexpr CharacterSet setRepetition(CharacterSet::setDigits, ")\"'");
 	// for format identifiers
-	CharacterSet setFormatStart(CharacterSet::setAlpha, "_=");
-	CharacterSet &setFormat = setHereDocDelim;
+	static constexpr CharacterSet setFormatStart(CharacterSet::setAlpha, "_=");
+	const CharacterSet &setFormat = setHereDocDelim;
 
 	// Lexer for perl often has to backtrack to start of current style to determine
 	// which characters are being used as quotes, how deeply nested is the
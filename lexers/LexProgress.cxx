@@ -142,7 +142,8 @@ public:
       setNegationOp(CharacterSet::setNone, "!"),
       setArithmethicOp(CharacterSet::setNone, "+-/*%"),
       setRelOp(CharacterSet::setNone, "=!<>"),
-      setLogicalOp(CharacterSet::setNone, "|&"){
+      setLogicalOp(CharacterSet::setNone, "|&"),
+      setWordStart(CharacterSet::setAlpha, "_", 0x80, true) {
    }
    virtual ~LexerABL() {
    }
@@ -222,8 +223,6 @@ Sci_Position SCI_METHOD LexerABL::WordListSet(int n, const char *wl) {
 void SCI_METHOD LexerABL::Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) {
    LexAccessor styler(pAccess);
 
-   setWordStart = CharacterSet(CharacterSet::setAlpha, "_", 0x80, true);
-
    int visibleChars1 = 0;
    int styleBeforeTaskMarker = SCE_ABL_DEFAULT;
    bool continuationLine = false;
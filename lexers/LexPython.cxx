@@ -19,6 +19,7 @@
 #include "ILexer.h"
 #include "Scintilla.h"
 #include "SciLexer.h"
+#include "LexillaExtensions.h"
 
 #include "WordList.h"
 #include "LexAccessor.h"
@@ -28,7 +29,9 @@
 #include "CharacterCategory.h"
 #include "LexerModule.h"
 #include "OptionSet.h"
+#include "MemoryUse.h"
 #include "SubStyles.h"
+#include "Convergence.h"
 #include "DefaultLexer.h"
 
 using namespace Scintilla;
@@ -62,6 +65,23 @@ struct SingleFStringExpState {
 	int nestingCount;
 };
 
+using FStringStateMap = std::map<Sci_Position, std::vector<SingleFStringExpState>>;
+
+// Are the f-string states at the end of lineA in a and lineB in b the same?
+bool SameFStringStates(const FStringStateMap &a, Sci_Position lineA, const FStringStateMap &b, Sci_Position lineB) {
+	const FStringStateMap::const_iterator itA = a.find(lineA);
+	const FStringStateMap::const_iterator itB = b.find(lineB);
+	const bool emptyA = (itA == a.end()) || itA->second.empty();
+	const bool emptyB = (itB == b.end()) || itB->second.empty();
+	if (emptyA || emptyB) {
+		return emptyA == emptyB;
+	}
+	return std::equal(itA->second.begin(), itA->second.end(), itB->second.begin(), itB->second.end(),
+		[](const SingleFStringExpState &x, const SingleFStringExpState &y) noexcept {
+			return (x.state == y.state) && (x.nestingCount == y.nestingCount);
+		});
+}
+
 /* kwCDef, kwCTypeName only used for Cython */
 enum kwType { kwOther, kwClass, kwDef, kwImport, kwCDef, kwCTypeName, kwCPDef };
 
@@ -69,6 +89,12 @@ enum literalsAllowed { litNone = 0, litU = 1, litB = 2, litF = 4, litT = 8 };
 
 constexpr int indicatorWhitespace = 1;
 
+// Characters that may have an effect in strings, other characters are skipped in bulk by
+// ForwardUntilAny. Either quote may end an f-string in an f-string expression.
+constexpr CharacterSet setStopString("\\'\"{");
+// Comments outside f-string expressions only end at the line end
+constexpr CharacterSet setStopComment;
+
 bool IsPyComment(Accessor &styler, Sci_Position pos, Sci_Position len) {
 	return len > 0 && styler[pos] == '#';
 }
@@ -259,12 +285,12 @@ unsigned char GetNextNonWhitespaceChar(Accessor &styler, Sci_PositionU pos, Sci_
 // not a keyword. Does not require the line to end with : so "match\n"
 // and "match (x)\n" return false because match could be a keyword once
 // more text is added
-bool IsMatchOrCaseIdentifier(const StyleContext &sc, Accessor &styler, const char *symbol) {
-	if (strcmp(symbol, "match") != 0 && strcmp(symbol, "case") != 0) {
+bool IsMatchOrCaseIdentifier(const StyleContext &sc, Accessor &styler, std::string_view symbol) {
+	if (symbol != "match" && symbol != "case") {
 		return false;
 	}
 
-	if (!IsFirstNonWhitespace(sc.currentPos - strlen(symbol), styler)) {
+	if (!IsFirstNonWhitespace(sc.currentPos - symbol.length(), styler)) {
 		return true;
 	}
 
@@ -407,7 +433,7 @@ const LexicalClass lexicalClasses[] = {
 	20, "SCE_P_ATTRIBUTE", "identifier", "Attribute of identifier",
 };
 
-class LexerPython : public DefaultLexer {
+class LexerPython : public DefaultLexer, public Convergence {
 	WordList keywords;
 	WordList keywords2;
 	OptionsPython options;
@@ -415,9 +441,12 @@ class LexerPython : public DefaultLexer {
 	enum { ssIdentifier };
 	SubStyles subStyles{styleSubable};
 	std::map<Sci_Position, std::vector<SingleFStringExpState> > ftripleStateAtEol;
+	FStringStateMap ftripleStateSaved;
 public:
 	explicit LexerPython() :
 		DefaultLexer("python", SCLEX_PYTHON, lexicalClasses, std::size(lexicalClasses)) {
+		SetConvergence(this);
+		SetCanLexBudgeted();
 	}
 	void SCI_METHOD Release() override {
 		delete this;
@@ -445,10 +474,19 @@ public:
 	void SCI_METHOD Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) override;
 	void SCI_METHOD Fold(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) override;
 
-	void *SCI_METHOD PrivateCall(int, void *) override {
-		return nullptr;
+	bool ReportMemory(LexerMemoryUse &use) const override {
+		use.total = sizeof(*this);
+		use.Add("ftripleStateAtEol", HeapBytes(ftripleStateAtEol));
+		use.Add("ftripleStateSaved", HeapBytes(ftripleStateSaved));
+		return true;
 	}
 
+	// Convergence
+	[[nodiscard]] Sci_Position LinesBehind() const noexcept override;
+	void SaveLexerState(Sci_Position line) override;
+	bool ConvergedAfter(IDocument *pAccess, Sci_Position line, Sci_Position lineDelta) override;
+	void RestoreLexerState(Sci_Position line, Sci_Position lineDelta) override;
+
 	int SCI_METHOD LineEndTypesSupported() override {
 		return SC_LINE_END_TYPE_UNICODE;
 	}
@@ -562,6 +600,33 @@ void LexerPython::ProcessLineEnd(StyleContext &sc, std::vector<SingleFStringExpS
 	}
 }
 
+// Lex starts on the line before startPos so that line must also match.
+Sci_Position LexerPython::LinesBehind() const noexcept {
+	return 1;
+}
+
+void LexerPython::SaveLexerState(Sci_Position line) {
+	ftripleStateSaved.clear();
+	ftripleStateSaved.insert(ftripleStateAtEol.lower_bound(line), ftripleStateAtEol.end());
+}
+
+bool LexerPython::ConvergedAfter(IDocument *pAccess, Sci_Position line, Sci_Position lineDelta) {
+	// Lex backtracks over lines that end inside single quoted strings
+	const int eolStyle = static_cast<unsigned char>(pAccess->StyleAt(pAccess->LineStart(line + 1) - 1));
+	if (AnyOf(eolStyle, SCE_P_STRING, SCE_P_CHARACTER, SCE_P_STRINGEOL)) {
+		return false;
+	}
+	return SameFStringStates(ftripleStateAtEol, line, ftripleStateSaved, line - lineDelta);
+}
+
+void LexerPython::RestoreLexerState(Sci_Position line, Sci_Position lineDelta) {
+	ftripleStateAtEol.erase(ftripleStateAtEol.upper_bound(line), ftripleStateAtEol.end());
+	for (FStringStateMap::const_iterator it = ftripleStateSaved.upper_bound(line - lineDelta); it != ftripleStateSaved.end(); ++it) {
+		ftripleStateAtEol.emplace(it->first + lineDelta, it->second);
+	}
+	ftripleStateSaved.clear();
+}
+
 void SCI_METHOD LexerPython::Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) {
 	Accessor styler(pAccess, nullptr);
 
@@ -663,10 +728,13 @@ void SCI_METHOD LexerPython::Lex(Sci_PositionU startPos, Sci_Position length, in
 			}
 		} else if (sc.state == SCE_P_IDENTIFIER) {
 			if ((sc.ch == '.') || (!IsAWordChar(sc.ch, options.unicodeIdentifiers))) {
-				char identifier[100];
-				sc.GetCurrent(identifier, sizeof(identifier));
+				std::string_view identifier = sc.GetCurrentView();
+				if (identifier == "match" || identifier == "case") {
+					// IsMatchOrCaseIdentifier reads ahead which may move the view so use the literal
+					identifier = (identifier == "match") ? "match" : "case";
+				}
 				int style = SCE_P_IDENTIFIER;
-				if ((kwLast == kwImport) && (strcmp(identifier, "as") == 0)) {
+				if ((kwLast == kwImport) && (identifier == "as")) {
 					style = SCE_P_WORD;
 				} else if (keywords.InList(identifier) && !IsMatchOrCaseIdentifier(sc, styler, identifier)) {
 					style = SCE_P_WORD;
@@ -748,17 +816,17 @@ void SCI_METHOD LexerPython::Lex(Sci_PositionU startPos, Sci_Position length, in
 				sc.ChangeState(style);
 				sc.SetState(SCE_P_DEFAULT);
 				if (style == SCE_P_WORD) {
-					if (0 == strcmp(identifier, "class"))
+					if (identifier == "class")
 						kwLast = kwClass;
-					else if (0 == strcmp(identifier, "def"))
+					else if (identifier == "def")
 						kwLast = kwDef;
-					else if (0 == strcmp(identifier, "import"))
+					else if (identifier == "import")
 						kwLast = kwImport;
-					else if (0 == strcmp(identifier, "cdef"))
+					else if (identifier == "cdef")
 						kwLast = kwCDef;
-					else if (0 == strcmp(identifier, "cpdef"))
+					else if (identifier == "cpdef")
 						kwLast = kwCPDef;
-					else if (0 == strcmp(identifier, "cimport"))
+					else if (identifier == "cimport")
 						kwLast = kwImport;
 					else if (kwLast != kwCDef && kwLast != kwCPDef)
 						kwLast = kwOther;
@@ -769,6 +837,8 @@ void SCI_METHOD LexerPython::Lex(Sci_PositionU startPos, Sci_Position length, in
 		} else if ((sc.state == SCE_P_COMMENTLINE) || (sc.state == SCE_P_COMMENTBLOCK)) {
 			if (sc.ch == '\r' || sc.ch == '\n') {
 				sc.SetState(SCE_P_DEFAULT);
+			} else if (indentGood && fstringStateStack.empty()) {
+				sc.ForwardUntilAny(setStopComment);
 			}
 		} else if (sc.state == SCE_P_DECORATOR) {
 			if (!IsAWordStart(sc.ch, options.unicodeIdentifiers)) {
@@ -788,6 +858,8 @@ void SCI_METHOD LexerPython::Lex(Sci_PositionU startPos, Sci_Position length, in
 			} else if (sc.ch == GetPyStringQuoteChar(sc.state)) {
 				sc.ForwardSetState(SCE_P_DEFAULT);
 				needEOLCheck = true;
+			} else if (indentGood && !setStopString.Contains(sc.ch)) {
+				sc.ForwardUntilAny(setStopString);
 			}
 		} else if ((sc.state == SCE_P_TRIPLE) || (sc.state == SCE_P_FTRIPLE)) {
 			if (sc.ch == '\\') {
@@ -797,6 +869,8 @@ void SCI_METHOD LexerPython::Lex(Sci_PositionU startPos, Sci_Position length, in
 				sc.Forward();
 				sc.ForwardSetState(SCE_P_DEFAULT);
 				needEOLCheck = true;
+			} else if (indentGood && !setStopString.Contains(sc.ch)) {
+				sc.ForwardUntilAny(setStopString);
 			}
 		} else if ((sc.state == SCE_P_TRIPLEDOUBLE) || (sc.state == SCE_P_FTRIPLEDOUBLE)) {
 			if (sc.ch == '\\') {
@@ -806,6 +880,8 @@ void SCI_METHOD LexerPython::Lex(Sci_PositionU startPos, Sci_Position length, in
 				sc.Forward();
 				sc.ForwardSetState(SCE_P_DEFAULT);
 				needEOLCheck = true;
+			} else if (indentGood && !setStopString.Contains(sc.ch)) {
+				sc.ForwardUntilAny(setStopString);
 			}
 		}
 
@@ -886,6 +886,12 @@ void synchronizeDocStart(Sci_PositionU &startPos, Sci_Position &length, int &ini
         initStyle = (startPos > 0) ? styler.StyleIndexAt(startPos - 1) : 0;
     }
 
+    if (initStyle == SCE_RB_DATASECTION) {
+        // The data section after __END__ continues to the end of the document so
+        // there is no construct to go back to the start of.
+        return;
+    }
+
     const int style = styler.StyleIndexAt(startPos);
     switch (style) {
     case SCE_RB_STDIN:
@@ -31,6 +31,7 @@
 #include "CharacterSet.h"
 #include "LexerModule.h"
 #include "OptionSet.h"
+#include "Convergence.h"
 #include "DefaultLexer.h"
 
 using namespace Scintilla;
@@ -165,8 +166,10 @@ class LexerRust : public DefaultLexer {
 	WordList keywords[NUM_RUST_KEYWORD_LISTS];
 	OptionsRust options;
 	OptionSetRust osRust;
+	Convergence convergence;
 public:
 	LexerRust() : DefaultLexer("rust", SCLEX_RUST, lexicalClasses, std::size(lexicalClasses)) {
+		SetConvergence(&convergence);
 	}
 	virtual ~LexerRust() {
 	}
@@ -195,9 +198,6 @@ public:
 	Sci_Position SCI_METHOD WordListSet(int n, const char *wl) override;
 	void SCI_METHOD Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) override;
 	void SCI_METHOD Fold(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) override;
-	void * SCI_METHOD PrivateCall(int, void *) override {
-		return nullptr;
-	}
 	static ILexer5 *LexerFactoryRust() {
 		return new LexerRust();
 	}
@@ -250,6 +250,15 @@ static void GrabString(char* s, Accessor& styler, Sci_Position start, Sci_Positi
 	s[len] = '\0';
 }
 
+// View of an identifier in the styler's buffer, or a copy in s when it is not all in the buffer.
+static std::string_view ViewIdentifier(char* s, Accessor& styler, Sci_Position start, Sci_Position len) {
+	if (const char *text = styler.BufferPointer(start, start + len)) {
+		return std::string_view(text, len);
+	}
+	GrabString(s, styler, start, len);
+	return std::string_view(s, len);
+}
+
 static void ScanRawIdentifier(Accessor& styler, Sci_Position& pos) {
 	const Sci_Position start = pos;
 	while (IsIdentifierContinue(styler.SafeGetCharAt(pos, '\0')))
@@ -258,10 +267,10 @@ static void ScanRawIdentifier(Accessor& styler, Sci_Position& pos) {
 	char s[MAX_RUST_IDENT_CHARS + 1];
 	Sci_Position len = pos - start;
 	len = len > MAX_RUST_IDENT_CHARS ? MAX_RUST_IDENT_CHARS : len;
-	GrabString(s, styler, start, len);
+	const std::string_view identifier = ViewIdentifier(s, styler, start, len);
 	// restricted values https://doc.rust-lang.org/reference/identifiers.html#raw-identifiers
-	if (strcmp(s, "crate") != 0 && strcmp(s, "self") != 0 &&
-		strcmp(s, "super") != 0 && strcmp(s, "Self") != 0) {
+	if (identifier != "crate" && identifier != "self" &&
+		identifier != "super" && identifier != "Self") {
 		styler.ColourTo(pos - 1, SCE_RUST_IDENTIFIER);
 	} else {
 		styler.ColourTo(pos - 1, SCE_RUST_LEXERROR);
@@ -280,10 +289,10 @@ static void ScanIdentifier(Accessor& styler, Sci_Position& pos, WordList *keywor
 		char s[MAX_RUST_IDENT_CHARS + 1];
 		Sci_Position len = pos - start;
 		len = len > MAX_RUST_IDENT_CHARS ? MAX_RUST_IDENT_CHARS : len;
-		GrabString(s, styler, start, len);
+		const std::string_view identifier = ViewIdentifier(s, styler, start, len);
 		bool keyword = false;
 		for (int ii = 0; ii < NUM_RUST_KEYWORD_LISTS; ii++) {
-			if (keywords[ii].InList(s)) {
+			if (keywords[ii].InList(identifier)) {
 				styler.ColourTo(pos - 1, SCE_RUST_WORD + ii);
 				keyword = true;
 				break;
@@ -537,6 +546,24 @@ static void ScanCharacterLiteralOrLifetime(Accessor &styler, Sci_Position& pos,
 	}
 }
 
+// Characters that may end or nest a block comment or end a string
+constexpr CharacterSet setStopBlockComment("*/");
+constexpr CharacterSet setStopString("\"\\");
+constexpr CharacterSet setStopRawString("\"");
+
+/*
+ * Position after pos of the next character in set, of the next non-ASCII character when
+ * asciiOnly, or of the end of the line or max. Positions skipped are within one line so need
+ * no line state.
+ */
+static Sci_Position SkipUntilAny(Accessor &styler, Sci_Position pos, Sci_Position max, const CharacterSet &set, bool asciiOnly) {
+	const Sci_Position lineEnd = styler.LineEnd(styler.GetLine(pos));
+	if (pos >= lineEnd) {
+		return pos + 1;
+	}
+	return styler.ScanUntilAny(pos + 1, (lineEnd < max) ? lineEnd : max, set, asciiOnly ? 0x7F : 0xFF);
+}
+
 enum CommentState {
 	UnknownComment,
 	DocComment,
@@ -585,7 +612,7 @@ static void ResumeBlockComment(Accessor &styler, Sci_Position& pos, Sci_Position
 			}
 		}
 		else if (pos < max) {
-			pos++;
+			pos = SkipUntilAny(styler, pos, max, setStopBlockComment, false);
 		}
 		if (pos >= max) {
 			if (state == DocComment || (state == UnknownComment && maybe_doc_comment))
@@ -678,7 +705,7 @@ static void ResumeString(Accessor &styler, Sci_Position& pos, Sci_Position max,
 			if (string_type == StringType::BYTESTRING && !IsASCII((char)c))
 				error = true;
 			else
-				pos++;
+				pos = SkipUntilAny(styler, pos, max, setStopString, string_type == StringType::BYTESTRING);
 		}
 		c = styler.SafeGetCharAt(pos, '\0');
 	}
@@ -710,7 +737,7 @@ static void ResumeRawString(Accessor &styler, Sci_Position& pos, Sci_Position ma
 		} else {
 			if ((string_type == StringType::RAW_BYTESTRING) && !IsASCII((char)c))
 				break;
-			pos++;
+			pos = SkipUntilAny(styler, pos, max, setStopRawString, string_type == StringType::RAW_BYTESTRING);
 		}
 	}
 
@@ -43,10 +43,10 @@ static void ColouriseSASDoc(Sci_PositionU startPos, Sci_Position length, int ini
     WordList &functionKeywords = *keywordlists[2];
     WordList &statements = *keywordlists[3];
 
-    CharacterSet setCouldBePostOp(CharacterSet::setNone, "+-");
-    CharacterSet setMacroStart(CharacterSet::setNone, "%");
-    CharacterSet setWordStart(CharacterSet::setAlpha, "_", 0x80, true);
-    CharacterSet setWord(CharacterSet::setAlphaNum, "._", 0x80, true);
+    static constexpr CharacterSet setCouldBePostOp(CharacterSet::setNone, "+-");
+    static constexpr CharacterSet setMacroStart(CharacterSet::setNone, "%");
+    static constexpr CharacterSet setWordStart(CharacterSet::setAlpha, "_", 0x80, true);
+    static constexpr CharacterSet setWord(CharacterSet::setAlphaNum, "._", 0x80, true);
 
     StyleContext sc(startPos, length, initStyle, styler);
     bool lineHasNonCommentChar = false;
@@ -22,6 +22,7 @@
 #include "ILexer.h"
 #include "Scintilla.h"
 #include "SciLexer.h"
+#include "LexillaExtensions.h"
 
 #include "WordList.h"
 #include "LexAccessor.h"
@@ -31,6 +32,7 @@
 #include "LexerModule.h"
 #include "OptionSet.h"
 #include "SparseState.h"
+#include "MemoryUse.h"
 #include "DefaultLexer.h"
 
 using namespace Scintilla;
@@ -64,6 +66,13 @@ bool IsANumberChar(int ch, int chPrev) noexcept {
 	        ch == '.' || ((ch == '-' || ch == '+') && chPrev < 0x80 && toupper(chPrev) == 'E'));
 }
 
+// Characters that may have an effect in comments and strings, other characters are skipped
+// in bulk by ForwardUntilAny. Plain comments skip to their end with ForwardUntilMatch.
+constexpr CharacterSet setStopCommentDoc("*@\\");
+constexpr CharacterSet setStopCommentLine;
+constexpr CharacterSet setStopCharacter("'\\");
+constexpr CharacterSet setStopString("\"\\");
+
 typedef unsigned int sql_state_t;
 
 class SQLStates {
@@ -222,6 +231,10 @@ public :
 
 	SQLStates() {}
 
+	size_t HeapBytes() const noexcept {
+		return Lexilla::HeapBytes(sqlStatement);
+	}
+
 private :
 	SparseState <sql_state_t> sqlStatement;
 	enum {
@@ -351,8 +364,10 @@ public :
 	void SCI_METHOD Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) override;
 	void SCI_METHOD Fold(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) override;
 
-	void * SCI_METHOD PrivateCall(int, void *) override {
-		return 0;
+	bool ReportMemory(LexerMemoryUse &use) const override {
+		use.total = sizeof(*this);
+		use.Add("sqlStates", sqlStates.HeapBytes());
+		return true;
 	}
 
 	static ILexer5 *LexerFactorySQL() {
@@ -464,17 +479,16 @@ void SCI_METHOD LexerSQL::Lex(Sci_PositionU startPos, Sci_Position length, int i
 		case SCE_SQL_IDENTIFIER:
 			if (!IsAWordChar(sc.ch, options.sqlAllowDottedWord)) {
 				int nextState = SCE_SQL_DEFAULT;
-				char s[1000];
-				sc.GetCurrentLowered(s, sizeof(s));
+				const std::string_view s = sc.GetCurrentView(StyleContext::Transform::lower);
 				if (keywords1.InList(s)) {
 					sc.ChangeState(SCE_SQL_WORD);
 				} else if (keywords2.InList(s)) {
 					sc.ChangeState(SCE_SQL_WORD2);
 				} else if (kw_sqlplus.InListAbbreviated(s, '~')) {
 					sc.ChangeState(SCE_SQL_SQLPLUS);
-					if (strncmp(s, "rem", 3) == 0) {
+					if (s.rfind("rem", 0) == 0) {
 						nextState = SCE_SQL_SQLPLUS_COMMENT;
-					} else if (strncmp(s, "pro", 3) == 0) {
+					} else if (s.rfind("pro", 0) == 0) {
 						nextState = SCE_SQL_SQLPLUS_PROMPT;
 					}
 				} else if (kw_user1.InList(s)) {
@@ -502,6 +516,8 @@ void SCI_METHOD LexerSQL::Lex(Sci_PositionU startPos, Sci_Position length, int i
 			if (sc.Match('*', '/')) {
 				sc.Forward();
 				sc.ForwardSetState(SCE_SQL_DEFAULT);
+			} else {
+				sc.ForwardUntilMatch("*/");
 			}
 			break;
 		case SCE_SQL_COMMENTDOC:
@@ -514,6 +530,8 @@ void SCI_METHOD LexerSQL::Lex(Sci_PositionU startPos, Sci_Position length, int i
 					styleBeforeDCKeyword = SCE_SQL_COMMENTDOC;
 					sc.SetState(SCE_SQL_COMMENTDOCKEYWORD);
 				}
+			} else {
+				sc.ForwardUntilAny(setStopCommentDoc);
 			}
 			break;
 		case SCE_SQL_COMMENTLINE:
@@ -522,6 +540,8 @@ void SCI_METHOD LexerSQL::Lex(Sci_PositionU startPos, Sci_Position length, int i
 		case SCE_SQL_SQLPLUS_PROMPT:
 			if (sc.atLineStart) {
 				sc.SetState(SCE_SQL_DEFAULT);
+			} else {
+				sc.ForwardUntilAny(setStopCommentLine);
 			}
 			break;
 		case SCE_SQL_COMMENTDOCKEYWORD:
@@ -530,9 +550,8 @@ void SCI_METHOD LexerSQL::Lex(Sci_PositionU startPos, Sci_Position length, int i
 				sc.Forward();
 				sc.ForwardSetState(SCE_SQL_DEFAULT);
 			} else if (!IsADoxygenChar(sc.ch)) {
-				char s[100];
-				sc.GetCurrentLowered(s, sizeof(s));
-				if (!isspace(sc.ch) || !kw_pldoc.InList(s + 1)) {
+				const std::string_view s = sc.GetCurrentView(StyleContext::Transform::lower);
+				if (!isspace(sc.ch) || !kw_pldoc.InList(s.substr(1))) {
 					sc.ChangeState(SCE_SQL_COMMENTDOCKEYWORDERROR);
 				}
 				sc.SetState(styleBeforeDCKeyword);
@@ -547,6 +566,8 @@ void SCI_METHOD LexerSQL::Lex(Sci_PositionU startPos, Sci_Position length, int i
 				} else {
 					sc.ForwardSetState(SCE_SQL_DEFAULT);
 				}
+			} else {
+				sc.ForwardUntilAny(setStopCharacter);
 			}
 			break;
 		case SCE_SQL_STRING:
@@ -559,6 +580,8 @@ void SCI_METHOD LexerSQL::Lex(Sci_PositionU startPos, Sci_Position length, int i
 				} else {
 					sc.ForwardSetState(SCE_SQL_DEFAULT);
 				}
+			} else {
+				sc.ForwardUntilAny(setStopString);
 			}
 			break;
 		case SCE_SQL_QOPERATOR:
@@ -643,13 +666,22 @@ void SCI_METHOD LexerSQL::Fold(Sci_PositionU startPos, Sci_Position length, int
 
 	if (lineCurrent > 0) {
 		// Backtrack to previous line in case need to fix its fold status for folding block of single-line comments (i.e. '--').
+		const Sci_Position linePrevious = lineCurrent - 1;
 		Sci_Position lastNLPos = -1;
 		// And keep going back until we find an operator ';' followed
 		// by white-space and/or comments. This will improve folding.
+		// Also stop at an earlier line that starts outside any fold as the statement state of
+		// each line is kept so text without ';' is not folded again from the document start.
 		while (--startPos > 0) {
 			const char ch = styler[startPos];
 			if (ch == '\n' || (ch == '\r' && styler[startPos + 1] != '\n')) {
 				lastNLPos = startPos;
+				const Sci_Position lineAfter = styler.GetLine(startPos + 1);
+				if (lineAfter < linePrevious &&
+					FoldLevelStart(styler.LevelAt(lineAfter - 1)) == SC_FOLDLEVELBASE) {
+					startPos = lastNLPos + 1;
+					break;
+				}
 			} else if (ch == ';' &&
 				   styler.StyleAt(startPos) == SCE_SQL_OPERATOR) {
 				bool isAllClear = true;
@@ -66,10 +66,10 @@ static void ColouriseSTTXTDoc (Sci_PositionU startPos, Sci_Position length, int
 {
 	StyleContext sc(startPos, length, initStyle, styler);
 
-	CharacterSet setWord(CharacterSet::setAlphaNum, "_", 0x80, true);
-	CharacterSet setWordStart(CharacterSet::setAlpha, "_", 0x80, true);
-	CharacterSet setNumber(CharacterSet::setDigits, "_.eE");
-	CharacterSet setHexNumber(CharacterSet::setDigits, "_abcdefABCDEF");
+	static constexpr CharacterSet setWord(CharacterSet::setAlphaNum, "_", 0x80, true);
+	static constexpr CharacterSet setWordStart(CharacterSet::setAlpha, "_", 0x80, true);
+	static constexpr CharacterSet setNumber(CharacterSet::setDigits, "_.eE");
+	static constexpr CharacterSet setHexNumber(CharacterSet::setDigits, "_abcdefABCDEF");
 	CharacterSet setOperator(CharacterSet::setNone,",.+-*/:;<=>[]()%&");
 	CharacterSet setDataTime(CharacterSet::setDigits,"_.-:dmshDMSH");
 
@@ -337,7 +337,7 @@ static void FoldSTTXTDoc(Sci_PositionU startPos, Sci_Position length, int initSt
 	int style = initStyle;
 	Sci_Position lastStart = 0;
 
-	CharacterSet setWord(CharacterSet::setAlphaNum, "_", 0x80, true);
+	static constexpr CharacterSet setWord(CharacterSet::setAlphaNum, "_", 0x80, true);
 
 	for (Sci_PositionU i = startPos; i < endPos; i++)
 	{
@@ -41,9 +41,9 @@ static void ColouriseStataDoc(Sci_PositionU startPos, Sci_Position length, int i
     WordList &keywords = *keywordlists[0];
     WordList &types = *keywordlists[1];
     
-    CharacterSet setCouldBePostOp(CharacterSet::setNone, "+-");
-    CharacterSet setWordStart(CharacterSet::setAlpha, "_", 0x80, true);
-    CharacterSet setWord(CharacterSet::setAlphaNum, "._", 0x80, true);
+    static constexpr CharacterSet setCouldBePostOp(CharacterSet::setNone, "+-");
+    static constexpr CharacterSet setWordStart(CharacterSet::setAlpha, "_", 0x80, true);
+    static constexpr CharacterSet setWord(CharacterSet::setAlphaNum, "._", 0x80, true);
 
     StyleContext sc(startPos, length, initStyle, styler);
     bool lineHasNonCommentChar = false;
@@ -30,6 +30,7 @@
 #include "Scintilla.h"
 #include "SciLexer.h"
 
+#include "PropSetSimple.h"
 #include "WordList.h"
 #include "LexAccessor.h"
 #include "Accessor.h"
@@ -39,6 +40,13 @@
 
 using namespace Lexilla;
 
+static const PropertyKey propTexCommentProcess("lexer.tex.comment.process");
+static const PropertyKey propTexUseKeywords("lexer.tex.use.keywords");
+static const PropertyKey propTexAutoIf("lexer.tex.auto.if");
+static const PropertyKey propTexInterfaceDefault("lexer.tex.interface.default");
+static const PropertyKey propFoldCompact("fold.compact");
+static const PropertyKey propFoldComment("fold.comment");
+
 // val SCE_TEX_DEFAULT = 0
 // val SCE_TEX_SPECIAL = 1
 // val SCE_TEX_GROUP   = 2
@@ -180,10 +188,10 @@ static void ColouriseTeXDoc(
 	styler.StartAt(startPos) ;
 	styler.StartSegment(startPos) ;
 
-	bool processComment   = styler.GetPropertyInt("lexer.tex.comment.process",   0) == 1 ;
-	bool useKeywords      = styler.GetPropertyInt("lexer.tex.use.keywords",      1) == 1 ;
-	bool autoIf           = styler.GetPropertyInt("lexer.tex.auto.if",           1) == 1 ;
-	int  defaultInterface = styler.GetPropertyInt("lexer.tex.interface.default", 1) ;
+	bool processComment   = styler.GetPropertyInt(propTexCommentProcess,   0) == 1 ;
+	bool useKeywords      = styler.GetPropertyInt(propTexUseKeywords,      1) == 1 ;
+	bool autoIf           = styler.GetPropertyInt(propTexAutoIf,           1) == 1 ;
+	int  defaultInterface = styler.GetPropertyInt(propTexInterfaceDefault, 1) ;
 
 	char key[100] ;
 	int  k ;
@@ -383,7 +391,7 @@ static bool IsTeXCommentLine(Sci_Position line, Accessor &styler) {
 
 static void FoldTexDoc(Sci_PositionU startPos, Sci_Position length, int, WordList *[], Accessor &styler)
 {
-	bool foldCompact = styler.GetPropertyInt("fold.compact", 1) != 0;
+	bool foldCompact = styler.GetPropertyInt(propFoldCompact, 1) != 0;
 	Sci_PositionU endPos = startPos+length;
 	int visibleChars=0;
 	Sci_Position lineCurrent=styler.GetLine(startPos);
@@ -440,7 +448,7 @@ static void FoldTexDoc(Sci_PositionU startPos, Sci_Position length, int, WordLis
 		levelCurrent-=1;
 	}
 
-	bool foldComment = styler.GetPropertyInt("fold.comment") != 0;
+	bool foldComment = styler.GetPropertyInt(propFoldComment) != 0;
 
 	if (foldComment && atEOL && IsTeXCommentLine(lineCurrent, styler))
         {
@@ -830,8 +830,10 @@ static void FoldTroffDoc(Sci_PositionU startPos, Sci_Position length, int,
 			if (endmacBlocks.InList(requestName.substr(1))) {
 				// beginning of block
 				levelCurrent++;
-			} else {
+			} else if (levelCurrent > SC_FOLDLEVELBASE) {
 				// potential end of block
+				// Only inside a block: at the base level the search back would reach
+				// the start of the document for every request, making folding quadratic.
 				// This parsing could be avoided if we kept a list
 				// line numbers and end-mac strings.
 				// The parsing here could also be simplified if
@@ -841,12 +843,14 @@ static void FoldTroffDoc(Sci_PositionU startPos, Sci_Position length, int,
 					endmac.clear();
 				}
 
-				// find start of block
+				// find start of block: the request on the line before the lines inside it
+				// with only the level number compared so white lines do not extend the block
 				Sci_Position startLine = lineCurrent;
-				while (startLine > 0 && styler.LevelAt(startLine-1) >= levelCurrent) {
+				while (startLine > 0 && (styler.LevelAt(startLine-1) & SC_FOLDLEVELNUMBERMASK) >= levelCurrent) {
 					startLine--;
 				}
-				if (startLine) {
+				startLine--;
+				if (startLine > 0) {
 					Sci_Position startEndmac = styler.LineStart(startLine);
 					int reqStyle;
 					// skip the request/command name
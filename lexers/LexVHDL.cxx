@@ -24,6 +24,7 @@
 #include "Scintilla.h"
 #include "SciLexer.h"
 
+#include "PropSetSimple.h"
 #include "WordList.h"
 #include "LexAccessor.h"
 #include "Accessor.h"
@@ -35,6 +36,12 @@ using namespace Lexilla;
 
 namespace {
 
+const PropertyKey propFoldComment("fold.comment");
+const PropertyKey propFoldCompact("fold.compact");
+const PropertyKey propFoldAtElse("fold.at.else");
+const PropertyKey propFoldAtBegin("fold.at.Begin");
+const PropertyKey propFoldAtParenthese("fold.at.Parenthese");
+
 static void ColouriseVHDLDoc(
   Sci_PositionU startPos,
   Sci_Position length,
@@ -242,11 +249,11 @@ void FoldNoBoxVHDLDoc(
   WordList keywords;
   keywords.Set(words);
 
-  bool foldComment      = styler.GetPropertyInt("fold.comment", 1) != 0;
-  bool foldCompact      = styler.GetPropertyInt("fold.compact", 1) != 0;
-  bool foldAtElse       = styler.GetPropertyInt("fold.at.else", 1) != 0;
-  bool foldAtBegin      = styler.GetPropertyInt("fold.at.Begin", 1) != 0;
-  bool foldAtParenthese = styler.GetPropertyInt("fold.at.Parenthese", 1) != 0;
+  bool foldComment      = styler.GetPropertyInt(propFoldComment, 1) != 0;
+  bool foldCompact      = styler.GetPropertyInt(propFoldCompact, 1) != 0;
+  bool foldAtElse       = styler.GetPropertyInt(propFoldAtElse, 1) != 0;
+  bool foldAtBegin      = styler.GetPropertyInt(propFoldAtBegin, 1) != 0;
+  bool foldAtParenthese = styler.GetPropertyInt(propFoldAtParenthese, 1) != 0;
   //bool foldAtWhen       = styler.GetPropertyInt("fold.at.When", 1) != 0;  //< fold at when in case statements
 
   int  visibleChars     = 0;
@@ -23,6 +23,7 @@
 #include "ILexer.h"
 #include "Scintilla.h"
 #include "SciLexer.h"
+#include "LexillaExtensions.h"
 
 #include "WordList.h"
 #include "LexAccessor.h"
@@ -32,6 +33,7 @@
 #include "LexerModule.h"
 
 #include "OptionSet.h"
+#include "MemoryUse.h"
 #include "SubStyles.h"
 #include "DefaultLexer.h"
 
@@ -52,6 +54,10 @@ struct PPDefinition {
 	}
 };
 
+size_t HeapBytes(const PPDefinition &definition) noexcept {
+	return Lexilla::HeapBytes(definition.key) + Lexilla::HeapBytes(definition.value) + Lexilla::HeapBytes(definition.arguments);
+}
+
 class LinePPState {
 	int state;
 	int ifTaken;
@@ -118,6 +124,9 @@ public:
 		vlls.resize(line+1);
 		vlls[line] = lls;
 	}
+	size_t HeapBytes() const noexcept {
+		return Lexilla::HeapBytes(vlls);
+	}
 };
 
 // Options used for LexerVerilog
@@ -249,8 +258,12 @@ public:
 	Sci_Position SCI_METHOD WordListSet(int n, const char* wl) override;
 	void SCI_METHOD Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) override;
 	void SCI_METHOD Fold(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument *pAccess) override;
-	void* SCI_METHOD PrivateCall(int, void*) override {
-		return 0;
+	bool ReportMemory(LexerMemoryUse &use) const override {
+		use.total = sizeof(*this);
+		use.Add("vlls", vlls.HeapBytes());
+		use.Add("ppDefineHistory", Lexilla::HeapBytes(ppDefineHistory));
+		use.Add("foldState", Lexilla::HeapBytes(foldState));
+		return true;
 	}
 	int SCI_METHOD LineEndTypesSupported() override {
 		return SC_LINE_END_TYPE_UNICODE;
@@ -454,6 +467,7 @@ void SCI_METHOD LexerVerilog::Lex(Sci_PositionU startPos, Sci_Position length, i
 	Sci_Position lineEndNext = styler.LineEnd(curLine);
 	bool isEscapedId = false;    // true when parsing an escaped Identifier
 	bool isProtected = (lineState&kwProtected) != 0;	// true when parsing a protected region
+	int commentState = SCE_V_COMMENT;	// comment style to return to after a comment keyword
 
 	for (; sc.More(); sc.Forward()) {
 		if (sc.atLineStart) {
@@ -501,7 +515,7 @@ void SCI_METHOD LexerVerilog::Lex(Sci_PositionU startPos, Sci_Position length, i
 		// for comment keyword
 		if (MaskActive(sc.state) == SCE_V_COMMENT_WORD && !IsAWordChar(sc.ch)) {
 			char s[100];
-			int state = lineState & 0xff;
+			const int state = commentState;
 			sc.GetCurrent(s, sizeof(s));
 			if (keywords5.InList(s)) {
 				sc.ChangeState(SCE_V_COMMENT_WORD|activitySet);
@@ -571,7 +585,7 @@ void SCI_METHOD LexerVerilog::Lex(Sci_PositionU startPos, Sci_Position length, i
 					sc.Forward();
 					sc.ForwardSetState(SCE_V_DEFAULT|activitySet);
 				} else if (IsAWordStart(sc.ch)) {
-					lineState = sc.state | (lineState & 0xff00);
+					commentState = sc.state;
 					sc.SetState(SCE_V_COMMENT_WORD|activitySet);
 				}
 				break;
@@ -580,7 +594,7 @@ void SCI_METHOD LexerVerilog::Lex(Sci_PositionU startPos, Sci_Position length, i
 				if (sc.atLineStart) {
 					sc.SetState(SCE_V_DEFAULT|activitySet);
 				} else if (IsAWordStart(sc.ch)) {
-					lineState = sc.state | (lineState & 0xff00);
+					commentState = sc.state;
 					sc.SetState(SCE_V_COMMENT_WORD|activitySet);
 				}
 				break;
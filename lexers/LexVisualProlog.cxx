@@ -352,8 +352,8 @@ public:
 
 void SCI_METHOD LexerVisualProlog::Lex(Sci_PositionU startPos, Sci_Position length, int initStyle, IDocument* pAccess) {
     LexAccessor styler(pAccess);
-    CharacterSet setDoxygen(CharacterSet::setAlpha, "");
-    CharacterSet setNumber(CharacterSet::setNone, "0123456789abcdefABCDEFxoXO_");
+    static constexpr CharacterSet setDoxygen(CharacterSet::setAlpha, "");
+    static constexpr CharacterSet setNumber(CharacterSet::setNone, "0123456789abcdefABCDEFxoXO_");
 
     StyleContext sc(startPos, length, initStyle, styler, 0x7f);
 
@@ -99,6 +99,7 @@ protected:
 	};
 	Terminator InitialiseFromISA(IDocument *pAccess);
 	Sci_PositionU FindPreviousSegmentStart(IDocument *pAccess, Sci_Position startPos) const;
+	Sci_PositionU FindNextSegmentStart(IDocument *pAccess, Sci_PositionU pos) const;
 	Terminator DetectSegmentHeader(IDocument *pAccess, Sci_PositionU pos) const;
 	Terminator FindNextTerminator(IDocument *pAccess, Sci_PositionU pos, bool bJustSegmentTerminator = false) const;
 
@@ -148,7 +149,13 @@ void LexerX12::Lex(Sci_PositionU startPos, Sci_Position length, int, IDocument *
 		// Look for first element marker, so we can denote segment
 		T = DetectSegmentHeader(pAccess, posCurrent);
 		if (T.Style == SCE_X12_BAD)
-			break;
+		{
+			// Only this segment is bad, so lexing from any segment start gives the same result
+			const Sci_PositionU posNext = FindNextSegmentStart(pAccess, posCurrent);
+			pAccess->SetStyleFor(posNext - posCurrent, SCE_X12_BAD);
+			posCurrent = posNext;
+			continue;
+		}
 
 		pAccess->SetStyleFor(T.pos - posCurrent, T.Style);
 		pAccess->SetStyleFor(T.length, SCE_X12_SEP_ELEMENT);
@@ -167,10 +174,15 @@ void LexerX12::Lex(Sci_PositionU startPos, Sci_Position length, int, IDocument *
 			posCurrent = T.pos + T.length;
 		}
 		if (T.Style == SCE_X12_BAD)
-			break;
+		{
+			const Sci_PositionU posNext = FindNextSegmentStart(pAccess, posCurrent);
+			pAccess->SetStyleFor(posNext - posCurrent, SCE_X12_BAD);
+			posCurrent = posNext;
+		}
 	}
 
-	pAccess->SetStyleFor(posFinish - posCurrent, SCE_X12_BAD);
+	if (posCurrent < posFinish)
+		pAccess->SetStyleFor(posFinish - posCurrent, SCE_X12_BAD);
 }
 
 void LexerX12::Fold(Sci_PositionU startPos, Sci_Position length, int, IDocument *pAccess)
@@ -302,21 +314,40 @@ Sci_PositionU LexerX12::FindPreviousSegmentStart(IDocument *pAccess, Sci_Positio
 	std::string bufTest = m_SeparatorSegment + m_LineFeed; // quick way of making the lengths the same
 	std::string bufCompare = bufTest;
 
-	for (; startPos > 0; startPos--)
+	// Look for a terminator that ends at or before startPos, so startPos may itself be a segment start
+	for (Sci_Position pos = startPos - static_cast<Sci_Position>(bufTest.size()); pos > 0; pos--)
 	{
-		if (startPos + bufTest.size() > length)
+		if (pos + bufTest.size() > length)
 			continue;
 
-		pAccess->GetCharRange(&bufTest.at(0), startPos, bufTest.size());
+		pAccess->GetCharRange(&bufTest.at(0), pos, bufTest.size());
 		if (bufTest == bufCompare)
 		{
-			return startPos + bufTest.size();
+			return pos + bufTest.size();
 		}
 	}
 	// We didn't find a ', so just go with the beginning
 	return 0;
 }
 
+Sci_PositionU LexerX12::FindNextSegmentStart(IDocument *pAccess, Sci_PositionU pos) const
+{
+	Sci_PositionU length = pAccess->Length();
+	std::string bufTest = m_SeparatorSegment + m_LineFeed;
+	std::string bufCompare = bufTest;
+
+	for (; pos + bufTest.size() <= length; pos++)
+	{
+		pAccess->GetCharRange(&bufTest.at(0), pos, bufTest.size());
+		if (bufTest == bufCompare)
+		{
+			return pos + bufTest.size();
+		}
+	}
+	// No more segments
+	return length;
+}
+
 LexerX12::Terminator LexerX12::DetectSegmentHeader(IDocument *pAccess, Sci_PositionU pos) const
 {
 	Sci_PositionU Length = pAccess->Length();
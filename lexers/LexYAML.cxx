@@ -14,10 +14,12 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "ILexer.h"
 #include "Scintilla.h"
 #include "SciLexer.h"
+#include "LexillaExtensions.h"
 
 #include "WordList.h"
 #include "LexAccessor.h"
@@ -25,6 +27,7 @@
 #include "StyleContext.h"
 #include "CharacterSet.h"
 #include "LexerModule.h"
+#include "LineStyleCache.h"
 
 using namespace Lexilla;
 
@@ -228,7 +231,19 @@ void ColouriseYAMLDoc(Sci_PositionU startPos, Sci_Position length, int, WordList
 		lineBuffer.push_back(styler[i]);
 		if (AtEOL(styler, i)) {
 			// End of line (or of line buffer) met, colourise it
-			ColouriseYAMLLine(lineBuffer.data(), lineCurrent, lineBuffer.length(), startLine, i, *keywordLists[0], styler);
+			if (styler.lineStyleCache) {
+				// Styles depend on the state of the line before when it starts a text block
+				const int stateBefore = (lineCurrent > 0) ? styler.GetLineState(lineCurrent - 1) : 0;
+				const int state = StyleLine(styler.lineStyleCache, styler, startLine, i, lineBuffer, stateBefore, [&]() {
+					// ColouriseYAMLLine modifies its buffer so lex a copy as lineBuffer is the key
+					std::string lineCopy = lineBuffer;
+					ColouriseYAMLLine(lineCopy.data(), lineCurrent, lineCopy.length(), startLine, i, *keywordLists[0], styler);
+					return styler.GetLineState(lineCurrent);
+				});
+				styler.SetLineState(lineCurrent, state);
+			} else {
+				ColouriseYAMLLine(lineBuffer.data(), lineCurrent, lineBuffer.length(), startLine, i, *keywordLists[0], styler);
+			}
 			lineBuffer.clear();
 			startLine = i + 1;
 			lineCurrent++;
@@ -22,13 +22,17 @@
 
 using namespace Lexilla;
 
-Accessor::Accessor(Scintilla::IDocument *pAccess_, PropSetSimple *pprops_) : LexAccessor(pAccess_), pprops(pprops_) {
+Accessor::Accessor(Scintilla::IDocument *pAccess_, PropSetSimple *pprops_) : LexAccessor(pAccess_), pprops(pprops_), lineStyleCache(nullptr) {
 }
 
 int Accessor::GetPropertyInt(std::string_view key, int defaultValue) const {
 	return pprops->GetInt(key, defaultValue);
 }
 
+int Accessor::GetPropertyInt(const PropertyKey &key, int defaultValue) const {
+	return pprops->GetInt(key, defaultValue);
+}
+
 int Accessor::IndentAmount(Sci_Position line, int *flags, PFNIsCommentLeader pfnIsCommentLeader) {
 	const Sci_Position end = Length();
 	int spaceFlags = 0;
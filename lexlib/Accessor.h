@@ -15,14 +15,19 @@ enum { wsSpace=1, wsTab=2, wsSpaceTab=4, wsInconsistent=8 };
 class Accessor;
 class WordList;
 class PropSetSimple;
+class PropertyKey;
+class LineStyleCache;
 
 typedef bool (*PFNIsCommentLeader)(Accessor &styler, Sci_Position pos, Sci_Position len);
 
 class Accessor : public LexAccessor {
 public:
 	PropSetSimple *pprops;
+	// Set by the lexer for lexing functions that can replay the styles of repeated lines
+	LineStyleCache *lineStyleCache;
 	Accessor(Scintilla::IDocument *pAccess_, PropSetSimple *pprops_);
 	int GetPropertyInt(std::string_view key, int defaultValue=0) const;
+	int GetPropertyInt(const PropertyKey &key, int defaultValue=0) const;
 	int IndentAmount(Sci_Position line, int *flags, PFNIsCommentLeader pfnIsCommentLeader = nullptr);
 };
 
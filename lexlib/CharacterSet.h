@@ -10,12 +10,36 @@
 
 namespace Lexilla {
 
+// Can be constexpr so sets that do not depend on options are built at compile time.
 template<int N>
 class CharacterSetArray {
+public:
+	// Most byte values listed by Members for vector code to compare against.
+	static constexpr int maxMembers = 16;
+private:
 	static constexpr int bitsPerChar = 8;
 	static constexpr int mask3Bits = 7;
-	unsigned char bset[((N-1)/bitsPerChar) + 1] = {};
+	// At least one bit for every byte value so that Contains(char) is a lookup without branches.
+	// Values from N to bitsStored are set to valueAfter.
+	static constexpr int bitsStored = (N > 0x100) ? N : 0x100;
+	unsigned char bset[((bitsStored-1)/bitsPerChar) + 1] = {};
 	bool valueAfter = false;
+	// The first members added so that vector code can compare bytes against each of them
+	// when there are no more than maxMembers.
+	unsigned char members[maxMembers] = {};
+	int memberCount = 0;
+	constexpr void SetBit(int val) noexcept {
+		if (!(bset[val >> 3] & (1 << (val & mask3Bits)))) {
+			if (val > 0xFF) {
+				// Not a byte so cannot be compared
+				memberCount = maxMembers;
+			} else if (memberCount < maxMembers) {
+				members[memberCount] = static_cast<unsigned char>(val);
+			}
+			memberCount++;
+		}
+		bset[val >> 3] |= 1 << (val & mask3Bits);
+	}
 public:
 	enum setBase {
 		setNone=0,
@@ -25,7 +49,7 @@ public:
 		setAlpha=setLower|setUpper,
 		setAlphaNum=setAlpha|setDigits
 	};
-	explicit CharacterSetArray(setBase base=setNone, const char *initialSet="", bool valueAfter_=false) noexcept {
+	constexpr explicit CharacterSetArray(setBase base=setNone, const char *initialSet="", bool valueAfter_=false) noexcept {
 		valueAfter = valueAfter_;
 		AddString(initialSet);
 		if (base & setLower)
@@ -34,37 +58,50 @@ public:
 			AddString("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
 		if (base & setDigits)
 			AddString("0123456789");
+		if (valueAfter) {
+			for (int val = N; val < bitsStored; val++) {
+				SetBit(val);
+			}
+		}
 	}
-	explicit CharacterSetArray(const char *initialSet, bool valueAfter_=false) noexcept :
+	constexpr explicit CharacterSetArray(const char *initialSet, bool valueAfter_=false) noexcept :
 		CharacterSetArray(setNone, initialSet, valueAfter_) {
 	}
 	// For compatibility with previous version but should not be used in new code.
-	CharacterSetArray(setBase base, const char *initialSet, [[maybe_unused]]int size_, bool valueAfter_=false) noexcept :
+	constexpr CharacterSetArray(setBase base, const char *initialSet, [[maybe_unused]]int size_, bool valueAfter_=false) noexcept :
 		CharacterSetArray(base, initialSet, valueAfter_) {
 		assert(size_ == N);
 	}
-	void Add(int val) noexcept {
+	constexpr void Add(int val) noexcept {
 		assert(val >= 0);
 		assert(val < N);
-		bset[val >> 3] |= 1 << (val & mask3Bits);
+		SetBit(val);
 	}
-	void AddString(const char *setToAdd) noexcept {
+	constexpr void AddString(const char *setToAdd) noexcept {
 		for (const char *cp=setToAdd; *cp; cp++) {
 			const unsigned char uch = *cp;
 			assert(uch < N);
 			Add(uch);
 		}
 	}
-	[[nodiscard]] bool Contains(int val) const noexcept {
+	[[nodiscard]] constexpr bool Contains(int val) const noexcept {
 		assert(val >= 0);
 		if (val < 0) return false;
-		if (val >= N) return valueAfter;
+		if (val >= bitsStored) return valueAfter;
 		return bset[val >> 3] & (1 << (val & mask3Bits));
 	}
-	[[nodiscard]] bool Contains(char ch) const noexcept {
+	[[nodiscard]] constexpr bool Contains(char ch) const noexcept {
 		// Overload char as char may be signed
 		const unsigned char uch = ch;
-		return Contains(uch);
+		return bset[uch >> 3] & (1 << (uch & mask3Bits));
+	}
+	// Number of byte values in the set which may be more than maxMembers.
+	[[nodiscard]] constexpr int MemberCount() const noexcept {
+		return memberCount;
+	}
+	// Byte values in the set in the order added, valid when MemberCount() <= maxMembers.
+	[[nodiscard]] constexpr const unsigned char *Members() const noexcept {
+		return members;
 	}
 };
 
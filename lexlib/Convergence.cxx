@@ -0,0 +1,183 @@
+// Lexilla lexer library
+/** @file Convergence.cxx
+ ** Lex in chunks of lines: after a change only until the lexer's state matches the state
+ ** from the previous lex, or until a budget is spent.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cassert>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+#include "ILexer.h"
+
+#include "LexillaExtensions.h"
+
+#include "LexAccessor.h"
+#include "Convergence.h"
+
+using namespace Lexilla;
+
+namespace {
+
+// The state at the end of a line that is stored in the document.
+struct LineEnd {
+	int lineState;
+	char style;
+	int level;
+};
+
+// Lines in the first chunk after the changed lines: later chunks double in size.
+constexpr Sci_Position linesFirstChunk = 4;
+
+// Bytes in each chunk of budgeted lexing between checks of the time spent.
+constexpr Sci_Position bytesBudgetChunk = 0x4000;
+
+}
+
+Sci_Position Convergence::LinesBehind() const noexcept {
+	return 0;
+}
+
+void Convergence::SaveLexerState(Sci_Position) {
+}
+
+bool Convergence::ConvergedAfter(Scintilla::IDocument *, Sci_Position, Sci_Position) {
+	return true;
+}
+
+void Convergence::RestoreLexerState(Sci_Position, Sci_Position) {
+}
+
+void *Lexilla::LexConverging(Scintilla::ILexer5 *lexer, Convergence &convergence, void *pointer) {
+	LexConvergingArguments *args = static_cast<LexConvergingArguments *>(pointer);
+	if (!args || !args->pAccess) {
+		return nullptr;
+	}
+	Scintilla::IDocument *pAccess = args->pAccess;
+	const Sci_Position startPos = args->startPos;
+	const Sci_Position endPos = startPos + args->lengthDoc;
+	const Sci_Position lineFirst = pAccess->LineFromPosition(startPos);
+	const Sci_Position lineLast = pAccess->LineFromPosition(pAccess->Length());
+	// Lines after the change were not altered so their stored state can be compared
+	const Sci_Position lineUnchanged = std::max(pAccess->LineFromPosition(args->changedEnd) + 1, lineFirst);
+	args->lineConverged = -1;
+	args->endLexed = startPos;
+
+	if (ReferenceMode()) {
+		// Lex and fold the whole range as Lex and Fold would
+		lexer->Lex(startPos, args->lengthDoc, args->initStyle, pAccess);
+		if (args->fold) {
+			lexer->Fold(startPos, args->lengthDoc, args->initStyle, pAccess);
+		}
+		args->endLexed = endPos;
+		return args;
+	}
+
+	convergence.SaveLexerState(lineFirst);
+
+	// State of each line from lineFirst before it was relexed
+	std::vector<LineEnd> previous;
+	Sci_Position chunkStart = startPos;
+	Sci_Position lineChunk = lineFirst;
+	Sci_Position linesChunk = lineUnchanged - lineFirst + convergence.LinesBehind() + linesFirstChunk;
+	Sci_Position lineTest = lineUnchanged;
+	Sci_Position linesMatched = 0;
+	int initStyle = args->initStyle;
+	while (chunkStart < endPos) {
+		const Sci_Position lineChunkEnd = std::min(lineChunk + linesChunk, lineLast + 1);
+		const Sci_Position chunkEnd = std::min(pAccess->LineStart(lineChunkEnd), endPos);
+		// The line after the chunk is included as some lexers set the state of the next line
+		for (Sci_Position line = lineFirst + previous.size(); line <= lineChunkEnd; line++) {
+			const Sci_Position lineEndPosition = pAccess->LineStart(line + 1) - 1;
+			// Levels are only compared for lines in the document
+			const int level = (line <= lineLast) ? pAccess->GetLevel(line) : 0;
+			previous.push_back({ pAccess->GetLineState(line), pAccess->StyleAt(lineEndPosition), level });
+		}
+
+		lexer->Lex(chunkStart, chunkEnd - chunkStart, initStyle, pAccess);
+		if (args->fold) {
+			// Consumes the record of a fold during lex so it can not skip a later Fold
+			lexer->Fold(chunkStart, chunkEnd - chunkStart, initStyle, pAccess);
+		}
+		args->endLexed = chunkEnd;
+
+		// A line can be tested once the following line has been completely lexed
+		const Sci_Position lineTestEnd = pAccess->LineFromPosition(chunkEnd) - 1;
+		for (; lineTest < lineTestEnd; lineTest++) {
+			const LineEnd &before = previous[lineTest - lineFirst];
+			const LineEnd &beforeNext = previous[lineTest + 1 - lineFirst];
+			const Sci_Position lineEndPosition = pAccess->LineStart(lineTest + 1) - 1;
+			const bool same = (pAccess->GetLineState(lineTest) == before.lineState) &&
+				(pAccess->GetLineState(lineTest + 1) == beforeNext.lineState) &&
+				(pAccess->StyleAt(lineEndPosition) == before.style) &&
+				// Folding after this line starts from the level of the next line. Levels are compared even
+				// without args->fold as a lexer folding during lex sets them: otherwise they are unchanged.
+				(pAccess->GetLevel(lineTest) == before.level) &&
+				(pAccess->GetLevel(lineTest + 1) == beforeNext.level) &&
+				convergence.ConvergedAfter(pAccess, lineTest, args->linesInserted);
+			linesMatched = same ? linesMatched + 1 : 0;
+			if (linesMatched > convergence.LinesBehind()) {
+				convergence.RestoreLexerState(lineTest, args->linesInserted);
+				args->lineConverged = lineTest;
+				return args;
+			}
+		}
+
+		if (chunkEnd > 0) {
+			initStyle = static_cast<unsigned char>(pAccess->StyleAt(chunkEnd - 1));
+		}
+		chunkStart = chunkEnd;
+		lineChunk = lineChunkEnd;
+		linesChunk *= 2;
+	}
+	return args;
+}
+
+void *Lexilla::LexBudgeted(Scintilla::ILexer5 *lexer, void *pointer) {
+	LexBudgetArguments *args = static_cast<LexBudgetArguments *>(pointer);
+	if (!args || !args->pAccess) {
+		return nullptr;
+	}
+	Scintilla::IDocument *pAccess = args->pAccess;
+	const Sci_Position startPos = args->startPos;
+	const Sci_Position endPos = startPos + args->lengthDoc;
+	args->endLexed = startPos;
+
+	// Stop at the line start at or before the byte budget but lex at least one line
+	Sci_Position endAllowed = endPos;
+	if ((args->maxBytes > 0) && (startPos + args->maxBytes < endPos)) {
+		const Sci_Position lineFirst = pAccess->LineFromPosition(startPos);
+		const Sci_Position lineBudget = pAccess->LineFromPosition(startPos + args->maxBytes);
+		endAllowed = std::min(pAccess->LineStart(std::max(lineBudget, lineFirst + 1)), endPos);
+	}
+
+	const auto started = std::chrono::steady_clock::now();
+	const std::chrono::milliseconds maxDuration(args->maxMilliseconds);
+	Sci_Position chunkStart = startPos;
+	int initStyle = args->initStyle;
+	while (chunkStart < endAllowed) {
+		Sci_Position chunkEnd = endAllowed;
+		if (chunkStart + bytesBudgetChunk < endAllowed) {
+			chunkEnd = pAccess->LineStart(pAccess->LineFromPosition(chunkStart + bytesBudgetChunk));
+			if (chunkEnd <= chunkStart) {
+				// Inside one long line so lex the whole line
+				chunkEnd = std::min(pAccess->LineStart(pAccess->LineFromPosition(chunkStart) + 1), endAllowed);
+			}
+		}
+
+		lexer->Lex(chunkStart, chunkEnd - chunkStart, initStyle, pAccess);
+		args->endLexed = chunkEnd;
+
+		if ((args->maxMilliseconds > 0) && (std::chrono::steady_clock::now() - started >= maxDuration)) {
+			break;
+		}
+		initStyle = static_cast<unsigned char>(pAccess->StyleAt(chunkEnd - 1));
+		chunkStart = chunkEnd;
+	}
+	return args;
+}
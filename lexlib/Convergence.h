@@ -0,0 +1,40 @@
+// Lexilla lexer library
+/** @file Convergence.h
+ ** Lex in chunks of lines: after a change only until the lexer's state matches the state
+ ** from the previous lex, or until a budget is spent.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef CONVERGENCE_H
+#define CONVERGENCE_H
+
+namespace Lexilla {
+
+// Lexers that support privateCallLexConverging provide an implementation of this.
+// The default methods suit lexers that, when starting at a line, depend only on the style at the
+// end of the previous line and the line states stored in the document.
+class Convergence {
+public:
+	virtual ~Convergence() = default;
+	// Number of lines before a converged line that must also match as the lexer
+	// reads back that far when it starts lexing.
+	[[nodiscard]] virtual Sci_Position LinesBehind() const noexcept;
+	// Remember any state the lexer holds for lines from line onwards.
+	virtual void SaveLexerState(Sci_Position line);
+	// Could lexing start after line without reading back before it and does any state the lexer
+	// holds for line match the saved state that was lineDelta lines earlier?
+	virtual bool ConvergedAfter(Scintilla::IDocument *pAccess, Sci_Position line, Sci_Position lineDelta);
+	// Lexing stopped after line so reinstate the saved state for later lines, moved by lineDelta.
+	virtual void RestoreLexerState(Sci_Position line, Sci_Position lineDelta);
+};
+
+// Perform privateCallLexConverging for lexer by calling Lex over growing chunks of lines.
+void *LexConverging(Scintilla::ILexer5 *lexer, Convergence &convergence, void *pointer);
+
+// Perform privateCallLexBudgeted for lexer by calling Lex over chunks of lines until a budget is spent.
+// Suits lexers that produce the same results when lexing is restarted at any line start.
+void *LexBudgeted(Scintilla::ILexer5 *lexer, void *pointer);
+
+}
+
+#endif
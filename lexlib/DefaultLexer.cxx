@@ -11,11 +11,14 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
 #include <map>
+#include <atomic>
 
 #include "ILexer.h"
 #include "Scintilla.h"
 #include "SciLexer.h"
+#include "LexillaExtensions.h"
 
 #include "PropSetSimple.h"
 #include "WordList.h"
@@ -23,12 +26,21 @@
 #include "Accessor.h"
 #include "LexerModule.h"
 #include "OptionSet.h"
+#include "Convergence.h"
+#include "LineStyleCache.h"
 #include "DefaultLexer.h"
 
 using namespace Lexilla;
 
 static const char styleSubable[] = { 0 };
 
+namespace {
+
+// Set through SetLibraryProperty while lexers may be created on other threads
+std::atomic<bool> foldDuringLexDefault = false;
+
+}
+
 DefaultLexer::DefaultLexer(const char *languageName_, int language_,
 	const LexicalClass *lexClasses_, size_t nClasses_) :
 	languageName(languageName_),
@@ -82,10 +94,87 @@ Sci_Position SCI_METHOD DefaultLexer::WordListSet(int, const char *) {
 void SCI_METHOD DefaultLexer::Fold(Sci_PositionU, Sci_Position, int, Scintilla::IDocument *) {
 }
 
-void * SCI_METHOD DefaultLexer::PrivateCall(int, void *) {
+void * SCI_METHOD DefaultLexer::PrivateCall(int operation, void *pointer) {
+	if ((operation == privateCallLexConverging) && convergence) {
+		LexConvergingArguments *args = static_cast<LexConvergingArguments *>(LexConverging(this, *convergence, pointer));
+		if (args) {
+			foldDuringLex.FoldedConverging(args->startPos, args->endLexed, args->pAccess);
+		}
+		return args;
+	}
+	if (operation == privateCallFoldDuringLex) {
+		return foldDuringLex.Turn(pointer);
+	}
+	if ((operation == privateCallLexBudgeted) && canLexBudgeted) {
+		return LexBudgeted(this, pointer);
+	}
+	if ((operation == privateCallLineStyleCache) && lineStyleCache && pointer) {
+		lineStyleCache->Report(*static_cast<LineStyleCacheUse *>(pointer));
+		return pointer;
+	}
+	if ((operation == privateCallMemoryUse) && pointer) {
+		LexerMemoryUse *use = static_cast<LexerMemoryUse *>(pointer);
+		*use = LexerMemoryUse();
+		if (ReportMemory(*use)) {
+			return pointer;
+		}
+	}
 	return nullptr;
 }
 
+bool DefaultLexer::ReportMemory(LexerMemoryUse &) const {
+	return false;
+}
+
+LineStyleCache *DefaultLexer::ActiveLineStyleCache() const noexcept {
+	return LineStyleCaching() ? lineStyleCache : nullptr;
+}
+
+void FoldDuringLexState::SetCan() noexcept {
+	canFold = true;
+	on = FoldDuringLexDefault();
+}
+
+bool FoldDuringLexState::Active() const noexcept {
+	return on && !ReferenceMode();
+}
+
+void *FoldDuringLexState::Turn(void *pointer) noexcept {
+	if (!canFold || !pointer) {
+		return nullptr;
+	}
+	on = *static_cast<const int *>(pointer) != 0;
+	pAccessFolded = nullptr;
+	return pointer;
+}
+
+void FoldDuringLexState::Folded(Sci_PositionU startPos, Sci_Position lengthDoc, Scintilla::IDocument *pAccess) {
+	pAccessFolded = pAccess;
+	startFolded = startPos;
+	lengthFolded = lengthDoc;
+	lengthDocumentFolded = pAccess->Length();
+}
+
+bool FoldDuringLexState::AlreadyFolded(Sci_PositionU startPos, Sci_Position lengthDoc, Scintilla::IDocument *pAccess) {
+	if (!pAccessFolded) {
+		return false;
+	}
+	// Only skip once: any later Fold of the same range must be performed
+	const bool same = (pAccess == pAccessFolded) && (startPos == startFolded) &&
+		(lengthDoc == lengthFolded) && (pAccess->Length() == lengthDocumentFolded);
+	pAccessFolded = nullptr;
+	return same && !ReferenceMode();
+}
+
+void FoldDuringLexState::FoldedConverging(Sci_PositionU startPos, Sci_Position endLexed, Scintilla::IDocument *pAccess) noexcept {
+	// The record is for the last chunk unless a Fold in LexConverging already consumed it
+	if (pAccessFolded && (pAccess == pAccessFolded) &&
+		(static_cast<Sci_Position>(startFolded) + lengthFolded == endLexed)) {
+		startFolded = startPos;
+		lengthFolded = endLexed - static_cast<Sci_Position>(startPos);
+	}
+}
+
 int SCI_METHOD DefaultLexer::LineEndTypesSupported() {
 	return SC_LINE_END_TYPE_DEFAULT;
 }
@@ -154,3 +243,15 @@ const char *SCI_METHOD DefaultLexer::PropertyGet(const char *key) {
 		return osi->PropertyGet(key);
 	return nullptr;
 }
+
+namespace Lexilla {
+
+void SetFoldDuringLexDefault(bool on) noexcept {
+	foldDuringLexDefault = on;
+}
+
+bool FoldDuringLexDefault() noexcept {
+	return foldDuringLexDefault;
+}
+
+}
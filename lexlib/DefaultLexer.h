@@ -13,6 +13,36 @@
 namespace Lexilla {
 
 struct OptionSetInterface;	// Forward declaration
+class Convergence;	// Forward declaration
+struct LexerMemoryUse;	// Forward declaration
+class LineStyleCache;	// Forward declaration
+
+// Whether a lexer that can fold while lexing is doing so and the range folded by its most recent Lex
+// so that the Fold call that follows for the same range can return immediately.
+class FoldDuringLexState {
+	bool canFold = false;
+	bool on = false;
+	Scintilla::IDocument *pAccessFolded = nullptr;
+	Sci_PositionU startFolded = 0;
+	Sci_Position lengthFolded = 0;
+	Sci_Position lengthDocumentFolded = 0;
+public:
+	// Folding during lexing starts on when the library property lexilla.fold.during.lex is set.
+	void SetCan() noexcept;
+	[[nodiscard]] bool Active() const noexcept;
+	// Perform privateCallFoldDuringLex, returning nullptr unless SetCan was called
+	void *Turn(void *pointer) noexcept;
+	// Called at the start of each Lex as a range recorded earlier may have changed since.
+	void Forget() noexcept {
+		pAccessFolded = nullptr;
+	}
+	void Folded(Sci_PositionU startPos, Sci_Position lengthDoc, Scintilla::IDocument *pAccess);
+	// Only true once for each range recorded by Folded.
+	bool AlreadyFolded(Sci_PositionU startPos, Sci_Position lengthDoc, Scintilla::IDocument *pAccess);
+	// After privateCallLexConverging when each chunk was folded as it was lexed, the whole range lexed
+	// from startPos to endLexed was folded.
+	void FoldedConverging(Sci_PositionU startPos, Sci_Position endLexed, Scintilla::IDocument *pAccess) noexcept;
+};
 
 // A simple lexer with no state
 class DefaultLexer : public Scintilla::ILexer5 {
@@ -21,6 +51,10 @@ class DefaultLexer : public Scintilla::ILexer5 {
 	const LexicalClass *lexClasses;
 	size_t nClasses;
 	OptionSetInterface *osi = nullptr;
+	Convergence *convergence = nullptr;
+	LineStyleCache *lineStyleCache = nullptr;
+	FoldDuringLexState foldDuringLex;
+	bool canLexBudgeted = false;
 public:
 	DefaultLexer(const char *languageName_, int language_,
 		const LexicalClass *lexClasses_ = nullptr, size_t nClasses_ = 0);
@@ -28,6 +62,42 @@ public:
 	void SetOptionSet(OptionSetInterface *osi_) noexcept {
 		this->osi = osi_;
 	}
+	// Lexers that can stop lexing when their state converges call this to support privateCallLexConverging
+	void SetConvergence(Convergence *convergence_) noexcept {
+		this->convergence = convergence_;
+	}
+	// Lexers that can replay the styles of repeated lines call this to support privateCallLineStyleCache
+	void SetLineStyleCache(LineStyleCache *lineStyleCache_) noexcept {
+		this->lineStyleCache = lineStyleCache_;
+	}
+	// The cache to use for the current lex or null when line style caching is off.
+	[[nodiscard]] LineStyleCache *ActiveLineStyleCache() const noexcept;
+	// Lexers that can fold while lexing call this to support privateCallFoldDuringLex
+	// Folding during lexing starts on when the library property lexilla.fold.during.lex is set.
+	void SetCanFoldDuringLex() noexcept {
+		foldDuringLex.SetCan();
+	}
+	[[nodiscard]] bool FoldDuringLex() const noexcept {
+		return foldDuringLex.Active();
+	}
+	// Lexers that produce the same results when restarted at any line start call this to support privateCallLexBudgeted
+	void SetCanLexBudgeted() noexcept {
+		canLexBudgeted = true;
+	}
+	// Called at the start of Lex by lexers that can fold while lexing.
+	void ForgetFolded() noexcept {
+		foldDuringLex.Forget();
+	}
+	// Called by Lex after folding the range it lexed.
+	void FoldedDuringLex(Sci_PositionU startPos, Sci_Position lengthDoc, Scintilla::IDocument *pAccess) {
+		foldDuringLex.Folded(startPos, lengthDoc, pAccess);
+	}
+	// Called by Fold to check whether the preceding Lex already folded this range.
+	bool AlreadyFolded(Sci_PositionU startPos, Sci_Position lengthDoc, Scintilla::IDocument *pAccess) {
+		return foldDuringLex.AlreadyFolded(startPos, lengthDoc, pAccess);
+	}
+	// Lexers that retain state for the document override this to support privateCallMemoryUse.
+	virtual bool ReportMemory(LexerMemoryUse &use) const;
 
 	void SCI_METHOD Release() override;
 	int SCI_METHOD Version() const override;
@@ -60,6 +130,11 @@ public:
 	const char *SCI_METHOD PropertyGet(const char *key) override;
 };
 
+// Whether lexers that can fold while lexing do so from when they are created. Set through
+// the library property lexilla.fold.during.lex and changed for each lexer by privateCallFoldDuringLex.
+void SetFoldDuringLexDefault(bool on) noexcept;
+[[nodiscard]] bool FoldDuringLexDefault() noexcept;
+
 }
 
 #endif
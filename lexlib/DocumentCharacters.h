@@ -0,0 +1,158 @@
+// Lexilla lexer library
+/** @file DocumentCharacters.h
+ ** Decode characters for documents implemented in lexlib.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef DOCUMENTCHARACTERS_H
+#define DOCUMENTCHARACTERS_H
+
+// Must have already included ILexer.h.
+
+namespace Lexilla {
+
+constexpr int codePageUTF8 = 65001;
+
+constexpr bool IsDBCSCodePage(int codePage) noexcept {
+	return codePage == 932 || codePage == 936 || codePage == 949 || codePage == 950 || codePage == 1361;
+}
+
+// Lead bytes of the DBCS code pages commonly used with Scintilla.
+constexpr bool IsDBCSLeadByteInCodePage(int codePage, unsigned char uch) noexcept {
+	switch (codePage) {
+	case 932:
+		// Shift_jis
+		return ((uch >= 0x81) && (uch <= 0x9F)) || ((uch >= 0xE0) && (uch <= 0xFC));
+	case 936:
+		// GBK
+	case 949:
+		// Korean Wansung KS C-5601-1987
+	case 950:
+		// Big5
+		return (uch >= 0x81) && (uch <= 0xFE);
+	case 1361:
+		// Korean Johab KS C-5601-1992
+		return ((uch >= 0x84) && (uch <= 0xD3)) || ((uch >= 0xD8) && (uch <= 0xDE)) || ((uch >= 0xE0) && (uch <= 0xF9));
+	default:
+		return false;
+	}
+}
+
+// Bytes that may follow a lead byte to form a character, as Scintilla checks them.
+constexpr bool IsDBCSTrailByteInCodePage(int codePage, unsigned char uch) noexcept {
+	switch (codePage) {
+	case 932:
+		// Shift_jis
+		return (uch >= 0x40) && (uch <= 0xFC) && (uch != 0x7F);
+	case 936:
+		// GBK
+		return (uch >= 0x40) && (uch <= 0xFE) && (uch != 0x7F);
+	case 949:
+		// Korean Wansung KS C-5601-1987
+		return ((uch >= 0x41) && (uch <= 0x5A)) || ((uch >= 0x61) && (uch <= 0x7A)) || ((uch >= 0x81) && (uch <= 0xFE));
+	case 950:
+		// Big5
+		return ((uch >= 0x40) && (uch <= 0x7E)) || ((uch >= 0xA1) && (uch <= 0xFE));
+	case 1361:
+		// Korean Johab KS C-5601-1992
+		return ((uch >= 0x31) && (uch <= 0x7E)) || ((uch >= 0x81) && (uch <= 0xFE));
+	default:
+		return false;
+	}
+}
+
+constexpr int UTF8BytesOfLead(unsigned char ch) noexcept {
+	if (ch < 0xC2) {
+		return 1;
+	} else if (ch < 0xE0) {
+		return 2;
+	} else if (ch < 0xF0) {
+		return 3;
+	} else if (ch < 0xF5) {
+		return 4;
+	}
+	return 1;
+}
+
+constexpr bool UTF8IsTrailByte(unsigned char ch) noexcept {
+	return (ch >= 0x80) && (ch < 0xC0);
+}
+
+// Decode the character starting bytes[0] with available bytes, up to 4, present.
+// Invalid UTF-8 is reported as one byte with a lone surrogate value as Scintilla does.
+// A DBCS character is reported as the lead byte shifted above the trail byte while a lead byte
+// not followed by a trail byte is reported as one byte.
+inline int CharacterFromBytes(const unsigned char *bytes, Sci_Position available, int codePage,
+	const bool dbcsLeadBytes[], Sci_Position *pWidth) noexcept {
+	Sci_Position width = 1;
+	const unsigned char leadByte = bytes[0];
+	int character = leadByte;
+	if (leadByte >= 0x80) {
+		if (codePage == codePageUTF8) {
+			const int widthCharBytes = UTF8BytesOfLead(leadByte);
+			bool valid = (widthCharBytes > 1) && (widthCharBytes <= available);
+			int value = leadByte & (0xFF >> (widthCharBytes + 1));
+			for (int b = 1; valid && (b < widthCharBytes); b++) {
+				valid = UTF8IsTrailByte(bytes[b]);
+				value = (value << 6) | (bytes[b] & 0x3F);
+			}
+			if (valid) {
+				character = value;
+				width = widthCharBytes;
+			} else {
+				character = 0xDC80 + leadByte;
+			}
+		} else if (IsDBCSCodePage(codePage) && dbcsLeadBytes[leadByte] && (available > 1) &&
+			IsDBCSTrailByteInCodePage(codePage, bytes[1])) {
+			character = (leadByte << 8) | bytes[1];
+			width = 2;
+		}
+	}
+	if (pWidth) {
+		*pWidth = width;
+	}
+	return character;
+}
+
+// Implement IDocument::GetRelativePosition with the document's GetCharacterAndWidth.
+inline Sci_Position RelativePosition(const Scintilla::IDocument *pdoc, Sci_Position positionStart, Sci_Position characterOffset) {
+	const int codePage = pdoc->CodePage();
+	Sci_Position position = positionStart;
+	while (characterOffset < 0) {
+		if (position <= 0) {
+			return -1;
+		}
+		Sci_Position previous = position - 1;
+		if ((codePage == codePageUTF8) || IsDBCSCodePage(codePage)) {
+			// Find the earliest character start that ends at position.
+			// DBCS trail bytes may look like lead bytes so scan forward from the line start.
+			Sci_Position scan = (codePage == codePageUTF8) ?
+				std::max<Sci_Position>(position - 4, 0) : pdoc->LineStart(pdoc->LineFromPosition(position - 1));
+			while (scan < position) {
+				Sci_Position width = 1;
+				pdoc->GetCharacterAndWidth(scan, &width);
+				if (scan + width == position) {
+					previous = scan;
+					break;
+				}
+				scan += (codePage == codePageUTF8) ? 1 : width;
+			}
+		}
+		position = previous;
+		characterOffset++;
+	}
+	while (characterOffset > 0) {
+		if (position >= pdoc->Length()) {
+			return -1;
+		}
+		Sci_Position width = 1;
+		pdoc->GetCharacterAndWidth(position, &width);
+		position += width;
+		characterOffset--;
+	}
+	return position;
+}
+
+}
+
+#endif
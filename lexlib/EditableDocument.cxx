@@ -0,0 +1,344 @@
+// Lexilla lexer library
+/** @file EditableDocument.cxx
+ ** A document that can be edited and lexed by applications that do not use Scintilla.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstddef>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+
+#include "ILexer.h"
+#include "Scintilla.h"
+
+#include "LexillaExtensions.h"
+
+#include "DocumentCharacters.h"
+#include "GapBuffer.h"
+#include "EditableDocument.h"
+
+using namespace Lexilla;
+
+namespace {
+
+constexpr int tabWidth = 8;
+
+}
+
+EditableDocument::EditableDocument() {
+	Set(std::string_view());
+}
+
+EditableDocument::~EditableDocument() {
+	if (lexer) {
+		lexer->Release();
+	}
+}
+
+// Does a line start after the byte at position?
+bool EditableDocument::IsLineStartAfter(Sci_Position position) const noexcept {
+	const char ch = text.ValueAt(position);
+	return (ch == '\n') || ((ch == '\r') && (text.ValueAt(position + 1) != '\n'));
+}
+
+void EditableDocument::Replace(Sci_Position position, Sci_Position deleteLength, std::string_view insert) {
+	const Sci_Position insertLength = insert.length();
+	const Sci_Position lineEdited = lines.PartitionFromPosition(position);
+	// Whether a line starts at a position depends on the bytes before and at that position so
+	// line starts from position to one byte after the changed text may change. They are
+	// removed and then found again by examining the new text.
+	Sci_Position lineFirst = lineEdited;
+	if ((position == 0) || (lines.PositionFromPartition(lineFirst) != position)) {
+		lineFirst++;
+	}
+	Sci_Position linesRemoved = 0;
+	while ((lineFirst < lines.Partitions()) && (lines.PositionFromPartition(lineFirst) <= position + deleteLength + 1)) {
+		lines.RemovePartition(lineFirst);
+		linesRemoved++;
+	}
+
+	text.DeleteRange(position, deleteLength);
+	textStyles.DeleteRange(position, deleteLength);
+	text.InsertFromArray(position, insert.data(), insertLength);
+	textStyles.InsertValue(position, insertLength, 0);
+	lines.InsertText(lineFirst - 1, insertLength - deleteLength);
+
+	Sci_Position linesAdded = 0;
+	const Sci_Position endScan = std::min(position + insertLength + 1, Length());
+	for (Sci_Position lineStart = std::max<Sci_Position>(position, 1); lineStart <= endScan; lineStart++) {
+		if (IsLineStartAfter(lineStart - 1)) {
+			lines.InsertPartition(lineFirst + linesAdded, lineStart);
+			linesAdded++;
+		}
+	}
+
+	// New lines start with the state and level of the line they were split from
+	const Sci_Position linesInserted = linesAdded - linesRemoved;
+	if (linesInserted > 0) {
+		lineStates.InsertValue(lineEdited + 1, linesInserted, lineStates.ValueAt(lineEdited));
+		levels.InsertValue(lineEdited + 1, linesInserted, levels.ValueAt(lineEdited));
+	} else if (linesInserted < 0) {
+		lineStates.DeleteRange(lineEdited + 1, -linesInserted);
+		levels.DeleteRange(lineEdited + 1, -linesInserted);
+	}
+}
+
+void EditableDocument::Invalidate(Sci_Position position) noexcept {
+	endStyled = std::min(endStyled, position);
+}
+
+void EditableDocument::Set(std::string_view sv) {
+	text.DeleteAll();
+	textStyles.DeleteAll();
+	lines.DeleteAll();
+	lineStates.DeleteAll();
+	lineStates.InsertValue(0, 2, 0);
+	levels.DeleteAll();
+	levels.Insert(0, SC_FOLDLEVELBASE);
+	endStyled = 0;
+	Replace(0, 0, sv);
+}
+
+void EditableDocument::InsertText(Sci_Position position, std::string_view sv) {
+	if ((position < 0) || (position > Length()) || sv.empty()) {
+		return;
+	}
+	Replace(position, 0, sv);
+	Invalidate(position);
+}
+
+void EditableDocument::DeleteRange(Sci_Position position, Sci_Position length) {
+	if ((position < 0) || (length <= 0) || (position + length > Length())) {
+		return;
+	}
+	Replace(position, length, std::string_view());
+	Invalidate(position);
+}
+
+void EditableDocument::SetCodePage(int codePage_) {
+	codePage = codePage_;
+	for (int ch = 0; ch < 0x100; ch++) {
+		dbcsLeadBytes[ch] = IsDBCSLeadByteInCodePage(codePage, static_cast<unsigned char>(ch));
+	}
+	Invalidate(0);
+}
+
+void EditableDocument::SetLexer(Scintilla::ILexer5 *lexer_) {
+	if (lexer) {
+		lexer->Release();
+	}
+	lexer = lexer_;
+	Invalidate(0);
+}
+
+Scintilla::ILexer5 *EditableDocument::Lexer() const noexcept {
+	return lexer;
+}
+
+void EditableDocument::PropertySet(const char *key, const char *val) {
+	if (lexer) {
+		const Sci_Position firstModification = lexer->PropertySet(key, val);
+		if (firstModification >= 0) {
+			Invalidate(firstModification);
+		}
+	}
+}
+
+void EditableDocument::WordListSet(int n, const char *wl) {
+	if (lexer) {
+		const Sci_Position firstModification = lexer->WordListSet(n, wl);
+		if (firstModification >= 0) {
+			Invalidate(firstModification);
+		}
+	}
+}
+
+Sci_Position EditableDocument::EndStyled() const noexcept {
+	return endStyled;
+}
+
+void EditableDocument::EnsureStyledTo(Sci_Position position) {
+	if (!lexer || lexing || (endStyled > position) || (endStyled >= Length())) {
+		return;
+	}
+	// Lexers expect to start at a line start and styling whole lines helps them resume
+	const Sci_Position lineStart = LineStart(LineFromPosition(endStyled));
+	const Sci_Position end = LineStart(LineFromPosition(position) + 1);
+	const int initStyle = (lineStart > 0) ? static_cast<unsigned char>(StyleAt(lineStart - 1)) : 0;
+	lexing = true;
+	lexer->Lex(lineStart, end - lineStart, initStyle, this);
+	lexer->Fold(lineStart, end - lineStart, initStyle, this);
+	lexing = false;
+}
+
+Sci_Position EditableDocument::Lines() const noexcept {
+	return lines.Partitions();
+}
+
+#if defined(_MSC_VER)
+// IDocument interface does not specify noexcept so best to not add it to implementation
+#pragma warning(disable: 26440)
+#endif
+
+int SCI_METHOD EditableDocument::Version() const {
+	return Scintilla::dvRelease4 | dvStyleRange;
+}
+
+void SCI_METHOD EditableDocument::SetErrorStatus(int) {
+}
+
+Sci_Position SCI_METHOD EditableDocument::Length() const {
+	return text.Length();
+}
+
+void SCI_METHOD EditableDocument::GetCharRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const {
+	text.GetRange(buffer, position, lengthRetrieve);
+}
+
+char SCI_METHOD EditableDocument::StyleAt(Sci_Position position) const {
+	return textStyles.ValueAt(position);
+}
+
+Sci_Position SCI_METHOD EditableDocument::LineFromPosition(Sci_Position position) const {
+	return lines.PartitionFromPosition(position);
+}
+
+Sci_Position SCI_METHOD EditableDocument::LineStart(Sci_Position line) const {
+	if (line < 0) {
+		return 0;
+	}
+	if (line >= Lines()) {
+		return Length();
+	}
+	return lines.PositionFromPartition(line);
+}
+
+int SCI_METHOD EditableDocument::GetLevel(Sci_Position line) const {
+	if ((line < 0) || (line >= Lines())) {
+		return SC_FOLDLEVELBASE;
+	}
+	return levels.ValueAt(line);
+}
+
+int SCI_METHOD EditableDocument::SetLevel(Sci_Position line, int level) {
+	if ((line < 0) || (line >= Lines())) {
+		return SC_FOLDLEVELBASE;
+	}
+	const int previous = levels.ValueAt(line);
+	levels.SetValueAt(line, level);
+	return previous;
+}
+
+int SCI_METHOD EditableDocument::GetLineState(Sci_Position line) const {
+	return lineStates.ValueAt(line);
+}
+
+int SCI_METHOD EditableDocument::SetLineState(Sci_Position line, int state) {
+	const int previous = lineStates.ValueAt(line);
+	lineStates.SetValueAt(line, state);
+	return previous;
+}
+
+void SCI_METHOD EditableDocument::StartStyling(Sci_Position position) {
+	endStyled = std::clamp<Sci_Position>(position, 0, Length());
+}
+
+bool SCI_METHOD EditableDocument::SetStyleFor(Sci_Position length, char style) {
+	length = std::min(length, Length() - endStyled);
+	if (length <= 0) {
+		return false;
+	}
+	std::fill_n(textStyles.RangePointer(endStyled, length), length, style);
+	endStyled += length;
+	return true;
+}
+
+bool SCI_METHOD EditableDocument::SetStyles(Sci_Position length, const char *styles) {
+	length = std::min(length, Length() - endStyled);
+	if (length <= 0) {
+		return false;
+	}
+	std::copy_n(styles, length, textStyles.RangePointer(endStyled, length));
+	endStyled += length;
+	return true;
+}
+
+void SCI_METHOD EditableDocument::DecorationSetCurrentIndicator(int) {
+	// Decorations are not kept
+}
+
+void SCI_METHOD EditableDocument::DecorationFillRange(Sci_Position, int, Sci_Position) {
+	// Decorations are not kept
+}
+
+void SCI_METHOD EditableDocument::ChangeLexerState(Sci_Position, Sci_Position) {
+	// Styles are kept in the document so there is no display to update
+}
+
+int SCI_METHOD EditableDocument::CodePage() const {
+	return codePage;
+}
+
+bool SCI_METHOD EditableDocument::IsDBCSLeadByte(char ch) const {
+	return dbcsLeadBytes[static_cast<unsigned char>(ch)];
+}
+
+const char *SCI_METHOD EditableDocument::BufferPointer() {
+	return text.BufferPointer();
+}
+
+int SCI_METHOD EditableDocument::GetLineIndentation(Sci_Position line) {
+	// Tab width is not known so assume the common default
+	int indent = 0;
+	const Sci_Position lineEnd = LineEnd(line);
+	for (Sci_Position position = LineStart(line); position < lineEnd; position++) {
+		const char ch = text.ValueAt(position);
+		if (ch == ' ') {
+			indent++;
+		} else if (ch == '\t') {
+			indent = (indent / tabWidth + 1) * tabWidth;
+		} else {
+			break;
+		}
+	}
+	return indent;
+}
+
+Sci_Position SCI_METHOD EditableDocument::LineEnd(Sci_Position line) const {
+	if (line < 0) {
+		return 0;
+	}
+	if (line >= Lines() - 1) {
+		return Length();
+	}
+	Sci_Position position = LineStart(line + 1) - 1;
+	// Back over CR of CR LF
+	if ((text.ValueAt(position) == '\n') && (position > LineStart(line)) && (text.ValueAt(position - 1) == '\r')) {
+		position--;
+	}
+	return position;
+}
+
+Sci_Position SCI_METHOD EditableDocument::GetRelativePosition(Sci_Position positionStart, Sci_Position characterOffset) const {
+	return RelativePosition(this, positionStart, characterOffset);
+}
+
+int SCI_METHOD EditableDocument::GetCharacterAndWidth(Sci_Position position, Sci_Position *pWidth) const {
+	if ((position < 0) || (position >= Length())) {
+		if (pWidth) {
+			*pWidth = 1;
+		}
+		return 0;
+	}
+	unsigned char bytes[4] {};
+	const Sci_Position available = std::min<Sci_Position>(Length() - position, 4);
+	text.GetRange(reinterpret_cast<char *>(bytes), position, available);
+	return CharacterFromBytes(bytes, available, codePage, dbcsLeadBytes, pWidth);
+}
+
+void SCI_METHOD EditableDocument::GetStyleRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const {
+	textStyles.GetRange(buffer, position, lengthRetrieve);
+}
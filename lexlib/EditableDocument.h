@@ -0,0 +1,97 @@
+// Lexilla lexer library
+/** @file EditableDocument.h
+ ** A document that can be edited and lexed by applications that do not use Scintilla.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef EDITABLEDOCUMENT_H
+#define EDITABLEDOCUMENT_H
+
+// Must have already included ILexer.h, LexillaExtensions.h, and GapBuffer.h.
+
+namespace Lexilla {
+
+// Text and styles are held in gap buffers and line starts in a Partitioning so edits near the
+// previous edit are cheap and the line index is updated for just the text changed.
+// Lines end with LF, CR LF, or CR.
+// Styles are valid up to EndStyled. An edit moves EndStyled back to the edit and styles after it
+// are brought up to date by lexing only when requested with EnsureStyledTo.
+// Line states and fold levels move with their lines and lines split by an edit copy them.
+class EditableDocument : public IDocumentStyles {
+	GapBuffer<char> text;
+	GapBuffer<char> textStyles;
+	Partitioning<Sci_Position> lines;
+	// Line states are kept for each line and the line after the last as some lexers set that
+	GapBuffer<int> lineStates;
+	GapBuffer<int> levels;
+	Sci_Position endStyled = 0;
+	int codePage = 0;
+	bool dbcsLeadBytes[0x100] {};
+	Scintilla::ILexer5 *lexer = nullptr;
+	bool lexing = false;
+
+	[[nodiscard]] bool IsLineStartAfter(Sci_Position position) const noexcept;
+	void Replace(Sci_Position position, Sci_Position deleteLength, std::string_view insert);
+	void Invalidate(Sci_Position position) noexcept;
+public:
+	EditableDocument();
+	// Deleted so EditableDocument objects can not be copied.
+	EditableDocument(const EditableDocument &) = delete;
+	EditableDocument(EditableDocument &&) = delete;
+	EditableDocument &operator=(const EditableDocument &) = delete;
+	EditableDocument &operator=(EditableDocument &&) = delete;
+	virtual ~EditableDocument();
+
+	// Replace all text, clearing styles, line states, and fold levels.
+	void Set(std::string_view sv);
+	void InsertText(Sci_Position position, std::string_view sv);
+	void DeleteRange(Sci_Position position, Sci_Position length);
+
+	// Set the code page: 0 for single byte, 65001 for UTF-8, or a DBCS code page such as 932.
+	void SetCodePage(int codePage_);
+
+	// Take ownership of lexer, releasing any previous lexer, and invalidate all styles.
+	void SetLexer(Scintilla::ILexer5 *lexer_);
+	[[nodiscard]] Scintilla::ILexer5 *Lexer() const noexcept;
+	// Change a lexer setting, invalidating styles from where the lexer says they change.
+	void PropertySet(const char *key, const char *val);
+	void WordListSet(int n, const char *wl);
+
+	// Styles before EndStyled are valid.
+	[[nodiscard]] Sci_Position EndStyled() const noexcept;
+	// Lex and fold whole lines from EndStyled to cover position.
+	void EnsureStyledTo(Sci_Position position);
+
+	[[nodiscard]] Sci_Position Lines() const noexcept;
+
+	int SCI_METHOD Version() const override;
+	void SCI_METHOD SetErrorStatus(int status) override;
+	Sci_Position SCI_METHOD Length() const override;
+	void SCI_METHOD GetCharRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const override;
+	char SCI_METHOD StyleAt(Sci_Position position) const override;
+	Sci_Position SCI_METHOD LineFromPosition(Sci_Position position) const override;
+	Sci_Position SCI_METHOD LineStart(Sci_Position line) const override;
+	int SCI_METHOD GetLevel(Sci_Position line) const override;
+	int SCI_METHOD SetLevel(Sci_Position line, int level) override;
+	int SCI_METHOD GetLineState(Sci_Position line) const override;
+	int SCI_METHOD SetLineState(Sci_Position line, int state) override;
+	void SCI_METHOD StartStyling(Sci_Position position) override;
+	bool SCI_METHOD SetStyleFor(Sci_Position length, char style) override;
+	bool SCI_METHOD SetStyles(Sci_Position length, const char *styles) override;
+	void SCI_METHOD DecorationSetCurrentIndicator(int indicator) override;
+	void SCI_METHOD DecorationFillRange(Sci_Position position, int value, Sci_Position fillLength) override;
+	void SCI_METHOD ChangeLexerState(Sci_Position start, Sci_Position end) override;
+	int SCI_METHOD CodePage() const override;
+	bool SCI_METHOD IsDBCSLeadByte(char ch) const override;
+	const char *SCI_METHOD BufferPointer() override;
+	int SCI_METHOD GetLineIndentation(Sci_Position line) override;
+	Sci_Position SCI_METHOD LineEnd(Sci_Position line) const override;
+	Sci_Position SCI_METHOD GetRelativePosition(Sci_Position positionStart, Sci_Position characterOffset) const override;
+	int SCI_METHOD GetCharacterAndWidth(Sci_Position position, Sci_Position *pWidth) const override;
+	// IDocumentStyles method
+	void SCI_METHOD GetStyleRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const override;
+};
+
+}
+
+#endif
@@ -0,0 +1,314 @@
+// Lexilla lexer library
+/** @file GapBuffer.h
+ ** Storage for documents that are edited: a gap buffer and partitions of it into lines.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef GAPBUFFER_H
+#define GAPBUFFER_H
+
+namespace Lexilla {
+
+// A vector with a gap at the last edit position so that a sequence of insertions and deletions
+// near each other only moves the elements between edits.
+template <typename T>
+class GapBuffer {
+	std::vector<T> body;
+	T empty {};
+	ptrdiff_t lengthBody = 0;
+	ptrdiff_t part1Length = 0;
+	ptrdiff_t gapLength = 0;
+	ptrdiff_t growSize = 8;
+
+	// Move the gap to position so that insertions or deletions there are cheap.
+	void GapTo(ptrdiff_t position) noexcept {
+		if (position != part1Length) {
+			if (gapLength > 0) {
+				if (position < part1Length) {
+					std::move_backward(body.data() + position, body.data() + part1Length, body.data() + gapLength + part1Length);
+				} else {
+					std::move(body.data() + part1Length + gapLength, body.data() + gapLength + position, body.data() + part1Length);
+				}
+			}
+			part1Length = position;
+		}
+	}
+
+	// Grow the gap so insertionLength elements fit, growing more as the buffer becomes large
+	// to avoid repeated reallocation.
+	void RoomFor(ptrdiff_t insertionLength) {
+		if (gapLength < insertionLength) {
+			while (growSize < static_cast<ptrdiff_t>(body.size() / 6)) {
+				growSize *= 2;
+			}
+			const ptrdiff_t newSize = static_cast<ptrdiff_t>(body.size()) + insertionLength + growSize;
+			GapTo(lengthBody);
+			gapLength += newSize - static_cast<ptrdiff_t>(body.size());
+			body.resize(newSize);
+		}
+	}
+
+public:
+	GapBuffer() = default;
+
+	[[nodiscard]] ptrdiff_t Length() const noexcept {
+		return lengthBody;
+	}
+
+	// Memory allocated, including the gap, in elements.
+	[[nodiscard]] ptrdiff_t Allocated() const noexcept {
+		return body.size();
+	}
+
+	// Value at position or a default value when position is outside the buffer.
+	[[nodiscard]] T ValueAt(ptrdiff_t position) const noexcept {
+		if (position < part1Length) {
+			if (position < 0) {
+				return empty;
+			}
+			return body[position];
+		}
+		if (position >= lengthBody) {
+			return empty;
+		}
+		return body[gapLength + position];
+	}
+
+	void SetValueAt(ptrdiff_t position, T v) noexcept {
+		if (position < part1Length) {
+			if (position >= 0) {
+				body[position] = std::move(v);
+			}
+		} else if (position < lengthBody) {
+			body[gapLength + position] = std::move(v);
+		}
+	}
+
+	void Insert(ptrdiff_t position, T v) {
+		InsertValue(position, 1, v);
+	}
+
+	// Insert count copies of v at position.
+	void InsertValue(ptrdiff_t position, ptrdiff_t count, T v) {
+		if ((position < 0) || (position > lengthBody) || (count <= 0)) {
+			return;
+		}
+		RoomFor(count);
+		GapTo(position);
+		std::fill_n(body.data() + part1Length, count, v);
+		lengthBody += count;
+		part1Length += count;
+		gapLength -= count;
+	}
+
+	void InsertFromArray(ptrdiff_t position, const T *s, ptrdiff_t insertLength) {
+		if ((position < 0) || (position > lengthBody) || (insertLength <= 0)) {
+			return;
+		}
+		RoomFor(insertLength);
+		GapTo(position);
+		std::copy_n(s, insertLength, body.data() + part1Length);
+		lengthBody += insertLength;
+		part1Length += insertLength;
+		gapLength -= insertLength;
+	}
+
+	void Delete(ptrdiff_t position) {
+		DeleteRange(position, 1);
+	}
+
+	void DeleteRange(ptrdiff_t position, ptrdiff_t deleteLength) {
+		if ((position < 0) || (deleteLength <= 0) || (position + deleteLength > lengthBody)) {
+			return;
+		}
+		if ((position == 0) && (deleteLength == lengthBody)) {
+			// Whole buffer deleted so release the memory
+			DeleteAll();
+			return;
+		}
+		GapTo(position);
+		lengthBody -= deleteLength;
+		gapLength += deleteLength;
+	}
+
+	void DeleteAll() noexcept {
+		body.clear();
+		body.shrink_to_fit();
+		lengthBody = 0;
+		part1Length = 0;
+		gapLength = 0;
+		growSize = 8;
+	}
+
+	// Copy range of elements into buffer which must be large enough.
+	void GetRange(T *buffer, ptrdiff_t position, ptrdiff_t retrieveLength) const noexcept {
+		if ((position < 0) || (retrieveLength <= 0) || (position + retrieveLength > lengthBody)) {
+			return;
+		}
+		const ptrdiff_t range1Length = std::clamp<ptrdiff_t>(part1Length - position, 0, retrieveLength);
+		std::copy_n(body.data() + position, range1Length, buffer);
+		std::copy_n(body.data() + gapLength + position + range1Length, retrieveLength - range1Length, buffer + range1Length);
+	}
+
+	// Add delta to each element in [start, end) which are commonly partition positions.
+	void RangeAddDelta(ptrdiff_t start, ptrdiff_t end, T delta) noexcept {
+		ptrdiff_t i = start;
+		const ptrdiff_t range1Length = std::min(end, part1Length);
+		for (; i < range1Length; i++) {
+			body[i] += delta;
+		}
+		for (; i < end; i++) {
+			body[gapLength + i] += delta;
+		}
+	}
+
+	// Contiguous elements from position for rangeLength, moving the gap out of the way if needed.
+	T *RangePointer(ptrdiff_t position, ptrdiff_t rangeLength) noexcept {
+		if ((position < part1Length) && (position + rangeLength > part1Length)) {
+			GapTo(position);
+		}
+		if (position < part1Length) {
+			return body.data() + position;
+		}
+		return body.data() + gapLength + position;
+	}
+
+	// All the elements contiguously followed by a default value, as for a NUL-terminated string.
+	T *BufferPointer() {
+		RoomFor(1);
+		GapTo(lengthBody);
+		body[lengthBody] = empty;
+		return body.data();
+	}
+};
+
+// Divides a range of positions into partitions, such as a document into lines, recording the start
+// of each partition with a final entry for the end of the range.
+// Insertion or deletion of text moves all following partitions. To make a sequence of edits near
+// each other cheap, the move is recorded as a pending step applied to partitions after stepPartition
+// when they are next read or changed.
+template <typename T>
+class Partitioning {
+	T stepPartition = 0;
+	T stepLength = 0;
+	GapBuffer<T> body;
+
+	// Move the pending step up so that partitions up to partitionUpTo are correct.
+	void ApplyStep(T partitionUpTo) noexcept {
+		if (stepLength != 0) {
+			body.RangeAddDelta(stepPartition + 1, partitionUpTo + 1, stepLength);
+		}
+		stepPartition = partitionUpTo;
+		if (stepPartition >= body.Length() - 1) {
+			stepPartition = Partitions();
+			stepLength = 0;
+		}
+	}
+
+	// Move the pending step down so that it starts after partitionDownTo.
+	void BackStep(T partitionDownTo) noexcept {
+		if (stepLength != 0) {
+			body.RangeAddDelta(partitionDownTo + 1, stepPartition + 1, -stepLength);
+		}
+		stepPartition = partitionDownTo;
+	}
+
+public:
+	// Starts with one empty partition.
+	Partitioning() {
+		body.Insert(0, 0);
+		body.Insert(1, 0);
+	}
+
+	[[nodiscard]] T Partitions() const noexcept {
+		return static_cast<T>(body.Length()) - 1;
+	}
+
+	// Memory allocated in elements.
+	[[nodiscard]] ptrdiff_t Allocated() const noexcept {
+		return body.Allocated();
+	}
+
+	void InsertPartition(T partition, T pos) {
+		if (stepPartition < partition) {
+			ApplyStep(partition);
+		}
+		body.Insert(partition, pos);
+		stepPartition++;
+	}
+
+	void RemovePartition(T partition) {
+		if (partition > stepPartition) {
+			ApplyStep(partition);
+		}
+		stepPartition--;
+		body.Delete(partition);
+	}
+
+	// Text of length delta inserted (negative for deleted) in partitionInsert so move the
+	// partitions after it.
+	void InsertText(T partitionInsert, T delta) noexcept {
+		if (stepLength != 0) {
+			if (partitionInsert >= stepPartition) {
+				// Fill in up to the new insertion point
+				ApplyStep(partitionInsert);
+				stepLength += delta;
+			} else if (partitionInsert >= (stepPartition - body.Length() / 10)) {
+				// Close to step but before so move step back
+				BackStep(partitionInsert);
+				stepLength += delta;
+			} else {
+				ApplyStep(Partitions());
+				stepPartition = partitionInsert;
+				stepLength = delta;
+			}
+		} else {
+			stepPartition = partitionInsert;
+			stepLength = delta;
+		}
+	}
+
+	[[nodiscard]] T PositionFromPartition(T partition) const noexcept {
+		if ((partition < 0) || (partition >= body.Length())) {
+			return 0;
+		}
+		T pos = body.ValueAt(partition);
+		if (partition > stepPartition) {
+			pos += stepLength;
+		}
+		return pos;
+	}
+
+	// Return the partition containing pos: the last partition when pos is at or after its start.
+	[[nodiscard]] T PartitionFromPosition(T pos) const noexcept {
+		if (body.Length() <= 1) {
+			return 0;
+		}
+		if (pos >= PositionFromPartition(Partitions() - 1)) {
+			return Partitions() - 1;
+		}
+		T lower = 0;
+		T upper = Partitions() - 1;
+		do {
+			const T middle = (upper + lower + 1) / 2;
+			if (pos < PositionFromPartition(middle)) {
+				upper = middle - 1;
+			} else {
+				lower = middle;
+			}
+		} while (lower < upper);
+		return lower;
+	}
+
+	void DeleteAll() {
+		stepPartition = 0;
+		stepLength = 0;
+		body.DeleteAll();
+		body.Insert(0, 0);
+		body.Insert(1, 0);
+	}
+};
+
+}
+
+#endif
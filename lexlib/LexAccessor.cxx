@@ -9,17 +9,59 @@
 
 #include <string>
 #include <algorithm>
+#include <atomic>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 #include "ILexer.h"
 #include "Scintilla.h"
+#include "LexillaExtensions.h"
 
 #include "LexAccessor.h"
 #include "CharacterSet.h"
+#include "DocumentCharacters.h"
 
 using namespace Lexilla;
 
+namespace {
+
+std::atomic<bool> referenceMode = false;
+
+// Built at compile time for each DBCS code page so LexAccessor need not ask the document.
+class DBCSByteTable {
+public:
+	unsigned char flags[0x100] {};
+	constexpr explicit DBCSByteTable(int codePage) noexcept {
+		for (int ch = 0x80; ch < 0x100; ch++) {
+			if (IsDBCSLeadByteInCodePage(codePage, static_cast<unsigned char>(ch))) {
+				flags[ch] |= LexAccessor::dbcsLeadByte;
+			}
+		}
+		for (int ch = 0; ch < 0x100; ch++) {
+			if (IsDBCSTrailByteInCodePage(codePage, static_cast<unsigned char>(ch))) {
+				flags[ch] |= LexAccessor::dbcsTrailByte;
+			}
+		}
+	}
+};
+
+constexpr DBCSByteTable dbcsNone(0);
+constexpr DBCSByteTable dbcs932(932);
+constexpr DBCSByteTable dbcs936(936);
+constexpr DBCSByteTable dbcs949(949);
+constexpr DBCSByteTable dbcs950(950);
+constexpr DBCSByteTable dbcs1361(1361);
+
+}
+
 namespace Lexilla {
 
+thread_local AccessorCounts *accessorCounts = nullptr;
+
 bool LexAccessor::Match(Sci_Position pos, std::string_view sv) {
 	for (unsigned int i = 0; i < sv.size(); i++) {
 		if (sv[i] != SafeGetCharAt(pos + i)) {
@@ -83,6 +125,128 @@ std::string LexAccessor::GetRangeLowered(Sci_PositionU startPos_, Sci_PositionU
 	return s;
 }
 
+bool LexAccessor::SupportsStyleRange(int version) noexcept {
+	return ((version & dvStyleRange) != 0) && !ReferenceMode();
+}
+
+bool LexAccessor::SupportsFills(int version) noexcept {
+	return (version & dvFills) != 0;
+}
+
+void LexAccessor::Filling(Sci_Position position) {
+	static_cast<IDocumentFills *>(pAccess)->Filling(position);
+}
+
+const unsigned char *LexAccessor::DBCSBytes(int codePage) noexcept {
+	switch (codePage) {
+	case 932:
+		return dbcs932.flags;
+	case 936:
+		return dbcs936.flags;
+	case 949:
+		return dbcs949.flags;
+	case 950:
+		return dbcs950.flags;
+	case 1361:
+		return dbcs1361.flags;
+	default:
+		return dbcsNone.flags;
+	}
+}
+
+void SetReferenceMode(bool on) noexcept {
+	referenceMode = on;
+}
+
+bool ReferenceMode() noexcept {
+	return referenceMode;
+}
+
+size_t ScanBytesScalar(const char *text, size_t length, const unsigned char *stops, size_t count, unsigned char stopAbove) noexcept {
+	for (size_t i = 0; i < length; i++) {
+		const unsigned char ch = text[i];
+		if ((ch > stopAbove) || (std::find(stops, stops + count, ch) != stops + count)) {
+			return i;
+		}
+	}
+	return length;
+}
+
+size_t ScanBytes(const char *text, size_t length, const unsigned char *stops, size_t count, unsigned char stopAbove) noexcept {
+	assert(count <= CharacterSet::maxMembers);
+	size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+	constexpr size_t vectorSize = sizeof(__m128i);
+	__m128i vectorStops[CharacterSet::maxMembers];
+	for (size_t stop = 0; stop < count; stop++) {
+		vectorStops[stop] = _mm_set1_epi8(static_cast<char>(stops[stop]));
+	}
+	// There is no unsigned greater than so a byte is above stopAbove when it is the maximum of
+	// itself and stopAbove + 1
+	const bool checkAbove = stopAbove < 0xFF;
+	const __m128i aboveMinimum = _mm_set1_epi8(static_cast<char>(stopAbove + 1));
+	for (; i + vectorSize <= length; i += vectorSize) {
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i));
+		__m128i found = checkAbove ? _mm_cmpeq_epi8(_mm_max_epu8(bytes, aboveMinimum), bytes) : _mm_setzero_si128();
+		for (size_t stop = 0; stop < count; stop++) {
+			found = _mm_or_si128(found, _mm_cmpeq_epi8(bytes, vectorStops[stop]));
+		}
+		if (_mm_movemask_epi8(found)) {
+			// Find which byte in the 16 that matched
+			return i + ScanBytesScalar(text + i, vectorSize, stops, count, stopAbove);
+		}
+	}
+#elif defined(__ARM_NEON)
+	constexpr size_t vectorSize = sizeof(uint8x16_t);
+	uint8x16_t vectorStops[CharacterSet::maxMembers];
+	for (size_t stop = 0; stop < count; stop++) {
+		vectorStops[stop] = vdupq_n_u8(stops[stop]);
+	}
+	const uint8x16_t above = vdupq_n_u8(stopAbove);
+	for (; i + vectorSize <= length; i += vectorSize) {
+		const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t *>(text + i));
+		uint8x16_t found = vcgtq_u8(bytes, above);
+		for (size_t stop = 0; stop < count; stop++) {
+			found = vorrq_u8(found, vceqq_u8(bytes, vectorStops[stop]));
+		}
+		// Any byte set shows in one of the two halves
+		const uint64x2_t halves = vreinterpretq_u64_u8(found);
+		if (vgetq_lane_u64(halves, 0) | vgetq_lane_u64(halves, 1)) {
+			return i + ScanBytesScalar(text + i, vectorSize, stops, count, stopAbove);
+		}
+	}
+#endif
+	return i + ScanBytesScalar(text + i, length - i, stops, count, stopAbove);
+}
+
+Sci_Position LexAccessor::ScanUntilAnyOf(Sci_Position position, Sci_Position endPos_, const unsigned char *stops, size_t count, unsigned char stopAbove) {
+	while (position < endPos_) {
+		const std::string_view text = BufferFrom(position, endPos_);
+		if (text.empty()) {
+			return endPos_;
+		}
+		const size_t i = ScanBytes(text.data(), text.length(), stops, count, stopAbove);
+		position += i;
+		if (i < text.length()) {
+			return position;
+		}
+	}
+	return endPos_;
+}
+
+void LexAccessor::FillStyles(Sci_Position position) const {
+	// Fold passes read forwards but backtracking reads backwards so extend the window in the
+	// direction of reading.
+	const bool backwards = (styleEnd > styleStart) && (position < styleStart);
+	styleStart = backwards ? position + slopSize + 1 - bufferSize : position - slopSize;
+	if (styleStart + bufferSize > lenDoc)
+		styleStart = lenDoc - bufferSize;
+	if (styleStart < 0)
+		styleStart = 0;
+	styleEnd = std::min<Sci_Position>(styleStart + bufferSize, lenDoc);
+	static_cast<const IDocumentStyles *>(pAccess)->GetStyleRange(styleWindow, styleStart, styleEnd - styleStart);
+}
+
 void LexAccessor::SetLevelIfDifferent(Sci_Position line, int level) {
 	if (level != pAccess->GetLevel(line)) {
 		pAccess->SetLevel(line, level);
@@ -12,6 +12,51 @@ namespace Lexilla {
 
 enum class EncodingType { eightBit, unicode, dbcs };
 
+// Informed of each range as its style is set so that a lexer can fold while lexing
+// instead of reading the styles back from the document.
+class StyleListener {
+public:
+	virtual ~StyleListener() = default;
+	virtual void Styled(Sci_PositionU start, Sci_PositionU end, int style) = 0;
+};
+
+// Work done by the LexAccessors of a thread during a Lex or Fold call measured for statistics.
+struct AccessorCounts {
+	size_t fills;
+	size_t flushes;
+	Sci_PositionU lowestStart;
+};
+// Points to the counts of the call being measured on this thread, otherwise null so that
+// LexAccessors count nothing when statistics are not being collected.
+extern thread_local AccessorCounts *accessorCounts;
+
+#if defined(LEXILLA_TRACE)
+// Defined in LexerTrace.cxx.
+// Current time in nanoseconds for the start of an event.
+[[nodiscard]] unsigned long long TraceNow() noexcept;
+// Add an event that started at start and ends now. Arguments that do not apply are -1.
+// name and lexer are kept so must stay valid while the library is loaded.
+// When lexer is null, the lexer of the innermost TraceScope on this thread is used.
+void TraceEvent(const char *name, const char *lexer, unsigned long long start,
+	Sci_Position position, Sci_Position length, Sci_Position lines) noexcept;
+#endif
+
+// In reference mode the library avoids its optimised paths: LexAccessor reads each style
+// from the document and decodes DBCS through it, StyleContext moves one character at a time
+// and copies tokens, WordLists do not share keyword lists, lexers do not fold during lexing,
+// and converging lexes do not stop early.
+// Results should be identical in both modes so comparing them validates the optimisations.
+// The mode applies to the whole library and is set through the library property lexilla.reference.mode.
+// A LexAccessor reads the mode when it is constructed.
+void SetReferenceMode(bool on) noexcept;
+[[nodiscard]] bool ReferenceMode() noexcept;
+
+// Index of the first byte of text that is one of the count bytes of stops or is above stopAbove,
+// or length when there is none. Compares 16 bytes at a time with SSE2 or NEON when available.
+[[nodiscard]] size_t ScanBytes(const char *text, size_t length, const unsigned char *stops, size_t count, unsigned char stopAbove) noexcept;
+// The same one byte at a time as used for the tail of text and to check the vector versions.
+[[nodiscard]] size_t ScanBytesScalar(const char *text, size_t length, const unsigned char *stops, size_t count, unsigned char stopAbove) noexcept;
+
 class LexAccessor {
 private:
 	Scintilla::IDocument *pAccess;
@@ -26,12 +71,36 @@ private:
 	Sci_Position endPos;
 	int codePage;
 	enum EncodingType encodingType;
+	// Lead and trail byte flags for each byte of the code page, all clear unless DBCS.
+	const unsigned char *dbcsBytes;
 	Sci_Position lenDoc;
 	char styleBuf[bufferSize];
 	Sci_Position validLen;
 	Sci_PositionU startSeg;
 	Sci_Position startPosStyling;
 	int documentVersion;
+	StyleListener *styleListener;
+	// When the document can copy styles in bulk, StyleAt reads from styleWindow which is
+	// discarded whenever this accessor writes styles.
+	const bool styleRange;
+	mutable char styleWindow[bufferSize];
+	mutable Sci_Position styleStart;
+	mutable Sci_Position styleEnd;
+	AccessorCounts *const counts;
+	// The document records reads so is told the position needed for each fill.
+	const bool fills;
+	// Reference mode was on when constructed.
+	const bool reference;
+
+	static bool SupportsStyleRange(int version) noexcept;
+	static bool SupportsFills(int version) noexcept;
+	void Filling(Sci_Position position);
+	static const unsigned char *DBCSBytes(int codePage) noexcept;
+	void FillStyles(Sci_Position position) const;
+	void InvalidateStyles() noexcept {
+		styleStart = extremePosition;
+		styleEnd = 0;
+	}
 
 	void Fill(Sci_Position position) {
 		startPos = position - slopSize;
@@ -43,8 +112,20 @@ private:
 		if (endPos > lenDoc)
 			endPos = lenDoc;
 
+#if defined(LEXILLA_TRACE)
+		const unsigned long long traceStart = TraceNow();
+#endif
+		if (fills) {
+			Filling(position);
+		}
 		pAccess->GetCharRange(buf, startPos, endPos-startPos);
 		buf[endPos-startPos] = '\0';
+		if (counts) {
+			counts->fills++;
+		}
+#if defined(LEXILLA_TRACE)
+		TraceEvent("Fill", nullptr, traceStart, startPos, endPos-startPos, -1);
+#endif
 	}
 
 public:
@@ -52,13 +133,21 @@ public:
 		pAccess(pAccess_), startPos(extremePosition), endPos(0),
 		codePage(pAccess->CodePage()),
 		encodingType(EncodingType::eightBit),
+		dbcsBytes(DBCSBytes(codePage)),
 		lenDoc(pAccess->Length()),
 		validLen(0),
 		startSeg(0), startPosStyling(0),
-		documentVersion(pAccess->Version()) {
-		// Prevent warnings by static analyzers about uninitialized buf and styleBuf.
+		documentVersion(pAccess->Version()),
+		styleListener(nullptr),
+		styleRange(SupportsStyleRange(documentVersion)),
+		styleStart(extremePosition), styleEnd(0),
+		counts(accessorCounts),
+		fills(SupportsFills(documentVersion)),
+		reference(ReferenceMode()) {
+		// Prevent warnings by static analyzers about uninitialized buf, styleBuf, and styleWindow.
 		buf[0] = 0;
 		styleBuf[0] = 0;
+		styleWindow[0] = 0;
 		switch (codePage) {
 		case 65001:
 			encodingType = EncodingType::unicode;
@@ -94,16 +183,41 @@ public:
 		}
 		return buf[position - startPos];
 	}
+	enum { dbcsLeadByte=1, dbcsTrailByte=2 };
 	bool IsLeadByte(char ch) const {
-		const unsigned char uch = ch;
-		return
-			(uch >= 0x80) &&	// non-ASCII
-			(encodingType == EncodingType::dbcs) &&		// IsDBCSLeadByte only for DBCS
-			pAccess->IsDBCSLeadByte(ch);
+		if (reference) {
+			return pAccess->IsDBCSLeadByte(ch);
+		}
+		return dbcsBytes[static_cast<unsigned char>(ch)] & dbcsLeadByte;
+	}
+	// Character and width at position in a DBCS document, decoded from the buffer as
+	// IDocument::GetCharacterAndWidth would without calling the document for each character.
+	int DBCSCharacterAndWidth(Sci_Position position, Sci_Position *pWidth) {
+		if (reference) {
+			return pAccess->GetCharacterAndWidth(position, pWidth);
+		}
+		const unsigned char leadByte = SafeGetCharAt(position, 0);
+		int character = leadByte;
+		Sci_Position width = 1;
+		if (dbcsBytes[leadByte] & dbcsLeadByte) {
+			const unsigned char trailByte = SafeGetCharAt(position + 1, 0);
+			if (dbcsBytes[trailByte] & dbcsTrailByte) {
+				character = (leadByte << 8) | trailByte;
+				width = 2;
+			}
+		}
+		if (pWidth) {
+			*pWidth = width;
+		}
+		return character;
 	}
 	EncodingType Encoding() const noexcept {
 		return encodingType;
 	}
+	// Whether optimised paths should be avoided as reference mode was on when constructed.
+	[[nodiscard]] bool ReferencePath() const noexcept {
+		return reference;
+	}
 	bool Match(Sci_Position pos, const char *s) {
 		assert(s);
 		for (int i=0; *s; i++) {
@@ -122,12 +236,65 @@ public:
 	// Get all characters in range [startPos_, endPos_).
 	std::string GetRange(Sci_PositionU startPos_, Sci_PositionU endPos_) const;
 	std::string GetRangeLowered(Sci_PositionU startPos_, Sci_PositionU endPos_) const;
+	// Pointer to the characters in range [startPos_, endPos_) when they are all in the buffer,
+	// otherwise nullptr. Only valid until the buffer is next filled.
+	[[nodiscard]] const char *BufferPointer(Sci_PositionU startPos_, Sci_PositionU endPos_) const noexcept {
+		if (startPos_ >= static_cast<Sci_PositionU>(startPos) && endPos_ <= static_cast<Sci_PositionU>(endPos)) {
+			return buf + (startPos_ - startPos);
+		}
+		return nullptr;
+	}
+	// View of the buffered characters from position up to endPos_, which may end sooner at the
+	// end of the buffer. Fills the buffer when position is not in it.
+	[[nodiscard]] std::string_view BufferFrom(Sci_Position position, Sci_Position endPos_) {
+		if (position < startPos || position >= endPos) {
+			Fill(position);
+		}
+		const Sci_Position end = (endPos_ < endPos) ? endPos_ : endPos;
+		if (position < startPos || position >= end) {
+			return {};
+		}
+		return std::string_view(buf + position - startPos, end - position);
+	}
+	// Position of the first byte from position up to endPos_ that is one of the count bytes of
+	// stops or is above stopAbove, or endPos_ when there is none.
+	[[nodiscard]] Sci_Position ScanUntilAnyOf(Sci_Position position, Sci_Position endPos_, const unsigned char *stops, size_t count, unsigned char stopAbove=0xFF);
+	// Position of the first byte from position up to endPos_ that is in set or is above
+	// stopAbove, or endPos_ when there is none. Scans the buffer a window at a time without
+	// calling the document for each byte. Sets with few enough members are scanned by ScanBytes.
+	template <typename Set>
+	[[nodiscard]] Sci_Position ScanUntilAny(Sci_Position position, Sci_Position endPos_, const Set &set, unsigned char stopAbove=0xFF) {
+		if (set.MemberCount() <= Set::maxMembers) {
+			return ScanUntilAnyOf(position, endPos_, set.Members(), set.MemberCount(), stopAbove);
+		}
+		while (position < endPos_) {
+			const std::string_view text = BufferFrom(position, endPos_);
+			if (text.empty()) {
+				return endPos_;
+			}
+			size_t i = 0;
+			while ((i < text.length()) && (static_cast<unsigned char>(text[i]) <= stopAbove) && !set.Contains(text[i])) {
+				i++;
+			}
+			position += i;
+			if (i < text.length()) {
+				return position;
+			}
+		}
+		return endPos_;
+	}
 
 	char StyleAt(Sci_Position position) const {
-		return pAccess->StyleAt(position);
+		if (position < styleStart || position >= styleEnd) {
+			if (!styleRange || position < 0 || position >= lenDoc) {
+				return pAccess->StyleAt(position);
+			}
+			FillStyles(position);
+		}
+		return styleWindow[position - styleStart];
 	}
 	int StyleIndexAt(Sci_Position position) const {
-		const unsigned char style = pAccess->StyleAt(position);
+		const unsigned char style = StyleAt(position);
 		return style;
 	}
 	// Return style value from buffer when in buffer, else retrieve from document.
@@ -138,8 +305,7 @@ public:
 			const unsigned char style = styleBuf[index];
 			return style;
 		}
-		const unsigned char style = pAccess->StyleAt(position);
-		return style;
+		return StyleIndexAt(position);
 	}
 	Sci_Position GetLine(Sci_Position position) const {
 		return pAccess->LineFromPosition(position);
@@ -159,8 +325,12 @@ public:
 	void Flush() {
 		if (validLen > 0) {
 			pAccess->SetStyles(validLen, styleBuf);
+			if (counts) {
+				counts->flushes++;
+			}
 			startPosStyling += validLen;
 			validLen = 0;
+			InvalidateStyles();
 		}
 	}
 	int GetLineState(Sci_Position line) const {
@@ -173,6 +343,12 @@ public:
 	void StartAt(Sci_PositionU start) {
 		pAccess->StartStyling(start);
 		startPosStyling = start;
+		if (counts && (start < counts->lowestStart)) {
+			counts->lowestStart = start;
+		}
+	}
+	void SetStyleListener(StyleListener *styleListener_) noexcept {
+		styleListener = styleListener_;
 	}
 	Sci_PositionU GetStartSegment() const noexcept {
 		return startSeg;
@@ -191,6 +367,9 @@ public:
 			}
 			assert((startPosStyling + validLen + len) <= static_cast<Sci_PositionU>(Length()));
 			const unsigned char attr = chAttr & 0xffU;
+			if (styleListener) {
+				styleListener->Styled(startSeg, pos, attr);
+			}
 			startSeg += len;
 			if (validLen + len < bufferSize) {
 				for (Sci_PositionU i = 0; i < len; i++) {
@@ -199,6 +378,10 @@ public:
 			} else {
 				// Too big for buffer so send directly
 				pAccess->SetStyleFor(len, attr);
+				if (counts) {
+					counts->flushes++;
+				}
+				InvalidateStyles();
 			}
 		}
 	}
@@ -10,6 +10,7 @@
 
 #include <string>
 #include <string_view>
+#include <memory>
 
 #include "ILexer.h"
 #include "Scintilla.h"
@@ -10,21 +10,32 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
+#include <memory>
 
 #include "ILexer.h"
 #include "Scintilla.h"
 #include "SciLexer.h"
+#include "LexillaExtensions.h"
 
 #include "PropSetSimple.h"
 #include "WordList.h"
 #include "LexAccessor.h"
 #include "Accessor.h"
 #include "LexerModule.h"
+#include "Convergence.h"
+#include "LineStyleCache.h"
 #include "LexerBase.h"
 #include "LexerSimple.h"
 
 using namespace Lexilla;
 
+namespace {
+
+const PropertyKey propFold("fold");
+
+}
+
 LexerSimple::LexerSimple(const LexerModule *module_) :
 	LexerBase(module_->LexClasses(), module_->NamedStyles()),
 	lexerModule(module_) {
@@ -35,24 +46,65 @@ LexerSimple::LexerSimple(const LexerModule *module_) :
 	}
 }
 
+LexerSimple::~LexerSimple() = default;
+
+Sci_Position SCI_METHOD LexerSimple::PropertySet(const char *key, const char *val) {
+	const Sci_Position firstModification = LexerBase::PropertySet(key, val);
+	if ((firstModification >= 0) && lineStyleCache) {
+		// Styles remembered may depend on the property
+		lineStyleCache->Clear();
+	}
+	return firstModification;
+}
+
 const char * SCI_METHOD LexerSimple::DescribeWordListSets() {
 	return wordLists.c_str();
 }
 
+Sci_Position SCI_METHOD LexerSimple::WordListSet(int n, const char *wl) {
+	const Sci_Position firstModification = LexerBase::WordListSet(n, wl);
+	if ((firstModification >= 0) && lineStyleCache) {
+		lineStyleCache->Clear();
+	}
+	return firstModification;
+}
+
 void SCI_METHOD LexerSimple::Lex(Sci_PositionU startPos, Sci_Position lengthDoc, int initStyle, Scintilla::IDocument *pAccess) {
 	Accessor astyler(pAccess, &props);
+	if (LineStyleCaching()) {
+		if (!lineStyleCache) {
+			lineStyleCache = std::make_unique<LineStyleCache>();
+		}
+		astyler.lineStyleCache = lineStyleCache.get();
+	}
 	lexerModule->Lex(startPos, lengthDoc, initStyle, keyWordLists, astyler);
 	astyler.Flush();
 }
 
 void SCI_METHOD LexerSimple::Fold(Sci_PositionU startPos, Sci_Position lengthDoc, int initStyle, Scintilla::IDocument *pAccess) {
-	if (props.GetInt("fold")) {
+	if (props.GetInt(propFold)) {
 		Accessor astyler(pAccess, &props);
 		lexerModule->Fold(startPos, lengthDoc, initStyle, keyWordLists, astyler);
 		astyler.Flush();
 	}
 }
 
+void * SCI_METHOD LexerSimple::PrivateCall(int operation, void *pointer) {
+	// Lexing functions hold no state between calls so can be restarted at any line start
+	if (operation == privateCallLexBudgeted) {
+		return LexBudgeted(this, pointer);
+	}
+	if ((operation == privateCallLineStyleCache) && pointer && lineStyleCache) {
+		// Every lexing function is given the cache but only report it once used
+		LineStyleCacheUse *use = static_cast<LineStyleCacheUse *>(pointer);
+		lineStyleCache->Report(*use);
+		if (use->lookups > 0) {
+			return pointer;
+		}
+	}
+	return LexerBase::PrivateCall(operation, pointer);
+}
+
 const char * SCI_METHOD LexerSimple::GetName() {
 	return lexerModule->languageName;
 }
@@ -10,15 +10,28 @@
 
 namespace Lexilla {
 
+class LineStyleCache;	// Forward declaration
+
 // A simple lexer with no state
 class LexerSimple : public LexerBase {
 	const LexerModule *lexerModule;
 	std::string wordLists;
+	// Created when first lexing with line style caching on
+	std::unique_ptr<LineStyleCache> lineStyleCache;
 public:
 	explicit LexerSimple(const LexerModule *lexerModule_);
+	// Deleted so LexerSimple objects can not be copied.
+	LexerSimple(const LexerSimple &) = delete;
+	LexerSimple(LexerSimple &&) = delete;
+	LexerSimple &operator=(const LexerSimple &) = delete;
+	LexerSimple &operator=(LexerSimple &&) = delete;
+	~LexerSimple() override;
+	Sci_Position SCI_METHOD PropertySet(const char *key, const char *val) override;
 	const char * SCI_METHOD DescribeWordListSets() override;
+	Sci_Position SCI_METHOD WordListSet(int n, const char *wl) override;
 	void SCI_METHOD Lex(Sci_PositionU startPos, Sci_Position lengthDoc, int initStyle, Scintilla::IDocument *pAccess) override;
 	void SCI_METHOD Fold(Sci_PositionU startPos, Sci_Position lengthDoc, int initStyle, Scintilla::IDocument *pAccess) override;
+	void * SCI_METHOD PrivateCall(int operation, void *pointer) override;
 	// ILexer5 methods
 	const char * SCI_METHOD GetName() override;
 	int SCI_METHOD  GetIdentifier() override;
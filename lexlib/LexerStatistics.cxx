@@ -0,0 +1,354 @@
+// Lexilla lexer library
+/** @file LexerStatistics.cxx
+ ** Count the work done by lexers for each language so applications can see where lexing time goes.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <map>
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+#include "ILexer.h"
+
+#include "LexAccessor.h"
+#include "LexerStatistics.h"
+#include "LexerTrace.h"
+
+using namespace Lexilla;
+
+namespace {
+
+std::atomic<bool> statisticsCollection = false;
+
+// Lexers on several threads may add to the same language so each counter is atomic. Counters
+// are only summed so relaxed ordering is enough and keeps the cost to a few instructions.
+class Counter {
+	std::atomic<std::uint64_t> value = 0;
+public:
+	void Add(std::uint64_t amount) noexcept {
+		value.fetch_add(amount, std::memory_order_relaxed);
+	}
+	void Maximum(std::uint64_t amount) noexcept {
+		std::uint64_t current = value.load(std::memory_order_relaxed);
+		while ((amount > current) && !value.compare_exchange_weak(current, amount, std::memory_order_relaxed)) {
+		}
+	}
+	[[nodiscard]] std::uint64_t Value() const noexcept {
+		return value.load(std::memory_order_relaxed);
+	}
+};
+
+// Counts for Lex or for Fold.
+struct CallCounters {
+	Counter calls;
+	Counter bytes;
+	Counter nanoseconds;
+	Counter nanosecondsMax;
+	Counter fills;
+	Counter flushes;
+};
+
+struct LanguageCounters {
+	CallCounters lex;
+	CallCounters fold;
+	// Distance Lex started styling before the position it was asked to lex from
+	Counter backtrack;
+	Counter backtrackMax;
+};
+
+struct Registry {
+	std::mutex mutex;
+	// Entries are never removed so lexers can keep pointers to their counters
+	std::map<std::string, LanguageCounters, std::less<>> languages;
+};
+
+Registry &TheRegistry() {
+	// Never destroyed as lexers in static objects may be released after it would be
+	static Registry *registry = new Registry();
+	return *registry;
+}
+
+// The name is returned with the counters as lexers keep a pointer to it for tracing.
+std::pair<const std::string, LanguageCounters> &CountersForLanguage(const char *language) {
+	Registry &registry = TheRegistry();
+	std::lock_guard<std::mutex> guard(registry.mutex);
+	return *registry.languages.try_emplace(language).first;
+}
+
+#if defined(LEXILLA_TRACE)
+// Number of lines touched by a call on [startPos, startPos + lengthDoc).
+Sci_Position LinesIn(const Scintilla::IDocument *pAccess, Sci_PositionU startPos, Sci_Position lengthDoc) {
+	if (lengthDoc <= 0) {
+		return 0;
+	}
+	return pAccess->LineFromPosition(startPos + lengthDoc - 1) - pAccess->LineFromPosition(startPos) + 1;
+}
+#endif
+
+constexpr Sci_PositionU noStart = static_cast<Sci_PositionU>(-1);
+
+// Measures one Lex or Fold call from construction to Finish.
+// LexAccessors created meanwhile on this thread count into counts. When calls nest, as when
+// a lexer creates another, the work of the inner call is also added to the outer call.
+class CallMeasure {
+	CallCounters &counters;
+	AccessorCounts counts { 0, 0, noStart };
+	AccessorCounts *countsOuter;
+	std::chrono::steady_clock::time_point start;
+public:
+	explicit CallMeasure(CallCounters &counters_) noexcept :
+		counters(counters_), countsOuter(accessorCounts), start(std::chrono::steady_clock::now()) {
+		accessorCounts = &counts;
+	}
+	// Deleted so CallMeasure objects can not be copied.
+	CallMeasure(const CallMeasure &) = delete;
+	CallMeasure(CallMeasure &&) = delete;
+	CallMeasure &operator=(const CallMeasure &) = delete;
+	CallMeasure &operator=(CallMeasure &&) = delete;
+	~CallMeasure() {
+		accessorCounts = countsOuter;
+		if (countsOuter) {
+			countsOuter->fills += counts.fills;
+			countsOuter->flushes += counts.flushes;
+			countsOuter->lowestStart = std::min(countsOuter->lowestStart, counts.lowestStart);
+		}
+	}
+	// Returns the lowest position styled during the call.
+	Sci_PositionU Finish(Sci_Position lengthDoc) noexcept {
+		if (StatisticsCollection()) {
+			const std::chrono::nanoseconds duration = std::chrono::steady_clock::now() - start;
+			const std::uint64_t nanoseconds = duration.count();
+			counters.calls.Add(1);
+			counters.bytes.Add(lengthDoc);
+			counters.nanoseconds.Add(nanoseconds);
+			counters.nanosecondsMax.Maximum(nanoseconds);
+			counters.fills.Add(counts.fills);
+			counters.flushes.Add(counts.flushes);
+		}
+		return counts.lowestStart;
+	}
+};
+
+// In trace builds also adds trace events for calls that change or use the lexer.
+class LexerCounted : public Scintilla::ILexer5 {
+	Scintilla::ILexer5 *lexer;
+	const char *language;
+	LanguageCounters *counters;
+public:
+	LexerCounted(Scintilla::ILexer5 *lexer_, std::pair<const std::string, LanguageCounters> &languageCounters) noexcept :
+		lexer(lexer_), language(languageCounters.first.c_str()), counters(&languageCounters.second) {
+	}
+	// Deleted so LexerCounted objects can not be copied.
+	LexerCounted(const LexerCounted &) = delete;
+	LexerCounted(LexerCounted &&) = delete;
+	LexerCounted &operator=(const LexerCounted &) = delete;
+	LexerCounted &operator=(LexerCounted &&) = delete;
+	virtual ~LexerCounted() = default;
+
+	int SCI_METHOD Version() const override {
+		return lexer->Version();
+	}
+	void SCI_METHOD Release() override {
+		lexer->Release();
+		delete this;
+	}
+	const char *SCI_METHOD PropertyNames() override {
+		return lexer->PropertyNames();
+	}
+	int SCI_METHOD PropertyType(const char *name) override {
+		return lexer->PropertyType(name);
+	}
+	const char *SCI_METHOD DescribeProperty(const char *name) override {
+		return lexer->DescribeProperty(name);
+	}
+	Sci_Position SCI_METHOD PropertySet(const char *key, const char *val) override {
+#if defined(LEXILLA_TRACE)
+		const TraceScope trace("PropertySet", language);
+#endif
+		return lexer->PropertySet(key, val);
+	}
+	const char *SCI_METHOD DescribeWordListSets() override {
+		return lexer->DescribeWordListSets();
+	}
+	Sci_Position SCI_METHOD WordListSet(int n, const char *wl) override {
+#if defined(LEXILLA_TRACE)
+		const TraceScope trace("WordListSet", language);
+#endif
+		return lexer->WordListSet(n, wl);
+	}
+	void SCI_METHOD Lex(Sci_PositionU startPos, Sci_Position lengthDoc, int initStyle, Scintilla::IDocument *pAccess) override {
+#if defined(LEXILLA_TRACE)
+		const TraceScope trace("Lex", language, startPos, lengthDoc, LinesIn(pAccess, startPos, lengthDoc));
+#endif
+		if (!CountingLexers()) {
+			lexer->Lex(startPos, lengthDoc, initStyle, pAccess);
+			return;
+		}
+		CallMeasure measure(counters->lex);
+		lexer->Lex(startPos, lengthDoc, initStyle, pAccess);
+		const Sci_PositionU lowestStart = measure.Finish(lengthDoc);
+		if (lowestStart < startPos) {
+			if (StatisticsCollection()) {
+				counters->backtrack.Add(startPos - lowestStart);
+				counters->backtrackMax.Maximum(startPos - lowestStart);
+			}
+#if defined(LEXILLA_TRACE)
+			TraceEvent("Backtrack", language, TraceNow(), lowestStart, startPos - lowestStart, -1);
+#endif
+		}
+	}
+	void SCI_METHOD Fold(Sci_PositionU startPos, Sci_Position lengthDoc, int initStyle, Scintilla::IDocument *pAccess) override {
+#if defined(LEXILLA_TRACE)
+		const TraceScope trace("Fold", language, startPos, lengthDoc, LinesIn(pAccess, startPos, lengthDoc));
+#endif
+		if (!CountingLexers()) {
+			lexer->Fold(startPos, lengthDoc, initStyle, pAccess);
+			return;
+		}
+		CallMeasure measure(counters->fold);
+		lexer->Fold(startPos, lengthDoc, initStyle, pAccess);
+		measure.Finish(lengthDoc);
+	}
+	void *SCI_METHOD PrivateCall(int operation, void *pointer) override {
+		return lexer->PrivateCall(operation, pointer);
+	}
+	int SCI_METHOD LineEndTypesSupported() override {
+		return lexer->LineEndTypesSupported();
+	}
+	int SCI_METHOD AllocateSubStyles(int styleBase, int numberStyles) override {
+		return lexer->AllocateSubStyles(styleBase, numberStyles);
+	}
+	int SCI_METHOD SubStylesStart(int styleBase) override {
+		return lexer->SubStylesStart(styleBase);
+	}
+	int SCI_METHOD SubStylesLength(int styleBase) override {
+		return lexer->SubStylesLength(styleBase);
+	}
+	int SCI_METHOD StyleFromSubStyle(int subStyle) override {
+		return lexer->StyleFromSubStyle(subStyle);
+	}
+	int SCI_METHOD PrimaryStyleFromStyle(int style) override {
+		return lexer->PrimaryStyleFromStyle(style);
+	}
+	void SCI_METHOD FreeSubStyles() override {
+		lexer->FreeSubStyles();
+	}
+	void SCI_METHOD SetIdentifiers(int style, const char *identifiers) override {
+		lexer->SetIdentifiers(style, identifiers);
+	}
+	int SCI_METHOD DistanceToSecondaryStyles() override {
+		return lexer->DistanceToSecondaryStyles();
+	}
+	const char *SCI_METHOD GetSubStyleBases() override {
+		return lexer->GetSubStyleBases();
+	}
+	int SCI_METHOD NamedStyles() override {
+		return lexer->NamedStyles();
+	}
+	const char *SCI_METHOD NameOfStyle(int style) override {
+		return lexer->NameOfStyle(style);
+	}
+	const char *SCI_METHOD TagsOfStyle(int style) override {
+		return lexer->TagsOfStyle(style);
+	}
+	const char *SCI_METHOD DescriptionOfStyle(int style) override {
+		return lexer->DescriptionOfStyle(style);
+	}
+	const char *SCI_METHOD GetName() override {
+		return lexer->GetName();
+	}
+	int SCI_METHOD GetIdentifier() override {
+		return lexer->GetIdentifier();
+	}
+	const char *SCI_METHOD PropertyGet(const char *key) override {
+		return lexer->PropertyGet(key);
+	}
+};
+
+void AppendMember(std::string &json, std::string_view name, std::uint64_t value) {
+	if (json.back() != '{') {
+		json += ",";
+	}
+	json += "\"";
+	json += name;
+	json += "\":";
+	json += std::to_string(value);
+}
+
+void AppendCalls(std::string &json, std::string_view prefix, const CallCounters &counters) {
+	const std::string name(prefix);
+	AppendMember(json, name + "Calls", counters.calls.Value());
+	AppendMember(json, name + "Bytes", counters.bytes.Value());
+	AppendMember(json, name + "Nanoseconds", counters.nanoseconds.Value());
+	AppendMember(json, name + "NanosecondsMax", counters.nanosecondsMax.Value());
+	AppendMember(json, name + "Fills", counters.fills.Value());
+	AppendMember(json, name + "Flushes", counters.flushes.Value());
+}
+
+void AppendString(std::string &json, std::string_view text) {
+	json += "\"";
+	for (const char ch : text) {
+		if ((ch == '"') || (ch == '\\')) {
+			json += '\\';
+		}
+		json += ch;
+	}
+	json += "\"";
+}
+
+}
+
+namespace Lexilla {
+
+void SetStatisticsCollection(bool on) noexcept {
+	statisticsCollection = on;
+}
+
+bool StatisticsCollection() noexcept {
+	return statisticsCollection.load(std::memory_order_relaxed);
+}
+
+bool CountingLexers() noexcept {
+#if defined(LEXILLA_TRACE)
+	return true;
+#else
+	return StatisticsCollection();
+#endif
+}
+
+Scintilla::ILexer5 *CountedLexer(Scintilla::ILexer5 *lexer, const char *language) {
+	assert(lexer && language);
+	return new LexerCounted(lexer, CountersForLanguage(language));
+}
+
+std::string StatisticsJSON() {
+	Registry &registry = TheRegistry();
+	std::lock_guard<std::mutex> guard(registry.mutex);
+	std::string json = "{";
+	for (const auto &[language, counters] : registry.languages) {
+		if (json.back() != '{') {
+			json += ",";
+		}
+		AppendString(json, language);
+		json += ":{";
+		AppendCalls(json, "lex", counters.lex);
+		AppendCalls(json, "fold", counters.fold);
+		AppendMember(json, "backtrackBytes", counters.backtrack.Value());
+		AppendMember(json, "backtrackBytesMax", counters.backtrackMax.Value());
+		json += "}";
+	}
+	json += "}";
+	return json;
+}
+
+}
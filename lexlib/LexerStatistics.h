@@ -0,0 +1,31 @@
+// Lexilla lexer library
+/** @file LexerStatistics.h
+ ** Count the work done by lexers for each language so applications can see where lexing time goes.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef LEXERSTATISTICS_H
+#define LEXERSTATISTICS_H
+
+// Must have already included <string> and ILexer.h.
+
+namespace Lexilla {
+
+// Statistics collection applies to the whole library and is set through the library property
+// lexilla.statistics. Only lexers created while it is on are counted.
+void SetStatisticsCollection(bool on) noexcept;
+[[nodiscard]] bool StatisticsCollection() noexcept;
+// Whether new lexers should be wrapped by CountedLexer: when collecting statistics or in
+// builds with LEXILLA_TRACE where the wrapper adds the trace events for each call.
+[[nodiscard]] bool CountingLexers() noexcept;
+
+// Return a lexer that forwards to lexer and adds the work of its Lex and Fold calls to the
+// counters of language. Owns lexer and releases it when released.
+[[nodiscard]] Scintilla::ILexer5 *CountedLexer(Scintilla::ILexer5 *lexer, const char *language);
+
+// The counters of every language as a JSON object with a member for each language.
+[[nodiscard]] std::string StatisticsJSON();
+
+}
+
+#endif
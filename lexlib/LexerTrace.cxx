@@ -0,0 +1,234 @@
+// Lexilla lexer library
+/** @file LexerTrace.cxx
+ ** Record what lexers do over time in builds with LEXILLA_TRACE and export it for trace viewers.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstddef>
+#include <cstdio>
+#include <cassert>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+#include "ILexer.h"
+
+#include "LexAccessor.h"
+#include "LexerTrace.h"
+
+#if defined(LEXILLA_TRACE)
+
+using namespace Lexilla;
+
+namespace {
+
+struct Event {
+	const char *name = nullptr;
+	const char *lexer = nullptr;
+	unsigned long long start = 0;
+	unsigned long long end = 0;
+	Sci_Position position = -1;
+	Sci_Position length = -1;
+	Sci_Position lines = -1;
+};
+
+// A slot of the ring. Fields are atomic as TraceJSON may read a slot while its thread writes
+// it. Relaxed order is enough as a reader discards slots written while it was copying them.
+struct Slot {
+	std::atomic<const char *> name = nullptr;
+	std::atomic<const char *> lexer = nullptr;
+	std::atomic<unsigned long long> start = 0;
+	std::atomic<unsigned long long> end = 0;
+	std::atomic<Sci_Position> position = -1;
+	std::atomic<Sci_Position> length = -1;
+	std::atomic<Sci_Position> lines = -1;
+
+	void Store(const Event &event) noexcept {
+		name.store(event.name, std::memory_order_relaxed);
+		lexer.store(event.lexer, std::memory_order_relaxed);
+		start.store(event.start, std::memory_order_relaxed);
+		end.store(event.end, std::memory_order_relaxed);
+		position.store(event.position, std::memory_order_relaxed);
+		length.store(event.length, std::memory_order_relaxed);
+		lines.store(event.lines, std::memory_order_relaxed);
+	}
+	[[nodiscard]] Event Load() const noexcept {
+		return {
+			name.load(std::memory_order_relaxed),
+			lexer.load(std::memory_order_relaxed),
+			start.load(std::memory_order_relaxed),
+			end.load(std::memory_order_relaxed),
+			position.load(std::memory_order_relaxed),
+			length.load(std::memory_order_relaxed),
+			lines.load(std::memory_order_relaxed),
+		};
+	}
+};
+
+// Written only by its own thread. Readers take a copy then discard any events the writer may
+// have replaced while copying, which are those older than ringSize - 1 events before the end.
+struct Ring {
+	static constexpr size_t ringSize = 0x10000;
+	std::unique_ptr<Slot[]> events = std::make_unique<Slot[]>(ringSize);
+	std::atomic<size_t> written = 0;
+	std::atomic<size_t> cleared = 0;
+	size_t thread = 0;
+};
+
+struct Rings {
+	std::mutex mutex;
+	// Rings outlive their threads so events from finished threads can still be exported
+	std::vector<std::unique_ptr<Ring>> rings;
+};
+
+Rings &TheRings() {
+	// Never destroyed as threads may still be tracing while the library is unloaded
+	static Rings *rings = new Rings();
+	return *rings;
+}
+
+Ring &ThreadRing() {
+	thread_local Ring *ring = [] {
+		Rings &all = TheRings();
+		std::lock_guard<std::mutex> guard(all.mutex);
+		all.rings.push_back(std::make_unique<Ring>());
+		all.rings.back()->thread = all.rings.size();
+		return all.rings.back().get();
+	}();
+	return *ring;
+}
+
+thread_local const char *lexerCurrent = nullptr;
+
+void AppendString(std::string &json, std::string_view text) {
+	json += "\"";
+	for (const char ch : text) {
+		if ((ch == '"') || (ch == '\\')) {
+			json += '\\';
+		}
+		json += ch;
+	}
+	json += "\"";
+}
+
+void AppendArgument(std::string &json, std::string_view name, Sci_Position value) {
+	if (value >= 0) {
+		json += ",\"";
+		json += name;
+		json += "\":";
+		json += std::to_string(value);
+	}
+}
+
+// Chrome trace times are in microseconds.
+std::string Microseconds(unsigned long long nanoseconds) {
+	return std::to_string(nanoseconds / 1000) + "." + std::to_string(1000 + nanoseconds % 1000).substr(1);
+}
+
+void AppendEvent(std::string &json, const Event &event, size_t thread) {
+	json += "{\"name\":";
+	AppendString(json, event.name);
+	json += ",\"cat\":\"lexilla\",\"ph\":\"X\",\"ts\":";
+	json += Microseconds(event.start);
+	json += ",\"dur\":";
+	json += Microseconds(event.end - event.start);
+	json += ",\"pid\":1,\"tid\":";
+	json += std::to_string(thread);
+	json += ",\"args\":{\"lexer\":";
+	AppendString(json, event.lexer ? event.lexer : "");
+	AppendArgument(json, "position", event.position);
+	AppendArgument(json, "length", event.length);
+	AppendArgument(json, "lines", event.lines);
+	json += "}}";
+}
+
+}
+
+namespace Lexilla {
+
+unsigned long long TraceNow() noexcept {
+	const std::chrono::nanoseconds sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+	return sinceEpoch.count();
+}
+
+void TraceEvent(const char *name, const char *lexer, unsigned long long start,
+	Sci_Position position, Sci_Position length, Sci_Position lines) noexcept {
+	Ring &ring = ThreadRing();
+	const size_t index = ring.written.load(std::memory_order_relaxed);
+	ring.events[index % Ring::ringSize].Store({
+		name, lexer ? lexer : lexerCurrent, start, TraceNow(), position, length, lines
+	});
+	ring.written.store(index + 1, std::memory_order_release);
+}
+
+TraceScope::TraceScope(const char *name_, const char *lexer_, Sci_Position position_, Sci_Position length_, Sci_Position lines_) noexcept :
+	name(name_), lexer(lexer_), lexerOuter(lexerCurrent), start(TraceNow()),
+	position(position_), length(length_), lines(lines_) {
+	lexerCurrent = lexer;
+}
+
+TraceScope::~TraceScope() {
+	TraceEvent(name, lexer, start, position, length, lines);
+	lexerCurrent = lexerOuter;
+}
+
+std::string TraceJSON() {
+	Rings &all = TheRings();
+	std::lock_guard<std::mutex> guard(all.mutex);
+	std::string json = "{\"traceEvents\":[";
+	bool first = true;
+	for (const std::unique_ptr<Ring> &ring : all.rings) {
+		const size_t end = ring->written.load(std::memory_order_acquire);
+		const size_t begin = std::max(ring->cleared.load(std::memory_order_relaxed),
+			(end > Ring::ringSize) ? end - Ring::ringSize : 0);
+		std::vector<Event> events;
+		for (size_t index = begin; index < end; index++) {
+			events.push_back(ring->events[index % Ring::ringSize].Load());
+		}
+		// Drop events that may have been replaced while copying. The fence orders the
+		// copies before reading how far the writer has reached. The writer stores event
+		// endAfter before publishing it so the slot it shares may be part written.
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const size_t endAfter = ring->written.load(std::memory_order_acquire);
+		const size_t overwritten = (endAfter + 1 > Ring::ringSize) ? endAfter + 1 - Ring::ringSize : 0;
+		for (size_t index = begin; index < end; index++) {
+			if (index >= overwritten) {
+				if (!first) {
+					json += ",";
+				}
+				first = false;
+				AppendEvent(json, events[index - begin], ring->thread);
+			}
+		}
+	}
+	json += "]}";
+	return json;
+}
+
+bool WriteTrace(const char *path) {
+	FILE *fp = fopen(path, "wb");
+	if (!fp) {
+		return false;
+	}
+	const std::string json = TraceJSON();
+	const bool written = fwrite(json.data(), 1, json.length(), fp) == json.length();
+	return (fclose(fp) == 0) && written;
+}
+
+void ClearTrace() {
+	Rings &all = TheRings();
+	std::lock_guard<std::mutex> guard(all.mutex);
+	for (const std::unique_ptr<Ring> &ring : all.rings) {
+		ring->cleared.store(ring->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+	}
+}
+
+}
+
+#endif
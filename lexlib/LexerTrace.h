@@ -0,0 +1,48 @@
+// Lexilla lexer library
+/** @file LexerTrace.h
+ ** Record what lexers do over time in builds with LEXILLA_TRACE and export it for trace viewers.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef LEXERTRACE_H
+#define LEXERTRACE_H
+
+// Must have already included <string>, ILexer.h, and LexAccessor.h.
+
+namespace Lexilla {
+
+#if defined(LEXILLA_TRACE)
+
+// TraceNow and TraceEvent are declared in LexAccessor.h so it can trace filling its buffer.
+
+// Adds an event covering its lifetime. Events added on this thread meanwhile are attributed to lexer.
+class TraceScope {
+	const char *name;
+	const char *lexer;
+	const char *lexerOuter;
+	unsigned long long start;
+	Sci_Position position;
+	Sci_Position length;
+	Sci_Position lines;
+public:
+	TraceScope(const char *name_, const char *lexer_, Sci_Position position_=-1, Sci_Position length_=-1, Sci_Position lines_=-1) noexcept;
+	// Deleted so TraceScope objects can not be copied.
+	TraceScope(const TraceScope &) = delete;
+	TraceScope(TraceScope &&) = delete;
+	TraceScope &operator=(const TraceScope &) = delete;
+	TraceScope &operator=(TraceScope &&) = delete;
+	~TraceScope();
+};
+
+// Each thread keeps its most recent events in a ring without locking.
+// The events of every thread as Chrome trace JSON which can be opened by Perfetto and chrome://tracing.
+[[nodiscard]] std::string TraceJSON();
+// Write TraceJSON to a file, returning false on failure.
+bool WriteTrace(const char *path);
+void ClearTrace();
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,155 @@
+// Lexilla lexer library
+/** @file LineStyleCache.cxx
+ ** Remember the styles of lines so that repeated lines are styled without lexing them again.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <cstring>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <atomic>
+
+#include "ILexer.h"
+
+#include "LexillaExtensions.h"
+
+#include "LexAccessor.h"
+#include "MemoryUse.h"
+#include "LineStyleCache.h"
+
+using namespace Lexilla;
+
+namespace {
+
+std::atomic<bool> lineStyleCaching = false;
+std::atomic<size_t> lineStyleCacheLines = LineStyleCache::defaultSlotCount;
+
+}
+
+size_t LineStyleCache::Hash(std::string_view text, int stateIn) noexcept {
+	// Every line is hashed when looked up so mix 8 bytes at a time to stay much cheaper than lexing
+	constexpr std::uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
+	std::uint64_t hash = (static_cast<std::uint32_t>(stateIn) ^ (static_cast<std::uint64_t>(text.length()) << 32)) * multiplier;
+	const char *data = text.data();
+	size_t remaining = text.length();
+	while (remaining > 0) {
+		const size_t chunk = std::min<size_t>(remaining, sizeof(std::uint64_t));
+		std::uint64_t word = 0;
+		memcpy(&word, data, chunk);
+		hash = (hash ^ word) * multiplier;
+		hash ^= hash >> 32;
+		data += chunk;
+		remaining -= chunk;
+	}
+	return static_cast<size_t>(hash);
+}
+
+size_t LineStyleCache::SetStart(size_t hash) const noexcept {
+	return (hash % (slots.size() / setSize)) * setSize;
+}
+
+bool LineStyleCache::Replay(LexAccessor &styler, Sci_PositionU start, Sci_PositionU end, std::string_view text, int stateIn, int &stateOut) {
+	lookups++;
+	if (slots.empty()) {
+		return false;
+	}
+	const size_t hash = Hash(text, stateIn);
+	Entry *entry = nullptr;
+	const size_t first = SetStart(hash);
+	for (size_t slot = first; slot < first + setSize; slot++) {
+		const Entry &candidate = slots[slot];
+		if ((candidate.hash == hash) && (candidate.stateIn == stateIn) && (candidate.length == end + 1 - start) &&
+			(candidate.text == text)) {
+			entry = &slots[slot];
+			break;
+		}
+	}
+	if (!entry) {
+		return false;
+	}
+	hits++;
+	entry->lastUsed = lookups;
+	Sci_PositionU position = start;
+	for (const StyleRun &run : entry->runs) {
+		position += run.length;
+		styler.ColourTo(position - 1, run.style);
+	}
+	stateOut = entry->stateOut;
+	return true;
+}
+
+void LineStyleCache::Add(const LexAccessor &styler, Sci_PositionU start, Sci_PositionU end, std::string_view text, int stateIn, int stateOut) {
+	if (slots.empty()) {
+		slots.resize(LineStyleCacheLines());
+	}
+	const size_t hash = Hash(text, stateIn);
+	// Replace the least recently used entry of the set which will be an empty entry if there is one
+	const size_t first = SetStart(hash);
+	size_t oldest = first;
+	for (size_t slot = first + 1; slot < first + setSize; slot++) {
+		if (slots[slot].lastUsed < slots[oldest].lastUsed) {
+			oldest = slot;
+		}
+	}
+	Entry &entry = slots[oldest];
+	entry.hash = hash;
+	entry.lastUsed = lookups;
+	entry.stateIn = stateIn;
+	entry.stateOut = stateOut;
+	entry.length = end + 1 - start;
+	entry.text.assign(text);
+	entry.runs.clear();
+	for (Sci_PositionU position = start; position <= end; position++) {
+		const unsigned char style = static_cast<unsigned char>(styler.BufferStyleAt(position));
+		if (!entry.runs.empty() && (entry.runs.back().style == style)) {
+			entry.runs.back().length++;
+		} else {
+			entry.runs.push_back({ 1, style });
+		}
+	}
+}
+
+void LineStyleCache::Clear() noexcept {
+	slots = std::vector<Entry>();
+}
+
+void LineStyleCache::Report(LineStyleCacheUse &use) const noexcept {
+	use.lookups = lookups;
+	use.hits = hits;
+	use.entries = 0;
+	use.bytes = slots.capacity() * sizeof(Entry);
+	for (const Entry &entry : slots) {
+		if (entry.length > 0) {
+			use.entries++;
+			use.bytes += HeapBytes(entry.text) + HeapBytes(entry.runs);
+		}
+	}
+}
+
+namespace Lexilla {
+
+void SetLineStyleCaching(bool on) noexcept {
+	lineStyleCaching = on;
+}
+
+bool LineStyleCaching() noexcept {
+	return lineStyleCaching.load(std::memory_order_relaxed) && !ReferenceMode();
+}
+
+void SetLineStyleCacheLines(size_t lines) noexcept {
+	lineStyleCacheLines = std::max(lines + LineStyleCache::setSize - 1, LineStyleCache::setSize) /
+		LineStyleCache::setSize * LineStyleCache::setSize;
+}
+
+size_t LineStyleCacheLines() noexcept {
+	return lineStyleCacheLines;
+}
+
+}
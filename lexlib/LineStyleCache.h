@@ -0,0 +1,91 @@
+// Lexilla lexer library
+/** @file LineStyleCache.h
+ ** Remember the styles of lines so that repeated lines are styled without lexing them again.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef LINESTYLECACHE_H
+#define LINESTYLECACHE_H
+
+// Must have already included <string>, <string_view>, <vector>, LexillaExtensions.h, and LexAccessor.h.
+
+namespace Lexilla {
+
+// For lexers where the styles of a line depend only on the line's text and a state passed in
+// from the line before. Each entry is found by a hash of the text and incoming state then
+// checked against the stored text so a collision can not produce wrong styles.
+// The outgoing state is stored with the styles so the lexer can continue after a replayed line.
+// A cache belongs to one lexer instance and the lexer clears it when its properties or
+// keywords change so the lexer and its options do not need to be part of the key.
+// Entries are held in a fixed number of slots so memory is bounded. Each hash may go in any slot
+// of a small set so a few lines with clashing hashes do not keep replacing each other and a new
+// entry replaces the least recently used in its set. Long lines are not cached as they rarely repeat.
+class LineStyleCache {
+	// Styles are held as runs as most lines have only a few
+	struct StyleRun {
+		unsigned short length;
+		unsigned char style;
+	};
+	struct Entry {
+		size_t hash = 0;
+		size_t lastUsed = 0;
+		int stateIn = 0;
+		int stateOut = 0;
+		Sci_PositionU length = 0;
+		std::string text;
+		std::vector<StyleRun> runs;
+	};
+	std::vector<Entry> slots;
+	size_t lookups = 0;
+	size_t hits = 0;
+	static size_t Hash(std::string_view text, int stateIn) noexcept;
+	size_t SetStart(size_t hash) const noexcept;
+public:
+	static constexpr size_t defaultSlotCount = 4096;
+	static constexpr size_t setSize = 4;
+	static constexpr size_t minLineLength = 16;
+	static constexpr size_t maxLineLength = 1000;
+
+	// Style [start, end] from an entry with the same text and incoming state, setting stateOut.
+	// Returns false when there is no such entry.
+	bool Replay(LexAccessor &styler, Sci_PositionU start, Sci_PositionU end, std::string_view text, int stateIn, int &stateOut);
+	// Remember the styles just set for [start, end].
+	void Add(const LexAccessor &styler, Sci_PositionU start, Sci_PositionU end, std::string_view text, int stateIn, int stateOut);
+	void Clear() noexcept;
+	void Report(LineStyleCacheUse &use) const noexcept;
+};
+
+// Style the line [start, end] whose bytes are text, returning the state after the line.
+// colourise styles the line when it is not in cache and returns the state after it.
+// When cache is null or the line can not be cached, colourise is just called.
+template <typename Colourise>
+int StyleLine(LineStyleCache *cache, LexAccessor &styler, Sci_PositionU start, Sci_PositionU end,
+	std::string_view text, int stateIn, Colourise colourise) {
+	// Only whole lines not preceded by an unstyled segment can be cached and very short lines
+	// are quicker to lex than to look up
+	if (!cache || (styler.GetStartSegment() != start) ||
+		(text.length() < LineStyleCache::minLineLength) || (text.length() > LineStyleCache::maxLineLength)) {
+		return colourise();
+	}
+	int stateOut = 0;
+	if (!cache->Replay(styler, start, end, text, stateIn, stateOut)) {
+		stateOut = colourise();
+		if (styler.GetStartSegment() == end + 1) {
+			cache->Add(styler, start, end, text, stateIn, stateOut);
+		}
+	}
+	return stateOut;
+}
+
+// Line style caching applies to the whole library and is set through the library property
+// lexilla.line.cache. It is always off in reference mode.
+void SetLineStyleCaching(bool on) noexcept;
+[[nodiscard]] bool LineStyleCaching() noexcept;
+// The number of lines each cache can hold is set through lexilla.line.cache.lines and
+// applies to caches that are empty when it is set. It is rounded up to a whole number of sets.
+void SetLineStyleCacheLines(size_t lines) noexcept;
+[[nodiscard]] size_t LineStyleCacheLines() noexcept;
+
+}
+
+#endif
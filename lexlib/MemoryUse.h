@@ -0,0 +1,71 @@
+// Lexilla lexer library
+/** @file MemoryUse.h
+ ** Estimate the heap memory retained by lexer state for privateCallMemoryUse.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef MEMORYUSE_H
+#define MEMORYUSE_H
+
+namespace Lexilla {
+
+template <typename T>
+class SparseState;
+
+// Each node of a std::map holds a colour and 3 pointers in common implementations.
+constexpr size_t mapNodeOverhead = 4 * sizeof(void *);
+
+// Heap bytes owned by a value. Overloads are declared before being defined so they can be nested.
+template <typename T>
+size_t HeapBytes(const T &) noexcept;
+size_t HeapBytes(const std::string &s) noexcept;
+template <typename T>
+size_t HeapBytes(const std::vector<T> &v) noexcept;
+template <typename K, typename V, typename C>
+size_t HeapBytes(const std::map<K, V, C> &m) noexcept;
+template <typename T>
+size_t HeapBytes(const SparseState<T> &ss) noexcept;
+
+// Types without an overload own no heap memory.
+template <typename T>
+size_t HeapBytes(const T &) noexcept {
+	return 0;
+}
+
+inline size_t HeapBytes(const std::string &s) noexcept {
+	// Short strings are held inside the string object
+	const char *object = reinterpret_cast<const char *>(&s);
+	if ((s.data() >= object) && (s.data() < object + sizeof(s))) {
+		return 0;
+	}
+	return s.capacity() + 1;
+}
+
+template <typename T>
+size_t HeapBytes(const std::vector<T> &v) noexcept {
+	size_t bytes = v.capacity() * sizeof(T);
+	for (const T &element : v) {
+		bytes += HeapBytes(element);
+	}
+	return bytes;
+}
+
+template <typename K, typename V, typename C>
+size_t HeapBytes(const std::map<K, V, C> &m) noexcept {
+	size_t bytes = m.size() * (mapNodeOverhead + sizeof(typename std::map<K, V, C>::value_type));
+	for (const auto &[key, value] : m) {
+		bytes += HeapBytes(key) + HeapBytes(value);
+	}
+	return bytes;
+}
+
+template <typename T>
+size_t HeapBytes(const SparseState<T> &ss) noexcept {
+	return ss.HeapBytes([](const T &value) noexcept {
+		return HeapBytes(value);
+	});
+}
+
+}
+
+#endif
@@ -0,0 +1,100 @@
+// Lexilla lexer library
+/** @file OptionSet.cxx
+ ** Share option definitions and word list descriptions between lexer instances.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstdlib>
+#include <cstring>
+
+#include <string>
+#include <string_view>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "Scintilla.h"
+
+#include "OptionSet.h"
+
+using namespace Lexilla;
+
+namespace {
+
+// Registered definitions live until the library is unloaded as instances point to them.
+struct Registry {
+	std::mutex mutex;
+	// Separate from mutex as resolving finds and registers definitions
+	std::mutex resolution;
+	std::map<const void *, std::unique_ptr<OptionDefinitions>> definitions;
+	std::map<const void *, std::string> wordLists;
+};
+
+Registry &TheRegistry() {
+	static Registry registry;
+	return registry;
+}
+
+// Is joined the result of JoinWordListDescriptions(wordListDescriptions)?
+bool SameDescriptions(std::string_view joined, const char *const wordListDescriptions[]) {
+	size_t position = 0;
+	for (size_t wl = 0; wordListDescriptions[wl]; wl++) {
+		if (wl > 0) {
+			if ((position >= joined.length()) || (joined[position] != '\n')) {
+				return false;
+			}
+			position++;
+		}
+		const std::string_view description(wordListDescriptions[wl]);
+		if (joined.compare(position, description.length(), description) != 0) {
+			return false;
+		}
+		position += description.length();
+	}
+	return position == joined.length();
+}
+
+}
+
+const OptionDefinitions *Lexilla::FindOptionDefinitions(const void *key) {
+	Registry &registry = TheRegistry();
+	std::lock_guard<std::mutex> guard(registry.mutex);
+	auto it = registry.definitions.find(key);
+	if (it != registry.definitions.end()) {
+		return it->second.get();
+	}
+	return nullptr;
+}
+
+const OptionDefinitions *Lexilla::RegisterOptionDefinitions(const void *key, OptionDefinitions *definitions) {
+	std::unique_ptr<OptionDefinitions> owned(definitions);
+	Registry &registry = TheRegistry();
+	std::lock_guard<std::mutex> guard(registry.mutex);
+	auto [it, inserted] = registry.definitions.try_emplace(key, std::move(owned));
+	return inserted ? it->second.get() : nullptr;
+}
+
+const char *Lexilla::SharedWordListDescriptions(const char *const wordListDescriptions[]) {
+	if (!wordListDescriptions) {
+		return nullptr;
+	}
+	Registry &registry = TheRegistry();
+	std::lock_guard<std::mutex> guard(registry.mutex);
+	auto it = registry.wordLists.find(wordListDescriptions);
+	if (it == registry.wordLists.end()) {
+		it = registry.wordLists.emplace(wordListDescriptions, JoinWordListDescriptions(wordListDescriptions)).first;
+	} else if (!SameDescriptions(it->second, wordListDescriptions)) {
+		// Address reused for different descriptions
+		return nullptr;
+	}
+	return it->second.c_str();
+}
+
+void Lexilla::ResolveOnce(bool &resolved, void (*resolve)(const void *set), const void *set) {
+	Registry &registry = TheRegistry();
+	std::lock_guard<std::mutex> guard(registry.resolution);
+	if (!resolved) {
+		resolve(set);
+		resolved = true;
+	}
+}
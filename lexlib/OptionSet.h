@@ -24,9 +24,28 @@ inline std::string JoinWordListDescriptions(const char *const wordListDescriptio
 	return wordLists;
 }
 
+// Option definitions are the same for every instance of a lexer so the first instance to complete
+// its definitions registers them and later instances share them after checking they match.
+struct OptionDefinitions {
+	virtual ~OptionDefinitions() = default;
+};
+
+// Find the definitions registered for key or nullptr if there are none.
+const OptionDefinitions *FindOptionDefinitions(const void *key);
+// Register definitions for key, taking ownership. Returns definitions when registered or, when
+// another instance has already registered for key, deletes definitions and returns nullptr.
+const OptionDefinitions *RegisterOptionDefinitions(const void *key, OptionDefinitions *definitions);
+// Joined descriptions shared between instances using the same array or nullptr when the array
+// does not match a previous use of its address.
+const char *SharedWordListDescriptions(const char *const wordListDescriptions[]);
+// Call resolve(set) if resolved is false then set resolved. Holds a lock so that the const
+// methods of an OptionSet, which resolve its definitions when first used, may be called from
+// multiple threads.
+void ResolveOnce(bool &resolved, void (*resolve)(const void *set), const void *set);
+
 // Allow OptionSet<T> to be called without knowing T
 struct OptionSetInterface {
-	[[nodiscard]] virtual const char *PropertyNames() const noexcept = 0;
+	[[nodiscard]] virtual const char *PropertyNames() const = 0;
 	[[nodiscard]] virtual int PropertyType(const char *name) const = 0;
 	[[nodiscard]] virtual const char *DescribeProperty(const char *name) const = 0;
 	[[nodiscard]] virtual const char *PropertyGet(const char *name) const = 0;
@@ -39,29 +58,28 @@ class OptionSet : public OptionSetInterface {
 	using plcob = bool T::*;
 	using plcoi = int T::*;
 	using plcos = std::string T::*;
-	struct Option {
+	// The member an option sets is kept apart from its description so definitions can be
+	// checked against shared definitions without copying the description.
+	struct Member {
 		int opType;
 		union {
 			plcob pb;
 			plcoi pi;
 			plcos ps;
 		};
-		std::string value;
-		std::string description;
-		Option() :
+		Member() noexcept :
 			opType(SC_TYPE_BOOLEAN), pb(nullptr) {
 		}
-		Option(plcob pb_, std::string_view description_="") :
-			opType(SC_TYPE_BOOLEAN), pb(pb_), description(description_) {
+		explicit Member(plcob pb_) noexcept :
+			opType(SC_TYPE_BOOLEAN), pb(pb_) {
 		}
-		Option(plcoi pi_, std::string_view description_) :
-			opType(SC_TYPE_INTEGER), pi(pi_), description(description_) {
+		explicit Member(plcoi pi_) noexcept :
+			opType(SC_TYPE_INTEGER), pi(pi_) {
 		}
-		Option(plcos ps_, std::string_view description_) :
-			opType(SC_TYPE_STRING), ps(ps_), description(description_) {
+		explicit Member(plcos ps_) noexcept :
+			opType(SC_TYPE_STRING), ps(ps_) {
 		}
-		bool Set(T *base, const char *val) {
-			value = val;
+		bool Set(T *base, const char *val) const {
 			switch (opType) {
 			case SC_TYPE_BOOLEAN: {
 					const bool option = atoi(val) != 0;
@@ -91,34 +109,166 @@ class OptionSet : public OptionSetInterface {
 			}
 			return false;
 		}
-		[[nodiscard]] const char *Get() const noexcept {
-			return value.c_str();
+		[[nodiscard]] bool SameMember(const Member &other) const noexcept {
+			if (opType != other.opType) {
+				return false;
+			}
+			switch (opType) {
+			case SC_TYPE_BOOLEAN:
+				return pb == other.pb;
+			case SC_TYPE_INTEGER:
+				return pi == other.pi;
+			default:
+				return ps == other.ps;
+			}
+		}
+	};
+	struct Option : public Member {
+		std::string description;
+		Option() = default;
+		Option(const Member &member, std::string_view description_) :
+			Member(member), description(description_) {
+		}
+		[[nodiscard]] bool Same(const Member &member, std::string_view description_) const noexcept {
+			return this->SameMember(member) && (description == description_);
 		}
 	};
 	using OptionMap = std::map<std::string, Option, std::less<>> ;
-	OptionMap nameToDef;
-	std::string names;
+	struct Definitions : public OptionDefinitions {
+		OptionMap nameToDef;
+		std::string names;
+		void Add(const char *name, const Option &option) {
+			nameToDef[name] = option;
+			if (!names.empty())
+				names += "\n";
+			names += name;
+		}
+		// Does the definition of name at offset in names match member and description?
+		[[nodiscard]] bool Matches(size_t offset, std::string_view name, const Member &member, std::string_view description) const {
+			if ((offset > names.length()) || (names.compare(offset, name.length(), name) != 0)) {
+				return false;
+			}
+			const size_t end = offset + name.length();
+			if ((end < names.length()) && (names[end] != '\n')) {
+				return false;
+			}
+			typename OptionMap::const_iterator const it = nameToDef.find(name);
+			return (it != nameToDef.end()) && it->second.Same(member, description);
+		}
+		[[nodiscard]] bool Same(const Definitions &other) const {
+			if ((names != other.names) || (nameToDef.size() != other.nameToDef.size())) {
+				return false;
+			}
+			typename OptionMap::const_iterator itOther = other.nameToDef.begin();
+			for (const auto &[name, option] : nameToDef) {
+				if ((name != itOther->first) || !option.Same(itOther->second, itOther->second.description)) {
+					return false;
+				}
+				++itOther;
+			}
+			return true;
+		}
+	};
+	// Each OptionSet<T> registers its definitions under the address of its own registryKey
+	static inline const char registryKey = 0;
+
+	// Definitions start by being checked against the registered definitions then either
+	// share them, when all match, or are held by this instance. That is decided once, through
+	// ResolveOnce when the definitions are first used.
+	enum class Sharing { matching, shared, own };
+	mutable bool resolved = false;
+	mutable Sharing sharing = Sharing::matching;
+	mutable const Definitions *shared = nullptr;
+	// While matching, the offset in shared->names after the definitions matched so far
+	size_t matched = 0;
+	mutable Definitions own;
+	std::map<std::string, std::string, std::less<>> values;
 	std::string wordLists;
+	const char *wordListsShared = nullptr;
 
-	void AppendName(const char *name) {
-		if (!names.empty())
-			names += "\n";
-		names += name;
+	// Copy the matched definitions from shared so they can be extended or changed.
+	void CopyMatched() const {
+		if (shared) {
+			// matched is one past the end of names when all of it has been matched
+			const std::string_view names(shared->names.c_str(), (matched > 0) ? matched - 1 : 0);
+			size_t start = 0;
+			while (start < names.length()) {
+				size_t end = names.find('\n', start);
+				if (end == std::string_view::npos) {
+					end = names.length();
+				}
+				const std::string name(names.substr(start, end - start));
+				own.Add(name.c_str(), shared->nameToDef.find(name)->second);
+				start = end + 1;
+			}
+		}
+		shared = nullptr;
+		sharing = Sharing::own;
+	}
+	// Definitions are complete when first used so decide whether to share them.
+	void Resolve() const {
+		if (shared) {
+			if (matched == shared->names.length() + 1) {
+				sharing = Sharing::shared;
+			} else {
+				CopyMatched();
+			}
+		} else if (own.names.empty()) {
+			sharing = Sharing::own;
+		} else {
+			// Another instance may have registered since this was constructed
+			shared = static_cast<const Definitions *>(FindOptionDefinitions(&registryKey));
+			if (!shared) {
+				shared = static_cast<const Definitions *>(RegisterOptionDefinitions(&registryKey, new Definitions(own)));
+			}
+			if (shared && shared->Same(own)) {
+				own = Definitions();
+				sharing = Sharing::shared;
+			} else {
+				shared = nullptr;
+				sharing = Sharing::own;
+			}
+		}
+	}
+	const Definitions &Defs() const {
+		ResolveOnce(resolved, [](const void *set) {
+			const OptionSet *optionSet = static_cast<const OptionSet *>(set);
+			if (optionSet->sharing == Sharing::matching) {
+				optionSet->Resolve();
+			}
+		}, this);
+		return (sharing == Sharing::shared) ? *shared : own;
+	}
+	void Define(const char *name, const Member &member, std::string_view description) {
+		if (sharing == Sharing::matching) {
+			if (shared) {
+				if (shared->Matches(matched, name, member, description)) {
+					matched += std::string_view(name).length() + 1;
+					return;
+				}
+				CopyMatched();
+			}
+		} else if (sharing == Sharing::shared) {
+			own = *shared;
+			shared = nullptr;
+			sharing = Sharing::own;
+		}
+		own.Add(name, Option(member, description));
 	}
 public:
+	OptionSet() {
+		shared = static_cast<const Definitions *>(FindOptionDefinitions(&registryKey));
+	}
 	virtual ~OptionSet() = default;
 
 	void DefineProperty(const char *name, plcob pb, std::string_view description="") {
-		nameToDef[name] = Option(pb, description);
-		AppendName(name);
+		Define(name, Member(pb), description);
 	}
 	void DefineProperty(const char *name, plcoi pi, std::string_view description="") {
-		nameToDef[name] = Option(pi, description);
-		AppendName(name);
+		Define(name, Member(pi), description);
 	}
 	void DefineProperty(const char *name, plcos ps, std::string_view description="") {
-		nameToDef[name] = Option(ps, description);
-		AppendName(name);
+		Define(name, Member(ps), description);
 	}
 	template <typename E>
 	void DefineProperty(const char *name, E T::*pe, std::string_view description="") {
@@ -126,13 +276,13 @@ public:
 		plcoi pi {};
 		static_assert(sizeof(pe) == sizeof(pi));
 		memcpy(&pi, &pe, sizeof(pe));
-		nameToDef[name] = Option(pi, description);
-		AppendName(name);
+		Define(name, Member(pi), description);
 	}
-	[[nodiscard]] const char *PropertyNames() const noexcept final {
-		return names.c_str();
+	[[nodiscard]] const char *PropertyNames() const final {
+		return Defs().names.c_str();
 	}
 	[[nodiscard]] int PropertyType(const char *name) const final {
+		const OptionMap &nameToDef = Defs().nameToDef;
 		typename OptionMap::const_iterator const it = nameToDef.find(name);
 		if (it != nameToDef.end()) {
 			return it->second.opType;
@@ -140,6 +290,7 @@ public:
 		return SC_TYPE_BOOLEAN;
 	}
 	[[nodiscard]] const char *DescribeProperty(const char *name) const final {
+		const OptionMap &nameToDef = Defs().nameToDef;
 		typename OptionMap::const_iterator const it = nameToDef.find(name);
 		if (it != nameToDef.end()) {
 			return it->second.description.c_str();
@@ -148,27 +299,36 @@ public:
 	}
 
 	bool PropertySet(T *base, const char *name, const char *val) {
-		typename OptionMap::iterator const it = nameToDef.find(name);
+		const OptionMap &nameToDef = Defs().nameToDef;
+		typename OptionMap::const_iterator const it = nameToDef.find(name);
 		if (it != nameToDef.end()) {
+			auto itValue = values.find(name);
+			if (itValue != values.end()) {
+				itValue->second = val;
+			} else {
+				values.emplace(name, val);
+			}
 			return it->second.Set(base, val);
 		}
 		return false;
 	}
 
 	[[nodiscard]] const char *PropertyGet(const char *name) const final {
-		typename OptionMap::const_iterator const it = nameToDef.find(name);
-		if (it != nameToDef.end()) {
-			return it->second.Get();
+		const OptionMap &nameToDef = Defs().nameToDef;
+		if (nameToDef.find(name) != nameToDef.end()) {
+			auto itValue = values.find(name);
+			return (itValue != values.end()) ? itValue->second.c_str() : "";
 		}
 		return nullptr;
 	}
 
 	void DefineWordListSets(const char * const wordListDescriptions[]) {
-		wordLists = JoinWordListDescriptions(wordListDescriptions);
+		wordListsShared = SharedWordListDescriptions(wordListDescriptions);
+		wordLists = wordListsShared ? std::string() : JoinWordListDescriptions(wordListDescriptions);
 	}
 
 	[[nodiscard]] const char *DescribeWordListSets() const noexcept final {
-		return wordLists.c_str();
+		return wordListsShared ? wordListsShared : wordLists.c_str();
 	}
 };
 
@@ -13,6 +13,7 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
 #include <map>
 #include <functional>
 
@@ -24,43 +25,98 @@ namespace {
 
 using mapss = std::map<std::string, std::string, std::less<>>;
 
-mapss *PropsFromPointer(void *impl) noexcept {
-	return static_cast<mapss *>(impl);
+// Every name interned by a PropertyKey. Only added to by PropertyKey constructors.
+struct InternedNames {
+	std::map<std::string, size_t, std::less<>> indices;
+	std::vector<std::string_view> names;
+};
+
+InternedNames &Interned() {
+	static InternedNames interned;
+	return interned;
+}
+
+// Value of an interned property parsed as an integer. Empty values are not set so GetInt
+// returns the default for them.
+struct ParsedInt {
+	bool set = false;
+	int value = 0;
+};
+
+ParsedInt Parse(std::string_view val) {
+	if (val.empty()) {
+		return {};
+	}
+	return { true, atoi(std::string(val).c_str()) };
+}
+
+struct PropSetImpl {
+	mapss props;
+	// Indexed by PropertyKey::Index. Keys interned after the last Set are beyond the end.
+	std::vector<ParsedInt> parsed;
+	void Update(std::string_view key, std::string_view val) {
+		const InternedNames &interned = Interned();
+		for (size_t index = parsed.size(); index < interned.names.size(); index++) {
+			const mapss::const_iterator it = props.find(interned.names[index]);
+			parsed.push_back((it != props.end()) ? Parse(it->second) : ParsedInt());
+		}
+		const auto itIndex = interned.indices.find(key);
+		if (itIndex != interned.indices.end()) {
+			parsed[itIndex->second] = Parse(val);
+		}
+	}
+};
+
+PropSetImpl *PropsFromPointer(void *impl) noexcept {
+	return static_cast<PropSetImpl *>(impl);
 }
 
 }
 
+PropertyKey::PropertyKey(const char *name_) : name(name_), index(0) {
+	InternedNames &interned = Interned();
+	const auto it = interned.indices.find(name);
+	if (it != interned.indices.end()) {
+		index = it->second;
+	} else {
+		index = interned.names.size();
+		const auto itAdded = interned.indices.emplace(name, index).first;
+		interned.names.push_back(itAdded->first);
+	}
+}
+
 PropSetSimple::PropSetSimple() {
-	mapss *props = new mapss;
+	PropSetImpl *props = new PropSetImpl;
 	impl = static_cast<void *>(props);
 }
 
 PropSetSimple::~PropSetSimple() {
-	mapss *props = PropsFromPointer(impl);
+	PropSetImpl *props = PropsFromPointer(impl);
 	delete props;
 	impl = nullptr;
 }
 
 bool PropSetSimple::Set(std::string_view key, std::string_view val) {
-	mapss *props = PropsFromPointer(impl);
+	PropSetImpl *props = PropsFromPointer(impl);
 	if (!props)
 		return false;
-	mapss::iterator const it = props->find(key);
-	if (it != props->end()) {
+	mapss::iterator const it = props->props.find(key);
+	if (it != props->props.end()) {
 		if (val == it->second)
 			return false;
 		it->second = val;
 	} else {
-		props->emplace(key, val);
+		props->props.emplace(key, val);
 	}
+	props->Update(key, val);
 	return true;
 }
 
 const char *PropSetSimple::Get(std::string_view key) const {
-	mapss *props = PropsFromPointer(impl);
+	const PropSetImpl *props = PropsFromPointer(impl);
 	if (props) {
-		mapss::const_iterator const keyPos = props->find(key);
-		if (keyPos != props->end()) {
+		mapss::const_iterator const keyPos = props->props.find(key);
+		if (keyPos != props->props.end()) {
 			return keyPos->second.c_str();
 		}
 	}
@@ -75,3 +131,13 @@ int PropSetSimple::GetInt(std::string_view key, int defaultValue) const {
 	}
 	return defaultValue;
 }
+
+int PropSetSimple::GetInt(const PropertyKey &key, int defaultValue) const {
+	const PropSetImpl *props = PropsFromPointer(impl);
+	if (props && (key.Index() < props->parsed.size())) {
+		const ParsedInt &parsed = props->parsed[key.Index()];
+		return parsed.set ? parsed.value : defaultValue;
+	}
+	// Interned after the last Set so not yet parsed
+	return GetInt(key.Name(), defaultValue);
+}
@@ -10,6 +10,18 @@
 
 namespace Lexilla {
 
+// A property name interned to a small integer so that its value can be read without
+// looking up the name. Define keys at namespace scope in lexer modules so names are
+// interned while the library loads, before any lexing.
+class PropertyKey {
+	const char *name;
+	size_t index;
+public:
+	explicit PropertyKey(const char *name_);
+	[[nodiscard]] const char *Name() const noexcept { return name; }
+	[[nodiscard]] size_t Index() const noexcept { return index; }
+};
+
 class PropSetSimple {
 	void *impl;
 public:
@@ -24,6 +36,8 @@ public:
 	bool Set(std::string_view key, std::string_view val);
 	const char *Get(std::string_view key) const;
 	int GetInt(std::string_view key, int defaultValue=0) const;
+	// Integer values of interned keys are parsed when set rather than each time they are read.
+	int GetInt(const PropertyKey &key, int defaultValue=0) const;
 };
 
 }
@@ -0,0 +1,309 @@
+// Lexilla lexer library
+/** @file SnapshotDocument.cxx
+ ** A copy of a document that can be lexed on another thread while the original is edited.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <algorithm>
+
+#include "ILexer.h"
+#include "Scintilla.h"
+
+#include "LexillaExtensions.h"
+
+#include "DocumentCharacters.h"
+#include "SnapshotDocument.h"
+
+using namespace Lexilla;
+
+namespace {
+
+constexpr int tabWidth = 8;
+
+}
+
+Sci_Position LexResult::EndStyled() const noexcept {
+	return startStyled + styles.length();
+}
+
+void LexResult::Rebase(const Scintilla::IDocument *pdoc, Sci_Position position) {
+	const Sci_Position lineEdited = pdoc->LineFromPosition(position);
+	const Sci_Position lineStartEdited = pdoc->LineStart(lineEdited);
+	if (startStyled >= lineStartEdited) {
+		styles.clear();
+	} else if (EndStyled() > lineStartEdited) {
+		styles.resize(lineStartEdited - startStyled);
+	}
+	const auto afterEdit = [lineEdited](const std::pair<Sci_Position, int> &lineValue) noexcept {
+		return lineValue.first >= lineEdited;
+	};
+	lineStates.erase(std::find_if(lineStates.begin(), lineStates.end(), afterEdit), lineStates.end());
+	levels.erase(std::find_if(levels.begin(), levels.end(), afterEdit), levels.end());
+	startChanged = std::min(startChanged, lineStartEdited);
+	endChanged = std::min(endChanged, lineStartEdited);
+}
+
+void LexResult::Apply(Scintilla::IDocument *pdoc) const {
+	if (!styles.empty()) {
+		pdoc->StartStyling(startStyled);
+		pdoc->SetStyles(styles.length(), styles.data());
+	}
+	for (const auto &[line, state] : lineStates) {
+		pdoc->SetLineState(line, state);
+	}
+	for (const auto &[line, level] : levels) {
+		pdoc->SetLevel(line, level);
+	}
+	if (endChanged > startChanged) {
+		pdoc->ChangeLexerState(startChanged, endChanged);
+	}
+}
+
+SnapshotDocument::SnapshotDocument(Scintilla::IDocument *pdoc) {
+	const Sci_Position length = pdoc->Length();
+	text.resize(length);
+	pdoc->GetCharRange(text.data(), 0, length);
+	textStyles.resize(length);
+	if (pdoc->Version() & dvStyleRange) {
+		static_cast<IDocumentStyles *>(pdoc)->GetStyleRange(textStyles.data(), 0, length);
+	} else {
+		for (Sci_Position position = 0; position < length; position++) {
+			textStyles[position] = pdoc->StyleAt(position);
+		}
+	}
+
+	const Sci_Position lines = pdoc->LineFromPosition(length) + 1;
+	lineStarts.reserve(lines + 1);
+	lineEnds.reserve(lines);
+	// Line states may be set for the line after the last
+	lineStates.reserve(lines + 1);
+	levels.reserve(lines);
+	for (Sci_Position line = 0; line < lines; line++) {
+		lineStarts.push_back(pdoc->LineStart(line));
+		lineEnds.push_back(pdoc->LineEnd(line));
+		lineStates.push_back(pdoc->GetLineState(line));
+		levels.push_back(pdoc->GetLevel(line));
+	}
+	lineStarts.push_back(length);
+	lineStates.push_back(0);
+
+	codePage = pdoc->CodePage();
+	if (IsDBCSCodePage(codePage)) {
+		for (int ch = 0x80; ch < 0x100; ch++) {
+			dbcsLeadBytes[ch] = pdoc->IsDBCSLeadByte(static_cast<char>(ch));
+		}
+	}
+	startStyled = length;
+}
+
+Sci_Position SnapshotDocument::Lines() const noexcept {
+	return lineEnds.size();
+}
+
+void SnapshotDocument::StyleSet(Sci_Position start, Sci_Position length) noexcept {
+	startStyled = std::min(startStyled, start);
+	endSet = std::max(endSet, start + length);
+}
+
+LexResult SnapshotDocument::Result() const {
+	LexResult result;
+	if (endSet > startStyled) {
+		result.startStyled = startStyled;
+		result.styles = textStyles.substr(startStyled, endSet - startStyled);
+	}
+	result.lineStates.assign(lineStatesSet.begin(), lineStatesSet.end());
+	result.levels.assign(levelsSet.begin(), levelsSet.end());
+	result.startChanged = startChanged;
+	result.endChanged = endChanged;
+	return result;
+}
+
+#if defined(_MSC_VER)
+// IDocument interface does not specify noexcept so best to not add it to implementation
+#pragma warning(disable: 26440)
+#endif
+
+int SCI_METHOD SnapshotDocument::Version() const {
+	return Scintilla::dvRelease4 | dvStyleRange;
+}
+
+void SCI_METHOD SnapshotDocument::SetErrorStatus(int) {
+}
+
+Sci_Position SCI_METHOD SnapshotDocument::Length() const {
+	return text.length();
+}
+
+void SCI_METHOD SnapshotDocument::GetCharRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const {
+	text.copy(buffer, lengthRetrieve, position);
+}
+
+char SCI_METHOD SnapshotDocument::StyleAt(Sci_Position position) const {
+	if (position < 0 || position >= Length()) {
+		return 0;
+	}
+	return textStyles[position];
+}
+
+Sci_Position SCI_METHOD SnapshotDocument::LineFromPosition(Sci_Position position) const {
+	if (position <= 0) {
+		return 0;
+	}
+	// Last line start is a sentinel at the document length
+	const auto it = std::upper_bound(lineStarts.begin(), lineStarts.end() - 1, position);
+	return it - lineStarts.begin() - 1;
+}
+
+Sci_Position SCI_METHOD SnapshotDocument::LineStart(Sci_Position line) const {
+	if (line < 0) {
+		return 0;
+	}
+	if (line >= Lines()) {
+		return Length();
+	}
+	return lineStarts[line];
+}
+
+int SCI_METHOD SnapshotDocument::GetLevel(Sci_Position line) const {
+	if (line < 0 || line >= Lines()) {
+		return SC_FOLDLEVELBASE;
+	}
+	return levels[line];
+}
+
+int SCI_METHOD SnapshotDocument::SetLevel(Sci_Position line, int level) {
+	if (line < 0 || line >= Lines()) {
+		return SC_FOLDLEVELBASE;
+	}
+	const int previous = levels[line];
+	if (level != previous) {
+		levels[line] = level;
+		levelsSet[line] = level;
+	}
+	return previous;
+}
+
+int SCI_METHOD SnapshotDocument::GetLineState(Sci_Position line) const {
+	if (line < 0 || line >= static_cast<Sci_Position>(lineStates.size())) {
+		return 0;
+	}
+	return lineStates[line];
+}
+
+int SCI_METHOD SnapshotDocument::SetLineState(Sci_Position line, int state) {
+	if (line < 0 || line >= static_cast<Sci_Position>(lineStates.size())) {
+		return 0;
+	}
+	const int previous = lineStates[line];
+	if (state != previous) {
+		lineStates[line] = state;
+		lineStatesSet[line] = state;
+	}
+	return previous;
+}
+
+void SCI_METHOD SnapshotDocument::StartStyling(Sci_Position position) {
+	endStyled = std::clamp<Sci_Position>(position, 0, Length());
+}
+
+bool SCI_METHOD SnapshotDocument::SetStyleFor(Sci_Position length, char style) {
+	length = std::min(length, Length() - endStyled);
+	if (length <= 0) {
+		return false;
+	}
+	std::fill_n(textStyles.begin() + endStyled, length, style);
+	StyleSet(endStyled, length);
+	endStyled += length;
+	return true;
+}
+
+bool SCI_METHOD SnapshotDocument::SetStyles(Sci_Position length, const char *styles) {
+	length = std::min(length, Length() - endStyled);
+	if (length <= 0) {
+		return false;
+	}
+	std::copy_n(styles, length, textStyles.begin() + endStyled);
+	StyleSet(endStyled, length);
+	endStyled += length;
+	return true;
+}
+
+void SCI_METHOD SnapshotDocument::DecorationSetCurrentIndicator(int) {
+	// Decorations are not kept
+}
+
+void SCI_METHOD SnapshotDocument::DecorationFillRange(Sci_Position, int, Sci_Position) {
+	// Decorations are not kept
+}
+
+void SCI_METHOD SnapshotDocument::ChangeLexerState(Sci_Position start, Sci_Position end) {
+	if (endChanged > startChanged) {
+		startChanged = std::min(startChanged, start);
+		endChanged = std::max(endChanged, end);
+	} else {
+		startChanged = start;
+		endChanged = end;
+	}
+}
+
+int SCI_METHOD SnapshotDocument::CodePage() const {
+	return codePage;
+}
+
+bool SCI_METHOD SnapshotDocument::IsDBCSLeadByte(char ch) const {
+	return dbcsLeadBytes[static_cast<unsigned char>(ch)];
+}
+
+const char *SCI_METHOD SnapshotDocument::BufferPointer() {
+	return text.c_str();
+}
+
+int SCI_METHOD SnapshotDocument::GetLineIndentation(Sci_Position line) {
+	// Tab width is not known so assume the common default
+	int indent = 0;
+	for (Sci_Position position = LineStart(line); position < LineEnd(line); position++) {
+		const char ch = text[position];
+		if (ch == ' ') {
+			indent++;
+		} else if (ch == '\t') {
+			indent = (indent / tabWidth + 1) * tabWidth;
+		} else {
+			break;
+		}
+	}
+	return indent;
+}
+
+Sci_Position SCI_METHOD SnapshotDocument::LineEnd(Sci_Position line) const {
+	if (line < 0) {
+		return 0;
+	}
+	if (line >= Lines()) {
+		return Length();
+	}
+	return lineEnds[line];
+}
+
+Sci_Position SCI_METHOD SnapshotDocument::GetRelativePosition(Sci_Position positionStart, Sci_Position characterOffset) const {
+	return RelativePosition(this, positionStart, characterOffset);
+}
+
+int SCI_METHOD SnapshotDocument::GetCharacterAndWidth(Sci_Position position, Sci_Position *pWidth) const {
+	if ((position < 0) || (position >= Length())) {
+		if (pWidth) {
+			*pWidth = 1;
+		}
+		return 0;
+	}
+	const Sci_Position available = std::min<Sci_Position>(Length() - position, 4);
+	return CharacterFromBytes(reinterpret_cast<const unsigned char *>(text.data() + position), available,
+		codePage, dbcsLeadBytes, pWidth);
+}
+
+void SCI_METHOD SnapshotDocument::GetStyleRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const {
+	textStyles.copy(buffer, lengthRetrieve, position);
+}
@@ -0,0 +1,102 @@
+// Lexilla lexer library
+/** @file SnapshotDocument.h
+ ** A copy of a document that can be lexed on another thread while the original is edited.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef SNAPSHOTDOCUMENT_H
+#define SNAPSHOTDOCUMENT_H
+
+// Must have already included ILexer.h and LexillaExtensions.h.
+
+namespace Lexilla {
+
+// The styles, line states, and fold levels set by lexing and folding a SnapshotDocument.
+struct LexResult {
+	// Styles set from startStyled onwards
+	Sci_Position startStyled = 0;
+	std::string styles;
+	// Lines whose state or fold level was changed, with their new values, in line order
+	std::vector<std::pair<Sci_Position, int>> lineStates;
+	std::vector<std::pair<Sci_Position, int>> levels;
+	// Range reported by the lexer through ChangeLexerState, empty when not called
+	Sci_Position startChanged = 0;
+	Sci_Position endChanged = 0;
+
+	[[nodiscard]] Sci_Position EndStyled() const noexcept;
+	// pdoc has been edited at position since the snapshot was taken. Keep only the results for
+	// lines before the edited line as those are still valid. Call for each edit or once with the
+	// lowest position edited.
+	void Rebase(const Scintilla::IDocument *pdoc, Sci_Position position);
+	// Set the results into pdoc. Text before EndStyled must be the same as in the snapshot,
+	// which Rebase ensures.
+	void Apply(Scintilla::IDocument *pdoc) const;
+};
+
+// Copies the text, styles, line starts, line states, and fold levels of a document so a lexer can
+// run on the copy on another thread. The copy is taken with bulk copies of the text and styles and
+// one pass over the lines. Only the thread lexing may use the snapshot once taken.
+// Decorations set by lexers are not kept.
+class SnapshotDocument : public IDocumentStyles {
+	std::string text;
+	std::string textStyles;
+	std::vector<Sci_Position> lineStarts;
+	std::vector<Sci_Position> lineEnds;
+	std::vector<int> lineStates;
+	std::vector<int> levels;
+	int codePage = 0;
+	bool dbcsLeadBytes[0x100] {};
+	Sci_Position endStyled = 0;
+	// Results recorded as they are set
+	Sci_Position startStyled;
+	Sci_Position endSet = 0;
+	std::map<Sci_Position, int> lineStatesSet;
+	std::map<Sci_Position, int> levelsSet;
+	Sci_Position startChanged = 0;
+	Sci_Position endChanged = 0;
+	[[nodiscard]] Sci_Position Lines() const noexcept;
+	void StyleSet(Sci_Position start, Sci_Position length) noexcept;
+public:
+	// Copy from pdoc: called on the thread that owns pdoc.
+	explicit SnapshotDocument(Scintilla::IDocument *pdoc);
+	// Deleted so SnapshotDocument objects can not be copied.
+	SnapshotDocument(const SnapshotDocument &) = delete;
+	SnapshotDocument(SnapshotDocument &&) = delete;
+	SnapshotDocument &operator=(const SnapshotDocument &) = delete;
+	SnapshotDocument &operator=(SnapshotDocument &&) = delete;
+	virtual ~SnapshotDocument() = default;
+
+	// The styles, line states, and fold levels set since the snapshot was taken.
+	[[nodiscard]] LexResult Result() const;
+
+	int SCI_METHOD Version() const override;
+	void SCI_METHOD SetErrorStatus(int status) override;
+	Sci_Position SCI_METHOD Length() const override;
+	void SCI_METHOD GetCharRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const override;
+	char SCI_METHOD StyleAt(Sci_Position position) const override;
+	Sci_Position SCI_METHOD LineFromPosition(Sci_Position position) const override;
+	Sci_Position SCI_METHOD LineStart(Sci_Position line) const override;
+	int SCI_METHOD GetLevel(Sci_Position line) const override;
+	int SCI_METHOD SetLevel(Sci_Position line, int level) override;
+	int SCI_METHOD GetLineState(Sci_Position line) const override;
+	int SCI_METHOD SetLineState(Sci_Position line, int state) override;
+	void SCI_METHOD StartStyling(Sci_Position position) override;
+	bool SCI_METHOD SetStyleFor(Sci_Position length, char style) override;
+	bool SCI_METHOD SetStyles(Sci_Position length, const char *styles) override;
+	void SCI_METHOD DecorationSetCurrentIndicator(int indicator) override;
+	void SCI_METHOD DecorationFillRange(Sci_Position position, int value, Sci_Position fillLength) override;
+	void SCI_METHOD ChangeLexerState(Sci_Position start, Sci_Position end) override;
+	int SCI_METHOD CodePage() const override;
+	bool SCI_METHOD IsDBCSLeadByte(char ch) const override;
+	const char *SCI_METHOD BufferPointer() override;
+	int SCI_METHOD GetLineIndentation(Sci_Position line) override;
+	Sci_Position SCI_METHOD LineEnd(Sci_Position line) const override;
+	Sci_Position SCI_METHOD GetRelativePosition(Sci_Position positionStart, Sci_Position characterOffset) const override;
+	int SCI_METHOD GetCharacterAndWidth(Sci_Position position, Sci_Position *pWidth) const override;
+	// IDocumentStyles method
+	void SCI_METHOD GetStyleRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const override;
+};
+
+}
+
+#endif
@@ -72,6 +72,33 @@ public:
 	size_t size() const {
 		return states.size();
 	}
+	// Heap bytes used with valueBytes returning the heap bytes owned by each value.
+	template <typename F>
+	size_t HeapBytes(F valueBytes) const noexcept {
+		size_t bytes = states.capacity() * sizeof(State);
+		for (const State &state : states) {
+			bytes += valueBytes(state.value);
+		}
+		return bytes;
+	}
+
+	// Replace the states after position with those from other that were delta positions earlier.
+	void Splice(const SparseState<T> &other, Sci_Position position, Sci_Position delta) {
+		Delete(position+1);
+		const Sci_Position positionOther = position + 1 - delta;
+		T valueStart = T();
+		for (const State &state : other.states) {
+			if (state.position <= positionOther) {
+				valueStart = state.value;
+			}
+		}
+		Set(position+1, valueStart);
+		for (const State &state : other.states) {
+			if (state.position > positionOther) {
+				Set(state.position + delta, state.value);
+			}
+		}
+	}
 
 	// Returns true if Merge caused a significant change
 	bool Merge(const SparseState<T> &other, Sci_Position ignoreAfter) {
@@ -11,6 +11,7 @@
 
 #include <string>
 #include <string_view>
+#include <algorithm>
 
 #include "ILexer.h"
 
@@ -25,6 +26,7 @@ StyleContext::StyleContext(Sci_PositionU startPos, Sci_PositionU length,
 	int initStyle, LexAccessor &styler_, char chMask) :
 	styler(styler_),
 	multiByteAccess((styler.Encoding() == EncodingType::eightBit) ? nullptr : styler.MultiByteAccess()),
+	dbcs(styler.Encoding() == EncodingType::dbcs),
 	lengthDocument(static_cast<Sci_PositionU>(styler.Length())),
 	endPos(((startPos + length) < lengthDocument) ? (startPos + length) : (lengthDocument+1)),
 	lineDocEnd(styler.GetLine(lengthDocument)),
@@ -50,6 +52,38 @@ StyleContext::StyleContext(Sci_PositionU startPos, Sci_PositionU length,
 	GetNextChar();
 }
 
+// Move so chNext is at position when the characters skipped to get there are single bytes.
+void StyleContext::ForwardBefore(Sci_PositionU position) {
+	if (position <= currentPos + width + 1) {
+		if (position == currentPos + width + 1) {
+			Forward();
+		}
+		return;
+	}
+	atLineStart = false;
+	currentPos = position - 1;
+	chPrev = static_cast<unsigned char>(styler[position - 2]);
+	ch = static_cast<unsigned char>(styler[position - 1]);
+	width = 1;
+	GetNextChar();
+}
+
+// Position characters after position in a DBCS document, or -1 past the end as for
+// IDocument::GetRelativePosition.
+Sci_Position StyleContext::ForwardCharacters(Sci_Position position, Sci_Position characters) {
+	const Sci_Position length = lengthDocument;
+	while (characters > 0) {
+		if ((position < 0) || (position >= length)) {
+			return -1;
+		}
+		Sci_Position widthCharacter = 1;
+		styler.DBCSCharacterAndWidth(position, &widthCharacter);
+		position += widthCharacter;
+		characters--;
+	}
+	return position;
+}
+
 bool StyleContext::MatchIgnoreCase(const char *s) {
 	if (MakeLowerCase(ch) != static_cast<unsigned char>(*s))
 		return false;
@@ -86,3 +120,18 @@ void StyleContext::GetCurrentString(std::string &string, Transform transform) co
 		styler.GetRange(startPos, currentPos, string.data(), len + 1);
 	}
 }
+
+std::string_view StyleContext::GetCurrentView(Transform transform) {
+	const Sci_PositionU startPos = styler.GetStartSegment();
+	// Reference mode always copies
+	const char *text = styler.ReferencePath() ? nullptr : styler.BufferPointer(startPos, currentPos);
+	if (text) {
+		const std::string_view view(text, currentPos - startPos);
+		if ((transform == Transform::none) ||
+			std::none_of(view.begin(), view.end(), [](char ch) noexcept { return ch >= 'A' && ch <= 'Z'; })) {
+			return view;
+		}
+	}
+	GetCurrentString(currentScratch, transform);
+	return currentScratch;
+}
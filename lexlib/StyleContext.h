@@ -17,17 +17,24 @@ namespace Lexilla {
 class StyleContext {
 	LexAccessor &styler;
 	Scintilla::IDocument * const multiByteAccess;
+	// DBCS characters are decoded by the styler from its buffer
+	const bool dbcs;
 	const Sci_PositionU lengthDocument;
 	const Sci_PositionU endPos;
 	const Sci_Position lineDocEnd;
 
+	// Holds the text for GetCurrentView when it can not be a view of the styler's buffer
+	std::string currentScratch;
+
 	// Used for optimizing GetRelativeCharacter
 	Sci_PositionU posRelative = 0;
 	Sci_PositionU currentPosLastRelative;
 	Sci_Position offsetRelative = 0;
 
 	void GetNextChar() {
-		if (multiByteAccess) {
+		if (dbcs) {
+			chNext = styler.DBCSCharacterAndWidth(currentPos+width, &widthNext);
+		} else if (multiByteAccess) {
 			chNext = multiByteAccess->GetCharacterAndWidth(currentPos+width, &widthNext);
 		} else {
 			const unsigned char charNext = styler.SafeGetCharAt(currentPos + width, 0);
@@ -42,6 +49,9 @@ class StyleContext {
 			atLineEnd = currentPosSigned >= lineStartNext;
 	}
 
+	void ForwardBefore(Sci_PositionU position);
+	Sci_Position ForwardCharacters(Sci_Position position, Sci_Position characters);
+
 public:
 	Sci_PositionU currentPos;
 	Sci_Position currentLine;
@@ -105,6 +115,46 @@ public:
 			}
 		}
 	}
+	// Move forward until chNext is in set or is at the end of the line or range. For a lexer
+	// to call after finding that ch has no effect when every character that may have an effect
+	// in the current state is in set, so runs of other characters are not examined one by one.
+	// Scans the styler's buffer directly except in DBCS where trail bytes may look like members
+	// and in reference mode.
+	template <typename Set>
+	void ForwardUntilAny(const Set &set) {
+		const Sci_PositionU limit = (static_cast<Sci_PositionU>(lineEnd) < endPos) ? lineEnd : endPos;
+		if (dbcs || styler.ReferencePath()) {
+			while ((currentPos + width < limit) && !set.Contains(chNext)) {
+				Forward();
+			}
+			return;
+		}
+		// In UTF-8 only ASCII is skipped so each character skipped is one byte
+		const unsigned char stopAbove = (styler.Encoding() == EncodingType::unicode) ? 0x7F : 0xFF;
+		const Sci_Position position = currentPos + width;
+		if (position < static_cast<Sci_Position>(limit)) {
+			ForwardBefore(styler.ScanUntilAny(position, limit, set, stopAbove));
+		}
+	}
+	// Move forward until the text from chNext starts with s or chNext is at the end of the line
+	// or range. s starts with an ASCII character which is scanned for as by ForwardUntilAny.
+	void ForwardUntilMatch(const char *s) {
+		const Sci_PositionU limit = (static_cast<Sci_PositionU>(lineEnd) < endPos) ? lineEnd : endPos;
+		const unsigned char first = *s;
+		const unsigned char stopAbove = (styler.Encoding() == EncodingType::unicode) ? 0x7F : 0xFF;
+		while (currentPos + width < limit) {
+			if ((chNext == first) && styler.Match(currentPos + width, s)) {
+				return;
+			}
+			if (dbcs || styler.ReferencePath() || (chNext > stopAbove)) {
+				Forward();
+			} else {
+				// chNext is a single byte that does not start s
+				const Sci_Position position = currentPos + width + 1;
+				ForwardBefore(styler.ScanUntilAnyOf(position, limit, &first, 1, stopAbove));
+			}
+		}
+	}
 	void ChangeState(int state_) noexcept {
 		state = state_;
 	}
@@ -138,8 +188,17 @@ public:
 				offsetRelative = 0;
 			}
 			const Sci_Position diffRelative = n - offsetRelative;
-			const Sci_Position posNew = multiByteAccess->GetRelativePosition(posRelative, diffRelative);
-			const int chReturn = multiByteAccess->GetCharacterAndWidth(posNew, nullptr);
+			Sci_Position posNew = 0;
+			int chReturn = 0;
+			if (dbcs) {
+				// Moving back may need the document to find character starts
+				posNew = (n > 0) ? ForwardCharacters(posRelative, diffRelative) :
+					multiByteAccess->GetRelativePosition(posRelative, diffRelative);
+				chReturn = styler.DBCSCharacterAndWidth(posNew, nullptr);
+			} else {
+				posNew = multiByteAccess->GetRelativePosition(posRelative, diffRelative);
+				chReturn = multiByteAccess->GetCharacterAndWidth(posNew, nullptr);
+			}
 			posRelative = posNew;
 			currentPosLastRelative = currentPos;
 			offsetRelative = n;
@@ -187,6 +246,9 @@ public:
 	void GetCurrentLowered(char *s, Sci_PositionU len) const;
 	enum class Transform { none, lower };
 	void GetCurrentString(std::string &string, Transform transform) const;
+	// Text of the current token without copying when it is in the styler's buffer and does
+	// not need to be lowered. Only valid until the context moves or the styler is read again.
+	[[nodiscard]] std::string_view GetCurrentView(Transform transform=Transform::none);
 };
 
 }
@@ -14,7 +14,12 @@
 #include <algorithm>
 #include <iterator>
 #include <memory>
+#include <unordered_map>
+#include <mutex>
 
+#include "ILexer.h"
+
+#include "LexAccessor.h"
 #include "WordList.h"
 #include "CharacterSet.h"
 
@@ -73,10 +78,137 @@ bool cmpWords(const char *a, const char *b) noexcept {
 
 }
 
+// Documents using the same language set the same keyword text on each of their lexers so
+// the split and sorted form of each distinct text is kept once for the whole process and
+// reference counted. Once constructed, only references changes and that is protected by
+// the cache mutex so WordLists may be set from multiple threads.
+// Lists are found by the hash and length of their text then checked against list, which
+// holds each character of the text as Stored transforms it, so the text is not kept.
+struct WordList::Interned {
+	size_t hash;
+	size_t length;
+	bool lowerCase;
+	bool onlyLineEnds;
+	std::unique_ptr<char[]> list;
+	std::unique_ptr<char *[]> words;
+	size_t len = 0;
+	int starts[256];
+	size_t references = 0;
+
+	Interned(std::string_view source, size_t hash_, bool lowerCase_, bool onlyLineEnds_) :
+		hash(hash_), length(source.length()), lowerCase(lowerCase_), onlyLineEnds(onlyLineEnds_) {
+		list = std::make_unique<char[]>(length + 1);
+		for (size_t i = 0; i < length; i++) {
+			list[i] = lowerCase ? MakeLowerCase(source[i]) : source[i];
+		}
+		list[length] = '\0';
+		words = ArrayFromWordList(list.get(), length, &len, onlyLineEnds);
+		if (len == 0) {
+			// Separators are only terminated when there are words so terminate them here
+			// for Stored to match
+			std::fill(list.get(), list.get() + length, '\0');
+		}
+		std::sort(words.get(), words.get() + len, cmpWords);
+		std::fill(starts, std::end(starts), -1);
+		for (int l = static_cast<int>(len - 1); l >= 0; l--) {
+			unsigned char const indexChar = words[l][0];
+			starts[indexChar] = l;
+		}
+	}
+
+	struct Cache {
+		std::mutex mutex;
+		std::unordered_multimap<size_t, Interned *> lists;
+	};
+	static Cache &TheCache() {
+		// Never destroyed as WordLists in static objects may be released after it would be
+		static Cache *cache = new Cache();
+		return *cache;
+	}
+
+	// The character of list for ch in the text: separators become terminators.
+	[[nodiscard]] char Stored(char ch) const noexcept {
+		if ((ch == '\r') || (ch == '\n') || (!onlyLineEnds && ((ch == ' ') || (ch == '\t')))) {
+			return '\0';
+		}
+		return lowerCase ? MakeLowerCase(ch) : ch;
+	}
+
+	// Would source produce the same list?
+	[[nodiscard]] bool Matches(std::string_view source, bool lowerCase_, bool onlyLineEnds_) const noexcept {
+		if ((source.length() != length) || (lowerCase != lowerCase_) || (onlyLineEnds != onlyLineEnds_)) {
+			return false;
+		}
+		for (size_t i = 0; i < length; i++) {
+			if (Stored(source[i]) != list[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Must be called with the cache mutex locked.
+	static Interned *Find(Cache &cache, std::string_view source, size_t hash, bool lowerCase, bool onlyLineEnds) noexcept {
+		auto [first, last] = cache.lists.equal_range(hash);
+		for (auto it = first; it != last; ++it) {
+			Interned *candidate = it->second;
+			if (candidate->Matches(source, lowerCase, onlyLineEnds)) {
+				candidate->references++;
+				return candidate;
+			}
+		}
+		return nullptr;
+	}
+
+	static Interned *Acquire(std::string_view source, bool lowerCase, bool onlyLineEnds) {
+		const size_t hash = std::hash<std::string_view>{}(source);
+		if (ReferenceMode()) {
+			// Not shared: Release deletes it as it is not found in the cache
+			std::unique_ptr<Interned> own = std::make_unique<Interned>(source, hash, lowerCase, onlyLineEnds);
+			own->references = 1;
+			return own.release();
+		}
+		Cache &cache = TheCache();
+		{
+			std::lock_guard<std::mutex> guard(cache.mutex);
+			if (Interned *found = Find(cache, source, hash, lowerCase, onlyLineEnds)) {
+				return found;
+			}
+		}
+		// Split and sort without holding the lock so other threads are not delayed
+		std::unique_ptr<Interned> created = std::make_unique<Interned>(source, hash, lowerCase, onlyLineEnds);
+		std::lock_guard<std::mutex> guard(cache.mutex);
+		// Another thread may have added the same text meanwhile
+		if (Interned *found = Find(cache, source, hash, lowerCase, onlyLineEnds)) {
+			return found;
+		}
+		created->references = 1;
+		cache.lists.emplace(hash, created.get());
+		return created.release();
+	}
+
+	static void Release(Interned *interned) noexcept {
+		if (!interned) {
+			return;
+		}
+		Cache &cache = TheCache();
+		std::lock_guard<std::mutex> guard(cache.mutex);
+		interned->references--;
+		if (interned->references == 0) {
+			auto [first, last] = cache.lists.equal_range(interned->hash);
+			for (auto it = first; it != last; ++it) {
+				if (it->second == interned) {
+					cache.lists.erase(it);
+					break;
+				}
+			}
+			delete interned;
+		}
+	}
+};
+
 WordList::WordList(bool onlyLineEnds_) noexcept :
-	words(nullptr), list(nullptr), len(0), onlyLineEnds(onlyLineEnds_) {
-	// Prevent warnings by static analyzers about uninitialized starts.
-	starts[0] = -1;
+	interned(nullptr), words(nullptr), starts(nullptr), len(0), onlyLineEnds(onlyLineEnds_) {
 }
 
 WordList::~WordList() {
@@ -102,48 +234,35 @@ int WordList::Length() const noexcept {
 }
 
 void WordList::Clear() noexcept {
-	delete []list;
-	list = nullptr;
-	delete []words;
+	Interned::Release(interned);
+	interned = nullptr;
 	words = nullptr;
+	starts = nullptr;
 	len = 0;
 }
 
 bool WordList::Set(const char *s, bool lowerCase) {
-	const size_t lenS = strlen(s) + 1;
-	std::unique_ptr<char[]> listTemp = std::make_unique<char[]>(lenS);
-	memcpy(listTemp.get(), s, lenS);
-	if (lowerCase) {
-		for (size_t i = 0; i < lenS; i++) {
-			listTemp[i] = MakeLowerCase(listTemp[i]);
-		}
-	}
-	size_t lenTemp = 0;
-	std::unique_ptr<char *[]> wordsTemp = ArrayFromWordList(listTemp.get(), lenS - 1, &lenTemp, onlyLineEnds);
-	std::sort(wordsTemp.get(), wordsTemp.get() + lenTemp, cmpWords);
+	Interned *setting = Interned::Acquire(s, lowerCase, onlyLineEnds);
 
-	if (lenTemp == len) {
+	if (setting->len == len) {
 		bool changed = false;
-		for (size_t i = 0; i < lenTemp; i++) {
-			if (strcmp(words[i], wordsTemp[i]) != 0) {
+		for (size_t i = 0; i < len; i++) {
+			if (strcmp(words[i], setting->words[i]) != 0) {
 				changed = true;
 				break;
 			}
 		}
 		if (!changed) {
+			Interned::Release(setting);
 			return false;
 		}
 	}
 
 	Clear();
-	words = wordsTemp.release();
-	list = listTemp.release();
-	len = lenTemp;
-	std::fill(starts, std::end(starts), -1);
-	for (int l = static_cast<int>(len - 1); l >= 0; l--) {
-		unsigned char const indexChar = words[l][0];
-		starts[indexChar] = l;
-	}
+	interned = setting;
+	words = setting->words.get();
+	starts = setting->starts;
+	len = setting->len;
 	return true;
 }
 
@@ -270,6 +389,46 @@ bool WordList::InListAbbreviated(const char *s, const char marker) const noexcep
 	return false;
 }
 
+bool WordList::InListAbbreviated(std::string_view sv, const char marker) const noexcept {
+	if (!words || sv.empty())
+		return false;
+	const char first = sv[0];
+	const unsigned char firstChar = first;
+	const char second = (sv.length() > 1) ? sv[1] : '\0';
+	if (int j = starts[firstChar]; j >= 0) {
+		for (; words[j][0] == first; j++) {
+			bool isSubword = false;
+			int start = 1;
+			if (words[j][1] == marker) {
+				isSubword = true;
+				start++;
+			}
+			if (second == words[j][start]) {
+				const char *a = words[j] + start;
+				size_t b = 1;
+				while (*a && (b < sv.length()) && *a == sv[b]) {
+					a++;
+					if (*a == marker) {
+						isSubword = true;
+						a++;
+					}
+					b++;
+				}
+				if ((!*a || isSubword) && (b == sv.length()))
+					return true;
+			}
+		}
+	}
+	if (int j = starts[static_cast<unsigned int>('^')]; j >= 0) {
+		for (; words[j][0] == '^'; j++) {
+			if (sv.rfind(words[j] + 1, 0) == 0) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
 /** similar to InListAbbreviated, but word s can be an abridged version of a keyword.
 * eg. the keyword is defined as "after.~:". This means the word must have a prefix (begins with) of
 * "after." and suffix (ends with) of ":" to be a keyword, Hence "after.field:" , "after.form.item:" are valid.
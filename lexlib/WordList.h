@@ -13,12 +13,15 @@ namespace Lexilla {
 /**
  */
 class WordList {
+	// Sorted words shared by all WordLists set from the same text.
+	struct Interned;
+	Interned *interned;
+	// Copied from interned for fast access.
 	// Each word contains at least one character - an empty word acts as sentinel at the end.
-	char **words;
-	char *list;
+	const char *const *words;
+	const int *starts;
 	size_t len;
 	bool onlyLineEnds;	///< Delimited by any white space or only line ends
-	int starts[256];
 public:
 	explicit WordList(bool onlyLineEnds_ = false) noexcept;
 	// Deleted so WordList objects can not be copied.
@@ -35,6 +38,7 @@ public:
 	bool InList(const char *s) const noexcept;
 	bool InList(std::string_view sv) const noexcept;
 	bool InListAbbreviated(const char *s, const char marker) const noexcept;
+	bool InListAbbreviated(std::string_view sv, const char marker) const noexcept;
 	bool InListAbridged(const char *s, const char marker) const noexcept;
 	const char *WordAt(int n) const noexcept;
 };
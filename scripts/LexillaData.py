@@ -24,6 +24,9 @@ Common code used by Lexilla and SciTE for source file regeneration.
 #         sorted list of lexer file stems like LexAbaqus
 #     lexerModules
 #         sorted list of module names like lmAbaqus
+#     lexerNameModules
+#         list of [lexer name, module name] like ["abaqus", "lmAbaqus"]
+#         sorted by lexer name in byte order so it can be binary searched with strcmp
 #     lexerProperties
 #         sorted list of lexer properties like lexer.bash.command.substitution
 #     propertyDocuments
@@ -281,6 +284,7 @@ class LexillaData:
         SortListInsensitive(lexFilePaths)
         self.lexFiles = [f.stem for f in lexFilePaths]
         self.lexerModules = []
+        self.lexerNameModules = []
         lexerProperties = set()
         self.propertyDocuments = {}
         self.sclexFromName = {}
@@ -291,6 +295,7 @@ class LexillaData:
                 self.sclexFromName[module[2]] = module[1]
                 self.fileFromSclex[module[1]] = lexFile
                 self.lexerModules.append(module[0])
+                self.lexerNameModules.append([module[2], module[0]])
             for prop in FindProperties(lexFile):
                 lexerProperties.add(prop)
             documents = FindPropertyDocumentation(lexFile)
@@ -298,6 +303,7 @@ class LexillaData:
                 if prop not in self.propertyDocuments:
                     self.propertyDocuments[prop] = doc
         SortListInsensitive(self.lexerModules)
+        self.lexerNameModules.sort(key=lambda nameModule: nameModule[0].encode("utf-8"))
         self.lexerProperties = list(lexerProperties)
         SortListInsensitive(self.lexerProperties)
 
@@ -7,11 +7,13 @@ Regenerate the Lexilla source files that list all the lexers.
 """
 
 # Should be run whenever a new lexer is added or removed.
+# With "--subset lexers.txt", instead generate src/LexillaSubset.h and src/LexillaSubset.mak to
+# build Lexilla with just the lexers named in lexers.txt, one name per line.
 # Requires Python 3.6 or later
 # Files are regenerated in place with templates stored in comments.
 # The format of generation comments is documented in FileGenerator.py.
 
-import os, pathlib, sys, uuid
+import os, pathlib, re, sys, uuid
 
 thisPath = pathlib.Path(__file__).resolve()
 
@@ -92,6 +94,71 @@ def RegenerateXcodeProject(path, lexers, lexerReferences):
 
     UpdateFileFromLines(path, lines, os.linesep)
 
+def PluginStem(name):
+    """ Name of a lexer as used in plugin file names, where only letters, digits, and '_' are safe. """
+    return re.sub("[^A-Za-z0-9_]", "_", name)
+
+def ReadSubsetList(listPath):
+    """ Return the lexer names in a subset list, ignoring blank lines and '#' comments. """
+    names = []
+    for line in listPath.read_text().splitlines():
+        name = line.split("#")[0].strip()
+        if name:
+            names.append(name)
+    return names
+
+def RegenerateSubset(rootDirectory, listPath):
+    """ Generate the files that build Lexilla with just the lexers named in listPath. """
+
+    root = pathlib.Path(rootDirectory).resolve()
+    srcDir = root / "src"
+
+    # Module and source file for each lexer name
+    nameModules = {}
+    for lexFile in sorted((root / "lexers").glob("Lex*.cxx")):
+        for module in LexillaData.FindModules(lexFile):
+            nameModules[module[2]] = [module[0], lexFile.stem]
+
+    names = ReadSubsetList(listPath)
+    unknown = [name for name in names if name not in nameModules]
+    if unknown:
+        print(f"{listPath}: Unknown lexers: {' '.join(unknown)}")
+        sys.exit(1)
+    # Sorted in strcmp order as Lexilla.cxx binary searches the names
+    names = sorted(set(names), key=lambda name: name.encode("utf-8"))
+    generated = f"Generated by scripts/LexillaGen.py --subset from {listPath.name} so do not edit."
+
+    header = [
+        "// Lexilla lexer library",
+        "/** @file LexillaSubset.h",
+        " ** Lexers built into Lexilla when LEXILLA_SUBSET is defined.",
+        f" ** {generated}",
+        " **/",
+        "",
+        "#define LEXILLA_SUBSET_LEXERS \\",
+    ]
+    header += [f'\tLEXILLA_LEXER("{name}", {nameModules[name][0]}) \\' for name in names]
+    header[-1] = header[-1].rstrip(" \\")
+    (srcDir / "LexillaSubset.h").write_text("\n".join(header) + "\n")
+
+    lexFiles = sorted({nameModules[name][1] for name in names}, key=str.lower)
+    plugins = [PluginStem(name) for name in names]
+    mak = [
+        f"# {generated}",
+        "# Lexer source files built into Lexilla with make SUBSET",
+        "SUBSET_LEXERS = " + " ".join(f"{lexFile}.cxx" for lexFile in lexFiles),
+        "# Plugins along with the lexer name, module, and source file of each",
+        "SUBSET_PLUGINS = " + " ".join(plugins),
+    ]
+    for name, plugin in zip(names, plugins):
+        module, lexFile = nameModules[name]
+        mak += [
+            f"PLUGIN_NAME_{plugin} = {name}",
+            f"PLUGIN_MODULE_{plugin} = {module}",
+            f"PLUGIN_LEXER_{plugin} = {lexFile}",
+        ]
+    (srcDir / "LexillaSubset.mak").write_text("\n".join(mak) + "\n")
+
 def RegenerateAll(rootDirectory):
     """ Regenerate all the files. """
 
@@ -105,7 +172,8 @@ def RegenerateAll(rootDirectory):
     srcDir = lexillaDir / "src"
     docDir = lexillaDir / "doc"
 
-    Regenerate(srcDir / "Lexilla.cxx", "//", lex.lexerModules)
+    lexerNameTable = [f'"{name}", &{module}' for name, module in lex.lexerNameModules]
+    Regenerate(srcDir / "Lexilla.cxx", "//", lex.lexerModules, lexerNameTable)
     Regenerate(srcDir / "lexilla.mak", "#", lex.lexFiles)
 
     # Discover version information
@@ -162,4 +230,8 @@ def RegenerateAll(rootDirectory):
     os.chdir(currentDirectory)
 
 if __name__=="__main__":
-    RegenerateAll(pathlib.Path(__file__).resolve().parent.parent)
+    lexillaRoot = pathlib.Path(__file__).resolve().parent.parent
+    if len(sys.argv) == 3 and sys.argv[1] == "--subset":
+        RegenerateSubset(lexillaRoot, pathlib.Path(sys.argv[2]))
+    else:
+        RegenerateAll(lexillaRoot)
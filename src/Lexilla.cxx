@@ -6,9 +6,16 @@
 // Copyright 2019 by Neil Hodgson <neilh@scintilla.org>
 // The License.txt file describes the conditions under which this software may be distributed.
 
+#include <cstdlib>
+#include <cassert>
 #include <cstring>
+#include <cstdio>
 
+#include <string>
+#include <string_view>
 #include <vector>
+#include <algorithm>
+#include <iterator>
 #include <initializer_list>
 
 #if defined(LEXILLA_NO_EXPORT)
@@ -29,11 +36,31 @@
 
 #include "ILexer.h"
 
+#include "LexillaExtensions.h"
+
+#include "LexAccessor.h"
 #include "LexerModule.h"
 #include "CatalogueModules.h"
+#include "LineStyleCache.h"
+#include "DefaultLexer.h"
+#include "LexerStatistics.h"
+#include "LexerTrace.h"
 
 using namespace Lexilla;
 
+#if defined(LEXILLA_PLUGIN_MODULE)
+// A plugin library holds the single lexer module named on the command line
+#define LEXILLA_SUBSET_LEXERS LEXILLA_LEXER(LEXILLA_PLUGIN_NAME, LEXILLA_PLUGIN_MODULE)
+#elif defined(LEXILLA_SUBSET)
+// Only the lexers listed in LexillaSubset.h which is generated by LexillaGen.py --subset
+#include "LexillaSubset.h"
+#endif
+
+#if defined(LEXILLA_SUBSET_LEXERS)
+#define LEXILLA_LEXER(name, module) extern const LexerModule module;
+LEXILLA_SUBSET_LEXERS
+#undef LEXILLA_LEXER
+#else
 //++Autogenerated -- run lexilla/scripts/LexillaGen.py to regenerate
 //**\(extern const LexerModule \*;\n\)
 extern const LexerModule lmA68k;
@@ -177,11 +204,225 @@ extern const LexerModule lmYAML;
 extern const LexerModule lmZig;
 
 //--Autogenerated -- end of automatically generated section
+#endif
 
 namespace {
 
+struct NamedModule {
+	const char *name;
+	const LexerModule *module;
+};
+
+// Sorted by name in strcmp order so CreateLexer can binary search
+constexpr NamedModule lexerNames[] = {
+#if defined(LEXILLA_SUBSET_LEXERS)
+#define LEXILLA_LEXER(name, module) {name, &module},
+	LEXILLA_SUBSET_LEXERS
+#undef LEXILLA_LEXER
+#else
+//++Autogenerated -- run scripts/LexillaGen.py to regenerate
+//**1\(\t{\*},\n\)
+	{"COBOL", &lmCOBOL},
+	{"DMAP", &lmDMAP},
+	{"DMIS", &lmDMIS},
+	{"PL/M", &lmPLM},
+	{"SML", &lmSML},
+	{"TACL", &lmTACL},
+	{"TAL", &lmTAL},
+	{"a68k", &lmA68k},
+	{"abaqus", &lmAbaqus},
+	{"abl", &lmProgress},
+	{"ada", &lmAda},
+	{"apdl", &lmAPDL},
+	{"as", &lmAs},
+	{"asciidoc", &lmAsciidoc},
+	{"asm", &lmAsm},
+	{"asn1", &lmAsn1},
+	{"asy", &lmASY},
+	{"au3", &lmAU3},
+	{"ave", &lmAVE},
+	{"avs", &lmAVS},
+	{"baan", &lmBaan},
+	{"bash", &lmBash},
+	{"batch", &lmBatch},
+	{"bib", &lmBibTeX},
+	{"blitzbasic", &lmBlitzBasic},
+	{"bullant", &lmBullant},
+	{"caml", &lmCaml},
+	{"cil", &lmCIL},
+	{"clarion", &lmClw},
+	{"clarionnocase", &lmClwNoCase},
+	{"cmake", &lmCmake},
+	{"coffeescript", &lmCoffeeScript},
+	{"conf", &lmConf},
+	{"cpp", &lmCPP},
+	{"cppnocase", &lmCPPNoCase},
+	{"csound", &lmCsound},
+	{"css", &lmCss},
+	{"d", &lmD},
+	{"dart", &lmDart},
+	{"dataflex", &lmDataflex},
+	{"diff", &lmDiff},
+	{"ecl", &lmECL},
+	{"edifact", &lmEDIFACT},
+	{"eiffel", &lmEiffel},
+	{"eiffelkw", &lmEiffelkw},
+	{"erlang", &lmErlang},
+	{"errorlist", &lmErrorList},
+	{"escript", &lmESCRIPT},
+	{"escseq", &lmEscSeq},
+	{"f77", &lmF77},
+	{"fcST", &lmSTTXT},
+	{"flagship", &lmFlagShip},
+	{"forth", &lmForth},
+	{"fortran", &lmFortran},
+	{"freebasic", &lmFreeBasic},
+	{"fsharp", &lmFSharp},
+	{"gap", &lmGAP},
+	{"gdscript", &lmGDScript},
+	{"gui4cli", &lmGui4Cli},
+	{"haskell", &lmHaskell},
+	{"hollywood", &lmHollywood},
+	{"hypertext", &lmHTML},
+	{"ihex", &lmIHex},
+	{"indent", &lmIndent},
+	{"inno", &lmInno},
+	{"json", &lmJSON},
+	{"julia", &lmJulia},
+	{"kix", &lmKix},
+	{"kvirc", &lmKVIrc},
+	{"latex", &lmLatex},
+	{"lisp", &lmLISP},
+	{"literatehaskell", &lmLiterateHaskell},
+	{"lot", &lmLot},
+	{"lout", &lmLout},
+	{"lua", &lmLua},
+	{"magiksf", &lmMagikSF},
+	{"makefile", &lmMake},
+	{"markdown", &lmMarkdown},
+	{"matlab", &lmMatlab},
+	{"maxima", &lmMaxima},
+	{"metapost", &lmMETAPOST},
+	{"mmixal", &lmMMIXAL},
+	{"modula", &lmModula},
+	{"mssql", &lmMSSQL},
+	{"mysql", &lmMySQL},
+	{"nim", &lmNim},
+	{"nimrod", &lmNimrod},
+	{"nix", &lmNix},
+	{"nncrontab", &lmNncrontab},
+	{"nsis", &lmNsis},
+	{"null", &lmNull},
+	{"octave", &lmOctave},
+	{"opal", &lmOpal},
+	{"oscript", &lmOScript},
+	{"pascal", &lmPascal},
+	{"perl", &lmPerl},
+	{"phpscript", &lmPHPSCRIPT},
+	{"po", &lmPO},
+	{"pov", &lmPOV},
+	{"powerbasic", &lmPB},
+	{"powerpro", &lmPowerPro},
+	{"powershell", &lmPowerShell},
+	{"props", &lmProps},
+	{"ps", &lmPS},
+	{"purebasic", &lmPureBasic},
+	{"python", &lmPython},
+	{"r", &lmR},
+	{"raku", &lmRaku},
+	{"rebol", &lmREBOL},
+	{"registry", &lmRegistry},
+	{"ruby", &lmRuby},
+	{"rust", &lmRust},
+	{"sas", &lmSAS},
+	{"scriptol", &lmScriptol},
+	{"sinex", &lmSINEX},
+	{"smalltalk", &lmSmalltalk},
+	{"sorcins", &lmSorc},
+	{"specman", &lmSpecman},
+	{"spice", &lmSpice},
+	{"sql", &lmSQL},
+	{"srec", &lmSrec},
+	{"stata", &lmStata},
+	{"tads3", &lmTADS3},
+	{"tcl", &lmTCL},
+	{"tcmd", &lmTCMD},
+	{"tehex", &lmTEHex},
+	{"tex", &lmTeX},
+	{"toml", &lmTOML},
+	{"troff", &lmTroff},
+	{"txt2tags", &lmTxt2tags},
+	{"vb", &lmVB},
+	{"vbscript", &lmVBScript},
+	{"verilog", &lmVerilog},
+	{"vhdl", &lmVHDL},
+	{"visualprolog", &lmVisualProlog},
+	{"x12", &lmX12},
+	{"xml", &lmXML},
+	{"yaml", &lmYAML},
+	{"zig", &lmZig},
+
+//--Autogenerated -- end of automatically generated section
+#endif
+};
+
+// strcmp order at compile time so lexerNames can be checked whenever it is built.
+constexpr bool NameBefore(const char *a, const char *b) noexcept {
+	while (*a && (*a == *b)) {
+		a++;
+		b++;
+	}
+	return static_cast<unsigned char>(*a) < static_cast<unsigned char>(*b);
+}
+
+constexpr bool NamesSorted() noexcept {
+	for (size_t i = 1; i < std::size(lexerNames); i++) {
+		if (!NameBefore(lexerNames[i - 1].name, lexerNames[i].name)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static_assert(NamesSorted(), "lexerNames must be unique and sorted in strcmp order for FindNamed");
+
+bool NameLess(const NamedModule &named, const char *name) noexcept {
+	return strcmp(named.name, name) < 0;
+}
+
+const LexerModule *FindNamed(const char *name) noexcept {
+	const NamedModule *it = std::lower_bound(std::begin(lexerNames), std::end(lexerNames), name, NameLess);
+	if ((it != std::end(lexerNames)) && (0 == strcmp(it->name, name))) {
+		return it->module;
+	}
+	return nullptr;
+}
+
 CatalogueModules catalogueLexilla;
 
+bool LanguageLess(const LexerModule *plm, int language) noexcept {
+	return plm->GetLanguage() < language;
+}
+
+// The built-in modules ordered by language, which is unique for each, for LexerNameFromID.
+const LexerModule *FindLanguage(int language) {
+	static const std::vector<const LexerModule *> modulesByLanguage = [] {
+		std::vector<const LexerModule *> modules;
+		for (const NamedModule &named : lexerNames) {
+			modules.push_back(named.module);
+		}
+		std::sort(modules.begin(), modules.end(), [](const LexerModule *a, const LexerModule *b) noexcept {
+			return a->GetLanguage() < b->GetLanguage();
+		});
+		return modules;
+	}();
+	const auto it = std::lower_bound(modulesByLanguage.begin(), modulesByLanguage.end(), language, LanguageLess);
+	if ((it != modulesByLanguage.end()) && ((*it)->GetLanguage() == language)) {
+		return *it;
+	}
+	return nullptr;
+}
+
 void AddEachLexer() {
 
 	if (catalogueLexilla.Count() > 0) {
@@ -189,6 +430,11 @@ void AddEachLexer() {
 	}
 
 	catalogueLexilla.AddLexerModules({
+#if defined(LEXILLA_SUBSET_LEXERS)
+#define LEXILLA_LEXER(name, module) &module,
+		LEXILLA_SUBSET_LEXERS
+#undef LEXILLA_LEXER
+#else
 //++Autogenerated -- run scripts/LexillaGen.py to regenerate
 //**\(\t\t&\*,\n\)
 		&lmA68k,
@@ -332,10 +578,65 @@ void AddEachLexer() {
 		&lmZig,
 
 //--Autogenerated -- end of automatically generated section
+#endif
 		});
 
 }
 
+Scintilla::ILexer5 *CreateNamed(const char *name) {
+	if (const LexerModule *pModule = FindNamed(name)) {
+		return pModule->Create();
+	}
+	// Modules added with AddStaticLexerModule are not in lexerNames
+	AddEachLexer();
+	for (size_t i = 0; i < catalogueLexilla.Count(); i++) {
+		const char *lexerName = catalogueLexilla.Name(i);
+		if (0 == strcmp(lexerName, name)) {
+			return catalogueLexilla.Create(i);
+		}
+	}
+	return nullptr;
+}
+
+bool BoolValue(const char *value) noexcept {
+	return atoi(value) != 0;
+}
+
+// Library properties set features for every lexer in the library so hosts can tune them
+// from configuration.
+struct LibraryProperty {
+	const char *name;
+	void (*set)(const char *value);
+};
+
+constexpr LibraryProperty libraryProperties[] = {
+	{ "lexilla.fold.during.lex", [](const char *value) {
+		SetFoldDuringLexDefault(BoolValue(value));
+	} },
+	{ "lexilla.line.cache", [](const char *value) {
+		SetLineStyleCaching(BoolValue(value));
+	} },
+	{ "lexilla.line.cache.lines", [](const char *value) {
+		const int lines = atoi(value);
+		SetLineStyleCacheLines((lines > 0) ? lines : LineStyleCache::defaultSlotCount);
+	} },
+	{ "lexilla.reference.mode", [](const char *value) {
+		SetReferenceMode(BoolValue(value));
+	} },
+	{ "lexilla.statistics", [](const char *value) {
+		SetStatisticsCollection(BoolValue(value));
+	} },
+#if defined(LEXILLA_TRACE)
+	{ "lexilla.trace.file", [](const char *value) {
+		// There is no way to return failure from SetLibraryProperty so report it where
+		// the developer running a trace build will see it
+		if (!WriteTrace(value)) {
+			fprintf(stderr, "Lexilla could not write trace file %s\n", value);
+		}
+	} },
+#endif
+};
+
 }
 
 extern "C" {
@@ -360,19 +661,19 @@ EXPORT_FUNCTION LexerFactoryFunction CALLING_CONVENTION GetLexerFactory(unsigned
 }
 
 EXPORT_FUNCTION Scintilla::ILexer5 * CALLING_CONVENTION CreateLexer(const char *name) {
-	AddEachLexer();
-	for (size_t i = 0; i < catalogueLexilla.Count(); i++) {
-		const char *lexerName = catalogueLexilla.Name(i);
-		if (0 == strcmp(lexerName, name)) {
-			return catalogueLexilla.Create(i);
-		}
+	Scintilla::ILexer5 *lexer = CreateNamed(name);
+	if (lexer && CountingLexers()) {
+		return CountedLexer(lexer, name);
 	}
-	return nullptr;
+	return lexer;
 }
 
 EXPORT_FUNCTION const char * CALLING_CONVENTION LexerNameFromID(int identifier) {
-	AddEachLexer();
-	const LexerModule *pModule = catalogueLexilla.Find(identifier);
+	const LexerModule *pModule = FindLanguage(identifier);
+	if (!pModule) {
+		AddEachLexer();
+		pModule = catalogueLexilla.Find(identifier);
+	}
 	if (pModule) {
 		return pModule->languageName;
 	}
@@ -380,11 +681,36 @@ EXPORT_FUNCTION const char * CALLING_CONVENTION LexerNameFromID(int identifier)
 }
 
 EXPORT_FUNCTION const char * CALLING_CONVENTION GetLibraryPropertyNames() {
-	return "";
+	static const std::string names = [] {
+		std::string joined;
+		for (const LibraryProperty &property : libraryProperties) {
+			if (!joined.empty()) {
+				joined += "\n";
+			}
+			joined += property.name;
+		}
+		return joined;
+	}();
+	return names.c_str();
+}
+
+EXPORT_FUNCTION void CALLING_CONVENTION SetLibraryProperty(const char *key, const char *value) {
+	if (!key || !value) {
+		return;
+	}
+	for (const LibraryProperty &property : libraryProperties) {
+		if (strcmp(key, property.name) == 0) {
+			property.set(value);
+			return;
+		}
+	}
 }
 
-EXPORT_FUNCTION void CALLING_CONVENTION SetLibraryProperty(const char *, const char *) {
-	// Null implementation
+EXPORT_FUNCTION const char * CALLING_CONVENTION GetLexerStatistics() {
+	// Each thread has its own copy which is valid until that thread calls again
+	thread_local std::string statistics;
+	statistics = StatisticsJSON();
+	return statistics.c_str();
 }
 
 EXPORT_FUNCTION const char * CALLING_CONVENTION GetNameSpace() {
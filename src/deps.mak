@@ -3,8 +3,14 @@ $(DIR_O)/Lexilla.o: \
 	../src/Lexilla.cxx \
 	../../scintilla/include/ILexer.h \
 	../../scintilla/include/Sci_Position.h \
+	../include/LexillaExtensions.h \
+	../lexlib/LexAccessor.h \
 	../lexlib/LexerModule.h \
-	../lexlib/CatalogueModules.h
+	../lexlib/CatalogueModules.h \
+	../lexlib/LineStyleCache.h \
+	../lexlib/DefaultLexer.h \
+	../lexlib/LexerStatistics.h \
+	../lexlib/LexerTrace.h
 $(DIR_O)/Accessor.o: \
 	../lexlib/Accessor.cxx \
 	../../scintilla/include/ILexer.h \
@@ -21,19 +27,38 @@ $(DIR_O)/CharacterCategory.o: \
 $(DIR_O)/CharacterSet.o: \
 	../lexlib/CharacterSet.cxx \
 	../lexlib/CharacterSet.h
+$(DIR_O)/Convergence.o: \
+	../lexlib/Convergence.cxx \
+	../../scintilla/include/ILexer.h \
+	../../scintilla/include/Sci_Position.h \
+	../include/LexillaExtensions.h \
+	../lexlib/LexAccessor.h \
+	../lexlib/Convergence.h
 $(DIR_O)/DefaultLexer.o: \
 	../lexlib/DefaultLexer.cxx \
 	../../scintilla/include/ILexer.h \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/PropSetSimple.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
+	../lexlib/Convergence.h \
+	../lexlib/LineStyleCache.h \
 	../lexlib/DefaultLexer.h
+$(DIR_O)/EditableDocument.o: \
+	../lexlib/EditableDocument.cxx \
+	../../scintilla/include/ILexer.h \
+	../../scintilla/include/Sci_Position.h \
+	../../scintilla/include/Scintilla.h \
+	../include/LexillaExtensions.h \
+	../lexlib/DocumentCharacters.h \
+	../lexlib/GapBuffer.h \
+	../lexlib/EditableDocument.h
 $(DIR_O)/InList.o: \
 	../lexlib/InList.cxx \
 	../lexlib/InList.h \
@@ -43,8 +68,10 @@ $(DIR_O)/LexAccessor.o: \
 	../../scintilla/include/ILexer.h \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
+	../include/LexillaExtensions.h \
 	../lexlib/LexAccessor.h \
-	../lexlib/CharacterSet.h
+	../lexlib/CharacterSet.h \
+	../lexlib/DocumentCharacters.h
 $(DIR_O)/LexerBase.o: \
 	../lexlib/LexerBase.cxx \
 	../../scintilla/include/ILexer.h \
@@ -76,16 +103,53 @@ $(DIR_O)/LexerSimple.o: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/PropSetSimple.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
 	../lexlib/LexerModule.h \
+	../lexlib/Convergence.h \
+	../lexlib/LineStyleCache.h \
 	../lexlib/LexerBase.h \
 	../lexlib/LexerSimple.h
+$(DIR_O)/LexerStatistics.o: \
+	../lexlib/LexerStatistics.cxx \
+	../../scintilla/include/ILexer.h \
+	../../scintilla/include/Sci_Position.h \
+	../lexlib/LexAccessor.h \
+	../lexlib/LexerStatistics.h \
+	../lexlib/LexerTrace.h
+$(DIR_O)/LexerTrace.o: \
+	../lexlib/LexerTrace.cxx \
+	../../scintilla/include/ILexer.h \
+	../../scintilla/include/Sci_Position.h \
+	../lexlib/LexAccessor.h \
+	../lexlib/LexerTrace.h
+$(DIR_O)/LineStyleCache.o: \
+	../lexlib/LineStyleCache.cxx \
+	../../scintilla/include/ILexer.h \
+	../../scintilla/include/Sci_Position.h \
+	../include/LexillaExtensions.h \
+	../lexlib/LexAccessor.h \
+	../lexlib/MemoryUse.h \
+	../lexlib/LineStyleCache.h
+$(DIR_O)/OptionSet.o: \
+	../lexlib/OptionSet.cxx \
+	../../scintilla/include/Scintilla.h \
+	../../scintilla/include/Sci_Position.h \
+	../lexlib/OptionSet.h
 $(DIR_O)/PropSetSimple.o: \
 	../lexlib/PropSetSimple.cxx \
 	../lexlib/PropSetSimple.h
+$(DIR_O)/SnapshotDocument.o: \
+	../lexlib/SnapshotDocument.cxx \
+	../../scintilla/include/ILexer.h \
+	../../scintilla/include/Sci_Position.h \
+	../../scintilla/include/Scintilla.h \
+	../include/LexillaExtensions.h \
+	../lexlib/DocumentCharacters.h \
+	../lexlib/SnapshotDocument.h
 $(DIR_O)/StyleContext.o: \
 	../lexlib/StyleContext.cxx \
 	../../scintilla/include/ILexer.h \
@@ -96,6 +160,9 @@ $(DIR_O)/StyleContext.o: \
 	../lexlib/CharacterSet.h
 $(DIR_O)/WordList.o: \
 	../lexlib/WordList.cxx \
+	../../scintilla/include/ILexer.h \
+	../../scintilla/include/Sci_Position.h \
+	../lexlib/LexAccessor.h \
 	../lexlib/WordList.h \
 	../lexlib/CharacterSet.h
 $(DIR_O)/LexA68k.o: \
@@ -259,6 +326,7 @@ $(DIR_O)/LexBash.o: \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
 	../lexlib/SubStyles.h \
+	../lexlib/Convergence.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexBasic.o: \
 	../lexers/LexBasic.cxx \
@@ -406,6 +474,7 @@ $(DIR_O)/LexCPP.o: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/StringCopy.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
@@ -415,7 +484,9 @@ $(DIR_O)/LexCPP.o: \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
 	../lexlib/SparseState.h \
-	../lexlib/SubStyles.h
+	../lexlib/MemoryUse.h \
+	../lexlib/SubStyles.h \
+	../lexlib/Convergence.h
 $(DIR_O)/LexCrontab.o: \
 	../lexers/LexCrontab.cxx \
 	../../scintilla/include/ILexer.h \
@@ -446,6 +517,7 @@ $(DIR_O)/LexCSS.o: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../lexlib/PropSetSimple.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -485,6 +557,7 @@ $(DIR_O)/LexDataflex.o: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../lexlib/PropSetSimple.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -580,6 +653,7 @@ $(DIR_O)/LexErrorList.o: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/InList.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
@@ -588,6 +662,7 @@ $(DIR_O)/LexErrorList.o: \
 	../lexlib/CharacterSet.h \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
+	../lexlib/LineStyleCache.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexEScript.o: \
 	../lexers/LexEScript.cxx \
@@ -762,6 +837,7 @@ $(DIR_O)/LexHTML.o: \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
 	../lexlib/SubStyles.h \
+	../lexlib/Convergence.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexIndent.o: \
 	../lexers/LexIndent.cxx \
@@ -799,6 +875,7 @@ $(DIR_O)/LexJSON.o: \
 	../lexlib/CharacterSet.h \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
+	../lexlib/Convergence.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexJulia.o: \
 	../lexers/LexJulia.cxx \
@@ -894,6 +971,7 @@ $(DIR_O)/LexLua.o: \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
 	../lexlib/SubStyles.h \
+	../lexlib/Convergence.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexMagik.o: \
 	../lexers/LexMagik.cxx \
@@ -913,6 +991,7 @@ $(DIR_O)/LexMake.o: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -920,6 +999,7 @@ $(DIR_O)/LexMake.o: \
 	../lexlib/CharacterSet.h \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
+	../lexlib/LineStyleCache.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexMarkdown.o: \
 	../lexers/LexMarkdown.cxx \
@@ -1077,6 +1157,7 @@ $(DIR_O)/LexNsis.o: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../lexlib/PropSetSimple.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -1262,6 +1343,7 @@ $(DIR_O)/LexPython.o: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -1270,7 +1352,9 @@ $(DIR_O)/LexPython.o: \
 	../lexlib/CharacterCategory.h \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
+	../lexlib/MemoryUse.h \
 	../lexlib/SubStyles.h \
+	../lexlib/Convergence.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexR.o: \
 	../lexers/LexR.cxx \
@@ -1353,6 +1437,7 @@ $(DIR_O)/LexRust.o: \
 	../lexlib/CharacterSet.h \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
+	../lexlib/Convergence.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexSAS.o: \
 	../lexers/LexSAS.cxx \
@@ -1454,6 +1539,7 @@ $(DIR_O)/LexSQL.o: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -1462,6 +1548,7 @@ $(DIR_O)/LexSQL.o: \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
 	../lexlib/SparseState.h \
+	../lexlib/MemoryUse.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexStata.o: \
 	../lexers/LexStata.cxx \
@@ -1553,6 +1640,7 @@ $(DIR_O)/LexTeX.o: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../lexlib/PropSetSimple.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -1615,6 +1703,7 @@ $(DIR_O)/LexVerilog.o: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -1622,6 +1711,7 @@ $(DIR_O)/LexVerilog.o: \
 	../lexlib/CharacterSet.h \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
+	../lexlib/MemoryUse.h \
 	../lexlib/SubStyles.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexVHDL.o: \
@@ -1630,6 +1720,7 @@ $(DIR_O)/LexVHDL.o: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../lexlib/PropSetSimple.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -1665,12 +1756,14 @@ $(DIR_O)/LexYAML.o: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
 	../lexlib/StyleContext.h \
 	../lexlib/CharacterSet.h \
-	../lexlib/LexerModule.h
+	../lexlib/LexerModule.h \
+	../lexlib/LineStyleCache.h
 $(DIR_O)/LexZig.o: \
 	../lexers/LexZig.cxx \
 	../../scintilla/include/ILexer.h \
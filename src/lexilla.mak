@@ -12,6 +12,7 @@
 #     DEBUG Debug build.
 #     QUIET Avoid most compiler invocation output and copyright info.
 #     SUPPORT_XP Build for Windows XP.
+#     TRACE Record trace events from lexers.
 
 .SUFFIXES: .cxx
 
@@ -68,6 +69,10 @@ LDFLAGS=$(LDDEBUG) $(LDFLAGS)
 CXXFLAGS=$(CXXFLAGS) $(CXXNDEBUG)
 !ENDIF
 
+!IFDEF TRACE
+CXXFLAGS=$(CXXFLAGS) -DLEXILLA_TRACE
+!ENDIF
+
 SCINTILLA_INCLUDE = ../../scintilla/include
 
 INCLUDEDIRS=-I../include -I$(SCINTILLA_INCLUDE) -I../lexlib
@@ -225,13 +230,20 @@ LEXLIB_OBJS=\
 	$(DIR_O)\Accessor.obj \
 	$(DIR_O)\CharacterCategory.obj \
 	$(DIR_O)\CharacterSet.obj \
+	$(DIR_O)\Convergence.obj \
 	$(DIR_O)\DefaultLexer.obj \
+	$(DIR_O)\EditableDocument.obj \
 	$(DIR_O)\InList.obj \
 	$(DIR_O)\LexAccessor.obj \
 	$(DIR_O)\LexerBase.obj \
 	$(DIR_O)\LexerModule.obj \
 	$(DIR_O)\LexerSimple.obj \
+	$(DIR_O)\LexerStatistics.obj \
+	$(DIR_O)\LexerTrace.obj \
+	$(DIR_O)\LineStyleCache.obj \
+	$(DIR_O)\OptionSet.obj \
 	$(DIR_O)\PropSetSimple.obj \
+	$(DIR_O)\SnapshotDocument.obj \
 	$(DIR_O)\StyleContext.obj \
 	$(DIR_O)\WordList.obj
 
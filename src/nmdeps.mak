@@ -3,8 +3,14 @@ $(DIR_O)/Lexilla.obj: \
 	../src/Lexilla.cxx \
 	../../scintilla/include/ILexer.h \
 	../../scintilla/include/Sci_Position.h \
+	../include/LexillaExtensions.h \
+	../lexlib/LexAccessor.h \
 	../lexlib/LexerModule.h \
-	../lexlib/CatalogueModules.h
+	../lexlib/CatalogueModules.h \
+	../lexlib/LineStyleCache.h \
+	../lexlib/DefaultLexer.h \
+	../lexlib/LexerStatistics.h \
+	../lexlib/LexerTrace.h
 $(DIR_O)/Accessor.obj: \
 	../lexlib/Accessor.cxx \
 	../../scintilla/include/ILexer.h \
@@ -21,19 +27,38 @@ $(DIR_O)/CharacterCategory.obj: \
 $(DIR_O)/CharacterSet.obj: \
 	../lexlib/CharacterSet.cxx \
 	../lexlib/CharacterSet.h
+$(DIR_O)/Convergence.obj: \
+	../lexlib/Convergence.cxx \
+	../../scintilla/include/ILexer.h \
+	../../scintilla/include/Sci_Position.h \
+	../include/LexillaExtensions.h \
+	../lexlib/LexAccessor.h \
+	../lexlib/Convergence.h
 $(DIR_O)/DefaultLexer.obj: \
 	../lexlib/DefaultLexer.cxx \
 	../../scintilla/include/ILexer.h \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/PropSetSimple.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
+	../lexlib/Convergence.h \
+	../lexlib/LineStyleCache.h \
 	../lexlib/DefaultLexer.h
+$(DIR_O)/EditableDocument.obj: \
+	../lexlib/EditableDocument.cxx \
+	../../scintilla/include/ILexer.h \
+	../../scintilla/include/Sci_Position.h \
+	../../scintilla/include/Scintilla.h \
+	../include/LexillaExtensions.h \
+	../lexlib/DocumentCharacters.h \
+	../lexlib/GapBuffer.h \
+	../lexlib/EditableDocument.h
 $(DIR_O)/InList.obj: \
 	../lexlib/InList.cxx \
 	../lexlib/InList.h \
@@ -43,8 +68,10 @@ $(DIR_O)/LexAccessor.obj: \
 	../../scintilla/include/ILexer.h \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
+	../include/LexillaExtensions.h \
 	../lexlib/LexAccessor.h \
-	../lexlib/CharacterSet.h
+	../lexlib/CharacterSet.h \
+	../lexlib/DocumentCharacters.h
 $(DIR_O)/LexerBase.obj: \
 	../lexlib/LexerBase.cxx \
 	../../scintilla/include/ILexer.h \
@@ -76,16 +103,53 @@ $(DIR_O)/LexerSimple.obj: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/PropSetSimple.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
 	../lexlib/LexerModule.h \
+	../lexlib/Convergence.h \
+	../lexlib/LineStyleCache.h \
 	../lexlib/LexerBase.h \
 	../lexlib/LexerSimple.h
+$(DIR_O)/LexerStatistics.obj: \
+	../lexlib/LexerStatistics.cxx \
+	../../scintilla/include/ILexer.h \
+	../../scintilla/include/Sci_Position.h \
+	../lexlib/LexAccessor.h \
+	../lexlib/LexerStatistics.h \
+	../lexlib/LexerTrace.h
+$(DIR_O)/LexerTrace.obj: \
+	../lexlib/LexerTrace.cxx \
+	../../scintilla/include/ILexer.h \
+	../../scintilla/include/Sci_Position.h \
+	../lexlib/LexAccessor.h \
+	../lexlib/LexerTrace.h
+$(DIR_O)/LineStyleCache.obj: \
+	../lexlib/LineStyleCache.cxx \
+	../../scintilla/include/ILexer.h \
+	../../scintilla/include/Sci_Position.h \
+	../include/LexillaExtensions.h \
+	../lexlib/LexAccessor.h \
+	../lexlib/MemoryUse.h \
+	../lexlib/LineStyleCache.h
+$(DIR_O)/OptionSet.obj: \
+	../lexlib/OptionSet.cxx \
+	../../scintilla/include/Scintilla.h \
+	../../scintilla/include/Sci_Position.h \
+	../lexlib/OptionSet.h
 $(DIR_O)/PropSetSimple.obj: \
 	../lexlib/PropSetSimple.cxx \
 	../lexlib/PropSetSimple.h
+$(DIR_O)/SnapshotDocument.obj: \
+	../lexlib/SnapshotDocument.cxx \
+	../../scintilla/include/ILexer.h \
+	../../scintilla/include/Sci_Position.h \
+	../../scintilla/include/Scintilla.h \
+	../include/LexillaExtensions.h \
+	../lexlib/DocumentCharacters.h \
+	../lexlib/SnapshotDocument.h
 $(DIR_O)/StyleContext.obj: \
 	../lexlib/StyleContext.cxx \
 	../../scintilla/include/ILexer.h \
@@ -96,6 +160,9 @@ $(DIR_O)/StyleContext.obj: \
 	../lexlib/CharacterSet.h
 $(DIR_O)/WordList.obj: \
 	../lexlib/WordList.cxx \
+	../../scintilla/include/ILexer.h \
+	../../scintilla/include/Sci_Position.h \
+	../lexlib/LexAccessor.h \
 	../lexlib/WordList.h \
 	../lexlib/CharacterSet.h
 $(DIR_O)/LexA68k.obj: \
@@ -259,6 +326,7 @@ $(DIR_O)/LexBash.obj: \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
 	../lexlib/SubStyles.h \
+	../lexlib/Convergence.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexBasic.obj: \
 	../lexers/LexBasic.cxx \
@@ -406,6 +474,7 @@ $(DIR_O)/LexCPP.obj: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/StringCopy.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
@@ -415,7 +484,9 @@ $(DIR_O)/LexCPP.obj: \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
 	../lexlib/SparseState.h \
-	../lexlib/SubStyles.h
+	../lexlib/MemoryUse.h \
+	../lexlib/SubStyles.h \
+	../lexlib/Convergence.h
 $(DIR_O)/LexCrontab.obj: \
 	../lexers/LexCrontab.cxx \
 	../../scintilla/include/ILexer.h \
@@ -446,6 +517,7 @@ $(DIR_O)/LexCSS.obj: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../lexlib/PropSetSimple.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -485,6 +557,7 @@ $(DIR_O)/LexDataflex.obj: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../lexlib/PropSetSimple.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -580,6 +653,7 @@ $(DIR_O)/LexErrorList.obj: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/InList.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
@@ -588,6 +662,7 @@ $(DIR_O)/LexErrorList.obj: \
 	../lexlib/CharacterSet.h \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
+	../lexlib/LineStyleCache.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexEScript.obj: \
 	../lexers/LexEScript.cxx \
@@ -762,6 +837,7 @@ $(DIR_O)/LexHTML.obj: \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
 	../lexlib/SubStyles.h \
+	../lexlib/Convergence.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexIndent.obj: \
 	../lexers/LexIndent.cxx \
@@ -799,6 +875,7 @@ $(DIR_O)/LexJSON.obj: \
 	../lexlib/CharacterSet.h \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
+	../lexlib/Convergence.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexJulia.obj: \
 	../lexers/LexJulia.cxx \
@@ -894,6 +971,7 @@ $(DIR_O)/LexLua.obj: \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
 	../lexlib/SubStyles.h \
+	../lexlib/Convergence.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexMagik.obj: \
 	../lexers/LexMagik.cxx \
@@ -913,6 +991,7 @@ $(DIR_O)/LexMake.obj: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -920,6 +999,7 @@ $(DIR_O)/LexMake.obj: \
 	../lexlib/CharacterSet.h \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
+	../lexlib/LineStyleCache.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexMarkdown.obj: \
 	../lexers/LexMarkdown.cxx \
@@ -1077,6 +1157,7 @@ $(DIR_O)/LexNsis.obj: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../lexlib/PropSetSimple.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -1262,6 +1343,7 @@ $(DIR_O)/LexPython.obj: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -1270,7 +1352,9 @@ $(DIR_O)/LexPython.obj: \
 	../lexlib/CharacterCategory.h \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
+	../lexlib/MemoryUse.h \
 	../lexlib/SubStyles.h \
+	../lexlib/Convergence.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexR.obj: \
 	../lexers/LexR.cxx \
@@ -1353,6 +1437,7 @@ $(DIR_O)/LexRust.obj: \
 	../lexlib/CharacterSet.h \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
+	../lexlib/Convergence.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexSAS.obj: \
 	../lexers/LexSAS.cxx \
@@ -1454,6 +1539,7 @@ $(DIR_O)/LexSQL.obj: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -1462,6 +1548,7 @@ $(DIR_O)/LexSQL.obj: \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
 	../lexlib/SparseState.h \
+	../lexlib/MemoryUse.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexStata.obj: \
 	../lexers/LexStata.cxx \
@@ -1553,6 +1640,7 @@ $(DIR_O)/LexTeX.obj: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../lexlib/PropSetSimple.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -1615,6 +1703,7 @@ $(DIR_O)/LexVerilog.obj: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -1622,6 +1711,7 @@ $(DIR_O)/LexVerilog.obj: \
 	../lexlib/CharacterSet.h \
 	../lexlib/LexerModule.h \
 	../lexlib/OptionSet.h \
+	../lexlib/MemoryUse.h \
 	../lexlib/SubStyles.h \
 	../lexlib/DefaultLexer.h
 $(DIR_O)/LexVHDL.obj: \
@@ -1630,6 +1720,7 @@ $(DIR_O)/LexVHDL.obj: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../lexlib/PropSetSimple.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
@@ -1665,12 +1756,14 @@ $(DIR_O)/LexYAML.obj: \
 	../../scintilla/include/Sci_Position.h \
 	../../scintilla/include/Scintilla.h \
 	../include/SciLexer.h \
+	../include/LexillaExtensions.h \
 	../lexlib/WordList.h \
 	../lexlib/LexAccessor.h \
 	../lexlib/Accessor.h \
 	../lexlib/StyleContext.h \
 	../lexlib/CharacterSet.h \
-	../lexlib/LexerModule.h
+	../lexlib/LexerModule.h \
+	../lexlib/LineStyleCache.h
 $(DIR_O)/LexZig.obj: \
 	../lexers/LexZig.cxx \
 	../../scintilla/include/ILexer.h \
@@ -0,0 +1,165 @@
+// Lexilla lexer library
+/** @file AllocationCounter.cxx
+ ** Count heap allocations made through operator new.
+ ** Replaces the global allocation functions so is only linked into test programs.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#include <new>
+#include <atomic>
+
+#include "AllocationCounter.h"
+
+namespace {
+
+std::atomic<bool> counting = false;
+std::atomic<size_t> allocations = 0;
+std::atomic<size_t> bytes = 0;
+
+void *Allocate(std::size_t size) noexcept {
+	if (counting.load(std::memory_order_relaxed)) {
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		bytes.fetch_add(size, std::memory_order_relaxed);
+	}
+	return std::malloc(size ? size : 1);
+}
+
+void *AllocateAligned(std::size_t size, std::align_val_t alignment) noexcept {
+	if (counting.load(std::memory_order_relaxed)) {
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		bytes.fetch_add(size, std::memory_order_relaxed);
+	}
+	const std::size_t align = static_cast<std::size_t>(alignment);
+#if defined(_WIN32)
+	return _aligned_malloc(size ? size : 1, align);
+#else
+	// aligned_alloc requires the size to be a multiple of the alignment
+	const std::size_t sizeRounded = ((size ? size : 1) + align - 1) / align * align;
+	return std::aligned_alloc(align, sizeRounded);
+#endif
+}
+
+void FreeAligned(void *p) noexcept {
+#if defined(_WIN32)
+	_aligned_free(p);
+#else
+	std::free(p);
+#endif
+}
+
+}
+
+void StartCountingAllocations() noexcept {
+	allocations = 0;
+	bytes = 0;
+	counting = true;
+}
+
+AllocationCount StopCountingAllocations() noexcept {
+	counting = false;
+	return { allocations, bytes };
+}
+
+void *operator new(std::size_t size) {
+	void *p = Allocate(size);
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void *operator new[](std::size_t size) {
+	void *p = Allocate(size);
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+	return Allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+	return Allocate(size);
+}
+
+void operator delete(void *p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+	std::free(p);
+}
+
+// Over-aligned types are allocated through the std::align_val_t overloads.
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+	void *p = AllocateAligned(size, alignment);
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+	void *p = AllocateAligned(size, alignment);
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+	return AllocateAligned(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+	return AllocateAligned(size, alignment);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept {
+	FreeAligned(p);
+}
+
+void operator delete[](void *p, std::align_val_t) noexcept {
+	FreeAligned(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+	FreeAligned(p);
+}
+
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept {
+	FreeAligned(p);
+}
+
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept {
+	FreeAligned(p);
+}
+
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept {
+	FreeAligned(p);
+}
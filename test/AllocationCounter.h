@@ -0,0 +1,21 @@
+// Lexilla lexer library
+/** @file AllocationCounter.h
+ ** Count heap allocations made through operator new.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+struct AllocationCount {
+	size_t allocations = 0;
+	size_t bytes = 0;
+};
+
+// Allocations are only counted between Start and Stop.
+// Allocations made inside a shared library are only seen when the platform resolves the library's
+// operator new to the executable's replacement as on Linux or when Lexilla is linked statically.
+void StartCountingAllocations() noexcept;
+AllocationCount StopCountingAllocations() noexcept;
+
+#endif
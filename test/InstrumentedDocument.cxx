@@ -0,0 +1,233 @@
+// Lexilla lexer library
+/** @file InstrumentedDocument.cxx
+ ** Wrap a document to record how a lexer accesses it.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#include <cassert>
+
+#include <string>
+#include <optional>
+#include <algorithm>
+
+#include "ILexer.h"
+
+#include "LexillaExtensions.h"
+
+#include "InstrumentedDocument.h"
+
+namespace {
+
+void Extend(std::optional<Sci_Position> &minimum, std::optional<Sci_Position> &maximum, Sci_Position start, Sci_Position end) noexcept {
+	minimum = minimum ? std::min(*minimum, start) : start;
+	maximum = maximum ? std::max(*maximum, end) : end;
+}
+
+}
+
+void AccessRecord::Start(Sci_Position startPos_, Sci_Position lengthDoc, Sci_Position startLine_) noexcept {
+	*this = AccessRecord();
+	startPos = startPos_;
+	endPos = startPos_ + lengthDoc;
+	startLine = startLine_;
+}
+
+Sci_Position AccessRecord::TextBehind() const noexcept {
+	if (minText && (*minText < startPos)) {
+		return startPos - *minText;
+	}
+	return 0;
+}
+
+Sci_Position AccessRecord::StyleBehind() const noexcept {
+	if (minStyle && (*minStyle < startPos)) {
+		return startPos - *minStyle;
+	}
+	return 0;
+}
+
+Sci_Position AccessRecord::TextAhead() const noexcept {
+	if (maxText && (*maxText >= endPos)) {
+		return *maxText - endPos + 1;
+	}
+	return 0;
+}
+
+#if defined(_MSC_VER)
+// IDocument interface does not specify noexcept so best to not add it to implementation
+#pragma warning(disable: 26440)
+#endif
+
+InstrumentedDocument::InstrumentedDocument(Scintilla::IDocument *pdoc_) noexcept : pdoc(pdoc_) {
+	assert(pdoc);
+}
+
+void InstrumentedDocument::Start(Sci_Position startPos, Sci_Position lengthDoc) {
+	record.Start(startPos, lengthDoc, pdoc->LineFromPosition(startPos));
+}
+
+const AccessRecord &InstrumentedDocument::Record() const noexcept {
+	return record;
+}
+
+void InstrumentedDocument::ReadText(Sci_Position start, Sci_Position length) const noexcept {
+	if (length > 0) {
+		Extend(record.minText, record.maxText, start, start + length - 1);
+	}
+}
+
+int SCI_METHOD InstrumentedDocument::Version() const {
+	record.calls++;
+	// Styles are recorded as each is read so bulk style access is not offered
+	return (pdoc->Version() & ~Lexilla::dvStyleRange) | Lexilla::dvFills;
+}
+
+void SCI_METHOD InstrumentedDocument::SetErrorStatus(int status) {
+	record.calls++;
+	pdoc->SetErrorStatus(status);
+}
+
+Sci_Position SCI_METHOD InstrumentedDocument::Length() const {
+	record.calls++;
+	return pdoc->Length();
+}
+
+void SCI_METHOD InstrumentedDocument::GetCharRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const {
+	record.calls++;
+	record.charRangeFills++;
+	record.bytesFilled += lengthRetrieve;
+	if (filling) {
+		// Buffer fill whose position needed was recorded by Filling
+		filling = false;
+	} else {
+		// Direct read so all of range needed
+		ReadText(position, lengthRetrieve);
+	}
+	pdoc->GetCharRange(buffer, position, lengthRetrieve);
+}
+
+char SCI_METHOD InstrumentedDocument::StyleAt(Sci_Position position) const {
+	record.calls++;
+	record.styleReads++;
+	if (position < record.startPos) {
+		record.styleReadsBefore++;
+	}
+	Extend(record.minStyle, record.maxStyle, position, position);
+	return pdoc->StyleAt(position);
+}
+
+Sci_Position SCI_METHOD InstrumentedDocument::LineFromPosition(Sci_Position position) const {
+	record.calls++;
+	return pdoc->LineFromPosition(position);
+}
+
+Sci_Position SCI_METHOD InstrumentedDocument::LineStart(Sci_Position line) const {
+	record.calls++;
+	return pdoc->LineStart(line);
+}
+
+int SCI_METHOD InstrumentedDocument::GetLevel(Sci_Position line) const {
+	record.calls++;
+	record.levelReads++;
+	return pdoc->GetLevel(line);
+}
+
+int SCI_METHOD InstrumentedDocument::SetLevel(Sci_Position line, int level) {
+	record.calls++;
+	return pdoc->SetLevel(line, level);
+}
+
+int SCI_METHOD InstrumentedDocument::GetLineState(Sci_Position line) const {
+	record.calls++;
+	record.lineStateReads++;
+	if (line < record.startLine) {
+		record.lineStateReadsBefore++;
+	}
+	return pdoc->GetLineState(line);
+}
+
+int SCI_METHOD InstrumentedDocument::SetLineState(Sci_Position line, int state) {
+	record.calls++;
+	return pdoc->SetLineState(line, state);
+}
+
+void SCI_METHOD InstrumentedDocument::StartStyling(Sci_Position position) {
+	record.calls++;
+	pdoc->StartStyling(position);
+}
+
+bool SCI_METHOD InstrumentedDocument::SetStyleFor(Sci_Position length, char style) {
+	record.calls++;
+	return pdoc->SetStyleFor(length, style);
+}
+
+bool SCI_METHOD InstrumentedDocument::SetStyles(Sci_Position length, const char *styles) {
+	record.calls++;
+	return pdoc->SetStyles(length, styles);
+}
+
+void SCI_METHOD InstrumentedDocument::DecorationSetCurrentIndicator(int indicator) {
+	record.calls++;
+	pdoc->DecorationSetCurrentIndicator(indicator);
+}
+
+void SCI_METHOD InstrumentedDocument::DecorationFillRange(Sci_Position position, int value, Sci_Position fillLength) {
+	record.calls++;
+	pdoc->DecorationFillRange(position, value, fillLength);
+}
+
+void SCI_METHOD InstrumentedDocument::ChangeLexerState(Sci_Position start, Sci_Position end) {
+	record.calls++;
+	pdoc->ChangeLexerState(start, end);
+}
+
+int SCI_METHOD InstrumentedDocument::CodePage() const {
+	record.calls++;
+	return pdoc->CodePage();
+}
+
+bool SCI_METHOD InstrumentedDocument::IsDBCSLeadByte(char ch) const {
+	record.calls++;
+	return pdoc->IsDBCSLeadByte(ch);
+}
+
+const char *SCI_METHOD InstrumentedDocument::BufferPointer() {
+	record.calls++;
+	// Whole document may be read through the pointer
+	ReadText(0, pdoc->Length());
+	return pdoc->BufferPointer();
+}
+
+int SCI_METHOD InstrumentedDocument::GetLineIndentation(Sci_Position line) {
+	record.calls++;
+	return pdoc->GetLineIndentation(line);
+}
+
+Sci_Position SCI_METHOD InstrumentedDocument::LineEnd(Sci_Position line) const {
+	record.calls++;
+	return pdoc->LineEnd(line);
+}
+
+Sci_Position SCI_METHOD InstrumentedDocument::GetRelativePosition(Sci_Position positionStart, Sci_Position characterOffset) const {
+	record.calls++;
+	return pdoc->GetRelativePosition(positionStart, characterOffset);
+}
+
+void SCI_METHOD InstrumentedDocument::Filling(Sci_Position position) {
+	record.calls++;
+	ReadText(position, 1);
+	filling = true;
+}
+
+int SCI_METHOD InstrumentedDocument::GetCharacterAndWidth(Sci_Position position, Sci_Position *pWidth) const {
+	record.calls++;
+	Sci_Position width = 1;
+	const int character = pdoc->GetCharacterAndWidth(position, &width);
+	if ((position >= 0) && (position < pdoc->Length())) {
+		ReadText(position, width);
+	}
+	if (pWidth) {
+		*pWidth = width;
+	}
+	return character;
+}
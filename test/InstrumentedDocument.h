@@ -0,0 +1,90 @@
+// Lexilla lexer library
+/** @file InstrumentedDocument.h
+ ** Wrap a document to record how a lexer accesses it.
+ **/
+// The License.txt file describes the conditions under which this software may be distributed.
+
+#ifndef INSTRUMENTEDDOCUMENT_H
+#define INSTRUMENTEDDOCUMENT_H
+
+#include <optional>
+
+// Accesses made by a single Lex or Fold call.
+// Positions are byte positions and lines are line numbers.
+struct AccessRecord {
+	Sci_Position startPos = 0;
+	Sci_Position endPos = 0;
+	Sci_Position startLine = 0;
+	// Range of text read with GetCharRange or GetCharacterAndWidth
+	std::optional<Sci_Position> minText;
+	std::optional<Sci_Position> maxText;
+	// Range of styles read with StyleAt
+	std::optional<Sci_Position> minStyle;
+	std::optional<Sci_Position> maxStyle;
+	size_t charRangeFills = 0;
+	size_t bytesFilled = 0;
+	size_t styleReads = 0;
+	size_t styleReadsBefore = 0;
+	size_t lineStateReads = 0;
+	size_t lineStateReadsBefore = 0;
+	size_t levelReads = 0;
+	size_t calls = 0;	// All IDocument calls
+
+	void Start(Sci_Position startPos_, Sci_Position lengthDoc, Sci_Position startLine_) noexcept;
+	// How far before startPos text or styles were read
+	Sci_Position TextBehind() const noexcept;
+	Sci_Position StyleBehind() const noexcept;
+	// How far after the end of the range text was read
+	Sci_Position TextAhead() const noexcept;
+};
+
+// Forwards each call to another document after recording the access in an AccessRecord.
+// Text read through a lexer's buffer is recorded at the position the lexer needed, not the
+// whole range filled.
+class InstrumentedDocument : public Lexilla::IDocumentFills {
+	Scintilla::IDocument *pdoc;
+	mutable AccessRecord record;
+	mutable bool filling = false;
+	void ReadText(Sci_Position start, Sci_Position length) const noexcept;
+public:
+	explicit InstrumentedDocument(Scintilla::IDocument *pdoc_) noexcept;
+	// Deleted so InstrumentedDocument objects can not be copied.
+	InstrumentedDocument(const InstrumentedDocument&) = delete;
+	InstrumentedDocument(InstrumentedDocument&&) = delete;
+	InstrumentedDocument &operator=(const InstrumentedDocument&) = delete;
+	InstrumentedDocument &operator=(InstrumentedDocument&&) = delete;
+	virtual ~InstrumentedDocument() = default;
+
+	// Start recording a Lex or Fold call over [startPos, startPos+lengthDoc)
+	void Start(Sci_Position startPos, Sci_Position lengthDoc);
+	const AccessRecord &Record() const noexcept;
+
+	int SCI_METHOD Version() const override;
+	void SCI_METHOD SetErrorStatus(int status) override;
+	Sci_Position SCI_METHOD Length() const override;
+	void SCI_METHOD GetCharRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const override;
+	char SCI_METHOD StyleAt(Sci_Position position) const override;
+	Sci_Position SCI_METHOD LineFromPosition(Sci_Position position) const override;
+	Sci_Position SCI_METHOD LineStart(Sci_Position line) const override;
+	int SCI_METHOD GetLevel(Sci_Position line) const override;
+	int SCI_METHOD SetLevel(Sci_Position line, int level) override;
+	int SCI_METHOD GetLineState(Sci_Position line) const override;
+	int SCI_METHOD SetLineState(Sci_Position line, int state) override;
+	void SCI_METHOD StartStyling(Sci_Position position) override;
+	bool SCI_METHOD SetStyleFor(Sci_Position length, char style) override;
+	bool SCI_METHOD SetStyles(Sci_Position length, const char *styles) override;
+	void SCI_METHOD DecorationSetCurrentIndicator(int indicator) override;
+	void SCI_METHOD DecorationFillRange(Sci_Position position, int value, Sci_Position fillLength) override;
+	void SCI_METHOD ChangeLexerState(Sci_Position start, Sci_Position end) override;
+	int SCI_METHOD CodePage() const override;
+	bool SCI_METHOD IsDBCSLeadByte(char ch) const override;
+	const char *SCI_METHOD BufferPointer() override;
+	int SCI_METHOD GetLineIndentation(Sci_Position line) override;
+	Sci_Position SCI_METHOD LineEnd(Sci_Position line) const override;
+	Sci_Position SCI_METHOD GetRelativePosition(Sci_Position positionStart, Sci_Position characterOffset) const override;
+	int SCI_METHOD GetCharacterAndWidth(Sci_Position position, Sci_Position *pWidth) const override;
+
+	void SCI_METHOD Filling(Sci_Position position) override;
+};
+
+#endif
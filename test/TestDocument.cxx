@@ -16,6 +16,10 @@
 
 #include "ILexer.h"
 
+#include "LexillaExtensions.h"
+
+#include "DocumentCharacters.h"
+
 #include "TestDocument.h"
 
 namespace {
@@ -109,11 +113,8 @@ std::u32string UTF32FromUTF8(std::string_view svu8) {
 	return ret;
 }
 
-void TestDocument::Set(std::string_view sv) {
-	text = sv;
-	textStyles.resize(text.size() + 1);
+void TestDocument::SetLineStarts() {
 	lineStarts.clear();
-	endStyled = 0;
 	lineStarts.push_back(0);
 	for (size_t pos = 0; pos < text.length(); pos++) {
 		if (text.at(pos) == '\n') {
@@ -127,6 +128,35 @@ void TestDocument::Set(std::string_view sv) {
 	lineLevels.resize(lineStarts.size(), 0x400);
 }
 
+void TestDocument::Set(std::string_view sv) {
+	text = sv;
+	textStyles.resize(text.size() + 1);
+	endStyled = 0;
+	SetLineStarts();
+}
+
+void TestDocument::InsertText(Sci_Position position, std::string_view sv) {
+	const Sci_Position line = LineFromPosition(position);
+	const Sci_Position linesInserted = std::count(sv.begin(), sv.end(), '\n');
+	text.insert(position, sv);
+	textStyles.insert(position, sv.length(), '\0');
+	// New lines start with the state and level of the line they were split from
+	lineStates.insert(lineStates.begin() + line + 1, linesInserted, lineStates.at(line));
+	lineLevels.insert(lineLevels.begin() + line + 1, linesInserted, lineLevels.at(line));
+	SetLineStarts();
+}
+
+void TestDocument::DeleteRange(Sci_Position position, Sci_Position length) {
+	const Sci_Position line = LineFromPosition(position);
+	const Sci_Position linesRemoved = std::count(text.begin() + position, text.begin() + position + length, '\n');
+	text.erase(position, length);
+	textStyles.erase(position, length);
+	lineStates.erase(lineStates.begin() + line + 1, lineStates.begin() + line + 1 + linesRemoved);
+	lineLevels.erase(lineLevels.begin() + line + 1, lineLevels.begin() + line + 1 + linesRemoved);
+	endStyled = std::min(endStyled, Length());
+	SetLineStarts();
+}
+
 #if defined(_MSC_VER)
 // IDocument interface does not specify noexcept so best to not add it to implementation
 #pragma warning(disable: 26440)
@@ -136,7 +166,18 @@ Sci_Position TestDocument::MaxLine() const noexcept {
 	return lineStarts.size() - 1;
 }
 
+void TestDocument::SetStyleRange(bool styleRange_) noexcept {
+	styleRange = styleRange_;
+}
+
+void TestDocument::SetCodePage(int codePage_) noexcept {
+	codePage = codePage_;
+}
+
 int SCI_METHOD TestDocument::Version() const {
+	if (styleRange) {
+		return Scintilla::dvRelease4 | Lexilla::dvStyleRange;
+	}
 	return Scintilla::dvRelease4;
 }
 
@@ -229,13 +270,11 @@ void SCI_METHOD TestDocument::ChangeLexerState(Sci_Position, Sci_Position) {
 }
 
 int SCI_METHOD TestDocument::CodePage() const {
-	// Always UTF-8 for now
-	return 65001;
+	return codePage;
 }
 
-bool SCI_METHOD TestDocument::IsDBCSLeadByte(char) const {
-	// Always UTF-8 for now
-	return false;
+bool SCI_METHOD TestDocument::IsDBCSLeadByte(char ch) const {
+	return Lexilla::IsDBCSLeadByteInCodePage(codePage, ch);
 }
 
 const char *SCI_METHOD TestDocument::BufferPointer() {
@@ -263,6 +302,9 @@ Sci_Position SCI_METHOD TestDocument::LineEnd(Sci_Position line) const {
 }
 
 Sci_Position SCI_METHOD TestDocument::GetRelativePosition(Sci_Position positionStart, Sci_Position characterOffset) const {
+	if (Lexilla::IsDBCSCodePage(codePage)) {
+		return Lexilla::RelativePosition(this, positionStart, characterOffset);
+	}
 	Sci_Position pos = positionStart;
 	if (characterOffset < 0) {
 		while (characterOffset < 0) {
@@ -312,6 +354,21 @@ int SCI_METHOD TestDocument::GetCharacterAndWidth(Sci_Position position, Sci_Pos
 		}
 		return leadByte;
 	}
+	if (Lexilla::IsDBCSCodePage(codePage)) {
+		Sci_Position width = 1;
+		int character = leadByte;
+		if (Lexilla::IsDBCSLeadByteInCodePage(codePage, leadByte) && (position + 1 < Length())) {
+			const unsigned char trailByte = text.at(position + 1);
+			if (Lexilla::IsDBCSTrailByteInCodePage(codePage, trailByte)) {
+				character = (leadByte << 8) | trailByte;
+				width = 2;
+			}
+		}
+		if (pWidth) {
+			*pWidth = width;
+		}
+		return character;
+	}
 	const int widthCharBytes = UTF8BytesOfLead[leadByte];
 	unsigned char charBytes[] = { leadByte,0,0,0 };
 	for (int b = 1; b < widthCharBytes; b++) {
@@ -323,3 +380,7 @@ int SCI_METHOD TestDocument::GetCharacterAndWidth(Sci_Position position, Sci_Pos
 	}
 	return UnicodeFromUTF8(charBytes);
 }
+
+void SCI_METHOD TestDocument::GetStyleRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const {
+	textStyles.copy(buffer, lengthRetrieve, position);
+}
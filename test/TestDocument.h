@@ -10,15 +10,22 @@
 
 std::u32string UTF32FromUTF8(std::string_view svu8);
 
-class TestDocument : public Scintilla::IDocument {
+class TestDocument : public Lexilla::IDocumentStyles {
 	std::string text;
 	std::string textStyles;
 	std::vector<Sci_Position> lineStarts;
 	std::vector<int> lineStates;
 	std::vector<int> lineLevels;
 	Sci_Position endStyled=0;
+	bool styleRange=false;
+	int codePage=65001;
+	void SetLineStarts();
 public:
 	void Set(std::string_view sv);
+	// Modify text as an editor would with the styles, line states, and fold levels
+	// of following text moving along with it.
+	void InsertText(Sci_Position position, std::string_view sv);
+	void DeleteRange(Sci_Position position, Sci_Position length);
 	TestDocument() = default;
 	// Deleted so TestDocument objects can not be copied.
 	TestDocument(const TestDocument&) = delete;
@@ -28,6 +35,10 @@ public:
 	virtual ~TestDocument() = default;
 
 	Sci_Position MaxLine() const noexcept;
+	// Whether to offer GetStyleRange to lexers through the version.
+	void SetStyleRange(bool styleRange_) noexcept;
+	// UTF-8 unless set to a DBCS code page such as 932.
+	void SetCodePage(int codePage_) noexcept;
 
 	int SCI_METHOD Version() const override;
 	void SCI_METHOD SetErrorStatus(int status) override;
@@ -53,6 +64,8 @@ public:
 	Sci_Position SCI_METHOD LineEnd(Sci_Position line) const override;
 	Sci_Position SCI_METHOD GetRelativePosition(Sci_Position positionStart, Sci_Position characterOffset) const override;
 	int SCI_METHOD GetCharacterAndWidth(Sci_Position position, Sci_Position *pWidth) const override;
+	// IDocumentStyles method
+	void SCI_METHOD GetStyleRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const override;
 };
 
 #endif
@@ -14,8 +14,11 @@
 #include <vector>
 #include <map>
 #include <optional>
+#include <memory>
 #include <algorithm>
 #include <iterator>
+#include <chrono>
+#include <cmath>
 
 #include <ios>
 #include <iostream>
@@ -24,15 +27,55 @@
 #include <iomanip>
 #include <filesystem>
 
+#if defined(__linux__)
+#include <unistd.h>
+#include <malloc.h>
+#endif
+
 #include "ILexer.h"
 
 #include "Lexilla.h"
+#include "LexillaExtensions.h"
 #include "LexillaAccess.h"
 
+#include "GapBuffer.h"
+#include "EditableDocument.h"
+
 #include "TestDocument.h"
+#include "InstrumentedDocument.h"
+#include "AllocationCounter.h"
 
 namespace {
 
+// Options set from the command line
+struct RunOptions {
+	// Instead of checking results, record how each lexer reads the document and print a report
+	bool profileAccess = false;
+	// Instead of checking results, replay keystrokes and measure bytes lexed with and without convergence
+	bool replayEdits = false;
+	// Instead of checking results, time Fold with and without the LexAccessor style window
+	bool timeFolds = false;
+	// Instead of checking results, check that lexing and folding cost grows linearly with size
+	bool scaling = false;
+	// Instead of running examples, measure the time and memory used to create many lexers
+	bool creation = false;
+	// Instead of checking results, count heap allocations made by Lex and Fold
+	bool allocations = false;
+	// Instead of checking results, report memory retained by lexers after lexing large documents
+	bool memory = false;
+	// Instead of checking results, compare the library's reference and optimised paths
+	bool shadow = false;
+	// Instead of checking results, time editing and lexing TestDocument and EditableDocument
+	bool document = false;
+	// Instead of checking results, time lexing repetitive documents with and without the line style cache
+	bool lineCache = false;
+	// After checking results, write the trace events of a library built with TRACE=1
+	bool trace = false;
+	// Instead of checking results, measure lexing and folding throughput for each language
+	bool throughput = false;
+};
+RunOptions runOptions;
+
 constexpr char MakeLowerCase(char c) noexcept {
 	if (c >= 'A' && c <= 'Z') {
 		return c - 'A' + 'a';
@@ -586,6 +629,11 @@ int UnixToWindows(std::string &s) {
 
 const std::string BOM = "\xEF\xBB\xBF";
 
+// Examples are UTF-8 unless code.page is set as in SciTE, which allows testing DBCS code pages like 932.
+int CodePageOf(const PropertyMap &propertyMap) {
+	return propertyMap.GetPropertyValue("code.page").value_or(65001);
+}
+
 void StyleLineByLine(TestDocument &doc, Scintilla::ILexer5 *plex) {
 	assert(plex);
 	Scintilla::IDocument *pdoc = &doc;
@@ -602,7 +650,7 @@ void StyleLineByLine(TestDocument &doc, Scintilla::ILexer5 *plex) {
 	}
 }
 
-bool TestCRLF(std::filesystem::path path, const std::string s, Scintilla::ILexer5 *plex, bool disablePerLineTests) {
+bool TestCRLF(std::filesystem::path path, const std::string s, Scintilla::ILexer5 *plex, int codePage, bool disablePerLineTests) {
 	assert(plex);
 	bool success = true;
 	// Convert all line ends to \r\n to check if styles change between \r and \n which makes
@@ -613,6 +661,7 @@ bool TestCRLF(std::filesystem::path path, const std::string s, Scintilla::ILexer
 	std::string textUnix = text;
 	UnixToWindows(text);
 	TestDocument doc;
+	doc.SetCodePage(codePage);
 	doc.Set(text);
 	Scintilla::IDocument *pdoc = &doc;
 	assert(pdoc);
@@ -641,6 +690,7 @@ bool TestCRLF(std::filesystem::path path, const std::string s, Scintilla::ILexer
 	// Lex and fold with \n line ends then check result is same
 
 	TestDocument docUnix;
+	docUnix.SetCodePage(codePage);
 	docUnix.Set(textUnix);
 	Scintilla::IDocument *pdocUnix = &docUnix;
 	assert(pdocUnix);
@@ -832,6 +882,88 @@ bool SetProperties(Scintilla::ILexer5 *plex, const std::string &language, const
 }
 
 
+// Lexers that can fold while lexing must produce the same styles and folds as separate Lex and Fold
+bool TestFoldDuringLex(const std::filesystem::path &path, const std::string &text, const std::string &language,
+	const PropertyMap &propertyMap, const std::string &styledText, const std::string &foldedText, bool disablePerLineTests) {
+	Scintilla::ILexer5 *plex = Lexilla::MakeLexer(language);
+	int foldDuringLex = 1;
+	if (!plex->PrivateCall(Lexilla::privateCallFoldDuringLex, &foldDuringLex)) {
+		plex->Release();
+		return true;
+	}
+	if (!SetProperties(plex, language, propertyMap, path)) {
+		plex->Release();
+		return false;
+	}
+
+	const int codePage = CodePageOf(propertyMap);
+	bool success = true;
+	TestDocument doc;
+	doc.SetCodePage(codePage);
+	doc.Set(text);
+	plex->Lex(0, doc.Length(), 0, &doc);
+	plex->Fold(0, doc.Length(), 0, &doc);
+	const auto [styledTextNew, foldedTextNew] = MarkedAndFoldedDocument(&doc);
+	success = success && CheckSame(styledText, styledTextNew, "fold during lex styles", suffixStyled, path);
+	success = success && CheckSame(foldedText, foldedTextNew, "fold during lex folds", suffixFolded, path);
+
+	if (success && !disablePerLineTests) {
+		TestDocument docPerLine;
+		docPerLine.SetCodePage(codePage);
+		docPerLine.Set(text);
+		StyleLineByLine(docPerLine, plex);
+		const auto [styledTextNewPerLine, foldedTextNewPerLine] = MarkedAndFoldedDocument(&docPerLine);
+		success = success && CheckSame(styledText, styledTextNewPerLine, "per-line fold during lex styles", suffixStyled, path);
+		success = success && CheckSame(foldedText, foldedTextNewPerLine, "per-line fold during lex folds", suffixFolded, path);
+	}
+
+	plex->Release();
+	return success;
+}
+
+// Lexers that can lex within a budget must produce the same styles when each call continues
+// from where the previous one stopped
+bool TestLexBudgeted(const std::filesystem::path &path, const std::string &text, const std::string &language,
+	const PropertyMap &propertyMap, const std::string &styledText, const std::string &foldedText) {
+	// Small enough to stop at most line ends
+	constexpr Sci_Position budgetBytes = 100;
+	Scintilla::ILexer5 *plex = Lexilla::MakeLexer(language);
+	if (!SetProperties(plex, language, propertyMap, path)) {
+		plex->Release();
+		return false;
+	}
+
+	TestDocument doc;
+	doc.SetCodePage(CodePageOf(propertyMap));
+	doc.Set(text);
+	Lexilla::LexBudgetArguments args;
+	args.lengthDoc = doc.Length();
+	args.pAccess = &doc;
+	args.maxBytes = budgetBytes;
+	if (!plex->PrivateCall(Lexilla::privateCallLexBudgeted, &args)) {
+		plex->Release();
+		return true;
+	}
+	while (args.endLexed < doc.Length()) {
+		if (args.endLexed <= static_cast<Sci_Position>(args.startPos)) {
+			std::cout << path.string() << ":1: budgeted lexing stopped at " << args.endLexed << "\n";
+			plex->Release();
+			return false;
+		}
+		args.startPos = args.endLexed;
+		args.lengthDoc = doc.Length() - args.endLexed;
+		args.initStyle = static_cast<unsigned char>(doc.StyleAt(args.endLexed - 1));
+		plex->PrivateCall(Lexilla::privateCallLexBudgeted, &args);
+	}
+	plex->Fold(0, doc.Length(), 0, &doc);
+
+	const auto [styledTextNew, foldedTextNew] = MarkedAndFoldedDocument(&doc);
+	bool success = CheckSame(styledText, styledTextNew, "budgeted lex styles", suffixStyled, path);
+	success = success && CheckSame(foldedText, foldedTextNew, "budgeted lex folds", suffixFolded, path);
+	plex->Release();
+	return success;
+}
+
 bool TestFile(const std::filesystem::path &path, const PropertyMap &propertyMap) {
 	// Find and create correct lexer
 	std::optional<std::string> language = propertyMap.GetPropertyForFile(lexerPrefix, path.filename().string());
@@ -867,7 +999,10 @@ bool TestFile(const std::filesystem::path &path, const PropertyMap &propertyMap)
 	const int repeatLex = propertyMap.GetPropertyValue("testlexers.repeat.lex").value_or(1);
 	const int repeatFold = propertyMap.GetPropertyValue("testlexers.repeat.fold").value_or(1);
 
+	const int codePage = CodePageOf(propertyMap);
+
 	TestDocument doc;
+	doc.SetCodePage(codePage);
 	doc.Set(text);
 	Scintilla::IDocument *pdoc = &doc;
 	assert(pdoc);
@@ -906,6 +1041,7 @@ bool TestFile(const std::filesystem::path &path, const PropertyMap &propertyMap)
 	// Test line by line lexing/folding
 	if (success && !disablePerLineTests) {
 		TestDocument docPerLine;
+		docPerLine.SetCodePage(codePage);
 		docPerLine.Set(text);
 		Scintilla::ILexer5 *plexPerLine = Lexilla::MakeLexer(*language);
 		if (!SetProperties(plexPerLine, *language, propertyMap, path)) {
@@ -917,16 +1053,1446 @@ bool TestFile(const std::filesystem::path &path, const PropertyMap &propertyMap)
 		success = success && CheckSame(foldedText, foldedTextNewPerLine, "per-line folds", suffixFolded, path);
 	}
 
+	if (success) {
+		success = TestFoldDuringLex(path, text, *language, propertyMap, styledText, foldedText, disablePerLineTests);
+	}
+
+	if (success && !disablePerLineTests) {
+		success = TestLexBudgeted(path, text, *language, propertyMap, styledText, foldedText);
+	}
+
 	if (success) {
 		Scintilla::ILexer5 *plexCRLF = Lexilla::MakeLexer(*language);
 		SetProperties(plexCRLF, *language, propertyMap, path.filename().string());
-		success = TestCRLF(path, text, plexCRLF, disablePerLineTests);
+		success = TestCRLF(path, text, plexCRLF, codePage, disablePerLineTests);
+	}
+
+	return success;
+}
+
+// Releases a lexer when it goes out of scope.
+struct LexerReleaser {
+	void operator()(Scintilla::ILexer5 *plex) const noexcept {
+		plex->Release();
+	}
+};
+using LexerPointer = std::unique_ptr<Scintilla::ILexer5, LexerReleaser>;
+
+// The setup shared by the modes that measure instead of checking results: the example's language,
+// its text without any BOM, a lexer with the example's properties set, and a document of the text.
+struct Example {
+	const std::filesystem::path &path;
+	const PropertyMap &propertyMap;
+	std::string language;
+	std::string text;
+	LexerPointer plex;
+	TestDocument doc;
+
+	Example(const std::filesystem::path &path_, const PropertyMap &propertyMap_) noexcept :
+		path(path_), propertyMap(propertyMap_) {
+	}
+	// Reports and returns false when the example has no language or lexer or its properties are bad.
+	bool Open() {
+		const std::optional<std::string> languageFound = propertyMap.GetPropertyForFile(lexerPrefix, path.filename().string());
+		if (!languageFound) {
+			std::cout << "\n" << path.string() << ":1: has no language\n\n";
+			return false;
+		}
+		language = *languageFound;
+		plex = MakeLexer();
+		if (!plex) {
+			return false;
+		}
+		text = ReadFile(path);
+		if (text.starts_with(BOM)) {
+			text.erase(0, BOM.length());
+		}
+		SetDocument(doc, text);
+		return true;
+	}
+	// Another lexer for the example with its properties set or null after reporting why not.
+	LexerPointer MakeLexer() const {
+		LexerPointer plexNew(Lexilla::MakeLexer(language));
+		if (!plexNew) {
+			std::cout << "\n" << path.string() << ":1: has no lexer for " << language << "\n\n";
+			return {};
+		}
+		if (!SetProperties(plexNew.get(), language, propertyMap, path)) {
+			return {};
+		}
+		return plexNew;
+	}
+	// Set a document to text in the example's code page.
+	void SetDocument(TestDocument &docSet, std::string_view textSet) const {
+		docSet.SetCodePage(CodePageOf(propertyMap));
+		docSet.Set(textSet);
+	}
+	// The text, ending with a line end, repeated until it has at least linesWanted lines.
+	[[nodiscard]] std::string ReplicatedLines(Sci_Position linesWanted) const {
+		std::string piece = text;
+		if (!piece.ends_with('\n') && !piece.ends_with('\r')) {
+			piece += "\n";
+		}
+		TestDocument docPiece;
+		docPiece.Set(piece);
+		const Sci_Position linesPiece = std::max<Sci_Position>(docPiece.LineFromPosition(docPiece.Length()), 1);
+		const Sci_Position repetitions = (linesWanted + linesPiece - 1) / linesPiece;
+		std::string large;
+		large.reserve(piece.length() * repetitions);
+		for (Sci_Position repetition = 0; repetition < repetitions; repetition++) {
+			large += piece;
+		}
+		return large;
+	}
+};
+
+// Summarise the AccessRecords of many Lex or Fold calls
+struct AccessSummary {
+	size_t calls = 0;
+	size_t fills = 0;
+	size_t maxFills = 0;
+	size_t styleReadsBefore = 0;
+	size_t lineStateReadsBefore = 0;
+	Sci_Position maxTextBehind = 0;
+	Sci_Position maxStyleBehind = 0;
+	Sci_Position maxTextAhead = 0;
+	std::string worstFile;	// File with furthest look-behind
+
+	void Add(const AccessRecord &record, const std::filesystem::path &path) {
+		calls++;
+		fills += record.charRangeFills;
+		maxFills = std::max(maxFills, record.charRangeFills);
+		styleReadsBefore += record.styleReadsBefore;
+		lineStateReadsBefore += record.lineStateReadsBefore;
+		const Sci_Position behind = std::max(record.TextBehind(), record.StyleBehind());
+		if (worstFile.empty() || behind > std::max(maxTextBehind, maxStyleBehind)) {
+			worstFile = path.filename().string();
+		}
+		maxTextBehind = std::max(maxTextBehind, record.TextBehind());
+		maxStyleBehind = std::max(maxStyleBehind, record.StyleBehind());
+		maxTextAhead = std::max(maxTextAhead, record.TextAhead());
+	}
+};
+
+struct LanguageProfile {
+	size_t files = 0;
+	AccessSummary lex;
+	AccessSummary fold;
+};
+
+std::map<std::string, LanguageProfile> languageProfiles;
+
+void ProfileRange(InstrumentedDocument &idoc, Scintilla::ILexer5 *plex, Sci_Position start, Sci_Position length,
+	int initStyle, LanguageProfile &profile, const std::filesystem::path &path) {
+	idoc.Start(start, length);
+	plex->Lex(start, length, initStyle, &idoc);
+	profile.lex.Add(idoc.Record(), path);
+	idoc.Start(start, length);
+	plex->Fold(start, length, initStyle, &idoc);
+	profile.fold.Add(idoc.Record(), path);
+}
+
+bool ProfileFile(const std::filesystem::path &path, const PropertyMap &propertyMap) {
+	Example example(path, propertyMap);
+	if (!example.Open()) {
+		return false;
+	}
+	Scintilla::ILexer5 *plex = example.plex.get();
+	TestDocument &doc = example.doc;
+	InstrumentedDocument idoc(&doc);
+
+	LanguageProfile &profile = languageProfiles[example.language];
+	profile.files++;
+
+	// Whole document then each line as is common when typing.
+	ProfileRange(idoc, plex, 0, doc.Length(), 0, profile, path);
+	const Sci_Position lines = doc.LineFromPosition(doc.Length());
+	for (Sci_Position line = 0; line <= lines; line++) {
+		const Sci_Position startLine = doc.LineStart(line);
+		const Sci_Position endLine = doc.LineStart(line + 1);
+		const int styleStart = (startLine > 0) ? doc.StyleAt(startLine - 1) : 0;
+		ProfileRange(idoc, plex, startLine, endLine - startLine, styleStart, profile, path);
+	}
+	return true;
+}
+
+void PrintAccessSummary(const AccessSummary &summary) {
+	const double fillsPerCall = summary.calls ? static_cast<double>(summary.fills) / summary.calls : 0.0;
+	std::cout << std::setw(8) << summary.maxTextBehind
+		<< std::setw(8) << summary.maxStyleBehind
+		<< std::setw(8) << summary.maxTextAhead
+		<< std::setw(8) << std::fixed << std::setprecision(1) << fillsPerCall
+		<< std::setw(7) << summary.maxFills
+		<< std::setw(9) << summary.styleReadsBefore
+		<< std::setw(9) << summary.lineStateReadsBefore;
+}
+
+void PrintAccessReport() {
+	// Most look-behind first so pathological backtracking lexers stand out
+	std::vector<std::pair<std::string, LanguageProfile>> profiles(languageProfiles.begin(), languageProfiles.end());
+	std::stable_sort(profiles.begin(), profiles.end(), [](const auto &a, const auto &b) {
+		return std::max(a.second.lex.maxTextBehind, a.second.lex.maxStyleBehind) >
+			std::max(b.second.lex.maxTextBehind, b.second.lex.maxStyleBehind);
+	});
+	std::cout << "\nDocument access by lexer for whole document and then each line.\n"
+		"Text: furthest bytes read before range. Only counts buffer fills not moved by document bounds.\n"
+		"Style: furthest style read before range. Ahead: furthest text read after range.\n"
+		"Fills: GetCharRange calls per call and maximum.\n"
+		"Styles/States: StyleAt and GetLineState reads before the range summed over calls.\n\n";
+	std::cout << std::left << std::setw(16) << "language" << std::right << std::setw(6) << "files"
+		<< "  Lex: Text   Style   Ahead   Fills    Max   Styles   States"
+		<< " | Fold: Text  Style   Ahead   Fills    Max   Styles   States  worst\n";
+	for (const auto &[language, profile] : profiles) {
+		std::cout << std::left << std::setw(16) << language << std::right << std::setw(6) << profile.files << "  ";
+		PrintAccessSummary(profile.lex);
+		std::cout << " | ";
+		PrintAccessSummary(profile.fold);
+		std::cout << "  " << profile.lex.worstFile << "\n";
+	}
+}
+
+// Bytes lexed after simulated keystrokes for one language
+struct ReplaySummary {
+	size_t files = 0;
+	size_t keystrokes = 0;
+	size_t bytesFull = 0;	// Lexing from the changed line to the end of the document
+	size_t bytesConverging = 0;	// Stopping once the lexer's state converges
+	size_t converged = 0;	// Keystrokes where lexing stopped early
+};
+
+std::map<std::string, ReplaySummary> replaySummaries;
+
+struct Keystroke {
+	Sci_Position position;
+	std::string_view inserted;
+	Sci_Position deleted;
+};
+
+template <typename Document>
+void ApplyKeystroke(Document &doc, const Keystroke &keystroke) {
+	if (keystroke.deleted) {
+		doc.DeleteRange(keystroke.position, keystroke.deleted);
+	} else {
+		doc.InsertText(keystroke.position, keystroke.inserted);
+	}
+}
+
+// Typing and then removing a character, a line end, and a quote at a few lines of the file.
+std::vector<Keystroke> KeystrokesForFile(TestDocument &doc) {
+	constexpr Sci_Position linesEdited = 10;
+	std::vector<Keystroke> keystrokes;
+	const Sci_Position lines = doc.LineFromPosition(doc.Length());
+	const Sci_Position step = std::max<Sci_Position>(lines / linesEdited, 1);
+	for (Sci_Position line = 0; line < lines; line += step) {
+		const Sci_Position lineStart = doc.LineStart(line);
+		const Sci_Position lineEnd = doc.LineEnd(line);
+		keystrokes.push_back({ lineEnd, "x", 0 });
+		keystrokes.push_back({ lineEnd, "", 1 });
+		keystrokes.push_back({ lineEnd, "\n", 0 });
+		keystrokes.push_back({ lineEnd, "", 1 });
+		keystrokes.push_back({ lineStart, "\"", 0 });
+		keystrokes.push_back({ lineStart, "", 1 });
+	}
+	return keystrokes;
+}
+
+// Describe the first position or line where the two documents differ or return an empty string.
+std::string FirstDifference(const Scintilla::IDocument &reference, const Scintilla::IDocument &optimised) {
+	std::ostringstream os;
+	const Sci_Position length = reference.Length();
+	for (Sci_Position position = 0; position < length; position++) {
+		const int styleReference = static_cast<unsigned char>(reference.StyleAt(position));
+		const int styleOptimised = static_cast<unsigned char>(optimised.StyleAt(position));
+		if (styleReference != styleOptimised) {
+			os << reference.LineFromPosition(position) + 1 << ": style at position " << position
+				<< " reference " << styleReference << " optimised " << styleOptimised;
+			return os.str();
+		}
+	}
+	const Sci_Position lines = reference.LineFromPosition(length) + 1;
+	for (Sci_Position line = 0; line < lines; line++) {
+		// Lexers never reach an empty last line so its state is whatever editing left there
+		const bool lexed = reference.LineStart(line) < length;
+		if (lexed && (reference.GetLineState(line) != optimised.GetLineState(line))) {
+			os << line + 1 << ": line state reference " << reference.GetLineState(line)
+				<< " optimised " << optimised.GetLineState(line);
+			return os.str();
+		}
+		if (reference.GetLevel(line) != optimised.GetLevel(line)) {
+			os << line + 1 << ": fold level reference " << std::hex << reference.GetLevel(line)
+				<< " optimised " << optimised.GetLevel(line) << std::dec;
+			return os.str();
+		}
+	}
+	return {};
+}
+
+bool ReplayFile(const std::filesystem::path &path, const PropertyMap &propertyMap) {
+	Example example(path, propertyMap);
+	if (!example.Open()) {
+		return false;
+	}
+	const LexerPointer plexConverging = example.MakeLexer();
+	if (!plexConverging) {
+		return false;
+	}
+	Scintilla::ILexer5 *plexFull = example.plex.get();
+	TestDocument &docFull = example.doc;
+	TestDocument docConverging;
+	example.SetDocument(docConverging, example.text);
+	plexFull->Lex(0, docFull.Length(), 0, &docFull);
+	plexFull->Fold(0, docFull.Length(), 0, &docFull);
+	plexConverging->Lex(0, docConverging.Length(), 0, &docConverging);
+	plexConverging->Fold(0, docConverging.Length(), 0, &docConverging);
+
+	// Lexers that can fold during lex are also replayed with that on and without args.fold, folding the
+	// range lexed afterwards as an application that only folds what was lexed would.
+	LexerPointer plexFused = example.MakeLexer();
+	int foldDuringLex = 1;
+	if (plexFused && !plexFused->PrivateCall(Lexilla::privateCallFoldDuringLex, &foldDuringLex)) {
+		plexFused.reset();
+	}
+	TestDocument docFused;
+	example.SetDocument(docFused, example.text);
+	if (plexFused) {
+		plexFused->Lex(0, docFused.Length(), 0, &docFused);
+		plexFused->Fold(0, docFused.Length(), 0, &docFused);
+	}
+
+	bool success = true;
+	ReplaySummary summary;
+	summary.files = 1;
+	const std::vector<Keystroke> keystrokes = KeystrokesForFile(docFull);
+	for (const Keystroke &keystroke : keystrokes) {
+		Sci_Position linesInserted = std::count(keystroke.inserted.begin(), keystroke.inserted.end(), '\n');
+		if (keystroke.deleted) {
+			std::string deleted(keystroke.deleted, '\0');
+			docFull.GetCharRange(deleted.data(), keystroke.position, keystroke.deleted);
+			linesInserted = -std::count(deleted.begin(), deleted.end(), '\n');
+		}
+		ApplyKeystroke(docFull, keystroke);
+		ApplyKeystroke(docConverging, keystroke);
+		ApplyKeystroke(docFused, keystroke);
+
+		const Sci_Position lineStart = docFull.LineStart(docFull.LineFromPosition(keystroke.position));
+		const int initStyle = (lineStart > 0) ? static_cast<unsigned char>(docFull.StyleAt(lineStart - 1)) : 0;
+		const Sci_Position length = docFull.Length() - lineStart;
+		plexFull->Lex(lineStart, length, initStyle, &docFull);
+		plexFull->Fold(lineStart, length, initStyle, &docFull);
+
+		Lexilla::LexConvergingArguments args;
+		args.startPos = lineStart;
+		args.lengthDoc = length;
+		args.initStyle = initStyle;
+		args.pAccess = &docConverging;
+		args.changedEnd = keystroke.position + keystroke.inserted.length();
+		args.linesInserted = linesInserted;
+		args.fold = true;
+		if (!plexConverging->PrivateCall(Lexilla::privateCallLexConverging, &args)) {
+			// Lexer does not support convergence so nothing to report
+			summary.files = 0;
+			break;
+		}
+		summary.keystrokes++;
+		summary.bytesFull += length;
+		summary.bytesConverging += args.endLexed - lineStart;
+		if (args.lineConverged >= 0) {
+			summary.converged++;
+		}
+
+		// Styles, line states, and fold levels must all match
+		const std::string difference = FirstDifference(docFull, docConverging);
+		if (!difference.empty()) {
+			if (args.lineConverged >= 0) {
+				std::cout << path.string() << ":" << difference << " converged after keystroke at "
+					<< keystroke.position << "\n";
+				success = false;
+			} else {
+				// Not caused by convergence: the lexer does not produce the same results when
+				// started at a line inside a range it has just lexed
+				std::cout << path.string() << ":" << difference << " lexing in chunks after keystroke at "
+					<< keystroke.position << "\n";
+				success = false;
+			}
+			break;
+		}
+
+		if (plexFused) {
+			Lexilla::LexConvergingArguments argsFused = args;
+			argsFused.pAccess = &docFused;
+			argsFused.fold = false;
+			argsFused.lineConverged = -1;
+			plexFused->PrivateCall(Lexilla::privateCallLexConverging, &argsFused);
+			plexFused->Fold(lineStart, argsFused.endLexed - lineStart, initStyle, &docFused);
+			const std::string differenceFused = FirstDifference(docFull, docFused);
+			if (!differenceFused.empty()) {
+				std::cout << path.string() << ":" << differenceFused << " folding during lex after keystroke at "
+					<< keystroke.position << "\n";
+				success = false;
+				break;
+			}
+		}
+	}
+
+	ReplaySummary &total = replaySummaries[example.language];
+	total.files += summary.files;
+	total.keystrokes += summary.keystrokes;
+	total.bytesFull += summary.bytesFull;
+	total.bytesConverging += summary.bytesConverging;
+	total.converged += summary.converged;
+	return success;
+}
+
+void PrintReplayReport() {
+	std::cout << "\nBytes lexed per keystroke from the changed line to the end of the document (full)\n"
+		"and when stopping once the lexer's state converges with the previous lex.\n\n";
+	std::cout << std::left << std::setw(16) << "language" << std::right << std::setw(6) << "files"
+		<< std::setw(11) << "keystrokes" << std::setw(10) << "full" << std::setw(12) << "converging"
+		<< std::setw(11) << "converged\n";
+	for (const auto &[language, summary] : replaySummaries) {
+		if (summary.keystrokes == 0) {
+			continue;
+		}
+		const double keystrokes = static_cast<double>(summary.keystrokes);
+		std::cout << std::left << std::setw(16) << language << std::right << std::setw(6) << summary.files
+			<< std::setw(11) << summary.keystrokes
+			<< std::setw(10) << std::fixed << std::setprecision(0) << summary.bytesFull / keystrokes
+			<< std::setw(12) << summary.bytesConverging / keystrokes
+			<< std::setw(9) << std::setprecision(0) << 100.0 * summary.converged / keystrokes << "%\n";
+	}
+}
+
+// Time spent folding whole documents for one language
+struct FoldTiming {
+	size_t files = 0;
+	size_t bytes = 0;
+	double secondsPerByte = 0.0;	// Reading each style from the document with StyleAt
+	double secondsWindow = 0.0;	// Reading styles through the LexAccessor style window
+};
+
+std::map<std::string, FoldTiming> foldTimings;
+
+double TimeFold(Scintilla::ILexer5 *plex, TestDocument &doc, bool styleRange) {
+	constexpr int repeats = 20;
+	doc.SetStyleRange(styleRange);
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < repeats; i++) {
+		plex->Fold(0, doc.Length(), 0, &doc);
+	}
+	const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+	doc.SetStyleRange(false);
+	return duration.count() / repeats;
+}
+
+bool TimeFoldFile(const std::filesystem::path &path, const PropertyMap &propertyMap) {
+	Example example(path, propertyMap);
+	if (!example.Open()) {
+		return false;
 	}
+	Scintilla::ILexer5 *plex = example.plex.get();
+	TestDocument &doc = example.doc;
+	plex->Lex(0, doc.Length(), 0, &doc);
+
+	FoldTiming &timing = foldTimings[example.language];
+	timing.files++;
+	timing.bytes += doc.Length();
+	timing.secondsPerByte += TimeFold(plex, doc, false);
+	timing.secondsWindow += TimeFold(plex, doc, true);
+	return true;
+}
+
+void PrintFoldTimingReport() {
+	// Slowest folders first as they gain most from the style window
+	std::vector<std::pair<std::string, FoldTiming>> timings(foldTimings.begin(), foldTimings.end());
+	std::stable_sort(timings.begin(), timings.end(), [](const auto &a, const auto &b) {
+		return a.second.secondsPerByte > b.second.secondsPerByte;
+	});
+	std::cout << "\nFold time for whole documents in microseconds.\n"
+		"StyleAt: styles read from the document for each byte. Window: styles read through LexAccessor's window.\n\n";
+	std::cout << std::left << std::setw(16) << "language" << std::right << std::setw(6) << "files"
+		<< std::setw(9) << "bytes" << std::setw(10) << "StyleAt" << std::setw(10) << "Window" << std::setw(9) << "ratio\n";
+	for (const auto &[language, timing] : timings) {
+		const double ratio = (timing.secondsWindow > 0.0) ? timing.secondsPerByte / timing.secondsWindow : 0.0;
+		std::cout << std::left << std::setw(16) << language << std::right << std::setw(6) << timing.files
+			<< std::setw(9) << timing.bytes
+			<< std::setw(10) << std::fixed << std::setprecision(1) << timing.secondsPerByte * 1.0e6
+			<< std::setw(10) << timing.secondsWindow * 1.0e6
+			<< std::setw(8) << std::setprecision(2) << ratio << "\n";
+	}
+}
+
+// Cost of lexing and folding a range measured through an InstrumentedDocument
+struct Cost {
+	size_t calls = 0;	// IDocument calls
+	double seconds = 0.0;
+};
 
+Cost MeasureRange(Scintilla::ILexer5 *plex, TestDocument &doc, Sci_Position start, Sci_Position length) {
+	// Fastest of a few runs to reduce timing noise
+	constexpr int repeats = 3;
+	InstrumentedDocument idoc(&doc);
+	const int initStyle = (start > 0) ? static_cast<unsigned char>(doc.StyleAt(start - 1)) : 0;
+	Cost cost;
+	for (int i = 0; i < repeats; i++) {
+		idoc.Start(start, length);
+		const auto startTime = std::chrono::steady_clock::now();
+		plex->Lex(start, length, initStyle, &idoc);
+		plex->Fold(start, length, initStyle, &idoc);
+		const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
+		cost.calls = idoc.Record().calls;
+		cost.seconds = (i == 0) ? duration.count() : std::min(cost.seconds, duration.count());
+	}
+	return cost;
+}
+
+// Worst growth when the document doubles in size for one way of growing it
+struct Growth {
+	double calls = 0.0;
+	double time = 0.0;
+	void Add(const Growth &other) noexcept {
+		calls = std::max(calls, other.calls);
+		time = std::max(time, other.time);
+	}
+};
+
+// Worst growth for a language in each way of growing documents
+struct ScalingSummary {
+	size_t files = 0;
+	Growth linesFull;	// Replicated lines, whole document
+	Growth linesEnd;	// Replicated lines, relexing the last line
+	Growth longFull;	// Single long line, whole document
+	Growth longEnd;		// Single long line, relexing from the start of the last piece appended
+};
+
+std::map<std::string, ScalingSummary> scalingSummaries;
+
+// Documents smaller than this are replicated up to this size before doubling so that
+// times are large enough to measure.
+constexpr size_t scalingBaseSize = 4000;
+constexpr int scalingDoublings = 3;
+
+// Below these, costs are dominated by fixed overheads so growth is not checked.
+constexpr size_t scalingMinimumCalls = 200;
+constexpr double scalingMinimumSeconds = 0.0005;
+
+bool CheckGrowth(const std::vector<Cost> &costs, double bound, std::string_view description,
+	const std::filesystem::path &path, Growth &growth) {
+	bool success = true;
+	for (size_t i = 1; i < costs.size(); i++) {
+		const Cost &before = costs[i - 1];
+		const Cost &after = costs[i];
+		const double callsGrowth = static_cast<double>(after.calls) / std::max<size_t>(before.calls, 1);
+		growth.calls = std::max(growth.calls, callsGrowth);
+		if ((after.calls >= scalingMinimumCalls) && (callsGrowth > bound)) {
+			std::cout << path.string() << ":1: IDocument calls for " << description << " grow from " <<
+				before.calls << " to " << after.calls << " when document doubles\n";
+			success = false;
+		}
+	}
+	// Times are noisy so only check over all the doublings
+	const Cost &first = costs.front();
+	const Cost &last = costs.back();
+	if (first.seconds > 0.0) {
+		const double timeGrowth = std::pow(last.seconds / first.seconds, 1.0 / (costs.size() - 1));
+		growth.time = std::max(growth.time, timeGrowth);
+		if ((last.seconds >= scalingMinimumSeconds) && (timeGrowth > bound)) {
+			std::cout << path.string() << ":1: time for " << description << " grows from " <<
+				first.seconds * 1.0e6 << " to " << last.seconds * 1.0e6 << " microseconds over " <<
+				costs.size() - 1 << " doublings\n";
+			success = false;
+		}
+	}
 	return success;
 }
 
+// Maximum growth each time the document doubles for lexing the whole document, which should be
+// linear, and for relexing the end, which should take about the same time whatever the size.
+struct ScalingBounds {
+	double full = 0.0;
+	double end = 0.0;
+};
+
+// Lex and fold documents made from piece repeated, doubling the repetitions each time.
+// Then check the costs of the whole document and of relexing the end of the document.
+bool CheckScaling(Scintilla::ILexer5 *plex, const std::string &piece, const ScalingBounds &bounds, std::string_view description,
+	const std::filesystem::path &path, Growth &growthFull, Growth &growthEnd) {
+	// At least two pieces so relexing the end of the smallest document has text before it
+	const size_t baseRepetitions = std::max<size_t>(scalingBaseSize / std::max<size_t>(piece.length(), 1), 2);
+	std::vector<Cost> costsFull;
+	std::vector<Cost> costsEnd;
+	for (int doubling = 0; doubling <= scalingDoublings; doubling++) {
+		const size_t repetitions = baseRepetitions << doubling;
+		std::string text;
+		text.reserve(piece.length() * repetitions);
+		for (size_t i = 0; i < repetitions; i++) {
+			text += piece;
+		}
+		TestDocument doc;
+		doc.Set(text);
+		costsFull.push_back(MeasureRange(plex, doc, 0, doc.Length()));
+		// Relex from the start of the last line with text or, for a single line, the last piece
+		// as when typing at the end of a document
+		const Sci_Position startEnd = std::max(doc.LineStart(doc.LineFromPosition(doc.Length() - 1)),
+			static_cast<Sci_Position>(text.length() - piece.length()));
+		costsEnd.push_back(MeasureRange(plex, doc, startEnd, doc.Length() - startEnd));
+	}
+	const bool fullLinear = CheckGrowth(costsFull, bounds.full, std::string(description) + " whole document", path, growthFull);
+	const bool endConstant = CheckGrowth(costsEnd, bounds.end, std::string(description) + " relex at end", path, growthEnd);
+	return fullLinear && endConstant;
+}
+
+bool ScalingFile(const std::filesystem::path &path, const PropertyMap &propertyMap) {
+	Example example(path, propertyMap);
+	if (!example.Open()) {
+		return false;
+	}
+	const std::string &text = example.text;
+	if (text.empty()) {
+		return true;
+	}
+	Scintilla::ILexer5 *plex = example.plex.get();
+
+	// Maximum growth in percent allowed each time the document doubles. Linear growth is 200
+	// and relexing the end should stay near constant at 100.
+	ScalingBounds bounds;
+	bounds.full = propertyMap.GetPropertyValue("testlexers.scaling.growth").value_or(300) / 100.0;
+	bounds.end = propertyMap.GetPropertyValue("testlexers.scaling.growth.end").value_or(125) / 100.0;
+
+	ScalingSummary &summary = scalingSummaries[example.language];
+	summary.files++;
+
+	// Replicate whole lines
+	std::string lines = text;
+	if (!lines.ends_with('\n') && !lines.ends_with('\r')) {
+		lines += "\n";
+	}
+	bool success = CheckScaling(plex, lines, bounds, "replicated lines", path, summary.linesFull, summary.linesEnd);
+
+	// Join all lines into one long line
+	std::string longLine = text;
+	std::replace(longLine.begin(), longLine.end(), '\r', ' ');
+	std::replace(longLine.begin(), longLine.end(), '\n', ' ');
+	longLine += " ";
+	// Lexers go back to the start of the line so relexing the end of one long line grows with it
+	const ScalingBounds boundsLongLine { bounds.full, bounds.full };
+	if (!CheckScaling(plex, longLine, boundsLongLine, "long line", path, summary.longFull, summary.longEnd)) {
+		success = false;
+	}
+	return success;
+}
+
+void PrintScalingReport() {
+	std::cout << "\nWorst growth of IDocument calls and time each time the document doubles in size.\n"
+		"Linear growth is 2.0. Lines: example replicated. Long: example joined into one line and replicated.\n"
+		"Full: lex and fold whole document. End: relex and fold the last line or piece.\n\n";
+	std::cout << std::left << std::setw(16) << "language" << std::right << std::setw(6) << "files"
+		<< "  Lines Full  calls  time   End  calls  time | Long Full  calls  time   End  calls  time\n";
+	const auto printGrowth = [](const Growth &growth) {
+		std::cout << std::setw(7) << std::fixed << std::setprecision(2) << growth.calls
+			<< std::setw(6) << growth.time;
+	};
+	for (const auto &[language, summary] : scalingSummaries) {
+		std::cout << std::left << std::setw(16) << language << std::right << std::setw(6) << summary.files;
+		std::cout << "           ";
+		printGrowth(summary.linesFull);
+		std::cout << "      ";
+		printGrowth(summary.linesEnd);
+		std::cout << " |          ";
+		printGrowth(summary.longFull);
+		std::cout << "      ";
+		printGrowth(summary.longEnd);
+		std::cout << "\n";
+	}
+}
+
+// Heap allocations made by Lex and Fold for one language
+struct AllocationSummary {
+	size_t files = 0;
+	size_t lexCalls = 0;
+	size_t foldCalls = 0;
+	size_t bytes = 0;	// Length of all ranges lexed and folded
+	AllocationCount lex;
+	AllocationCount fold;
+};
+
+std::map<std::string, AllocationSummary> allocationSummaries;
+
+void Accumulate(AllocationCount &total, const AllocationCount &count) noexcept {
+	total.allocations += count.allocations;
+	total.bytes += count.bytes;
+}
+
+void CountLexAndFold(Scintilla::ILexer5 *plex, TestDocument &doc, Sci_Position start, Sci_Position length, int initStyle, AllocationSummary &summary) {
+	StartCountingAllocations();
+	plex->Lex(start, length, initStyle, &doc);
+	Accumulate(summary.lex, StopCountingAllocations());
+	StartCountingAllocations();
+	plex->Fold(start, length, initStyle, &doc);
+	Accumulate(summary.fold, StopCountingAllocations());
+	summary.lexCalls++;
+	summary.foldCalls++;
+	summary.bytes += 2 * length;
+}
+
+bool AllocationsFile(const std::filesystem::path &path, const PropertyMap &propertyMap) {
+	Example example(path, propertyMap);
+	if (!example.Open()) {
+		return false;
+	}
+	Scintilla::ILexer5 *plex = example.plex.get();
+	TestDocument &doc = example.doc;
+
+	// Whole document then each line as when typing
+	AllocationSummary file;
+	CountLexAndFold(plex, doc, 0, doc.Length(), 0, file);
+	const Sci_Position lines = doc.LineFromPosition(doc.Length());
+	for (Sci_Position line = 0; line <= lines; line++) {
+		const Sci_Position startLine = doc.LineStart(line);
+		const int initStyle = (startLine > 0) ? static_cast<unsigned char>(doc.StyleAt(startLine - 1)) : 0;
+		CountLexAndFold(plex, doc, startLine, doc.LineStart(line + 1) - startLine, initStyle, file);
+	}
+
+	AllocationSummary &summary = allocationSummaries[example.language];
+	summary.files++;
+	summary.lexCalls += file.lexCalls;
+	summary.foldCalls += file.foldCalls;
+	summary.bytes += file.bytes;
+	Accumulate(summary.lex, file.lex);
+	Accumulate(summary.fold, file.fold);
+
+	const std::optional<int> maxPerMB = propertyMap.GetPropertyValue("testlexers.allocations.per.mb");
+	if (maxPerMB && (file.bytes > 0)) {
+		const double perMB = (file.lex.allocations + file.fold.allocations) * 1048576.0 / file.bytes;
+		if (perMB > *maxPerMB) {
+			std::cout << path.string() << ":1: " << perMB << " allocations per MB lexed and folded exceeds "
+				<< *maxPerMB << "\n";
+			return false;
+		}
+	}
+	return true;
+}
+
+void PrintAllocationReport() {
+	std::cout << "\nHeap allocations made by Lex and Fold over whole documents then each line.\n\n";
+	std::cout << std::left << std::setw(16) << "language" << std::right << std::setw(7) << "calls"
+		<< std::setw(11) << "lex/call" << std::setw(12) << "bytes/call" << std::setw(11) << "fold/call"
+		<< std::setw(12) << "bytes/call" << std::setw(10) << "per MB\n";
+	for (const auto &[language, summary] : allocationSummaries) {
+		if (summary.lexCalls == 0 || summary.bytes == 0) {
+			continue;
+		}
+		const double perMB = (summary.lex.allocations + summary.fold.allocations) * 1048576.0 / summary.bytes;
+		std::cout << std::left << std::setw(16) << language << std::right << std::setw(7) << summary.lexCalls
+			<< std::setw(11) << std::fixed << std::setprecision(2) << static_cast<double>(summary.lex.allocations) / summary.lexCalls
+			<< std::setw(12) << std::setprecision(0) << static_cast<double>(summary.lex.bytes) / summary.lexCalls
+			<< std::setw(11) << std::setprecision(2) << static_cast<double>(summary.fold.allocations) / summary.foldCalls
+			<< std::setw(12) << std::setprecision(0) << static_cast<double>(summary.fold.bytes) / summary.foldCalls
+			<< std::setw(9) << perMB << "\n";
+	}
+}
+
+// Memory retained by a lexer after lexing and folding an example replicated to many lines.
+// Only the largest example for each language is kept.
+struct MemorySummary {
+	std::string file;
+	Sci_Position lines = 0;
+	Lexilla::LexerMemoryUse use;
+};
+
+std::map<std::string, MemorySummary> memorySummaries;
+
+bool MemoryFile(const std::filesystem::path &path, const PropertyMap &propertyMap) {
+	Example example(path, propertyMap);
+	if (!example.Open()) {
+		return false;
+	}
+	Scintilla::ILexer5 *plex = example.plex.get();
+	Lexilla::LexerMemoryUse use;
+	if (!plex->PrivateCall(Lexilla::privateCallMemoryUse, &use)) {
+		// Lexer does not report its memory use
+		return true;
+	}
+
+	// Replicate whole lines until the document has at least the requested number of lines
+	const Sci_Position linesWanted = propertyMap.GetPropertyValue("testlexers.memory.lines").value_or(1000000);
+	TestDocument &doc = example.doc;
+	example.SetDocument(doc, example.ReplicatedLines(linesWanted));
+	plex->Lex(0, doc.Length(), 0, &doc);
+	plex->Fold(0, doc.Length(), 0, &doc);
+	plex->PrivateCall(Lexilla::privateCallMemoryUse, &use);
+
+	MemorySummary &summary = memorySummaries[example.language];
+	if (use.total >= summary.use.total) {
+		summary.file = path.filename().string();
+		summary.lines = doc.LineFromPosition(doc.Length());
+		summary.use = use;
+	}
+	return true;
+}
+
+void PrintMemoryReport() {
+	std::cout << "\nMemory retained by each lexer after lexing and folding its largest example replicated to many lines.\n"
+		"Only lexers that implement privateCallMemoryUse are shown.\n\n";
+	std::cout << std::left << std::setw(16) << "language" << std::setw(24) << "file" << std::right
+		<< std::setw(10) << "lines" << std::setw(12) << "bytes" << std::setw(12) << "bytes/line\n";
+	for (const auto &[language, summary] : memorySummaries) {
+		const double perLine = summary.lines ? static_cast<double>(summary.use.total) / summary.lines : 0.0;
+		std::cout << std::left << std::setw(16) << language << std::setw(24) << summary.file << std::right
+			<< std::setw(10) << summary.lines << std::setw(12) << summary.use.total
+			<< std::setw(11) << std::fixed << std::setprecision(2) << perLine << "\n";
+		for (int i = 0; i < summary.use.items; i++) {
+			const Lexilla::LexerMemoryUse::Item &item = summary.use.item[i];
+			std::cout << "    " << std::left << std::setw(46) << item.name << std::right
+				<< std::setw(12) << item.bytes << "\n";
+		}
+	}
+}
+
+// Time spent and differences found running the library's reference and optimised paths.
+struct ShadowSummary {
+	size_t files = 0;
+	size_t steps = 0;	// Lex and Fold calls made on each path
+	size_t differences = 0;
+	double secondsReference = 0.0;
+	double secondsOptimised = 0.0;
+};
+
+std::map<std::string, ShadowSummary> shadowSummaries;
+
+// Turns on the library property lexilla.reference.mode for its lifetime when on is true so
+// that lexlib avoids its optimised paths inside the calls made meanwhile.
+class ReferenceModeScope {
+	const bool on;
+public:
+	explicit ReferenceModeScope(bool on_) : on(on_) {
+		if (on) {
+			Lexilla::SetProperty("lexilla.reference.mode", "1");
+		}
+	}
+	// Deleted so ReferenceModeScope objects can not be copied.
+	ReferenceModeScope(const ReferenceModeScope &) = delete;
+	ReferenceModeScope(ReferenceModeScope &&) = delete;
+	ReferenceModeScope &operator=(const ReferenceModeScope &) = delete;
+	ReferenceModeScope &operator=(ReferenceModeScope &&) = delete;
+	~ReferenceModeScope() {
+		if (on) {
+			Lexilla::SetProperty("lexilla.reference.mode", "0");
+		}
+	}
+};
+
+// One path: a lexer and its own copy of the document.
+// The reference path calls Lex and Fold over the rest of the document with folding during lexing
+// off and a document that does not offer its style range. Its lexer is created and called with
+// lexilla.reference.mode on so keyword lists, character decoding, scanning, and tokens also
+// take the reference paths in lexlib. The optimised path uses the features the lexer supports.
+struct ShadowPath {
+	LexerPointer plex;
+	TestDocument doc;
+	bool reference = false;
+	double seconds = 0.0;
+	Sci_Position lineConverged = -1;
+
+	static LexerPointer MakeLexer(const Example &example, bool reference) {
+		const ReferenceModeScope scope(reference);
+		return example.MakeLexer();
+	}
+
+	ShadowPath(const Example &example, bool reference_) : plex(MakeLexer(example, reference_)), reference(reference_) {
+		example.SetDocument(doc, example.text);
+		doc.SetStyleRange(!reference);
+		if (plex) {
+			int foldDuringLex = reference ? 0 : 1;
+			plex->PrivateCall(Lexilla::privateCallFoldDuringLex, &foldDuringLex);
+		}
+	}
+	// Deleted so ShadowPath objects can not be copied.
+	ShadowPath(const ShadowPath &) = delete;
+	ShadowPath(ShadowPath &&) = delete;
+	ShadowPath &operator=(const ShadowPath &) = delete;
+	ShadowPath &operator=(ShadowPath &&) = delete;
+	~ShadowPath() = default;
+
+	// Relex and fold from startPos to the end of the document after a change, allowing the
+	// optimised path to stop early when it converges.
+	void LexAndFold(Sci_Position startPos, int initStyle, Sci_Position changedEnd, Sci_Position linesInserted) {
+		const ReferenceModeScope scope(reference);
+		const auto start = std::chrono::steady_clock::now();
+		const Sci_Position length = doc.Length() - startPos;
+		lineConverged = -1;
+		Lexilla::LexConvergingArguments args;
+		args.startPos = startPos;
+		args.lengthDoc = length;
+		args.initStyle = initStyle;
+		args.pAccess = &doc;
+		args.changedEnd = changedEnd;
+		args.linesInserted = linesInserted;
+		args.fold = true;
+		if (!reference && plex->PrivateCall(Lexilla::privateCallLexConverging, &args)) {
+			lineConverged = args.lineConverged;
+		} else {
+			plex->Lex(startPos, length, initStyle, &doc);
+			plex->Fold(startPos, length, initStyle, &doc);
+		}
+		const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+		seconds += duration.count();
+	}
+};
+
+bool ShadowFile(const std::filesystem::path &path, const PropertyMap &propertyMap) {
+	Example example(path, propertyMap);
+	if (!example.Open()) {
+		return false;
+	}
+	ShadowPath reference(example, true);
+	ShadowPath optimised(example, false);
+	if (!reference.plex || !optimised.plex) {
+		return false;
+	}
+
+	ShadowSummary summary;
+	summary.files = 1;
+	bool success = true;
+	reference.LexAndFold(0, 0, reference.doc.Length(), 0);
+	optimised.LexAndFold(0, 0, optimised.doc.Length(), 0);
+	summary.steps++;
+	std::string difference = FirstDifference(reference.doc, optimised.doc);
+	if (!difference.empty()) {
+		std::cout << path.string() << ":" << difference << " after lexing whole document\n";
+		summary.differences++;
+		success = false;
+	} else {
+		// Then keystrokes which exercise converging lexes and the style window when backtracking
+		const std::vector<Keystroke> keystrokes = KeystrokesForFile(reference.doc);
+		for (const Keystroke &keystroke : keystrokes) {
+			Sci_Position linesInserted = std::count(keystroke.inserted.begin(), keystroke.inserted.end(), '\n');
+			if (keystroke.deleted) {
+				std::string deleted(keystroke.deleted, '\0');
+				reference.doc.GetCharRange(deleted.data(), keystroke.position, keystroke.deleted);
+				linesInserted = -std::count(deleted.begin(), deleted.end(), '\n');
+			}
+			ApplyKeystroke(reference.doc, keystroke);
+			ApplyKeystroke(optimised.doc, keystroke);
+			const Sci_Position lineStart = reference.doc.LineStart(reference.doc.LineFromPosition(keystroke.position));
+			const int initStyle = (lineStart > 0) ? static_cast<unsigned char>(reference.doc.StyleAt(lineStart - 1)) : 0;
+			const Sci_Position changedEnd = keystroke.position + keystroke.inserted.length();
+			reference.LexAndFold(lineStart, initStyle, changedEnd, linesInserted);
+			optimised.LexAndFold(lineStart, initStyle, changedEnd, linesInserted);
+			summary.steps++;
+			difference = FirstDifference(reference.doc, optimised.doc);
+			if (!difference.empty()) {
+				summary.differences++;
+				if (optimised.lineConverged >= 0) {
+					std::cout << path.string() << ":" << difference << " after keystroke at " << keystroke.position << "\n";
+					success = false;
+				} else {
+					// Not caused by stopping early: the lexer does not produce the same results when
+					// started at a line inside a range it has just lexed
+					std::cout << path.string() << ":" << difference << " lexing in chunks after keystroke at "
+						<< keystroke.position << "\n";
+					success = false;
+				}
+				break;
+			}
+		}
+	}
+
+	ShadowSummary &total = shadowSummaries[example.language];
+	total.files += summary.files;
+	total.steps += summary.steps;
+	total.differences += summary.differences;
+	total.secondsReference += reference.seconds;
+	total.secondsOptimised += optimised.seconds;
+	return success;
+}
+
+void PrintShadowReport() {
+	std::cout << "\nLex and Fold through the reference and optimised paths of the library on copies of each document.\n"
+		"The whole document is lexed then relexed after each keystroke. Times are totals in milliseconds.\n\n";
+	std::cout << std::left << std::setw(16) << "language" << std::right << std::setw(6) << "files"
+		<< std::setw(7) << "steps" << std::setw(12) << "reference" << std::setw(12) << "optimised"
+		<< std::setw(8) << "ratio" << std::setw(13) << "differences\n";
+	for (const auto &[language, summary] : shadowSummaries) {
+		const double ratio = (summary.secondsOptimised > 0.0) ? summary.secondsReference / summary.secondsOptimised : 0.0;
+		std::cout << std::left << std::setw(16) << language << std::right << std::setw(6) << summary.files
+			<< std::setw(7) << summary.steps
+			<< std::setw(12) << std::fixed << std::setprecision(2) << summary.secondsReference * 1000.0
+			<< std::setw(12) << summary.secondsOptimised * 1000.0
+			<< std::setw(8) << ratio << std::setw(12) << summary.differences << "\n";
+	}
+}
+
+// Time spent editing and lexing visible text for one language
+struct DocumentSummary {
+	size_t files = 0;
+	size_t keystrokes = 0;
+	double secondsTestEdit = 0.0;
+	double secondsTestLex = 0.0;
+	double secondsEditableEdit = 0.0;
+	double secondsEditableLex = 0.0;
+	size_t differences = 0;	// Files where lexing visible text left different styles to lexing whole
+};
+
+std::map<std::string, DocumentSummary> documentSummaries;
+
+// Typing a word, a line end, and then some more before deleting it at many lines of the document.
+// Lines are visited from the end so that each keystroke's position is not moved by earlier lines.
+std::vector<Keystroke> EditTraceForDocument(const TestDocument &doc) {
+	constexpr Sci_Position linesEdited = 40;
+	std::vector<Keystroke> keystrokes;
+	const Sci_Position lines = doc.LineFromPosition(doc.Length());
+	const Sci_Position step = std::max<Sci_Position>(lines / linesEdited, 1);
+	for (Sci_Position line = lines - 1; line >= 0; line -= step) {
+		Sci_Position caret = doc.LineEnd(line);
+		for (const std::string_view typed : { "w", "o", "r", "d", "\n", "(", "x", ")", ";" }) {
+			keystrokes.push_back({ caret, typed, 0 });
+			caret += typed.length();
+		}
+		for (int backspace = 0; backspace < 4; backspace++) {
+			caret--;
+			keystrokes.push_back({ caret, "", 1 });
+		}
+	}
+	return keystrokes;
+}
+
+double SecondsSince(std::chrono::steady_clock::time_point start) noexcept {
+	const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+	return duration.count();
+}
+
+bool DocumentFile(const std::filesystem::path &path, const PropertyMap &propertyMap) {
+	Example example(path, propertyMap);
+	if (!example.Open()) {
+		return false;
+	}
+	LexerPointer plexEditable = example.MakeLexer();
+	if (!plexEditable) {
+		return false;
+	}
+	// The EditableDocument owns its lexer
+	Lexilla::EditableDocument docEditable;
+	docEditable.SetLexer(plexEditable.release());
+
+	// Replicate whole lines until the document has at least the requested number of lines
+	const Sci_Position linesWanted = propertyMap.GetPropertyValue("testlexers.document.lines").value_or(5000);
+	const std::string large = example.ReplicatedLines(linesWanted);
+	Scintilla::ILexer5 *plexTest = example.plex.get();
+	TestDocument &docTest = example.doc;
+	example.SetDocument(docTest, large);
+	docEditable.SetCodePage(CodePageOf(propertyMap));
+	docEditable.Set(large);
+	plexTest->Lex(0, docTest.Length(), 0, &docTest);
+	plexTest->Fold(0, docTest.Length(), 0, &docTest);
+	docEditable.EnsureStyledTo(docEditable.Length());
+
+	// After each keystroke, the lines from the edit to the bottom of a window are lexed and folded
+	// as they would be for display
+	constexpr Sci_Position linesVisible = 50;
+	DocumentSummary summary;
+	summary.files = 1;
+	const std::vector<Keystroke> keystrokes = EditTraceForDocument(docTest);
+	for (const Keystroke &keystroke : keystrokes) {
+		auto start = std::chrono::steady_clock::now();
+		ApplyKeystroke(docTest, keystroke);
+		summary.secondsTestEdit += SecondsSince(start);
+		start = std::chrono::steady_clock::now();
+		const Sci_Position line = docTest.LineFromPosition(keystroke.position);
+		const Sci_Position lineStart = docTest.LineStart(line);
+		const Sci_Position endVisible = docTest.LineStart(line + linesVisible);
+		const int initStyle = (lineStart > 0) ? static_cast<unsigned char>(docTest.StyleAt(lineStart - 1)) : 0;
+		plexTest->Lex(lineStart, endVisible - lineStart, initStyle, &docTest);
+		plexTest->Fold(lineStart, endVisible - lineStart, initStyle, &docTest);
+		summary.secondsTestLex += SecondsSince(start);
+
+		start = std::chrono::steady_clock::now();
+		ApplyKeystroke(docEditable, keystroke);
+		summary.secondsEditableEdit += SecondsSince(start);
+		start = std::chrono::steady_clock::now();
+		docEditable.EnsureStyledTo(docEditable.LineStart(docEditable.LineFromPosition(keystroke.position) + linesVisible) - 1);
+		summary.secondsEditableLex += SecondsSince(start);
+		summary.keystrokes++;
+	}
+
+	// The edited text must be the same and lexing the rest of the document should match lexing it whole
+	std::string textEdited(docEditable.Length(), '\0');
+	docEditable.GetCharRange(textEdited.data(), 0, docEditable.Length());
+	std::string textTest(docTest.Length(), '\0');
+	docTest.GetCharRange(textTest.data(), 0, docTest.Length());
+	if (textEdited != textTest) {
+		std::cout << path.string() << ":" << FirstLineDifferent(textTest, textEdited) + 1
+			<< ": EditableDocument text differs from TestDocument after edits\n";
+		return false;
+	}
+	docEditable.EnsureStyledTo(docEditable.Length());
+	TestDocument docWhole;
+	example.SetDocument(docWhole, textTest);
+	const LexerPointer plexWhole = example.MakeLexer();
+	plexWhole->Lex(0, docWhole.Length(), 0, &docWhole);
+	plexWhole->Fold(0, docWhole.Length(), 0, &docWhole);
+	const std::string difference = FirstDifference(docWhole, docEditable);
+	bool success = true;
+	if (!difference.empty()) {
+		// The lexer does not produce the same results when restarted at the edited line
+		std::cout << path.string() << ":" << difference << " after lexing visible text\n";
+		summary.differences++;
+		success = false;
+	}
+
+	DocumentSummary &total = documentSummaries[example.language];
+	total.files += summary.files;
+	total.keystrokes += summary.keystrokes;
+	total.secondsTestEdit += summary.secondsTestEdit;
+	total.secondsTestLex += summary.secondsTestLex;
+	total.secondsEditableEdit += summary.secondsEditableEdit;
+	total.secondsEditableLex += summary.secondsEditableLex;
+	total.differences += summary.differences;
+	return success;
+}
+
+void PrintDocumentReport() {
+	std::cout << "\nTime to apply keystrokes and then lex and fold the visible lines after each for TestDocument\n"
+		"and EditableDocument. Times are totals in milliseconds.\n\n";
+	std::cout << std::left << std::setw(16) << "language" << std::right << std::setw(6) << "files"
+		<< std::setw(11) << "keystrokes" << std::setw(11) << "test edit" << std::setw(10) << "test lex"
+		<< std::setw(15) << "editable edit" << std::setw(14) << "editable lex" << std::setw(13) << "differences\n";
+	DocumentSummary all;
+	for (const auto &[language, summary] : documentSummaries) {
+		std::cout << std::left << std::setw(16) << language << std::right << std::setw(6) << summary.files
+			<< std::setw(11) << summary.keystrokes
+			<< std::setw(11) << std::fixed << std::setprecision(2) << summary.secondsTestEdit * 1000.0
+			<< std::setw(10) << summary.secondsTestLex * 1000.0
+			<< std::setw(15) << summary.secondsEditableEdit * 1000.0
+			<< std::setw(14) << summary.secondsEditableLex * 1000.0
+			<< std::setw(12) << summary.differences << "\n";
+		all.keystrokes += summary.keystrokes;
+		all.secondsTestEdit += summary.secondsTestEdit;
+		all.secondsEditableEdit += summary.secondsEditableEdit;
+	}
+	if (all.keystrokes > 0) {
+		std::cout << "\nMicroseconds per keystroke to edit: TestDocument "
+			<< std::setprecision(2) << all.secondsTestEdit * 1.0e6 / all.keystrokes
+			<< ", EditableDocument " << all.secondsEditableEdit * 1.0e6 / all.keystrokes << "\n";
+	}
+}
+
+// Time spent lexing and cache activity for lexers with a line style cache
+struct LineCacheSummary {
+	size_t files = 0;
+	Sci_Position bytes = 0;
+	double secondsOff = 0.0;
+	double secondsOn = 0.0;
+	Lexilla::LineStyleCacheUse use;
+	size_t differences = 0;
+};
+
+std::map<std::string, LineCacheSummary> lineCacheSummaries;
+
+constexpr const char *lineCacheProperty = "lexilla.line.cache";
+
+double TimeLex(Scintilla::ILexer5 *plex, TestDocument &doc) {
+	const auto start = std::chrono::steady_clock::now();
+	plex->Lex(0, doc.Length(), 0, &doc);
+	return SecondsSince(start);
+}
+
+bool LineCacheFile(const std::filesystem::path &path, const PropertyMap &propertyMap) {
+	Example example(path, propertyMap);
+	if (!example.Open()) {
+		return false;
+	}
+	const LexerPointer plexOn = example.MakeLexer();
+	if (!plexOn) {
+		return false;
+	}
+	Scintilla::ILexer5 *plexOff = example.plex.get();
+
+	// Replicate whole lines to make a repetitive document like a log or build output
+	const Sci_Position linesWanted = propertyMap.GetPropertyValue("testlexers.linecache.lines").value_or(100000);
+	const std::string large = example.ReplicatedLines(linesWanted);
+	TestDocument &docOff = example.doc;
+	example.SetDocument(docOff, large);
+	TestDocument docOn;
+	example.SetDocument(docOn, large);
+
+	Lexilla::SetProperty(lineCacheProperty, "0");
+	const double secondsOff = TimeLex(plexOff, docOff);
+	Lexilla::SetProperty(lineCacheProperty, "1");
+	const double secondsOn = TimeLex(plexOn.get(), docOn);
+	Lexilla::SetProperty(lineCacheProperty, "0");
+	Lexilla::LineStyleCacheUse use;
+	const bool cached = plexOn->PrivateCall(Lexilla::privateCallLineStyleCache, &use) != nullptr;
+	if (!cached) {
+		// Lexer does not have a line style cache
+		return true;
+	}
+
+	LineCacheSummary &summary = lineCacheSummaries[example.language];
+	summary.files++;
+	summary.bytes += docOn.Length();
+	summary.secondsOff += secondsOff;
+	summary.secondsOn += secondsOn;
+	summary.use.lookups += use.lookups;
+	summary.use.hits += use.hits;
+	summary.use.entries += use.entries;
+	summary.use.bytes = std::max(summary.use.bytes, use.bytes);
+	const std::string difference = FirstDifference(docOff, docOn);
+	if (!difference.empty()) {
+		std::cout << path.string() << ":" << difference << " with line style cache\n";
+		summary.differences++;
+		return false;
+	}
+	return true;
+}
+
+void PrintLineCacheReport() {
+	std::cout << "\nLex each example replicated to many lines with the line style cache off and on.\n"
+		"Only lexers with a line style cache are shown. Lines too short or long to cache are not looked up.\n"
+		"Throughput is in megabytes per second and cache bytes is the most used for one file.\n\n";
+	std::cout << std::left << std::setw(16) << "language" << std::right << std::setw(6) << "files"
+		<< std::setw(10) << "lookups" << std::setw(9) << "hit %" << std::setw(9) << "off"
+		<< std::setw(9) << "on" << std::setw(8) << "ratio" << std::setw(12) << "cache bytes"
+		<< std::setw(13) << "differences\n";
+	for (const auto &[language, summary] : lineCacheSummaries) {
+		const double megabytes = summary.bytes / 1.0e6;
+		const double hitRate = summary.use.lookups ? 100.0 * summary.use.hits / summary.use.lookups : 0.0;
+		const double ratio = (summary.secondsOn > 0.0) ? summary.secondsOff / summary.secondsOn : 0.0;
+		std::cout << std::left << std::setw(16) << language << std::right << std::setw(6) << summary.files
+			<< std::setw(10) << summary.use.lookups
+			<< std::setw(9) << std::fixed << std::setprecision(2) << hitRate
+			<< std::setw(9) << ((summary.secondsOff > 0.0) ? megabytes / summary.secondsOff : 0.0)
+			<< std::setw(9) << ((summary.secondsOn > 0.0) ? megabytes / summary.secondsOn : 0.0)
+			<< std::setw(8) << ratio << std::setw(12) << summary.use.bytes
+			<< std::setw(12) << summary.differences << "\n";
+	}
+}
+
+// Bytes lexed and folded and the best times for one language
+struct ThroughputSummary {
+	size_t files = 0;
+	size_t bytes = 0;
+	double secondsLex = 0.0;
+	double secondsFold = 0.0;
+	// Only for lexers that can fold during lex: Lex and Fold with each call separate and when folding
+	// during lex along with the text and style bytes read from the document.
+	size_t filesFused = 0;
+	size_t bytesFused = 0;
+	double secondsSeparate = 0.0;
+	double secondsFused = 0.0;
+	size_t readsSeparate = 0;
+	size_t readsFused = 0;
+};
+
+std::map<std::string, ThroughputSummary> throughputSummaries;
+
+// Each document is lexed and folded this many times and the fastest kept as it is least
+// disturbed by other activity on the machine.
+constexpr int throughputRuns = 5;
+
+// Results are written to throughputFileName and compared with throughputBaselineName, if present,
+// so that builds such as profile guided optimisation can be compared with a previous build.
+constexpr const char *throughputFileName = "TestLexers.throughput.txt";
+constexpr const char *throughputBaselineName = "TestLexers.throughput.baseline.txt";
+
+// Text and style bytes read from the document by Lex followed by Fold of the whole document.
+// Styles are read one at a time as InstrumentedDocument does not offer GetStyleRange.
+size_t DocumentReads(Scintilla::ILexer5 *plex, TestDocument &doc) {
+	InstrumentedDocument idoc(&doc);
+	idoc.Start(0, doc.Length());
+	plex->Lex(0, doc.Length(), 0, &idoc);
+	size_t reads = idoc.Record().bytesFilled + idoc.Record().styleReads;
+	idoc.Start(0, doc.Length());
+	plex->Fold(0, doc.Length(), 0, &idoc);
+	reads += idoc.Record().bytesFilled + idoc.Record().styleReads;
+	return reads;
+}
+
+bool ThroughputFile(const std::filesystem::path &path, const PropertyMap &propertyMap) {
+	Example example(path, propertyMap);
+	if (!example.Open()) {
+		return false;
+	}
+	std::string text = example.text;
+	if (text.empty()) {
+		return true;
+	}
+	if (!text.ends_with('\n') && !text.ends_with('\r')) {
+		text += "\n";
+	}
+	// Replicate whole lines so times are large enough to measure
+	const size_t bytesWanted = propertyMap.GetPropertyValue("testlexers.throughput.bytes").value_or(1000000);
+	const size_t repetitions = (bytesWanted + text.length() - 1) / text.length();
+	std::string large;
+	large.reserve(text.length() * repetitions);
+	for (size_t repetition = 0; repetition < repetitions; repetition++) {
+		large += text;
+	}
+	Scintilla::ILexer5 *plex = example.plex.get();
+	TestDocument &doc = example.doc;
+	example.SetDocument(doc, large);
+	// Measure with the style window as applications that offer it would lex
+	doc.SetStyleRange(true);
+
+	double secondsLex = 0.0;
+	double secondsFold = 0.0;
+	for (int run = 0; run < throughputRuns; run++) {
+		auto start = std::chrono::steady_clock::now();
+		plex->Lex(0, doc.Length(), 0, &doc);
+		const double lex = SecondsSince(start);
+		start = std::chrono::steady_clock::now();
+		plex->Fold(0, doc.Length(), 0, &doc);
+		const double fold = SecondsSince(start);
+		secondsLex = (run == 0) ? lex : std::min(secondsLex, lex);
+		secondsFold = (run == 0) ? fold : std::min(secondsFold, fold);
+	}
+
+	ThroughputSummary &summary = throughputSummaries[example.language];
+	summary.files++;
+	summary.bytes += doc.Length();
+	summary.secondsLex += secondsLex;
+	summary.secondsFold += secondsFold;
+
+	const size_t readsSeparate = DocumentReads(plex, doc);
+	int foldDuringLex = 1;
+	if (plex->PrivateCall(Lexilla::privateCallFoldDuringLex, &foldDuringLex)) {
+		double secondsFused = 0.0;
+		for (int run = 0; run < throughputRuns; run++) {
+			const auto start = std::chrono::steady_clock::now();
+			plex->Lex(0, doc.Length(), 0, &doc);
+			plex->Fold(0, doc.Length(), 0, &doc);
+			const double fused = SecondsSince(start);
+			secondsFused = (run == 0) ? fused : std::min(secondsFused, fused);
+		}
+		summary.filesFused++;
+		summary.bytesFused += doc.Length();
+		summary.secondsSeparate += secondsLex + secondsFold;
+		summary.secondsFused += secondsFused;
+		summary.readsSeparate += readsSeparate;
+		summary.readsFused += DocumentReads(plex, doc);
+	}
+	return true;
+}
+
+double MegabytesPerSecond(size_t bytes, double seconds) noexcept {
+	return (seconds > 0.0) ? bytes / 1.0e6 / seconds : 0.0;
+}
+
+// Faster than this, folding does no measurable work as for lexers without a folder.
+constexpr double unmeasuredRate = 100000.0;
+
+void PrintRate(double rate) {
+	if (rate > unmeasuredRate) {
+		std::cout << std::setw(10) << "-";
+	} else {
+		std::cout << std::setw(10) << rate;
+	}
+}
+
+void PrintThroughputReport() {
+	// Baseline has lines of language, lex throughput, and fold throughput
+	std::map<std::string, std::pair<double, double>> baseline;
+	std::ifstream baselineFile(throughputBaselineName);
+	std::string language;
+	double lex = 0.0;
+	double fold = 0.0;
+	while (baselineFile >> language >> lex >> fold) {
+		baseline[language] = {lex, fold};
+	}
+
+	std::cout << "\nLex and fold each example replicated to testlexers.throughput.bytes, default 1000000,\n"
+		"keeping the fastest of " << throughputRuns << " runs. Throughput is in megabytes per second.\n";
+	if (!baseline.empty()) {
+		std::cout << "Change is the percentage change in throughput from " << throughputBaselineName << ".\n";
+	}
+	std::cout << "\n" << std::left << std::setw(16) << "language" << std::right << std::setw(6) << "files"
+		<< std::setw(10) << "lex" << std::setw(10) << "fold";
+	if (!baseline.empty()) {
+		std::cout << std::setw(12) << "lex change" << std::setw(13) << "fold change";
+	}
+	std::cout << "\n";
+
+	std::ofstream results(throughputFileName);
+	ThroughputSummary total;
+	const auto printLanguage = [&](const std::string &name, const ThroughputSummary &summary) {
+		const double lexRate = MegabytesPerSecond(summary.bytes, summary.secondsLex);
+		const double foldRate = MegabytesPerSecond(summary.bytes, summary.secondsFold);
+		results << name << " " << lexRate << " " << foldRate << "\n";
+		std::cout << std::left << std::setw(16) << name << std::right << std::setw(6) << summary.files
+			<< std::fixed << std::setprecision(2);
+		PrintRate(lexRate);
+		PrintRate(foldRate);
+		const auto itBaseline = baseline.find(name);
+		if (itBaseline != baseline.end()) {
+			const auto [lexBase, foldBase] = itBaseline->second;
+			std::cout << std::showpos << std::setprecision(1)
+				<< std::setw(11) << ((lexBase > 0.0) ? 100.0 * (lexRate / lexBase - 1.0) : 0.0) << "%";
+			if (foldRate > unmeasuredRate) {
+				std::cout << std::setw(13) << "-";
+			} else {
+				std::cout << std::setw(12) << ((foldBase > 0.0) ? 100.0 * (foldRate / foldBase - 1.0) : 0.0) << "%";
+			}
+			std::cout << std::noshowpos;
+		}
+		std::cout << "\n";
+	};
+	for (const auto &[name, summary] : throughputSummaries) {
+		printLanguage(name, summary);
+		total.files += summary.files;
+		total.bytes += summary.bytes;
+		total.secondsLex += summary.secondsLex;
+		total.secondsFold += summary.secondsFold;
+	}
+	// Languages are all lexer names so this can not be mistaken for one
+	printLanguage("(all)", total);
+	std::cout << "\nThroughput written to " << throughputFileName << ".\n";
+
+	std::cout << "\nLexers that can fold during lex: lex and fold throughput with separate calls and when\n"
+		"folding during lex, then text and style bytes read from the document per byte lexed.\n\n";
+	std::cout << std::left << std::setw(16) << "language" << std::right << std::setw(6) << "files"
+		<< std::setw(10) << "separate" << std::setw(10) << "fused"
+		<< std::setw(10) << "reads" << std::setw(10) << "fused" << "\n";
+	for (const auto &[name, summary] : throughputSummaries) {
+		if (summary.filesFused == 0) {
+			continue;
+		}
+		const double bytes = static_cast<double>(summary.bytesFused);
+		std::cout << std::left << std::setw(16) << name << std::right << std::setw(6) << summary.filesFused
+			<< std::fixed << std::setprecision(2)
+			<< std::setw(10) << MegabytesPerSecond(summary.bytesFused, summary.secondsSeparate)
+			<< std::setw(10) << MegabytesPerSecond(summary.bytesFused, summary.secondsFused)
+			<< std::setw(10) << summary.readsSeparate / bytes
+			<< std::setw(10) << summary.readsFused / bytes << "\n";
+	}
+}
+
+constexpr const char *traceFileProperty = "lexilla.trace.file";
+constexpr const char *traceFileName = "TestLexers.trace.json";
+
+void WriteTraceReport() {
+	// Only libraries built with LEXILLA_TRACE have the property so the file shows whether it was traced
+	std::filesystem::remove(traceFileName);
+	Lexilla::SetProperty(traceFileProperty, traceFileName);
+	if (std::filesystem::exists(traceFileName)) {
+		std::cout << "\nWrote trace to " << traceFileName << " which can be opened by Perfetto or chrome://tracing.\n";
+	} else {
+		std::cout << "\nNo trace written as Lexilla was not built with TRACE=1.\n";
+	}
+}
+
 bool TestDirectory(std::filesystem::path directory, std::filesystem::path basePath) {
+	using FileFunction = bool (*)(const std::filesystem::path &path, const PropertyMap &propertyMap);
+	const std::pair<bool, FileFunction> modes[] = {
+		{ runOptions.profileAccess, ProfileFile },
+		{ runOptions.replayEdits, ReplayFile },
+		{ runOptions.timeFolds, TimeFoldFile },
+		{ runOptions.scaling, ScalingFile },
+		{ runOptions.allocations, AllocationsFile },
+		{ runOptions.memory, MemoryFile },
+		{ runOptions.shadow, ShadowFile },
+		{ runOptions.document, DocumentFile },
+		{ runOptions.lineCache, LineCacheFile },
+		{ runOptions.throughput, ThroughputFile },
+	};
 	bool success = true;
 	for (auto &p : std::filesystem::directory_iterator(directory)) {
 		if (!p.is_directory()) {
@@ -938,7 +2504,17 @@ bool TestDirectory(std::filesystem::path directory, std::filesystem::path basePa
 				PropertyMap properties;
 				properties.properties["FileNameExt"] = p.path().filename().string();
 				properties.ReadFromFile(directory / "SciTE.properties");
-				if (!TestFile(p, properties)) {
+				// Each mode chosen runs over every example and checking results is the default
+				bool modeChosen = false;
+				for (const auto &[chosen, fileFunction] : modes) {
+					if (chosen) {
+						modeChosen = true;
+						if (!fileFunction(p, properties)) {
+							success = false;
+						}
+					}
+				}
+				if (!modeChosen && !TestFile(p, properties)) {
 					success = false;
 				}
 			}
@@ -970,6 +2546,121 @@ bool AccessLexilla(std::filesystem::path basePath) {
 	return success;
 }
 
+// Memory used by this process in bytes or 0 when not known on this platform.
+// Heap in use is exact where available while resident memory is affected by reuse of freed pages.
+size_t MemoryInUse() {
+#if defined(__linux__)
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 33)
+	return mallinfo2().uordblks;
+#endif
+#endif
+	std::ifstream statm("/proc/self/statm");
+	size_t pagesTotal = 0;
+	size_t pagesResident = 0;
+	if (statm >> pagesTotal >> pagesResident) {
+		return pagesResident * sysconf(_SC_PAGESIZE);
+	}
+#endif
+	return 0;
+}
+
+// Create many instances of each lexer as an application with many documents would and
+// report the time and memory used by each instance.
+// The fastest of several rounds is reported to reduce the effect of other activity.
+void MeasureCreation() {
+	constexpr size_t instances = 1000;
+	constexpr int rounds = 5;
+	std::cout << "\nCreating " << instances << " instances of each lexer and retrieving property names.\n\n";
+	std::cout << std::left << std::setw(16) << "language" << std::right << std::setw(14) << "microseconds"
+		<< std::setw(14) << "bytes each" << std::setw(14) << "allocations\n";
+	double secondsTotal = 0.0;
+	size_t bytesTotal = 0;
+	size_t allocationsTotal = 0;
+	size_t lexersMeasured = 0;
+	const std::vector<std::string> names = Lexilla::Lexers();
+	for (const std::string &name : names) {
+		Scintilla::ILexer5 *plexFirst = Lexilla::MakeLexer(name);
+		if (!plexFirst) {
+			continue;
+		}
+		plexFirst->Release();
+		double secondsFastest = 0.0;
+		size_t bytes = 0;
+		AllocationCount allocated;
+		std::vector<Scintilla::ILexer5 *> lexers;
+		lexers.reserve(instances);
+		for (int round = 0; round < rounds; round++) {
+			const size_t memoryBefore = MemoryInUse();
+			const auto start = std::chrono::steady_clock::now();
+			StartCountingAllocations();
+			for (size_t i = 0; i < instances; i++) {
+				Scintilla::ILexer5 *plex = Lexilla::MakeLexer(name);
+				[[maybe_unused]] const char *propertyNames = plex->PropertyNames();
+				lexers.push_back(plex);
+			}
+			allocated = StopCountingAllocations();
+			const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+			const size_t memoryAfter = MemoryInUse();
+			if ((round == 0) || (duration.count() < secondsFastest)) {
+				secondsFastest = duration.count();
+			}
+			bytes = (memoryAfter > memoryBefore) ? memoryAfter - memoryBefore : 0;
+			for (Scintilla::ILexer5 *plex : lexers) {
+				plex->Release();
+			}
+			lexers.clear();
+		}
+		secondsTotal += secondsFastest;
+		bytesTotal += bytes;
+		allocationsTotal += allocated.allocations;
+		lexersMeasured++;
+		std::cout << std::left << std::setw(16) << name << std::right
+			<< std::setw(13) << std::fixed << std::setprecision(2) << secondsFastest * 1.0e6 / instances
+			<< std::setw(13) << bytes / instances
+			<< std::setw(13) << allocated.allocations / instances << "\n";
+	}
+	if (lexersMeasured > 0) {
+		std::cout << "\n" << std::left << std::setw(16) << "average" << std::right
+			<< std::setw(13) << std::fixed << std::setprecision(2) << secondsTotal * 1.0e6 / (instances * lexersMeasured)
+			<< std::setw(13) << bytesTotal / (instances * lexersMeasured)
+			<< std::setw(13) << allocationsTotal / (instances * lexersMeasured) << "\n";
+	}
+}
+
+// Set a large keyword list on many C++ lexers as when many documents of one language are open.
+void MeasureKeywordSets() {
+	constexpr size_t instances = 500;
+	constexpr size_t keywordCount = 4000;
+	// Scattered so that setting the list must sort it
+	std::string keywords;
+	for (size_t i = 0; i < keywordCount; i++) {
+		keywords += "api_function_" + std::to_string(i * 7919 % keywordCount) + " ";
+	}
+	std::vector<Scintilla::ILexer5 *> lexers;
+	for (size_t i = 0; i < instances; i++) {
+		lexers.push_back(Lexilla::MakeLexer("cpp"));
+	}
+	if (lexers.front()) {
+		const size_t memoryBefore = MemoryInUse();
+		const auto start = std::chrono::steady_clock::now();
+		for (Scintilla::ILexer5 *plex : lexers) {
+			plex->WordListSet(0, keywords.c_str());
+		}
+		const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+		const size_t memoryAfter = MemoryInUse();
+		const size_t bytes = (memoryAfter > memoryBefore) ? memoryAfter - memoryBefore : 0;
+		std::cout << "\nSetting " << keywords.length() << " bytes of keywords on " << instances << " cpp lexers: "
+			<< std::fixed << std::setprecision(2) << duration.count() * 1.0e6 / instances << " microseconds and "
+			<< bytes << " bytes in total.\n";
+	}
+	for (Scintilla::ILexer5 *plex : lexers) {
+		if (plex) {
+			plex->Release();
+		}
+	}
+}
+
 std::filesystem::path FindLexillaDirectory(std::filesystem::path startDirectory) {
 	// Search up from startDirectory for a directory named "lexilla" or containing a "bin" subdirectory
 	std::filesystem::path directory = startDirectory;
@@ -1041,7 +2732,31 @@ int main(int argc, char **argv) {
 		std::vector<LexerTestsDirectory> directoryList;
 		for (int i = 1; i < argc; i++) {
 			const std::string_view arg = argv[i];
-			if (!arg.starts_with('-')) {
+			if (arg == "-profile") {
+				runOptions.profileAccess = true;
+			} else if (arg == "-replay") {
+				runOptions.replayEdits = true;
+			} else if (arg == "-foldtime") {
+				runOptions.timeFolds = true;
+			} else if (arg == "-scaling") {
+				runOptions.scaling = true;
+			} else if (arg == "-creation") {
+				runOptions.creation = true;
+			} else if (arg == "-allocations") {
+				runOptions.allocations = true;
+			} else if (arg == "-memory") {
+				runOptions.memory = true;
+			} else if (arg == "-shadow") {
+				runOptions.shadow = true;
+			} else if (arg == "-document") {
+				runOptions.document = true;
+			} else if (arg == "-linecache") {
+				runOptions.lineCache = true;
+			} else if (arg == "-trace") {
+				runOptions.trace = true;
+			} else if (arg == "-throughput") {
+				runOptions.throughput = true;
+			} else if (!arg.starts_with('-')) {
 				std::filesystem::path path = arg;
 				if (std::filesystem::is_directory(path)) {
 					std::filesystem::path parent = path.parent_path();
@@ -1055,7 +2770,45 @@ int main(int argc, char **argv) {
 				}
 			}
 		}
+		if (runOptions.creation) {
+			MeasureCreation();
+			MeasureKeywordSets();
+			return 0;
+		}
 		success = AccessLexilla(examplesDirectory, directoryList);
+		if (runOptions.profileAccess) {
+			PrintAccessReport();
+		}
+		if (runOptions.replayEdits) {
+			PrintReplayReport();
+		}
+		if (runOptions.timeFolds) {
+			PrintFoldTimingReport();
+		}
+		if (runOptions.scaling) {
+			PrintScalingReport();
+		}
+		if (runOptions.allocations) {
+			PrintAllocationReport();
+		}
+		if (runOptions.memory) {
+			PrintMemoryReport();
+		}
+		if (runOptions.shadow) {
+			PrintShadowReport();
+		}
+		if (runOptions.document) {
+			PrintDocumentReport();
+		}
+		if (runOptions.lineCache) {
+			PrintLineCacheReport();
+		}
+		if (runOptions.trace) {
+			WriteTraceReport();
+		}
+		if (runOptions.throughput) {
+			PrintThroughputReport();
+		}
 	}
 	return success ? 0 : 1;
 }
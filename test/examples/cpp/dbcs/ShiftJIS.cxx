@@ -0,0 +1,10 @@
+// Shift_JIS characters whose trail byte is '\' such as \ and \ must not continue lines or escape quotes
+// Rg̕\
+int x = 1;
+const char *s = "\";
+const char c = '\';
+/* \tgEFA
+   \ */
+#define TABLE "\"
+int y = 2; // \
+int z = 3;
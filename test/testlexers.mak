@@ -4,7 +4,7 @@
 DEL = del /q
 EXE = TestLexers.exe
 
-INCLUDEDIRS = -I ../../scintilla/include -I ../include -I ../access
+INCLUDEDIRS = -I ../../scintilla/include -I ../include -I ../access -I ../lexlib
 
 !IFDEF LEXILLA_STATIC
 STATIC_FLAG = -D LEXILLA_STATIC
@@ -19,7 +19,7 @@ DEBUG_OPTIONS = -O2 -MT -DNDEBUG $(STATIC_FLAG) -GL
 
 CXXFLAGS = /EHsc /std:c++20 $(DEBUG_OPTIONS) $(INCLUDEDIRS)
 
-OBJS = TestLexers.obj TestDocument.obj LexillaAccess.obj
+OBJS = TestLexers.obj TestDocument.obj InstrumentedDocument.obj AllocationCounter.obj EditableDocument.obj LexillaAccess.obj
 
 all: $(EXE)
 
@@ -36,6 +36,10 @@ $(EXE): $(OBJS) $(LIBS)
 	$(CXX) $(CXXFLAGS) -c $<
 {..\access}.cxx.obj::
 	$(CXX) $(CXXFLAGS) -c $<
+{..\lexlib}.cxx.obj::
+	$(CXX) $(CXXFLAGS) -c $<
 
-TestLexers.obj: $*.cxx TestDocument.h
-TestDocument.obj: $*.cxx $*.h
+TestLexers.obj: $*.cxx TestDocument.h InstrumentedDocument.h AllocationCounter.h ../lexlib/GapBuffer.h ../lexlib/EditableDocument.h
+TestDocument.obj: $*.cxx $*.h ../lexlib/DocumentCharacters.h
+InstrumentedDocument.obj: $*.cxx $*.h
+AllocationCounter.obj: $*.cxx $*.h
@@ -14,11 +14,18 @@ TESTSRC=test*.cxx
 TESTEDSRC=\
  ../../lexlib/Accessor.cxx \
  ../../lexlib/CharacterSet.cxx \
+ ../../lexlib/Convergence.cxx \
+ ../../lexlib/EditableDocument.cxx \
  ../../lexlib/InList.cxx \
+ ../../lexlib/LexAccessor.cxx \
  ../../lexlib/LexerBase.cxx \
  ../../lexlib/LexerModule.cxx \
  ../../lexlib/LexerSimple.cxx \
+ ../../lexlib/LexerStatistics.cxx \
+ ../../lexlib/LineStyleCache.cxx \
+ ../../lexlib/OptionSet.cxx \
  ../../lexlib/PropSetSimple.cxx \
+ ../../lexlib/StyleContext.cxx \
  ../../lexlib/WordList.cxx
 
 TESTS=$(EXE)
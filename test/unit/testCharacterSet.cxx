@@ -51,6 +51,43 @@ TEST_CASE("CharacterSet") {
 		CharacterSet cs2(CharacterSet::setNone, "", 0x80, true);
 		REQUIRE(cs2.Contains(0x100));
 	}
+
+	SECTION("Constexpr") {
+		static constexpr CharacterSet cs(CharacterSet::setDigits, "_");
+		static_assert(cs.Contains('_'));
+		static_assert(cs.Contains('7'));
+		static_assert(!cs.Contains('a'));
+		static constexpr CharacterSet csAfter(CharacterSet::setAlpha, "", true);
+		static_assert(csAfter.Contains(0xE9));
+		static_assert(!csAfter.Contains('1'));
+	}
+
+	SECTION("Members") {
+		static constexpr CharacterSet cs("*/*");
+		static_assert(cs.MemberCount() == 2);
+		static_assert(cs.Members()[0] == '*');
+		static_assert(cs.Members()[1] == '/');
+		const CharacterSet csEmpty;
+		REQUIRE(csEmpty.MemberCount() == 0);
+		// Too many to list
+		const CharacterSet csAlpha(CharacterSet::setAlpha);
+		REQUIRE(csAlpha.MemberCount() == 52);
+		REQUIRE(csAlpha.MemberCount() > CharacterSet::maxMembers);
+		const CharacterSet csAfter(CharacterSet::setNone, "", true);
+		REQUIRE(csAfter.MemberCount() > CharacterSet::maxMembers);
+	}
+
+	SECTION("HighBytes") {
+		const CharacterSet cs;
+		const CharacterSet csAfter(CharacterSet::setNone, "", true);
+		for (int i=0x80; i<0x100; i++) {
+			const char ch = static_cast<char>(i);
+			REQUIRE(!cs.Contains(ch));
+			REQUIRE(!cs.Contains(i));
+			REQUIRE(csAfter.Contains(ch));
+			REQUIRE(csAfter.Contains(i));
+		}
+	}
 }
 
 TEST_CASE("Functions") {
@@ -0,0 +1,273 @@
+/** @file testEditableDocument.cxx
+ ** Unit Tests for Lexilla internal data structures
+ **/
+
+#include <cstddef>
+#include <cassert>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <memory>
+
+#include "ILexer.h"
+#include "Scintilla.h"
+
+#include "LexillaExtensions.h"
+
+#include "PropSetSimple.h"
+#include "WordList.h"
+#include "CharacterSet.h"
+#include "LexAccessor.h"
+#include "Accessor.h"
+#include "LexerModule.h"
+#include "LexerBase.h"
+#include "LexerSimple.h"
+#include "GapBuffer.h"
+#include "EditableDocument.h"
+
+#include "catch.hpp"
+
+using namespace Lexilla;
+
+// Test GapBuffer and EditableDocument.
+
+namespace {
+
+Sci_Position lexedStart = -1;
+Sci_Position lexedLength = 0;
+
+// Style digits as 1 and other text as 0 and set each line state to its line number.
+void ColouriseDigits(Sci_PositionU startPos, Sci_Position length, int, WordList *[], Accessor &styler) {
+	lexedStart = startPos;
+	lexedLength = length;
+	const Sci_Position endPos = startPos + length;
+	styler.StartAt(startPos);
+	styler.StartSegment(startPos);
+	for (Sci_Position position = startPos; position < endPos; position++) {
+		const bool digit = IsADigit(styler[position]);
+		if (digit != IsADigit(styler.SafeGetCharAt(position + 1))) {
+			styler.ColourTo(position, digit ? 1 : 0);
+		}
+		if ((styler[position] == '\n') || (position == endPos - 1)) {
+			const Sci_Position line = styler.GetLine(position);
+			styler.SetLineState(line, static_cast<int>(line));
+		}
+	}
+	styler.ColourTo(endPos - 1, 0);
+}
+
+LexerModule lmDigits(123457, ColouriseDigits, "digits");
+
+// Line starts found by examining the whole text.
+std::vector<Sci_Position> LineStarts(std::string_view text) {
+	std::vector<Sci_Position> starts { 0 };
+	for (size_t position = 0; position < text.length(); position++) {
+		if ((text[position] == '\n') || ((text[position] == '\r') && (position + 1 >= text.length() || text[position + 1] != '\n'))) {
+			starts.push_back(position + 1);
+		}
+	}
+	return starts;
+}
+
+std::string Text(const EditableDocument &doc) {
+	std::string text(doc.Length(), '\0');
+	doc.GetCharRange(text.data(), 0, doc.Length());
+	return text;
+}
+
+}
+
+TEST_CASE("GapBuffer") {
+
+	GapBuffer<char> gb;
+
+	SECTION("IsEmptyInitially") {
+		REQUIRE(0 == gb.Length());
+		REQUIRE('\0' == gb.ValueAt(0));
+	}
+
+	SECTION("InsertAndDelete") {
+		gb.InsertFromArray(0, "abcdef", 6);
+		gb.Insert(3, 'x');
+		gb.DeleteRange(0, 2);
+		REQUIRE(5 == gb.Length());
+		char buffer[6] {};
+		gb.GetRange(buffer, 0, 5);
+		REQUIRE(std::string_view("cxdef") == buffer);
+		REQUIRE('\0' == gb.ValueAt(-1));
+		REQUIRE('\0' == gb.ValueAt(5));
+		REQUIRE(std::string_view("cxdef") == gb.BufferPointer());
+	}
+
+	SECTION("RangePointer") {
+		gb.InsertFromArray(0, "abcdef", 6);
+		gb.Insert(2, 'x');
+		const char *range = gb.RangePointer(1, 4);
+		REQUIRE(std::string_view(range, 4) == "bxcd");
+	}
+}
+
+TEST_CASE("Partitioning") {
+
+	Partitioning<Sci_Position> partitioning;
+
+	SECTION("InsertTextMovesFollowing") {
+		partitioning.InsertText(0, 10);
+		partitioning.InsertPartition(1, 4);
+		partitioning.InsertPartition(2, 8);
+		partitioning.InsertText(0, 2);
+		REQUIRE(3 == partitioning.Partitions());
+		REQUIRE(0 == partitioning.PositionFromPartition(0));
+		REQUIRE(6 == partitioning.PositionFromPartition(1));
+		REQUIRE(10 == partitioning.PositionFromPartition(2));
+		REQUIRE(12 == partitioning.PositionFromPartition(3));
+		REQUIRE(0 == partitioning.PartitionFromPosition(5));
+		REQUIRE(1 == partitioning.PartitionFromPosition(6));
+		REQUIRE(2 == partitioning.PartitionFromPosition(12));
+		partitioning.RemovePartition(1);
+		REQUIRE(2 == partitioning.Partitions());
+		REQUIRE(10 == partitioning.PositionFromPartition(1));
+	}
+}
+
+TEST_CASE("EditableDocument") {
+
+	EditableDocument doc;
+
+	SECTION("IsEmptyInitially") {
+		REQUIRE(0 == doc.Length());
+		REQUIRE(1 == doc.Lines());
+		REQUIRE(0 == doc.LineEnd(0));
+		REQUIRE(SC_FOLDLEVELBASE == doc.GetLevel(0));
+	}
+
+	SECTION("LineEnds") {
+		doc.Set("a\r\nb\rc\nd");
+		REQUIRE(4 == doc.Lines());
+		REQUIRE(1 == doc.LineEnd(0));
+		REQUIRE(3 == doc.LineStart(1));
+		REQUIRE(4 == doc.LineEnd(1));
+		REQUIRE(5 == doc.LineStart(2));
+		REQUIRE(6 == doc.LineEnd(2));
+		REQUIRE(7 == doc.LineStart(3));
+		REQUIRE(8 == doc.LineEnd(3));
+		REQUIRE(1 == doc.LineFromPosition(4));
+		REQUIRE(3 == doc.LineFromPosition(8));
+	}
+
+	SECTION("JoinAndSplitCRLF") {
+		doc.Set("a\rb");
+		REQUIRE(2 == doc.Lines());
+		doc.InsertText(2, "\n");
+		REQUIRE(2 == doc.Lines());
+		REQUIRE(3 == doc.LineStart(1));
+		doc.InsertText(2, "x");
+		REQUIRE(3 == doc.Lines());
+		doc.DeleteRange(2, 1);
+		REQUIRE(2 == doc.Lines());
+		REQUIRE(3 == doc.LineStart(1));
+	}
+
+	SECTION("EditsMatchLineStarts") {
+		const std::string_view pieces[] = { "ab", "\n", "\r", "\r\n", "x\ny\rz", "" };
+		unsigned int seed = 1;
+		const auto random = [&seed](unsigned int range) {
+			seed = seed * 1103515245 + 12345;
+			return static_cast<Sci_Position>((seed >> 16) % range);
+		};
+		for (int edit = 0; edit < 2000; edit++) {
+			const Sci_Position position = random(static_cast<unsigned int>(doc.Length() + 1));
+			if (random(3) == 0) {
+				doc.DeleteRange(position, std::min<Sci_Position>(random(4), doc.Length() - position));
+			} else {
+				doc.InsertText(position, pieces[random(std::size(pieces))]);
+			}
+			std::vector<Sci_Position> docStarts;
+			for (Sci_Position line = 0; line < doc.Lines(); line++) {
+				docStarts.push_back(doc.LineStart(line));
+			}
+			REQUIRE(LineStarts(Text(doc)) == docStarts);
+		}
+	}
+
+	SECTION("LineStatesMoveWithLines") {
+		doc.Set("a\nb\nc\n");
+		for (Sci_Position line = 0; line < doc.Lines(); line++) {
+			doc.SetLineState(line, 10 + static_cast<int>(line));
+			doc.SetLevel(line, SC_FOLDLEVELBASE + static_cast<int>(line));
+		}
+		doc.InsertText(2, "x\ny\n");
+		REQUIRE(6 == doc.Lines());
+		REQUIRE(10 == doc.GetLineState(0));
+		REQUIRE(11 == doc.GetLineState(1));
+		REQUIRE(11 == doc.GetLineState(2));
+		REQUIRE(11 == doc.GetLineState(3));
+		REQUIRE(12 == doc.GetLineState(4));
+		REQUIRE(SC_FOLDLEVELBASE + 2 == doc.GetLevel(4));
+		doc.DeleteRange(2, 4);
+		REQUIRE(4 == doc.Lines());
+		REQUIRE(10 == doc.GetLineState(0));
+		REQUIRE(11 == doc.GetLineState(1));
+		REQUIRE(12 == doc.GetLineState(2));
+	}
+
+	SECTION("LexesOnlyWhenRequested") {
+		doc.Set("a1\nb22\nc333\nd4444\n");
+		doc.SetLexer(new LexerSimple(&lmDigits));
+		REQUIRE(0 == doc.EndStyled());
+		lexedStart = -1;
+		doc.EnsureStyledTo(4);
+		REQUIRE(0 == lexedStart);
+		REQUIRE(7 == lexedLength);
+		REQUIRE(7 == doc.EndStyled());
+		REQUIRE(0 == doc.StyleAt(3));
+		REQUIRE(1 == doc.StyleAt(4));
+		REQUIRE(1 == doc.GetLineState(1));
+
+		// Already styled so no lexing
+		lexedStart = -1;
+		doc.EnsureStyledTo(6);
+		REQUIRE(-1 == lexedStart);
+
+		// Edit invalidates from the edit and lexing restarts from its line
+		doc.InsertText(5, "5");
+		REQUIRE(5 == doc.EndStyled());
+		doc.EnsureStyledTo(doc.Length());
+		REQUIRE(3 == lexedStart);
+		REQUIRE(doc.Length() == doc.EndStyled());
+		REQUIRE(1 == doc.StyleAt(5));
+		REQUIRE(3 == doc.GetLineState(3));
+	}
+
+	SECTION("UTF8Characters") {
+		doc.SetCodePage(65001);
+		// U+00E9, U+20AC, an invalid byte, then 'z'
+		doc.Set("\xC3\xA9\xE2\x82\xAC\xFFz");
+		Sci_Position width = 0;
+		REQUIRE(0xE9 == doc.GetCharacterAndWidth(0, &width));
+		REQUIRE(2 == width);
+		REQUIRE(0x20AC == doc.GetCharacterAndWidth(2, &width));
+		REQUIRE(3 == width);
+		REQUIRE(0xDC80 + 0xFF == doc.GetCharacterAndWidth(5, &width));
+		REQUIRE(1 == width);
+		REQUIRE(5 == doc.GetRelativePosition(0, 2));
+		REQUIRE(2 == doc.GetRelativePosition(6, -2));
+		REQUIRE(0 == doc.GetRelativePosition(6, -3));
+		REQUIRE(-1 == doc.GetRelativePosition(2, -2));
+	}
+
+	SECTION("DBCSCharacters") {
+		doc.SetCodePage(932);
+		doc.Set("a\x82\xA0" "b");
+		Sci_Position width = 0;
+		REQUIRE(0x82A0 == doc.GetCharacterAndWidth(1, &width));
+		REQUIRE(2 == width);
+		REQUIRE(1 == doc.GetRelativePosition(3, -1));
+		// A lead byte without a valid trail byte is a single byte
+		doc.Set("\x82\x7F");
+		REQUIRE(0x82 == doc.GetCharacterAndWidth(0, &width));
+		REQUIRE(1 == width);
+	}
+}
@@ -6,6 +6,7 @@
 
 #include <string>
 #include <string_view>
+#include <memory>
 
 #include "ILexer.h"
 #include "Scintilla.h"
@@ -0,0 +1,115 @@
+/** @file testLexerStatistics.cxx
+ ** Unit Tests for Lexilla internal data structures
+ **/
+
+#include <cstddef>
+#include <cassert>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <memory>
+
+#include "ILexer.h"
+#include "Scintilla.h"
+
+#include "LexillaExtensions.h"
+
+#include "PropSetSimple.h"
+#include "WordList.h"
+#include "LexAccessor.h"
+#include "Accessor.h"
+#include "LexerModule.h"
+#include "GapBuffer.h"
+#include "EditableDocument.h"
+#include "LexerBase.h"
+#include "LexerSimple.h"
+#include "LexerStatistics.h"
+
+#include "catch.hpp"
+
+using namespace Lexilla;
+
+// Test LexerStatistics.
+
+namespace {
+
+// Restarts from the start of the line containing startPos and styles everything as 1 unless
+// that line is empty.
+void ColouriseFromLineStart(Sci_PositionU startPos, Sci_Position length, int, WordList *[], Accessor &styler) {
+	const Sci_PositionU lineStart = styler.LineStart(styler.GetLine(startPos));
+	styler.StartAt(lineStart);
+	styler.StartSegment(lineStart);
+	styler.ColourTo(startPos + length - 1, (styler[lineStart] == '\n') ? 0 : 1);
+	styler.Flush();
+}
+
+void FoldNothing(Sci_PositionU, Sci_Position, int, WordList *[], Accessor &) {
+}
+
+LexerModule lmFromLineStart(123459, ColouriseFromLineStart, "fromlinestart", FoldNothing);
+
+// Value of a member of the object for language in the JSON or -1 when not found.
+long long Member(const std::string &json, std::string_view language, std::string_view name) {
+	const size_t start = json.find("\"" + std::string(language) + "\":{");
+	if (start == std::string::npos) {
+		return -1;
+	}
+	const size_t end = json.find('}', start);
+	const size_t member = json.find("\"" + std::string(name) + "\":", start);
+	if (member == std::string::npos || member > end) {
+		return -1;
+	}
+	return std::stoll(json.substr(member + name.length() + 3));
+}
+
+}
+
+TEST_CASE("LexerStatistics") {
+
+	SetStatisticsCollection(true);
+	EditableDocument doc;
+	doc.Set("first line\nsecond line\n");
+	Scintilla::ILexer5 *lexer = CountedLexer(new LexerSimple(&lmFromLineStart), "countedtest");
+
+	SECTION("ForwardsToLexer") {
+		REQUIRE(123459 == lexer->GetIdentifier());
+		REQUIRE(std::string_view("fromlinestart") == lexer->GetName());
+	}
+
+	SECTION("CountsLexAndFold") {
+		lexer->Lex(0, doc.Length(), 0, &doc);
+		lexer->PropertySet("fold", "1");
+		lexer->Fold(0, doc.Length(), 0, &doc);
+		const std::string json = StatisticsJSON();
+		REQUIRE(json.front() == '{');
+		REQUIRE(json.back() == '}');
+		REQUIRE(Member(json, "countedtest", "lexCalls") >= 1);
+		REQUIRE(Member(json, "countedtest", "lexBytes") >= doc.Length());
+		REQUIRE(Member(json, "countedtest", "lexFills") >= 1);
+		REQUIRE(Member(json, "countedtest", "lexFlushes") >= 1);
+		REQUIRE(Member(json, "countedtest", "foldCalls") >= 1);
+		REQUIRE(Member(json, "countedtest", "lexNanosecondsMax") <= Member(json, "countedtest", "lexNanoseconds"));
+	}
+
+	SECTION("CountsBacktrack") {
+		const long long before = Member(StatisticsJSON(), "countedtest", "backtrackBytes");
+		// Starting part way into the second line restarts from its start 11
+		lexer->Lex(14, doc.Length() - 14, 0, &doc);
+		const std::string json = StatisticsJSON();
+		REQUIRE(before + 3 == Member(json, "countedtest", "backtrackBytes"));
+		REQUIRE(Member(json, "countedtest", "backtrackBytesMax") >= 3);
+		REQUIRE(1 == doc.StyleAt(11));
+	}
+
+	SECTION("NotCountedWhenOff") {
+		SetStatisticsCollection(false);
+		const long long before = Member(StatisticsJSON(), "countedtest", "lexCalls");
+		lexer->Lex(0, doc.Length(), 0, &doc);
+		REQUIRE(before == Member(StatisticsJSON(), "countedtest", "lexCalls"));
+	}
+
+	lexer->Release();
+	SetStatisticsCollection(false);
+}
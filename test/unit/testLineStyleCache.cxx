@@ -0,0 +1,206 @@
+/** @file testLineStyleCache.cxx
+ ** Unit Tests for Lexilla internal data structures
+ **/
+
+#include <cstddef>
+#include <cassert>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <memory>
+
+#include "ILexer.h"
+#include "Scintilla.h"
+
+#include "LexillaExtensions.h"
+
+#include "PropSetSimple.h"
+#include "WordList.h"
+#include "CharacterSet.h"
+#include "LexAccessor.h"
+#include "Accessor.h"
+#include "LexerModule.h"
+#include "GapBuffer.h"
+#include "EditableDocument.h"
+#include "LineStyleCache.h"
+#include "LexerBase.h"
+#include "LexerSimple.h"
+
+#include "catch.hpp"
+
+using namespace Lexilla;
+
+// Test LineStyleCache.
+
+namespace {
+
+int linesColourised = 0;
+
+// Style digits as 1 and other text as 0. A line starting with '>' continues the previous line so
+// is styled 2 after a line that ended with ':'. The line state is 1 after a line ending with ':'.
+int ColouriseLine(std::string_view line, Sci_Position lineNumber, Sci_PositionU start, int stateBefore, Accessor &styler) {
+	linesColourised++;
+	if ((stateBefore == 1) && !line.empty() && line.front() == '>') {
+		styler.ColourTo(start + line.length() - 1, 2);
+	} else {
+		for (size_t i = 0; i < line.length(); i++) {
+			const bool digit = IsADigit(line[i]);
+			if ((i + 1 == line.length()) || (digit != IsADigit(line[i + 1]))) {
+				styler.ColourTo(start + i, digit ? 1 : 0);
+			}
+		}
+	}
+	const size_t lastVisible = line.find_last_not_of("\r\n");
+	const int state = ((lastVisible != std::string_view::npos) && (line[lastVisible] == ':')) ? 1 : 0;
+	styler.SetLineState(lineNumber, state);
+	return state;
+}
+
+void ColouriseLines(Sci_PositionU startPos, Sci_Position length, int, WordList *[], Accessor &styler) {
+	styler.StartAt(startPos);
+	styler.StartSegment(startPos);
+	std::string lineBuffer;
+	Sci_Position line = styler.GetLine(startPos);
+	Sci_PositionU startLine = startPos;
+	const Sci_PositionU endPos = startPos + length;
+	for (Sci_PositionU i = startPos; i < endPos; i++) {
+		lineBuffer.push_back(styler[i]);
+		if ((styler[i] == '\n') || (i == endPos - 1)) {
+			const int stateBefore = (line > 0) ? styler.GetLineState(line - 1) : 0;
+			const int state = StyleLine(styler.lineStyleCache, styler, startLine, i, lineBuffer, stateBefore, [&]() {
+				return ColouriseLine(lineBuffer, line, startLine, stateBefore, styler);
+			});
+			styler.SetLineState(line, state);
+			lineBuffer.clear();
+			startLine = i + 1;
+			line++;
+		}
+	}
+}
+
+LexerModule lmLines(123458, ColouriseLines, "lines");
+
+std::string Styles(const EditableDocument &doc) {
+	std::string styles(doc.Length(), '\0');
+	doc.GetStyleRange(styles.data(), 0, doc.Length());
+	return styles;
+}
+
+std::vector<int> LineStates(const EditableDocument &doc) {
+	std::vector<int> states;
+	for (Sci_Position line = 0; line < doc.Lines(); line++) {
+		states.push_back(doc.GetLineState(line));
+	}
+	return states;
+}
+
+std::string Repeated(std::string_view text, int times) {
+	std::string s;
+	for (int i = 0; i < times; i++) {
+		s += text;
+	}
+	return s;
+}
+
+}
+
+TEST_CASE("LineStyleCache") {
+
+	const std::string text = Repeated("alpha 12 beta 3 gamma:\n>continued line here\nx 345 and then more\n>plain line after that\n", 50);
+
+	// Results without the cache
+	SetLineStyleCaching(false);
+	EditableDocument docPlain;
+	docPlain.Set(text);
+	docPlain.SetLexer(new LexerSimple(&lmLines));
+	docPlain.EnsureStyledTo(docPlain.Length());
+
+	EditableDocument doc;
+	doc.Set(text);
+	LexerSimple *lexer = new LexerSimple(&lmLines);
+	doc.SetLexer(lexer);
+
+	SECTION("NoReportWhenOff") {
+		doc.EnsureStyledTo(doc.Length());
+		LineStyleCacheUse use;
+		REQUIRE(nullptr == lexer->PrivateCall(privateCallLineStyleCache, &use));
+	}
+
+	SECTION("ShortLinesNotCached") {
+		SetLineStyleCaching(true);
+		doc.Set(Repeated("short\n", 10));
+		linesColourised = 0;
+		doc.EnsureStyledTo(doc.Length());
+		REQUIRE(10 == linesColourised);
+	}
+
+	SECTION("ReplaysRepeatedLines") {
+		SetLineStyleCaching(true);
+		linesColourised = 0;
+		doc.EnsureStyledTo(doc.Length());
+		// Each distinct line and incoming state is only lexed once
+		REQUIRE(4 == linesColourised);
+		REQUIRE(Styles(docPlain) == Styles(doc));
+		REQUIRE(LineStates(docPlain) == LineStates(doc));
+		LineStyleCacheUse use;
+		REQUIRE(&use == lexer->PrivateCall(privateCallLineStyleCache, &use));
+		REQUIRE(200 == use.lookups);
+		REQUIRE(196 == use.hits);
+		REQUIRE(4 == use.entries);
+		REQUIRE(use.bytes > 0);
+	}
+
+	SECTION("IncomingStateIsPartOfKey") {
+		SetLineStyleCaching(true);
+		doc.EnsureStyledTo(doc.Length());
+		// Same text as the continued line but after a line that does not end with ':'
+		doc.InsertText(0, ">continued line here\n");
+		doc.EnsureStyledTo(doc.Length());
+		REQUIRE(0 == doc.StyleAt(0));
+		REQUIRE(2 == doc.StyleAt(doc.LineStart(2)));
+		docPlain.InsertText(0, ">continued line here\n");
+		docPlain.EnsureStyledTo(docPlain.Length());
+		REQUIRE(Styles(docPlain) == Styles(doc));
+	}
+
+	SECTION("ClearedWhenPropertyChanges") {
+		SetLineStyleCaching(true);
+		doc.EnsureStyledTo(doc.Length());
+		doc.PropertySet("lines.option", "1");
+		linesColourised = 0;
+		doc.EnsureStyledTo(doc.Length());
+		REQUIRE(4 == linesColourised);
+		LineStyleCacheUse use;
+		lexer->PrivateCall(privateCallLineStyleCache, &use);
+		REQUIRE(4 == use.entries);
+	}
+
+	SECTION("LimitedToLines") {
+		SetLineStyleCaching(true);
+		SetLineStyleCacheLines(3);
+		REQUIRE(LineStyleCache::setSize == LineStyleCacheLines());
+		doc.Set(Repeated("first line of the text\n", 2) + Repeated("second line of the text\n", 2) +
+			Repeated("third line of the text\n", 2) + Repeated("fourth line of the text\n", 2) +
+			Repeated("fifth line of the text\n", 2));
+		doc.EnsureStyledTo(doc.Length());
+		LineStyleCacheUse use;
+		lexer->PrivateCall(privateCallLineStyleCache, &use);
+		REQUIRE(LineStyleCache::setSize == use.entries);
+		REQUIRE(Styles(doc) == std::string(doc.Length(), '\0'));
+		SetLineStyleCacheLines(LineStyleCache::defaultSlotCount);
+	}
+
+	SECTION("OffInReferenceMode") {
+		SetLineStyleCaching(true);
+		SetReferenceMode(true);
+		REQUIRE(!LineStyleCaching());
+		linesColourised = 0;
+		doc.EnsureStyledTo(doc.Length());
+		REQUIRE(200 == linesColourised);
+		SetReferenceMode(false);
+	}
+
+	SetLineStyleCaching(false);
+}
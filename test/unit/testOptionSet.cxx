@@ -27,6 +27,21 @@ struct Options {
 	int io = 0;
 };
 
+// Separate type so registered definitions are not affected by other tests
+struct SharedOptions {
+	bool bo = false;
+	int io = 0;
+};
+
+struct OptionSetShared : public OptionSet<SharedOptions> {
+	explicit OptionSetShared(bool withInt) {
+		DefineProperty("bool.option", &SharedOptions::bo, "BoolOption");
+		if (withInt) {
+			DefineProperty("int.option", &SharedOptions::io, "IntOption");
+		}
+	}
+};
+
 const char *const denseWordLists[] = {
 	"Keywords 1",
 	"Keywords 2",
@@ -124,3 +139,55 @@ TEST_CASE("OptionSet") {
 			Equals("\n\nKeywords 1\n\nKeywords 2"));
 	}
 }
+
+TEST_CASE("OptionSetShared") {
+
+	SECTION("SameDefinitionsShared") {
+		const OptionSetShared os1(true);
+		const OptionSetShared os2(true);
+		REQUIRE_THAT(os1.PropertyNames(), Equals("bool.option\nint.option"));
+		REQUIRE(os1.PropertyNames() == os2.PropertyNames());
+		REQUIRE_THAT(os2.DescribeProperty("int.option"), Equals("IntOption"));
+	}
+
+	SECTION("ValuesPerInstance") {
+		OptionSetShared os1(true);
+		OptionSetShared os2(true);
+		SharedOptions options1;
+		SharedOptions options2;
+		REQUIRE(os1.PropertySet(&options1, "int.option", "7"));
+		REQUIRE(7 == options1.io);
+		REQUIRE(0 == options2.io);
+		REQUIRE_THAT(os1.PropertyGet("int.option"), Equals("7"));
+		REQUIRE_THAT(os2.PropertyGet("int.option"), Equals(""));
+		REQUIRE_FALSE(os2.PropertyGet("missing"));
+	}
+
+	SECTION("DifferentDefinitionsNotShared") {
+		const OptionSetShared os1(true);
+		const OptionSetShared os2(false);
+		REQUIRE_THAT(os1.PropertyNames(), Equals("bool.option\nint.option"));
+		REQUIRE_THAT(os2.PropertyNames(), Equals("bool.option"));
+		REQUIRE_FALSE(os2.PropertyGet("int.option"));
+		REQUIRE(SC_TYPE_INTEGER == os1.PropertyType("int.option"));
+	}
+
+	SECTION("ExtendShared") {
+		OptionSetShared os1(true);
+		const OptionSetShared os2(true);
+		REQUIRE(os1.PropertyNames() == os2.PropertyNames());
+		os1.DefineProperty("extra.option", &SharedOptions::bo, "ExtraOption");
+		REQUIRE_THAT(os1.PropertyNames(), Equals("bool.option\nint.option\nextra.option"));
+		REQUIRE_THAT(os2.PropertyNames(), Equals("bool.option\nint.option"));
+	}
+
+	SECTION("WordListSetsShared") {
+		OptionSetShared os1(true);
+		OptionSetShared os2(true);
+		os1.DefineWordListSets(denseWordLists);
+		os2.DefineWordListSets(denseWordLists);
+		REQUIRE(os1.DescribeWordListSets() == os2.DescribeWordListSets());
+		REQUIRE_THAT(os2.DescribeWordListSets(),
+			Equals("Keywords 1\nKeywords 2\nKeywords 3\nKeywords 4"));
+	}
+}
@@ -18,6 +18,9 @@ namespace {
 constexpr const char *propertyName = "lexer.tex.comment.process";
 constexpr const char *propertyValue = "1";
 
+const PropertyKey propertyKey(propertyName);
+
+
 }
 
 TEST_CASE("PropSetSimple") {
@@ -46,4 +49,34 @@ TEST_CASE("PropSetSimple") {
 		REQUIRE(1 == value);
 	}
 
+	SECTION("GetIntFromKey") {
+		PropSetSimple pss;
+		REQUIRE(0 == pss.GetInt(propertyKey));
+		REQUIRE(3 == pss.GetInt(propertyKey, 3));
+		pss.Set(propertyName, propertyValue);
+		REQUIRE(1 == pss.GetInt(propertyKey));
+		pss.Set(propertyName, "");
+		REQUIRE(3 == pss.GetInt(propertyKey, 3));
+		pss.Set(propertyName, "12abc");
+		REQUIRE(12 == pss.GetInt(propertyKey));
+	}
+
+	SECTION("KeysShareIndex") {
+		const PropertyKey again(propertyName);
+		REQUIRE(again.Index() == propertyKey.Index());
+		const PropertyKey other("lexer.tex.use.keywords");
+		REQUIRE(other.Index() != propertyKey.Index());
+	}
+
+	SECTION("KeyInternedAfterSet") {
+		PropSetSimple pss;
+		pss.Set("late.key", "7");
+		const PropertyKey late("late.key");
+		REQUIRE(7 == pss.GetInt(late));
+		pss.Set(propertyName, propertyValue);
+		REQUIRE(7 == pss.GetInt(late));
+		pss.Set("late.key", "8");
+		REQUIRE(8 == pss.GetInt(late));
+	}
+
 }
@@ -197,6 +197,40 @@ TEST_CASE("SparseState") {
 		REQUIRE(34 == ss.ValueAt(4));
 	}
 
+	SECTION("SpliceMoved") {
+		ss.Set(0, 30);
+		ss.Set(2, 32);
+
+		SparseState<int> ssSaved;
+		ssSaved.Set(0, 30);
+		ssSaved.Set(3, 33);
+		ssSaved.Set(5, 35);
+		// Positions after 2 taken from ssSaved moved forward by 2
+		ss.Splice(ssSaved, 2, 2);
+
+		REQUIRE(5u == ss.size());
+		REQUIRE(32 == ss.ValueAt(2));
+		REQUIRE(30 == ss.ValueAt(3));
+		REQUIRE(30 == ss.ValueAt(4));
+		REQUIRE(33 == ss.ValueAt(5));
+		REQUIRE(33 == ss.ValueAt(6));
+		REQUIRE(35 == ss.ValueAt(7));
+	}
+
+	SECTION("SpliceValueContinues") {
+		ss.Set(0, 30);
+
+		SparseState<int> ssSaved;
+		ssSaved.Set(0, 30);
+		ssSaved.Set(4, 34);
+		// Positions after 3 taken from ssSaved moved back by 1
+		ss.Splice(ssSaved, 3, -1);
+
+		REQUIRE(2u == ss.size());
+		REQUIRE(30 == ss.ValueAt(3));
+		REQUIRE(34 == ss.ValueAt(4));
+	}
+
 }
 
 TEST_CASE("SparseStateString") {
@@ -0,0 +1,315 @@
+/** @file testStyleContext.cxx
+ ** Unit Tests for Lexilla internal data structures
+ **/
+
+#include <cstddef>
+#include <cassert>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+
+#include "ILexer.h"
+#include "Scintilla.h"
+
+#include "LexillaExtensions.h"
+
+#include "LexAccessor.h"
+#include "GapBuffer.h"
+#include "EditableDocument.h"
+#include "StyleContext.h"
+#include "CharacterSet.h"
+
+#include "catch.hpp"
+
+using namespace Lexilla;
+
+// Test StyleContext.
+
+TEST_CASE("StyleContext") {
+
+	EditableDocument doc;
+
+	SECTION("GetCurrentView") {
+		doc.Set("Abc def GHI");
+		LexAccessor styler(&doc);
+		StyleContext sc(0, doc.Length(), 0, styler);
+		sc.Forward(3);
+		REQUIRE(sc.GetCurrentView() == "Abc");
+		REQUIRE(sc.GetCurrentView(StyleContext::Transform::lower) == "abc");
+		sc.SetState(1);
+		sc.Forward(4);
+		// No upper case so view of buffer
+		const std::string_view def = sc.GetCurrentView(StyleContext::Transform::lower);
+		REQUIRE(def == " def");
+		REQUIRE(def.data() == sc.GetCurrentView().data());
+		sc.SetState(2);
+		sc.Forward(4);
+		REQUIRE(sc.GetCurrentView() == " GHI");
+		REQUIRE(sc.GetCurrentView(StyleContext::Transform::lower) == " ghi");
+		sc.Complete();
+	}
+
+	SECTION("GetCurrentViewLongerThanBuffer") {
+		const std::string longToken(10000, 'X');
+		doc.Set(longToken + " ");
+		LexAccessor styler(&doc);
+		StyleContext sc(0, doc.Length(), 0, styler);
+		sc.Forward(10000);
+		REQUIRE(sc.GetCurrentView() == longToken);
+		REQUIRE(sc.GetCurrentView(StyleContext::Transform::lower) == std::string(10000, 'x'));
+		sc.Complete();
+	}
+
+	SECTION("ForwardUntilAny") {
+		doc.Set("/* ab*cd */\nxyz");
+		LexAccessor styler(&doc);
+		StyleContext sc(0, doc.Length(), 0, styler);
+		const CharacterSet setStop("*");
+		sc.Forward(2);
+		sc.ForwardUntilAny(setStop);
+		REQUIRE(sc.currentPos == 4);
+		REQUIRE(sc.chPrev == 'a');
+		REQUIRE(sc.ch == 'b');
+		REQUIRE(sc.chNext == '*');
+		// Already before a member so does not move
+		sc.ForwardUntilAny(setStop);
+		REQUIRE(sc.currentPos == 4);
+		sc.Forward(5);
+		// Stops before the line end
+		sc.ForwardUntilAny(setStop);
+		REQUIRE(sc.currentPos == 10);
+		REQUIRE(sc.ch == '/');
+		REQUIRE(sc.chNext == '\n');
+		REQUIRE(!sc.atLineEnd);
+		sc.Forward(2);
+		REQUIRE(sc.currentLine == 1);
+		REQUIRE(sc.atLineStart);
+		// Stops before the end of the range
+		sc.ForwardUntilAny(setStop);
+		REQUIRE(sc.currentPos == 14);
+		REQUIRE(sc.ch == 'z');
+		REQUIRE(!sc.atLineStart);
+		sc.Complete();
+	}
+
+	SECTION("ForwardUntilAnyUTF8") {
+		doc.SetCodePage(65001);
+		doc.Set("ab\xc3\xa9" "cde*");
+		LexAccessor styler(&doc);
+		StyleContext sc(0, doc.Length(), 0, styler);
+		const CharacterSet setStop("*");
+		// Stops before the non-ASCII character
+		sc.ForwardUntilAny(setStop);
+		REQUIRE(sc.currentPos == 1);
+		REQUIRE(sc.chNext == 0xE9);
+		sc.Forward();
+		REQUIRE(sc.width == 2);
+		sc.ForwardUntilAny(setStop);
+		REQUIRE(sc.currentPos == 6);
+		REQUIRE(sc.chPrev == 'd');
+		REQUIRE(sc.ch == 'e');
+		REQUIRE(sc.chNext == '*');
+		sc.Complete();
+	}
+
+	SECTION("ForwardUntilMatch") {
+		doc.Set("/* a*b/c */\n*/x*/");
+		LexAccessor styler(&doc);
+		StyleContext sc(0, doc.Length(), 0, styler);
+		sc.Forward(2);
+		// Passes over '*' and '/' that do not form the match
+		sc.ForwardUntilMatch("*/");
+		REQUIRE(sc.currentPos == 8);
+		REQUIRE(sc.ch == ' ');
+		REQUIRE(sc.chNext == '*');
+		// Already before the match so does not move
+		sc.ForwardUntilMatch("*/");
+		REQUIRE(sc.currentPos == 8);
+		sc.Forward(3);
+		REQUIRE(sc.chNext == '*');
+		REQUIRE(sc.atLineEnd);
+		sc.Forward();
+		REQUIRE(sc.currentLine == 1);
+		REQUIRE(sc.Match('*', '/'));
+		sc.ForwardUntilMatch("*/");
+		REQUIRE(sc.currentPos == 14);
+		REQUIRE(sc.ch == 'x');
+		sc.Forward(2);
+		// Stops before the end of the range
+		sc.ForwardUntilMatch("*/");
+		REQUIRE(sc.currentPos == 16);
+		sc.Complete();
+	}
+
+	SECTION("ForwardUntilMatchLong") {
+		// Crosses several buffer fills with non-ASCII characters and near matches
+		std::string text = "/*";
+		for (int i = 0; i < 1000; i++) {
+			text += "ab\xc3\xa9*c/";
+		}
+		const Sci_Position endComment = text.length();
+		text += "*/";
+		doc.SetCodePage(65001);
+		doc.Set(text);
+		LexAccessor styler(&doc);
+		StyleContext sc(0, doc.Length(), 0, styler);
+		sc.Forward(2);
+		sc.ForwardUntilMatch("*/");
+		REQUIRE(sc.currentPos == static_cast<Sci_PositionU>(endComment - 1));
+		REQUIRE(sc.ch == '/');
+		REQUIRE(sc.chPrev == 'c');
+		REQUIRE(sc.chNext == '*');
+		sc.Complete();
+	}
+
+	SECTION("ForwardUntilAnyDBCS") {
+		// In code page 932 the trail byte of \x83\x5c is '\\'
+		doc.SetCodePage(932);
+		doc.Set("a\x83\x5c" "b\\c");
+		LexAccessor styler(&doc);
+		StyleContext sc(0, doc.Length(), 0, styler);
+		const CharacterSet setStop("\\");
+		sc.ForwardUntilAny(setStop);
+		REQUIRE(sc.currentPos == 3);
+		REQUIRE(sc.ch == 'b');
+		REQUIRE(sc.chNext == '\\');
+		sc.Complete();
+	}
+
+	SECTION("DBCS") {
+		doc.SetCodePage(932);
+		doc.Set("a\x95\x5c\x82\x7f" "b");
+		LexAccessor styler(&doc);
+		REQUIRE(styler.IsLeadByte('\x95'));
+		REQUIRE(!styler.IsLeadByte('\x5c'));
+		REQUIRE(!styler.IsLeadByte('\xA0'));
+		StyleContext sc(0, doc.Length(), 0, styler);
+		REQUIRE(sc.ch == 'a');
+		REQUIRE(sc.chNext == 0x955C);
+		REQUIRE(sc.widthNext == 2);
+		REQUIRE(sc.GetRelativeCharacter(2) == 0x82);
+		REQUIRE(sc.GetRelativeCharacter(3) == 0x7F);
+		REQUIRE(sc.GetRelativeCharacter(5) == 0);
+		sc.Forward();
+		REQUIRE(sc.ch == 0x955C);
+		// 0x7F is not a trail byte so 0x82 is a single byte
+		REQUIRE(sc.chNext == 0x82);
+		REQUIRE(sc.widthNext == 1);
+		sc.Forward(3);
+		REQUIRE(sc.currentPos == 5);
+		REQUIRE(sc.ch == 'b');
+		REQUIRE(sc.GetRelativeCharacter(-3) == 0x955C);
+		sc.Complete();
+	}
+
+	SECTION("ReferenceMode") {
+		// Tokens are copied, runs are stepped over one character at a time, and DBCS is
+		// decoded by the document but the results are the same
+		SetReferenceMode(true);
+		doc.Set("/* ab*cd */");
+		LexAccessor styler(&doc);
+		REQUIRE(styler.ReferencePath());
+		StyleContext sc(0, doc.Length(), 0, styler);
+		const CharacterSet setStop("*");
+		sc.Forward(2);
+		sc.ForwardUntilAny(setStop);
+		REQUIRE(sc.currentPos == 4);
+		REQUIRE(sc.chNext == '*');
+		const std::string_view view = sc.GetCurrentView();
+		REQUIRE(view == "/* a");
+		REQUIRE(view.data() != styler.BufferPointer(0, 4));
+		sc.Complete();
+
+		doc.SetCodePage(932);
+		doc.Set("a\x95\x5c\x82\x7f" "b");
+		LexAccessor stylerDBCS(&doc);
+		REQUIRE(stylerDBCS.IsLeadByte('\x95'));
+		REQUIRE(!stylerDBCS.IsLeadByte('\x5c'));
+		StyleContext scDBCS(0, doc.Length(), 0, stylerDBCS);
+		REQUIRE(scDBCS.chNext == 0x955C);
+		REQUIRE(scDBCS.widthNext == 2);
+		scDBCS.Forward(2);
+		REQUIRE(scDBCS.ch == 0x82);
+		scDBCS.Complete();
+		SetReferenceMode(false);
+	}
+
+	SECTION("ScanUntilAny") {
+		const std::string text = std::string(10000, 'x') + "*";
+		doc.Set(text);
+		LexAccessor styler(&doc);
+		const CharacterSet setStop("*");
+		// Crosses several buffer fills
+		REQUIRE(styler.ScanUntilAny(0, doc.Length(), setStop) == 10000);
+		REQUIRE(styler.ScanUntilAny(0, 5000, setStop) == 5000);
+		REQUIRE(styler.ScanUntilAny(10000, doc.Length(), setStop) == 10000);
+		REQUIRE(styler.ScanUntilAny(0, doc.Length(), setStop, 'w') == 0);
+	}
+
+	SECTION("ScanBytes") {
+		// Vector code must find the same byte as the scalar loop wherever it is in or after each
+		// group of 16 bytes, whether it is a member or is above stopAbove
+		const unsigned char stops[] = { '*', '\\', '\n' };
+		for (size_t length = 0; length < 50; length++) {
+			for (size_t position = 0; position <= length; position++) {
+				for (const char stop : { '*', '\n', '\xe9', '\x80', '\xff', '\x7f' }) {
+					std::string text(length, 'x');
+					if (position < length) {
+						text[position] = stop;
+					}
+					for (const unsigned char stopAbove : { 0x7F, 0xFF, 0x77, 0xE8 }) {
+						for (size_t count = 0; count <= std::size(stops); count++) {
+							const size_t scalar = ScanBytesScalar(text.data(), length, stops, count, stopAbove);
+							REQUIRE(ScanBytes(text.data(), length, stops, count, stopAbove) == scalar);
+						}
+					}
+				}
+			}
+		}
+		// Every member a set may have
+		const CharacterSet setFull("0123456789abcdef");
+		REQUIRE(setFull.MemberCount() == CharacterSet::maxMembers);
+		const std::string digits(40, '-');
+		for (size_t position = 0; position < digits.length(); position++) {
+			std::string text = digits;
+			text[position] = 'f';
+			REQUIRE(ScanBytes(text.data(), text.length(), setFull.Members(), setFull.MemberCount(), 0xFF) == position);
+		}
+	}
+
+	SECTION("ScanUntilAnyWindowEdges") {
+		// LexAccessor buffers 4000 bytes starting 500 before the position filled. Stops are
+		// placed around the ends of the window and of its last 16 bytes, and just before the
+		// position so in the slop which must not be found.
+		constexpr Sci_Position bufferSize = 4000;
+		constexpr Sci_Position slopSize = bufferSize / 8;
+		const CharacterSet setStop("*");
+		// More members than vector code compares so always scanned by Contains
+		const CharacterSet setStopScalar(CharacterSet::setUpper, "*");
+		REQUIRE(setStopScalar.MemberCount() > CharacterSet::maxMembers);
+		for (const Sci_Position start : { Sci_Position(0), Sci_Position(1), slopSize, Sci_Position(1234) }) {
+			const Sci_Position windowStart = std::max<Sci_Position>(start - slopSize, 0);
+			const Sci_Position windowEnd = windowStart + bufferSize;
+			std::vector<Sci_Position> stops;
+			for (const Sci_Position edge : { start, windowEnd - 16, windowEnd }) {
+				for (Sci_Position offset = -2; offset <= 2; offset++) {
+					stops.push_back(edge + offset);
+				}
+			}
+			for (const Sci_Position stop : stops) {
+				std::string text(10000, 'x');
+				if (stop >= 0) {
+					text[stop] = '*';
+				}
+				doc.Set(text);
+				const Sci_Position expected = (stop >= start) ? stop : doc.Length();
+				LexAccessor styler(&doc);
+				REQUIRE(styler.ScanUntilAny(start, doc.Length(), setStop) == expected);
+				LexAccessor stylerScalar(&doc);
+				REQUIRE(stylerScalar.ScanUntilAny(start, doc.Length(), setStopScalar) == expected);
+			}
+		}
+	}
+}
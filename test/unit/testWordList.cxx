@@ -10,6 +10,9 @@
 #include <vector>
 #include <map>
 
+#include "ILexer.h"
+
+#include "LexAccessor.h"
 #include "WordList.h"
 #include "CharacterSet.h"
 #include "SubStyles.h"
@@ -112,6 +115,20 @@ TEST_CASE("WordList") {
 		REQUIRE(wl.InListAbbreviated("\xd1\x81\xd1\x8b\xd1\x80", '~'));
 	}
 
+	SECTION("StringViewInListAbbreviated") {
+		wl.Set("else stru~ct w~hile ^gtk");
+		// Views that are not terminated after the word, as when viewing a document
+		const std::string_view text = "structure whiles";
+		REQUIRE(wl.InListAbbreviated(text.substr(0, 6), '~'));
+		REQUIRE(wl.InListAbbreviated(text.substr(0, 4), '~'));
+		REQUIRE(!wl.InListAbbreviated(text.substr(0, 3), '~'));
+		REQUIRE(!wl.InListAbbreviated(text.substr(0, 7), '~'));
+		REQUIRE(wl.InListAbbreviated(text.substr(10, 5), '~'));
+		REQUIRE(!wl.InListAbbreviated(text.substr(10, 6), '~'));
+		REQUIRE(!wl.InListAbbreviated(std::string_view(), '~'));
+		REQUIRE(wl.InListAbbreviated(std::string_view("gtk_prefix"), '~'));
+	}
+
 	SECTION("InListAbridged") {
 		wl.Set("list w.~.active bo~k a~z ~_frozen \xd1\x81~\xd1\x80");
 		REQUIRE(wl.InListAbridged("list", '~'));
@@ -137,6 +154,66 @@ TEST_CASE("WordList") {
 		// Russian syr
 		REQUIRE(wl.InListAbridged("\xd1\x81\xd1\x8b\xd1\x80", '~'));
 	}
+
+	SECTION("Shared") {
+		// WordLists set to the same text share words
+		wl.Set("else struct");
+		WordList wl2;
+		wl2.Set("else struct");
+		REQUIRE(wl.WordAt(0) == wl2.WordAt(0));
+		// Lower casing and separators produce a different set of words
+		WordList wlLower;
+		wlLower.Set("else struct", true);
+		REQUIRE(wl.WordAt(0) != wlLower.WordAt(0));
+		WordList wlLines(true);
+		wlLines.Set("else struct");
+		REQUIRE(1 == wlLines.Length());
+		// Changing or clearing one does not affect the other
+		wl2.Set("class");
+		REQUIRE(wl.InList("struct"));
+		REQUIRE(!wl2.InList("struct"));
+		wl.Clear();
+		REQUIRE(!wl.InList("struct"));
+		REQUIRE(wlLower.InList("struct"));
+		// Sets after the last user was released still work
+		wl.Set("else struct");
+		REQUIRE(wl.InList("else"));
+	}
+
+	SECTION("SharedMatchesText") {
+		// Texts of the same length are only shared when they produce the same words
+		wl.Set("else struct");
+		WordList wlOther;
+		wlOther.Set("else strucT");
+		REQUIRE(wl.WordAt(0) != wlOther.WordAt(0));
+		REQUIRE(wlOther.InList("strucT"));
+		WordList wlUpper;
+		wlUpper.Set("ELSE STRUCT", true);
+		WordList wlUpper2;
+		wlUpper2.Set("ELSE STRUCT", true);
+		REQUIRE(wlUpper.WordAt(0) == wlUpper2.WordAt(0));
+		REQUIRE(wlUpper.InList("struct"));
+		// Only separators
+		WordList wlSpaces;
+		wlSpaces.Set("  \n ");
+		WordList wlSpaces2;
+		wlSpaces2.Set("  \n ");
+		REQUIRE(0 == wlSpaces2.Length());
+		WordList wlSpacesLines(true);
+		wlSpacesLines.Set("  \n ");
+		REQUIRE(2 == wlSpacesLines.Length());
+	}
+
+	SECTION("NotSharedInReferenceMode") {
+		wl.Set("else struct");
+		SetReferenceMode(true);
+		WordList wl2;
+		wl2.Set("else struct");
+		SetReferenceMode(false);
+		REQUIRE(wl.WordAt(0) != wl2.WordAt(0));
+		REQUIRE(wl2.InList("struct"));
+		REQUIRE(!(wl != wl2));
+	}
 }
 
 // Test WordClassifier.